@@ -222,6 +222,9 @@ class PROJ_GCC_DLL CoordinateOperation : public common::ObjectUsage,
         //! @cond Doxygen_Suppress
         PROJ_FOR_TEST CoordinateOperationNNPtr
         shallowClone() const;
+
+    // Not recorded in WKT or PROJJSON
+    PROJ_INTERNAL void setHasBallparkTransformation(bool b);
     //! @endcond
 
   protected:
@@ -251,8 +254,6 @@ class PROJ_GCC_DLL CoordinateOperation : public common::ObjectUsage,
     PROJ_INTERNAL
     void setAccuracies(
         const std::vector<metadata::PositionalAccuracyNNPtr> &accuracies);
-    PROJ_INTERNAL void setHasBallparkTransformation(bool b);
-
     PROJ_INTERNAL void setRequiresPerCoordinateInputTime(bool b);
 
     PROJ_INTERNAL void
@@ -806,6 +806,8 @@ class PROJ_GCC_DLL WKTParser {
 
     PROJ_DLL WKTParser &setUnsetIdentifiersIfIncompatibleDef(bool unset);
 
+    PROJ_DLL WKTParser &setCheckGrammar(bool check);
+
     PROJ_DLL util::BaseObjectNNPtr
     createFromWKT(const std::string &wkt); // throw(ParsingException)
 
@@ -923,6 +925,20 @@ class PROJ_GCC_DLL DatabaseContext {
 
     PROJ_DLL unsigned int getQueryCounter() const;
 
+    /** Execution statistics of a SQL statement. */
+    struct QueryStatistics {
+        std::string sql{};
+        unsigned int executionCount = 0;
+        // Number of executions that reused an already prepared statement
+        unsigned int preparedStatementHitCount = 0;
+        // Cumulated execution time, in microseconds
+        long long totalTimeUs = 0;
+    };
+
+    PROJ_DLL void setQueryStatisticsEnabled(bool enabled);
+
+    PROJ_DLL std::vector<QueryStatistics> getQueryStatistics() const;
+
     PROJ_INTERNAL std::string
     getProjGridName(const std::string &oldProjGridName);
 
@@ -0,0 +1,266 @@
+#!/usr/bin/env python
+###############################################################################
+#
+#  Project:  PROJ
+#  Purpose:  Convert a tinshift JSON file to the binary tinshift format
+#
+###############################################################################
+#  Copyright (c) 2026, PROJ contributors
+#
+#  Permission is hereby granted, free of charge, to any person obtaining a
+#  copy of this software and associated documentation files (the "Software"),
+#  to deal in the Software without restriction, including without limitation
+#  the rights to use, copy, modify, merge, publish, distribute, sublicense,
+#  and/or sell copies of the Software, and to permit persons to whom the
+#  Software is furnished to do so, subject to the following conditions:
+#
+#  The above copyright notice and this permission notice shall be included
+#  in all copies or substantial portions of the Software.
+#
+#  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+#  OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+#  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+#  THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+#  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+#  FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+#  DEALINGS IN THE SOFTWARE.
+###############################################################################
+
+# The layout of the binary format is described in
+# src/transformations/tinshift_impl.hpp and in the documentation of the
+# tinshift method.
+
+import argparse
+import array
+import json
+import math
+import struct
+import sys
+
+SIGNATURE = b'TINSHIFT'
+FORMAT_VERSION = 1
+HEADER_SIZE = 192
+
+# Maximum number of cells of the spatial index along each axis
+MAX_CELLS_PER_AXIS = 65536
+
+
+def get_column(columns, name):
+    return columns.index(name) if name in columns else -1
+
+
+def get_vertices(j):
+    """ Return the vertices, as a flat list of values, with the layout
+        expected by the binary format, and the number of values per vertex. """
+
+    components = j['transformed_components']
+    horizontal = 'horizontal' in components
+    vertical = 'vertical' in components
+    columns = j['vertices_columns']
+    source_x = get_column(columns, 'source_x')
+    source_y = get_column(columns, 'source_y')
+    target_x = get_column(columns, 'target_x')
+    target_y = get_column(columns, 'target_y')
+    source_z = get_column(columns, 'source_z')
+    target_z = get_column(columns, 'target_z')
+    offset_z = get_column(columns, 'offset_z')
+    if source_x < 0 or source_y < 0:
+        raise Exception('source_x and source_y must be specified')
+    if horizontal and (target_x < 0 or target_y < 0):
+        raise Exception('target_x and target_y must be specified')
+    if vertical and offset_z < 0 and (source_z < 0 or target_z < 0):
+        raise Exception('source_z and target_z, or offset_z, must be specified')
+
+    col_count = 2 + (2 if horizontal else 0) + (1 if vertical else 0)
+    values = array.array('d')
+    for vertex in j['vertices']:
+        if len(vertex) != len(columns):
+            raise Exception('vertices[] item has not expected number of elements')
+        values.append(vertex[source_x])
+        values.append(vertex[source_y])
+        if horizontal:
+            values.append(vertex[target_x])
+            values.append(vertex[target_y])
+        if vertical:
+            if offset_z >= 0:
+                values.append(vertex[offset_z])
+            else:
+                values.append(vertex[target_z] - vertex[source_z])
+    return values, col_count
+
+
+def get_triangles(j, vertex_count):
+    columns = j['triangles_columns']
+    idx = [get_column(columns, 'idx_vertex%d' % (i + 1)) for i in range(3)]
+    if min(idx) < 0:
+        raise Exception('idx_vertex1, idx_vertex2 and idx_vertex3 must be specified')
+    values = array.array('I')
+    if values.itemsize != 4:
+        values = array.array('L')
+        assert values.itemsize == 4
+    for triangle in j['triangles']:
+        if len(triangle) != len(columns):
+            raise Exception('triangles[] item has not expected number of elements')
+        for i in idx:
+            v = triangle[i]
+            if not isinstance(v, int) or v < 0 or v >= vertex_count:
+                raise Exception('Invalid value for a vertex index')
+            values.append(v)
+    return values
+
+
+def get_cell_range(vmin, vmax, extent_min, extent_max, n):
+    """ Return the range of cells intersecting [vmin, vmax]. It is made
+        slightly conservative so that a value on a cell boundary is found
+        whatever the rounding done by the reader. """
+
+    if extent_max == extent_min:
+        return 0, 0
+    scale = n / (extent_max - extent_min)
+    fmin = (vmin - extent_min) * scale
+    fmax = (vmax - extent_min) * scale
+    cmin = min(int(fmin), n - 1)
+    cmax = min(int(fmax), n - 1)
+    eps = 1e-6
+    if cmin > 0 and fmin - cmin < eps:
+        cmin -= 1
+    if cmax < n - 1 and cmax + 1 - fmax < eps:
+        cmax += 1
+    return cmin, cmax
+
+
+def build_index(vertices, col_count, triangles, idx_x, idx_y):
+    """ Return (extent, ncols, nrows, cell_start, cell_triangles) """
+
+    xs = vertices[idx_x::col_count]
+    ys = vertices[idx_y::col_count]
+    minx, maxx = min(xs), max(xs)
+    miny, maxy = min(ys), max(ys)
+
+    # Aim at about one triangle per cell
+    triangle_count = len(triangles) // 3
+    width = maxx - minx
+    height = maxy - miny
+    if width > 0 and height > 0:
+        ncols = int(round(math.sqrt(triangle_count * width / height)))
+    elif width > 0:
+        ncols = triangle_count
+    else:
+        ncols = 1
+    ncols = max(1, min(ncols, MAX_CELLS_PER_AXIS))
+    nrows = 1 if height == 0 else max(1, min(
+        int(round(triangle_count / ncols)), MAX_CELLS_PER_AXIS))
+
+    ranges = []
+    counts = [0] * (ncols * nrows + 1)
+    for i in range(triangle_count):
+        i1, i2, i3 = triangles[3 * i], triangles[3 * i + 1], triangles[3 * i + 2]
+        x1, x2, x3 = xs[i1], xs[i2], xs[i3]
+        y1, y2, y3 = ys[i1], ys[i2], ys[i3]
+        cmin, cmax = get_cell_range(min(x1, x2, x3), max(x1, x2, x3),
+                                    minx, maxx, ncols)
+        rmin, rmax = get_cell_range(min(y1, y2, y3), max(y1, y2, y3),
+                                    miny, maxy, nrows)
+        ranges.append((cmin, cmax, rmin, rmax))
+        for row in range(rmin, rmax + 1):
+            for col in range(cmin, cmax + 1):
+                counts[row * ncols + col + 1] += 1
+
+    cell_start = array.array(triangles.typecode, counts)
+    for i in range(1, len(cell_start)):
+        cell_start[i] += cell_start[i - 1]
+    cell_triangles = array.array(triangles.typecode, [0] * cell_start[-1])
+    next_pos = list(cell_start[:-1])
+    for i, (cmin, cmax, rmin, rmax) in enumerate(ranges):
+        for row in range(rmin, rmax + 1):
+            for col in range(cmin, cmax + 1):
+                cell = row * ncols + col
+                cell_triangles[next_pos[cell]] = i
+                next_pos[cell] += 1
+
+    return (minx, miny, maxx, maxy), ncols, nrows, cell_start, cell_triangles
+
+
+def pad(f, alignment=8):
+    pos = f.tell()
+    if pos % alignment:
+        f.write(b'\0' * (alignment - pos % alignment))
+    return f.tell()
+
+
+def write_array(f, values):
+    if sys.byteorder != 'little':
+        values = array.array(values.typecode, values)
+        values.byteswap()
+    offset = pad(f)
+    values.tofile(f)
+    return offset
+
+
+def convert(src, dst):
+    with open(src, 'rb') as f:
+        j = json.load(f)
+
+    if j.get('file_type') != 'triangulation_file':
+        raise Exception('%s is not a triangulation file' % src)
+
+    vertices, col_count = get_vertices(j)
+    vertex_count = len(vertices) // col_count
+    triangles = get_triangles(j, vertex_count)
+    horizontal = 'horizontal' in j['transformed_components']
+
+    metadata = dict(j)
+    del metadata['vertices']
+    del metadata['triangles']
+    columns = ['source_x', 'source_y']
+    if horizontal:
+        columns += ['target_x', 'target_y']
+    if 'vertical' in j['transformed_components']:
+        columns += ['offset_z']
+    metadata['vertices_columns'] = columns
+    metadata['triangles_columns'] = ['idx_vertex1', 'idx_vertex2', 'idx_vertex3']
+    metadata = json.dumps(metadata, separators=(',', ':')).encode('UTF-8')
+
+    indices = []
+    if triangles:
+        indices.append(build_index(vertices, col_count, triangles, 0, 1))
+        if horizontal:
+            indices.append(build_index(vertices, col_count, triangles, 2, 3))
+
+    with open(dst, 'wb') as f:
+        f.write(b'\0' * HEADER_SIZE)
+        metadata_offset = f.tell()
+        f.write(metadata)
+        vertices_offset = write_array(f, vertices)
+        triangles_offset = write_array(f, triangles)
+        index_headers = b''
+        for extent, ncols, nrows, cell_start, cell_triangles in indices:
+            cell_start_offset = write_array(f, cell_start)
+            cell_triangles_offset = write_array(f, cell_triangles)
+            index_headers += struct.pack('<4dIIQQQ', *extent, ncols, nrows,
+                                         cell_start_offset,
+                                         cell_triangles_offset,
+                                         len(cell_triangles))
+        index_headers += b'\0' * (2 * 64 - len(index_headers))
+
+        f.seek(0)
+        f.write(SIGNATURE)
+        f.write(struct.pack('<IIQQQQQQ', FORMAT_VERSION, col_count,
+                            metadata_offset, len(metadata),
+                            vertex_count, vertices_offset,
+                            len(triangles) // 3, triangles_offset))
+        f.write(index_headers)
+        assert f.tell() == HEADER_SIZE
+
+
+def main():
+    parser = argparse.ArgumentParser(
+        description='Convert a tinshift JSON file to the binary tinshift format.')
+    parser.add_argument('source', help='Source JSON file')
+    parser.add_argument('dest', help='Destination binary file')
+    args = parser.parse_args()
+    convert(args.source, args.dest)
+
+
+if __name__ == '__main__':
+    main()
@@ -3,12 +3,15 @@ set(CCT_SRC
   proj_strtod.cpp
   proj_strtod.h
 )
-set(CCT_INCLUDE optargpm.h)
+set(CCT_INCLUDE optargpm.h utils.h)
 
 source_group("Source Files\\Bin" FILES ${CCT_SRC})
 
 add_executable(cct ${CCT_SRC} ${CCT_INCLUDE})
 target_link_libraries(cct PRIVATE ${PROJ_LIBRARIES})
+if(Threads_FOUND AND CMAKE_USE_PTHREADS_INIT)
+  target_link_libraries(cct PRIVATE ${CMAKE_THREAD_LIBS_INIT})
+endif()
 
 install(TARGETS cct
   DESTINATION ${CMAKE_INSTALL_BINDIR})
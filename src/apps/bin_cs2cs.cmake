@@ -8,6 +8,9 @@ source_group("Source Files\\Bin" FILES ${CS2CS_SRC})
 
 add_executable(cs2cs ${CS2CS_SRC} ${CS2CS_INCLUDE})
 target_link_libraries(cs2cs PRIVATE ${PROJ_LIBRARIES})
+if(Threads_FOUND AND CMAKE_USE_PTHREADS_INIT)
+  target_link_libraries(cs2cs PRIVATE ${CMAKE_THREAD_LIBS_INIT})
+endif()
 
 install(TARGETS cs2cs
   DESTINATION ${CMAKE_INSTALL_BINDIR})
@@ -82,11 +82,25 @@ Thomas Knudsen, thokn@sdfe.dk, 2016-05-25/2017-10-26
 #include <cstdint>
 #include <fstream> // std::ifstream
 #include <iostream>
+#include <string>
+#include <vector>
 
 #include "optargpm.h"
 #include "proj.h"
 #include "proj_internal.h"
 #include "proj_strtod.h"
+#include "utils.h"
+
+#if defined(MSDOS) || defined(OS2) || defined(WIN32) || defined(__WIN32__)
+#include <fcntl.h>
+#include <io.h>
+#define SET_BINARY_MODE(file) _setmode(_fileno(file), O_BINARY)
+#else
+#define SET_BINARY_MODE(file)
+#endif
+
+/* Number of records of binary input transformed at once */
+constexpr size_t BINARY_BLOCK_SIZE = 16384;
 
 static void logger(void *data, int level, const char *msg);
 static void print(PJ_LOG_LEVEL log_level, const char *fmt, ...);
@@ -106,6 +120,8 @@ static const char usage[] = {
     "Options:\n"
     "--------------------------------------------------------------------------"
     "------\n"
+    "    -b                Binary input and output (see --dimension and "
+    "--planar)\n"
     "    -c x,y,z,t        Specify input columns for (up to) 4 input "
     "parameters.\n"
     "                      Defaults to 1,2,3,4\n"
@@ -133,6 +149,13 @@ static const char usage[] = {
     "    --verbose         Alias for -v\n"
     "    --inverse         Alias for -I\n"
     "    --skip-lines      Alias for -s\n"
+    "    --threads n       Transform the input with n threads\n"
+    "    --binary          Alias for -b\n"
+    "    --binary-input    Binary input only\n"
+    "    --binary-output   Binary output only\n"
+    "    --dimension n     Number of values of binary records (2 to 4). "
+    "Defaults to 4\n"
+    "    --planar n        Binary data is planar, by blocks of n records\n"
     "    --help            Alias for -h\n"
     "    --version         Print version number\n"
     "--------------------------------------------------------------------------"
@@ -215,9 +238,73 @@ static void print(PJ_LOG_LEVEL log_level, const char *fmt, ...) {
     free(msg_buf);
 }
 
+/* Append a formatted line to str, as print(PJ_LOG_NONE, ...) would write it */
+static void append_line(std::string &str, const char *fmt, ...) {
+    va_list args;
+    va_start(args, fmt);
+    char msg_buf[256];
+    va_list args_copy;
+    va_copy(args_copy, args);
+    const int len = vsnprintf(msg_buf, sizeof(msg_buf), fmt, args_copy);
+    va_end(args_copy);
+    if (len >= static_cast<int>(sizeof(msg_buf))) {
+        const size_t size = str.size();
+        str.resize(size + len + 1);
+        vsnprintf(&str[size], len + 1, fmt, args);
+        str.back() = '\n';
+    } else if (len >= 0) {
+        str.append(msg_buf, len);
+        str += '\n';
+    }
+    va_end(args);
+}
+
+static const int byte_order_test = 1;
+#define IS_LSB                                                                 \
+    (1 == (reinterpret_cast<const unsigned char *>(&byte_order_test))[0])
+
+/* Convert doubles between little-endian and the host byte order, in place */
+static void to_little_endian(double *values, size_t count) {
+    if (IS_LSB)
+        return;
+    unsigned char *data = reinterpret_cast<unsigned char *>(values);
+    for (size_t i = 0; i < count; i++, data += sizeof(double))
+        std::reverse(data, data + sizeof(double));
+}
+
+/* Append the first dimension components of point to str, as binary output */
+static void append_binary(std::string &str, PJ_COORD point, int dimension) {
+    to_little_endian(point.v, dimension);
+    str.append(reinterpret_cast<const char *>(point.v),
+               dimension * sizeof(double));
+}
+
+/* An input line and what its transformation prints */
+struct Record {
+    std::string line{};
+    int index = 0;
+    const char *filename = nullptr;
+    std::string output{};
+    std::string errors{};
+};
+
+/* Logger of the contexts used by threads. Messages are stored with the record
+   being transformed, so that they are printed in order */
+static void thread_logger(void *data, int level, const char *msg) {
+    Record *record = *static_cast<Record **>(data);
+    if (nullptr == record || level == PJ_LOG_NONE) {
+        logger((void *)stdout, level, msg);
+        return;
+    }
+    int log_tell = proj_log_level(PJ_DEFAULT_CTX, PJ_LOG_TELL);
+    if (level <= log_tell || level == PJ_LOG_ERROR) {
+        record->errors += msg;
+        record->errors += '\n';
+    }
+}
+
 int main(int argc, char **argv) {
     PJ *P = nullptr;
-    PJ_COORD point;
     PJ_PROJ_INFO info;
     OPTARGS *o;
     char blank_comment[] = "";
@@ -226,11 +313,16 @@ int main(int argc, char **argv) {
     double fixed_z = HUGE_VAL, fixed_time = HUGE_VAL;
     int decimals_angles = 10;
     int decimals_distances = 4;
+    int threads = 1;
+    int dimension = 4;
+    size_t planar = 0;
     int columns_xyzt[] = {1, 2, 3, 4};
-    const char *longflags[] = {"v=verbose", "h=help", "I=inverse", "version",
-                               nullptr};
+    const char *longflags[] = {"v=verbose",     "h=help",   "I=inverse",
+                               "b=binary",      "version",  "binary-input",
+                               "binary-output", nullptr};
     const char *longkeys[] = {"o=output", "c=columns", "d=decimals",
                               "z=height", "t=time",    "s=skip-lines",
+                              "threads",  "dimension", "planar",
                               nullptr};
 
     fout = stdout;
@@ -238,7 +330,7 @@ int main(int argc, char **argv) {
     pj_stderr_proj_lib_deprecation_warning();
 
     /* coverity[tainted_data] */
-    o = opt_parse(argc, argv, "hvI", "cdozts", longflags, longkeys);
+    o = opt_parse(argc, argv, "hvIb", "cdozts", longflags, longkeys);
     if (nullptr == o)
         return 1;
 
@@ -263,8 +355,19 @@ int main(int argc, char **argv) {
         return 0;
     }
 
+    const bool binary_input =
+        opt_given(o, "b") || opt_given(o, "binary-input");
+    const bool binary_output =
+        opt_given(o, "b") || opt_given(o, "binary-output");
+
     if (opt_given(o, "o"))
-        fout = fopen(opt_arg(o, "output"), "wt");
+        fout = fopen(opt_arg(o, "output"), binary_output ? "wb" : "wt");
+    else if (binary_output) {
+        SET_BINARY_MODE(stdout);
+    }
+    if (binary_input) {
+        SET_BINARY_MODE(stdin);
+    }
     if (nullptr == fout) {
         print(PJ_LOG_ERROR, "%s: Cannot open '%s' for output", o->progname,
               opt_arg(o, "output"));
@@ -294,6 +397,55 @@ int main(int argc, char **argv) {
         skip_lines = atoi(opt_arg(o, "s"));
     }
 
+    if (opt_given(o, "threads")) {
+        threads = atoi(opt_arg(o, "threads"));
+        if (threads < 1) {
+            print(PJ_LOG_ERROR, "%s: Invalid number of threads: '%s'",
+                  o->progname, opt_arg(o, "threads"));
+            free(o);
+            if (stdout != fout)
+                fclose(fout);
+            return 1;
+        }
+    }
+
+    if (opt_given(o, "dimension")) {
+        dimension = atoi(opt_arg(o, "dimension"));
+        if (dimension < 2 || dimension > 4) {
+            print(PJ_LOG_ERROR, "%s: Invalid dimension: '%s'", o->progname,
+                  opt_arg(o, "dimension"));
+            free(o);
+            if (stdout != fout)
+                fclose(fout);
+            return 1;
+        }
+    }
+
+    if (opt_given(o, "planar")) {
+        const int block_size = atoi(opt_arg(o, "planar"));
+        if (block_size < 1) {
+            print(PJ_LOG_ERROR, "%s: Invalid planar block size: '%s'",
+                  o->progname, opt_arg(o, "planar"));
+            free(o);
+            if (stdout != fout)
+                fclose(fout);
+            return 1;
+        }
+        planar = static_cast<size_t>(block_size);
+    }
+
+    if (binary_input && (opt_given(o, "c") || opt_given(o, "s") ||
+                         opt_given(o, "threads"))) {
+        print(PJ_LOG_ERROR,
+              "%s: --columns, --skip-lines and --threads cannot be used with "
+              "binary input",
+              o->progname);
+        free(o);
+        if (stdout != fout)
+            fclose(fout);
+        return 1;
+    }
+
     if (opt_given(o, "c")) {
         int ncols;
         /* reset column numbers to ease comment output later on */
@@ -432,6 +584,39 @@ int main(int argc, char **argv) {
     }
     direction = PJ_FWD;
 
+    /* Each thread needs its own context and its own copy of the operation */
+    std::vector<PJ_CONTEXT *> thread_contexts;
+    std::vector<PJ *> thread_operations;
+    std::vector<Record *> thread_records(threads, nullptr);
+    if (threads > 1) {
+        PJ_OPERATION_PLAN *plan = proj_operation_plan_create(nullptr, P);
+        for (int j = 0; plan != nullptr && j < threads; j++) {
+            PJ_CONTEXT *ctx = proj_context_clone(PJ_DEFAULT_CTX);
+            proj_log_func(ctx, &thread_records[j], thread_logger);
+            PJ *op = proj_operation_plan_create_handle(ctx, plan);
+            if (op == nullptr) {
+                proj_context_destroy(ctx);
+                break;
+            }
+            op->inverted = P->inverted;
+            thread_contexts.push_back(ctx);
+            thread_operations.push_back(op);
+        }
+        proj_operation_plan_destroy(plan);
+        if (thread_operations.size() != static_cast<size_t>(threads)) {
+            print(PJ_LOG_ERROR,
+                  "%s: Cannot transform with several threads. "
+                  "Using a single one",
+                  o->progname);
+            for (size_t j = 0; j < thread_operations.size(); j++) {
+                proj_destroy(thread_operations[j]);
+                proj_context_destroy(thread_contexts[j]);
+            }
+            thread_contexts.clear();
+            thread_operations.clear();
+        }
+    }
+
     /* Allocate input buffer */
     constexpr int BUFFER_SIZE = 10000;
     char *buf = static_cast<char *>(calloc(1, BUFFER_SIZE));
@@ -444,106 +629,273 @@ int main(int argc, char **argv) {
         return 1;
     }
 
-    /* Loop over all records of all input files */
+    /* Read a record, skipping the lines that must not be transformed at all
+     */
     int previous_index = -1;
     bool gotError = false;
-    while (opt_input_loop(o, optargs_file_format_text, &gotError)) {
-        int err;
-        char *bufptr = fgets(buf, BUFFER_SIZE - 1, o->input);
-        if (opt_eof(o)) {
-            continue;
-        }
-        if (nullptr == bufptr) {
-            print(PJ_LOG_ERROR, "Read error in record %d",
-                  (int)o->record_index);
-            continue;
-        }
+    const auto read_record = [&](Record &record) {
+        while (opt_input_loop(o, optargs_file_format_text, &gotError)) {
+            char *bufptr = fgets(buf, BUFFER_SIZE - 1, o->input);
+            if (opt_eof(o)) {
+                continue;
+            }
+            if (nullptr == bufptr) {
+                print(PJ_LOG_ERROR, "Read error in record %d",
+                      (int)o->record_index);
+                continue;
+            }
+
+            const bool bFirstLine = o->input_index != previous_index;
+            previous_index = o->input_index;
+            if (bFirstLine && static_cast<uint8_t>(bufptr[0]) == 0xEF &&
+                static_cast<uint8_t>(bufptr[1]) == 0xBB &&
+                static_cast<uint8_t>(bufptr[2]) == 0xBF) {
+                // Skip UTF-8 Byte Order Marker (BOM)
+                bufptr += 3;
+            }
 
-        const bool bFirstLine = o->input_index != previous_index;
-        previous_index = o->input_index;
-        if (bFirstLine && static_cast<uint8_t>(bufptr[0]) == 0xEF &&
-            static_cast<uint8_t>(bufptr[1]) == 0xBB &&
-            static_cast<uint8_t>(bufptr[2]) == 0xBF) {
-            // Skip UTF-8 Byte Order Marker (BOM)
-            bufptr += 3;
+            if (skip_lines > 0) {
+                skip_lines--;
+                continue;
+            }
+
+            record.line = bufptr;
+            record.index = (int)o->record_index;
+            record.filename = opt_filename(o);
+            return true;
         }
+        return false;
+    };
 
-        point = parse_input_line(bufptr, columns_xyzt, fixed_z, fixed_time);
-        if (skip_lines > 0) {
-            skip_lines--;
-            continue;
+    /* Append a point transformed by op to out, followed by comment for text
+       output */
+    const auto append_point = [&](PJ *op, std::string &out, PJ_COORD point,
+                                  const char *comment) {
+        /* use same arguments to printf format string for both radians and
+           degrees; convert radians to degrees before printing */
+        const bool angular_output = proj_angular_output(op, direction);
+        if (angular_output) {
+            point.lpzt.lam = proj_todeg(point.lpzt.lam);
+            point.lpzt.phi = proj_todeg(point.lpzt.phi);
+        }
+        if (binary_output) {
+            append_binary(out, point, dimension);
+            return;
         }
 
+        const char *comment_delimiter = *comment ? whitespace : blank_comment;
+        if (angular_output || proj_degree_output(op, direction)) {
+            append_line(out, "%14.*f  %14.*f  %12.*f  %12.4f%s%s",
+                        decimals_angles, point.xyzt.x, decimals_angles,
+                        point.xyzt.y, decimals_distances, point.xyzt.z,
+                        point.xyzt.t, comment_delimiter, comment);
+        } else
+            append_line(out, "%13.*f  %13.*f  %12.*f  %12.4f%s%s",
+                        decimals_distances, point.xyzt.x, decimals_distances,
+                        point.xyzt.y, decimals_distances, point.xyzt.z,
+                        point.xyzt.t, comment_delimiter, comment);
+    };
+
+    /* Transform a record with operation op. What would be printed to the
+       output and to stderr is stored in the record, so that records can be
+       transformed by several threads and printed afterwards in order. */
+    const auto transform_record = [&](PJ *op, Record &record) {
+        char *bufptr = &record.line[0];
+
+        PJ_COORD point =
+            parse_input_line(bufptr, columns_xyzt, fixed_z, fixed_time);
+
         /* if it's a comment or blank line, we reflect it */
         const char *c = column(bufptr, 1);
         if (c && ((*c == '\0') || (*c == '#'))) {
-            fprintf(fout, "%s", bufptr);
-            continue;
+            if (!binary_output)
+                record.output += bufptr;
+            return;
         }
 
         if (HUGE_VAL == point.xyzt.x) {
             /* otherwise, it must be a syntax error */
-            print(PJ_LOG_NONE, "# Record %d UNREADABLE: %s",
-                  (int)o->record_index, bufptr);
-            print(PJ_LOG_ERROR, "%s: Could not parse file '%s' line %d",
-                  o->progname, opt_filename(o), opt_record(o));
-            continue;
+            if (binary_output)
+                append_binary(record.output, proj_coord_error(), dimension);
+            else
+                append_line(record.output, "# Record %d UNREADABLE: %s",
+                            record.index, bufptr);
+            append_line(record.errors, "%s: Could not parse file '%s' line %d",
+                        o->progname, record.filename, record.index + 1);
+            return;
         }
 
-        if (proj_angular_input(P, direction)) {
+        if (proj_angular_input(op, direction)) {
             point.lpzt.lam = proj_torad(point.lpzt.lam);
             point.lpzt.phi = proj_torad(point.lpzt.phi);
         }
-        err = proj_errno_reset(P);
+        const int err = proj_errno_reset(op);
         /* coverity[returned_value] */
-        point = proj_trans(P, direction, point);
+        point = proj_trans(op, direction, point);
 
         if (HUGE_VAL == point.xyzt.x) {
             /* transformation error */
-            print(PJ_LOG_NONE, "# Record %d TRANSFORMATION ERROR: %s (%s)",
-                  (int)o->record_index, bufptr,
-                  proj_errno_string(proj_errno(P)));
-            proj_errno_restore(P, err);
-            continue;
+            if (binary_output)
+                append_binary(record.output, point, dimension);
+            else
+                append_line(record.output,
+                            "# Record %d TRANSFORMATION ERROR: %s (%s)",
+                            record.index, bufptr,
+                            proj_errno_string(proj_errno(op)));
+            proj_errno_restore(op, err);
+            return;
+        }
+        proj_errno_restore(op, err);
+
+        if (binary_output) {
+            append_point(op, record.output, point, "");
+            return;
         }
-        proj_errno_restore(P, err);
 
         /* handle comment string */
         char *comment = column(bufptr, nfields + 1);
         if (opt_given(o, "c")) {
             /* what number is the last coordinate column in the input data? */
             int colmax = 0;
-            for (i = 0; i < 4; i++)
-                colmax = MAX(colmax, columns_xyzt[i]);
+            for (int j = 0; j < 4; j++)
+                colmax = MAX(colmax, columns_xyzt[j]);
             comment = column(bufptr, colmax + 1);
         }
-        /* remove the line feed from comment, as logger() above, invoked
-           by print() below (output), will add one */
+        /* remove the line feed from comment, as append_point() below will
+           add one */
         size_t len = strlen(comment);
         if (len >= 1)
             comment[len - 1] = '\0';
-        const char *comment_delimiter = *comment ? whitespace : blank_comment;
 
-        /* Time to print the result */
-        /* use same arguments to printf format string for both radians and
-           degrees; convert radians to degrees before printing */
-        if (proj_angular_output(P, direction) ||
-            proj_degree_output(P, direction)) {
-            if (proj_angular_output(P, direction)) {
-                point.lpzt.lam = proj_todeg(point.lpzt.lam);
-                point.lpzt.phi = proj_todeg(point.lpzt.phi);
+        append_point(op, record.output, point, comment);
+    };
+
+    const auto write_record = [&](const Record &record) {
+        fwrite(record.output.data(), 1, record.output.size(), fout);
+        fwrite(record.errors.data(), 1, record.errors.size(), stderr);
+    };
+
+    /* Transform binary input by blocks of records */
+    const auto transform_binary_input = [&]() {
+        const size_t block_size = planar > 0 ? planar : BINARY_BLOCK_SIZE;
+        std::vector<double> values(block_size * dimension);
+        std::vector<PJ_COORD> points(block_size);
+        std::vector<PJ_COORD> inputs;
+        std::string out;
+        int index = 0;
+        while (opt_input_loop(o, optargs_file_format_binary, &gotError)) {
+            if (o->record_index == 0)
+                index = 0;
+            const size_t nvalues = fread(values.data(), sizeof(double),
+                                         values.size(), o->input);
+            const size_t n = nvalues / dimension;
+            if (n * dimension != nvalues) {
+                print(PJ_LOG_ERROR, "%s: Ignoring incomplete last record",
+                      o->progname);
             }
-            print(PJ_LOG_NONE, "%14.*f  %14.*f  %12.*f  %12.4f%s%s",
-                  decimals_angles, point.xyzt.x, decimals_angles, point.xyzt.y,
-                  decimals_distances, point.xyzt.z, point.xyzt.t,
-                  comment_delimiter, comment);
-        } else
-            print(PJ_LOG_NONE, "%13.*f  %13.*f  %12.*f  %12.4f%s%s",
-                  decimals_distances, point.xyzt.x, decimals_distances,
-                  point.xyzt.y, decimals_distances, point.xyzt.z, point.xyzt.t,
-                  comment_delimiter, comment);
-        if (fout == stdout)
-            fflush(stdout);
+            if (n == 0)
+                continue;
+
+            /* Offset between the components of a record, and between two
+               consecutive records */
+            const size_t component_step = planar > 0 ? n : 1;
+            const size_t record_step = planar > 0 ? 1 : dimension;
+            to_little_endian(values.data(), n * dimension);
+            for (size_t j = 0; j < n; j++) {
+                PJ_COORD &point = points[j];
+                /* As for text input, -z and -t take precedence over the
+                   values of the record */
+                point.xyzt.z = fixed_z;
+                point.xyzt.t = fixed_time;
+                for (int k = 0; k < dimension; k++) {
+                    if ((k == 2 && fixed_z != HUGE_VAL) ||
+                        (k == 3 && fixed_time != HUGE_VAL))
+                        continue;
+                    point.v[k] = values[k * component_step + j * record_step];
+                }
+                if (proj_angular_input(P, direction)) {
+                    point.lpzt.lam = proj_torad(point.lpzt.lam);
+                    point.lpzt.phi = proj_torad(point.lpzt.phi);
+                }
+            }
+            if (!binary_output)
+                inputs.assign(points.begin(), points.begin() + n);
+
+            proj_trans_array(P, direction, n, points.data());
+
+            if (binary_output) {
+                const bool angular_output = proj_angular_output(P, direction);
+                for (size_t j = 0; j < n; j++) {
+                    PJ_COORD &point = points[j];
+                    if (angular_output) {
+                        point.lpzt.lam = proj_todeg(point.lpzt.lam);
+                        point.lpzt.phi = proj_todeg(point.lpzt.phi);
+                    }
+                    for (int k = 0; k < dimension; k++)
+                        values[k * component_step + j * record_step] =
+                            point.v[k];
+                }
+                to_little_endian(values.data(), n * dimension);
+                fwrite(values.data(), sizeof(double), n * dimension, fout);
+                index += static_cast<int>(n);
+                continue;
+            }
+
+            out.clear();
+            for (size_t j = 0; j < n; j++, index++) {
+                if (HUGE_VAL != points[j].xyzt.x) {
+                    append_point(P, out, points[j], "");
+                    continue;
+                }
+                /* transformation error: transform the point again, to get
+                   the error specific to it */
+                const int err = proj_errno_reset(P);
+                proj_trans(P, direction, inputs[j]);
+                PJ_COORD input = inputs[j];
+                if (proj_angular_input(P, direction)) {
+                    input.lpzt.lam = proj_todeg(input.lpzt.lam);
+                    input.lpzt.phi = proj_todeg(input.lpzt.phi);
+                }
+                append_line(out,
+                            "# Record %d TRANSFORMATION ERROR: %.17g %.17g "
+                            "%.17g %.17g (%s)",
+                            index, input.xyzt.x, input.xyzt.y, input.xyzt.z,
+                            input.xyzt.t, proj_errno_string(proj_errno(P)));
+                proj_errno_restore(P, err);
+            }
+            fwrite(out.data(), 1, out.size(), fout);
+        }
+    };
+
+    /* Loop over all records of all input files */
+    if (binary_input) {
+        transform_binary_input();
+    } else if (thread_operations.empty()) {
+        Record record;
+        while (read_record(record)) {
+            record.output.clear();
+            record.errors.clear();
+            transform_record(P, record);
+            write_record(record);
+            if (fout == stdout)
+                fflush(stdout);
+        }
+    } else {
+        process_records_in_parallel<Record>(
+            threads, read_record,
+            [&](int iThread, Record &record) {
+                record.output.clear();
+                record.errors.clear();
+                thread_records[iThread] = &record;
+                transform_record(thread_operations[iThread], record);
+                thread_records[iThread] = nullptr;
+            },
+            write_record);
+    }
+
+    for (size_t j = 0; j < thread_operations.size(); j++) {
+        proj_destroy(thread_operations[j]);
+        proj_context_destroy(thread_contexts[j]);
     }
 
     proj_destroy(P);
@@ -84,7 +84,7 @@ static const char *usage =
     "              [--authority {name}] [--3d]\n"
     "              [--accuracy {accuracy}] [--only-best[=yes|=no]] "
     "[--no-ballpark]\n"
-    "              [--s_epoch {epoch}] [--t_epoch {epoch}]\n"
+    "              [--s_epoch {epoch}] [--t_epoch {epoch}] [--threads {n}]\n"
     "              [+opt[=arg] ...] [+to +opt[=arg] ...] [file ...]\n";
 
 static double (*informat)(const char *,
@@ -95,163 +95,239 @@ using namespace NS_PROJ::metadata;
 using namespace NS_PROJ::util;
 using namespace NS_PROJ::internal;
 
+/* An input line and what its transformation prints */
+struct Record {
+    std::string line{}; /* including the UTF-8 BOM of a first line */
+    size_t offset = 0;  /* of the line content after the BOM */
+    std::string output{};
+    std::string errors{};
+};
+
+/* Handles of the transformation used by each thread, with their context */
+static std::vector<PJ_CONTEXT *> thread_contexts;
+static std::vector<PJ *> thread_transformations;
+static std::vector<Record *> thread_records;
+
 /************************************************************************/
-/*                              process()                               */
+/*                           thread_logger()                            */
 /*                                                                      */
-/*      File processing function.                                       */
+/*      Logger of the contexts used by threads. Messages are stored     */
+/*      with the record being transformed, so that they are printed     */
+/*      in order.                                                       */
 /************************************************************************/
-static void process(FILE *fid)
+static void thread_logger(void *data, int, const char *msg) {
+    Record *record = *static_cast<Record **>(data);
+    if (record == nullptr) {
+        fprintf(stderr, "%s\n", msg);
+        return;
+    }
+    record->errors += msg;
+    record->errors += '\n';
+}
+
+/************************************************************************/
+/*                            read_record()                             */
+/************************************************************************/
+static bool read_record(FILE *fid, int &nLineNumber, Record &record)
 
 {
-    char line[MAX_LINE + 3], *s, pline[40];
-    PJ_UV data;
-    int nLineNumber = 0;
+    char line[MAX_LINE + 3], *s;
+
+    ++nLineNumber;
+    ++emess_dat.File_line;
+    if (!(s = fgets(line, MAX_LINE, fid)))
+        return false;
+
+    record.offset = 0;
+    if (nLineNumber == 1 && static_cast<uint8_t>(s[0]) == 0xEF &&
+        static_cast<uint8_t>(s[1]) == 0xBB &&
+        static_cast<uint8_t>(s[2]) == 0xBF) {
+        // Skip UTF-8 Byte Order Marker (BOM)
+        s += 3;
+        record.offset = 3;
+    }
 
-    while (true) {
-        double z;
-        ++nLineNumber;
-        ++emess_dat.File_line;
-        if (!(s = fgets(line, MAX_LINE, fid)))
-            break;
+    if (!strchr(s, '\n')) { /* overlong line */
+        int c;
+        (void)strcat(s, "\n");
+        /* gobble up to newline */
+        while ((c = fgetc(fid)) != EOF && c != '\n')
+            ;
+    }
+    record.line = line;
+    return true;
+}
 
-        if (nLineNumber == 1 && static_cast<uint8_t>(s[0]) == 0xEF &&
-            static_cast<uint8_t>(s[1]) == 0xBB &&
-            static_cast<uint8_t>(s[2]) == 0xBF) {
-            // Skip UTF-8 Byte Order Marker (BOM)
-            s += 3;
-        }
-        const char *pszLineAfterBOM = s;
-
-        if (!strchr(s, '\n')) { /* overlong line */
-            int c;
-            (void)strcat(s, "\n");
-            /* gobble up to newline */
-            while ((c = fgetc(fid)) != EOF && c != '\n')
-                ;
-        }
-        if (*s == tag) {
-            fputs(line, stdout);
-            continue;
-        }
+/************************************************************************/
+/*                          transform_record()                          */
+/*                                                                      */
+/*      Transform a record with P, storing what must be printed in      */
+/*      the record.                                                     */
+/************************************************************************/
+static void transform_record(PJ *P, Record &record)
 
-        if (reversein) {
-            data.v = (*informat)(s, &s);
-            data.u = (*informat)(s, &s);
-        } else {
-            data.u = (*informat)(s, &s);
-            data.v = (*informat)(s, &s);
-        }
+{
+    char *line = &record.line[0];
+    char *s = line + record.offset, pline[40];
+    PJ_UV data;
+    double z;
+    std::string &out = record.output;
 
-        z = strtod(s, &s);
-
-        /* To avoid breaking existing tests, we read what is a possible t    */
-        /* component of the input and rewind the s-pointer so that the final */
-        /* output has consistent behavior, with or without t values.        */
-        /* This is a bit of a hack, in most cases 4D coordinates will be     */
-        /* written to STDOUT (except when using -E) but the output format    */
-        /* specified with -f is not respected for the t component, rather it */
-        /* is forward verbatim from the input.                               */
-        char *before_time = s;
-        double t = strtod(s, &s);
-        if (s == before_time)
-            t = HUGE_VAL;
-        s = before_time;
-
-        if (data.v == HUGE_VAL)
-            data.u = HUGE_VAL;
-
-        if (!*s && (s > line))
-            --s; /* assumed we gobbled \n */
-
-        if (echoin) {
-            char temp;
-            temp = *s;
-            *s = '\0';
-            (void)fputs(pszLineAfterBOM, stdout);
-            *s = temp;
-            putchar('\t');
-        }
+    const char *pszLineAfterBOM = s;
 
-        if (data.u != HUGE_VAL) {
+    if (*s == tag) {
+        out += line;
+        return;
+    }
 
-            if (srcIsLongLat && fabs(srcToRadians - M_PI / 180) < 1e-10) {
-                /* dmstor gives values to radians. Convert now to the SRS unit
-                 */
-                data.u /= srcToRadians;
-                data.v /= srcToRadians;
-            }
+    if (reversein) {
+        data.v = (*informat)(s, &s);
+        data.u = (*informat)(s, &s);
+    } else {
+        data.u = (*informat)(s, &s);
+        data.v = (*informat)(s, &s);
+    }
+
+    z = strtod(s, &s);
+
+    /* To avoid breaking existing tests, we read what is a possible t    */
+    /* component of the input and rewind the s-pointer so that the final */
+    /* output has consistent behavior, with or without t values.        */
+    /* This is a bit of a hack, in most cases 4D coordinates will be     */
+    /* written to STDOUT (except when using -E) but the output format    */
+    /* specified with -f is not respected for the t component, rather it */
+    /* is forward verbatim from the input.                               */
+    char *before_time = s;
+    double t = strtod(s, &s);
+    if (s == before_time)
+        t = HUGE_VAL;
+    s = before_time;
+
+    if (data.v == HUGE_VAL)
+        data.u = HUGE_VAL;
+
+    if (!*s && (s > line))
+        --s; /* assumed we gobbled \n */
+
+    if (echoin) {
+        out.append(pszLineAfterBOM, s - pszLineAfterBOM);
+        out += '\t';
+    }
 
-            PJ_COORD coord;
-            coord.xyzt.x = data.u;
-            coord.xyzt.y = data.v;
-            coord.xyzt.z = z;
-            coord.xyzt.t = t;
-            coord = proj_trans(transformation, PJ_FWD, coord);
-            data.u = coord.xyz.x;
-            data.v = coord.xyz.y;
-            z = coord.xyz.z;
+    if (data.u != HUGE_VAL) {
+
+        if (srcIsLongLat && fabs(srcToRadians - M_PI / 180) < 1e-10) {
+            /* dmstor gives values to radians. Convert now to the SRS unit
+             */
+            data.u /= srcToRadians;
+            data.v /= srcToRadians;
         }
 
-        if (data.u == HUGE_VAL) /* error output */
-            fputs(oterr, stdout);
+        PJ_COORD coord;
+        coord.xyzt.x = data.u;
+        coord.xyzt.y = data.v;
+        coord.xyzt.z = z;
+        coord.xyzt.t = t;
+        coord = proj_trans(P, PJ_FWD, coord);
+        data.u = coord.xyz.x;
+        data.v = coord.xyz.y;
+        z = coord.xyz.z;
+    }
 
-        else if (destIsLongLat && !oform) { /*ascii DMS output */
+    if (data.u == HUGE_VAL) /* error output */
+        out += oterr;
 
-            // rtodms() expect radians: convert from the output SRS unit
-            data.u *= destToRadians;
-            data.v *= destToRadians;
+    else if (destIsLongLat && !oform) { /*ascii DMS output */
 
-            if (destIsLatLong) {
-                if (reverseout) {
-                    fputs(rtodms(pline, sizeof(pline), data.v, 'E', 'W'),
-                          stdout);
-                    putchar('\t');
-                    fputs(rtodms(pline, sizeof(pline), data.u, 'N', 'S'),
-                          stdout);
-                } else {
-                    fputs(rtodms(pline, sizeof(pline), data.u, 'N', 'S'),
-                          stdout);
-                    putchar('\t');
-                    fputs(rtodms(pline, sizeof(pline), data.v, 'E', 'W'),
-                          stdout);
-                }
-            } else if (reverseout) {
-                fputs(rtodms(pline, sizeof(pline), data.v, 'N', 'S'), stdout);
-                putchar('\t');
-                fputs(rtodms(pline, sizeof(pline), data.u, 'E', 'W'), stdout);
-            } else {
-                fputs(rtodms(pline, sizeof(pline), data.u, 'E', 'W'), stdout);
-                putchar('\t');
-                fputs(rtodms(pline, sizeof(pline), data.v, 'N', 'S'), stdout);
-            }
+        // rtodms() expect radians: convert from the output SRS unit
+        data.u *= destToRadians;
+        data.v *= destToRadians;
 
-        } else { /* x-y or decimal degree ascii output */
-            if (destIsLongLat) {
-                data.v *= destToRadians * RAD_TO_DEG;
-                data.u *= destToRadians * RAD_TO_DEG;
-            }
+        if (destIsLatLong) {
             if (reverseout) {
-                limited_fprintf_for_number(stdout, oform, data.v);
-                putchar('\t');
-                limited_fprintf_for_number(stdout, oform, data.u);
+                out += rtodms(pline, sizeof(pline), data.v, 'E', 'W');
+                out += '\t';
+                out += rtodms(pline, sizeof(pline), data.u, 'N', 'S');
             } else {
-                limited_fprintf_for_number(stdout, oform, data.u);
-                putchar('\t');
-                limited_fprintf_for_number(stdout, oform, data.v);
+                out += rtodms(pline, sizeof(pline), data.u, 'N', 'S');
+                out += '\t';
+                out += rtodms(pline, sizeof(pline), data.v, 'E', 'W');
             }
+        } else if (reverseout) {
+            out += rtodms(pline, sizeof(pline), data.v, 'N', 'S');
+            out += '\t';
+            out += rtodms(pline, sizeof(pline), data.u, 'E', 'W');
+        } else {
+            out += rtodms(pline, sizeof(pline), data.u, 'E', 'W');
+            out += '\t';
+            out += rtodms(pline, sizeof(pline), data.v, 'N', 'S');
+        }
+
+    } else { /* x-y or decimal degree ascii output */
+        if (destIsLongLat) {
+            data.v *= destToRadians * RAD_TO_DEG;
+            data.u *= destToRadians * RAD_TO_DEG;
+        }
+        if (reverseout) {
+            limited_append_for_number(out, oform, data.v);
+            out += '\t';
+            limited_append_for_number(out, oform, data.u);
+        } else {
+            limited_append_for_number(out, oform, data.u);
+            out += '\t';
+            limited_append_for_number(out, oform, data.v);
         }
+    }
 
-        putchar(' ');
-        if (oform != nullptr)
-            limited_fprintf_for_number(stdout, oform, z);
-        else
-            printf("%.3f", z);
-        if (s)
-            printf("%s", s);
-        else
-            printf("\n");
-        fflush(stdout);
+    out += ' ';
+    if (oform != nullptr)
+        limited_append_for_number(out, oform, z);
+    else
+        limited_append_for_number(out, "%.3f", z);
+    if (s)
+        out += s;
+    else
+        out += '\n';
+}
+
+/************************************************************************/
+/*                              process()                               */
+/*                                                                      */
+/*      File processing function.                                       */
+/************************************************************************/
+static void process(FILE *fid)
+
+{
+    int nLineNumber = 0;
+    const auto read = [fid, &nLineNumber](Record &record) {
+        return read_record(fid, nLineNumber, record);
+    };
+    const auto write = [](const Record &record) {
+        fwrite(record.errors.data(), 1, record.errors.size(), stderr);
+        fwrite(record.output.data(), 1, record.output.size(), stdout);
+    };
+
+    if (thread_transformations.empty()) {
+        Record record;
+        while (read(record)) {
+            record.output.clear();
+            transform_record(transformation, record);
+            write(record);
+            fflush(stdout);
+        }
+        return;
     }
+
+    process_records_in_parallel<Record>(
+        static_cast<int>(thread_transformations.size()), read,
+        [](int iThread, Record &record) {
+            record.output.clear();
+            record.errors.clear();
+            thread_records[iThread] = &record;
+            transform_record(thread_transformations[iThread], record);
+            thread_records[iThread] = nullptr;
+        },
+        write);
 }
 
 /************************************************************************/
@@ -422,6 +498,7 @@ int main(int argc, char **argv) {
     bool promoteTo3D = false;
     std::string sourceEpoch;
     std::string targetEpoch;
+    int threads = 1;
 
     /* process run line arguments */
     while (--argc > 0) { /* collect run line arguments */
@@ -486,6 +563,19 @@ int main(int argc, char **argv) {
                           << std::endl;
                 std::exit(1);
             }
+        } else if (strcmp(*argv, "--threads") == 0) {
+            ++argv;
+            --argc;
+            if (argc == 0) {
+                emess(1, "missing argument for --threads");
+                std::exit(1);
+            }
+            threads = atoi(*argv);
+            if (threads < 1) {
+                std::cerr << "Invalid value for option --threads: " << *argv
+                          << std::endl;
+                std::exit(1);
+            }
         } else if (strcmp(*argv, "--authority") == 0) {
             ++argv;
             --argc;
@@ -981,6 +1071,36 @@ int main(int argc, char **argv) {
               proj_errno_string(proj_context_errno(nullptr)));
     }
 
+    /* Each thread needs its own context and its own copy of the
+     * transformation */
+    if (threads > 1) {
+        PJ_OPERATION_PLAN *plan =
+            proj_operation_plan_create(nullptr, transformation);
+        thread_records.resize(threads);
+        for (int i = 0; plan != nullptr && i < threads; i++) {
+            PJ_CONTEXT *ctx = proj_context_clone(nullptr);
+            proj_log_func(ctx, &thread_records[i], thread_logger);
+            PJ *P = proj_operation_plan_create_handle(ctx, plan);
+            if (P == nullptr) {
+                proj_context_destroy(ctx);
+                break;
+            }
+            thread_contexts.push_back(ctx);
+            thread_transformations.push_back(P);
+        }
+        proj_operation_plan_destroy(plan);
+        if (thread_transformations.size() != static_cast<size_t>(threads)) {
+            emess(-1, "cannot transform with several threads. "
+                      "Using a single one");
+            for (size_t i = 0; i < thread_transformations.size(); i++) {
+                proj_destroy(thread_transformations[i]);
+                proj_context_destroy(thread_contexts[i]);
+            }
+            thread_contexts.clear();
+            thread_transformations.clear();
+        }
+    }
+
     if (use_env_locale) {
         /* Restore C locale to avoid issues in parsing/outputting numbers*/
         setlocale(LC_ALL, "C");
@@ -1022,6 +1142,10 @@ int main(int argc, char **argv) {
         emess_dat.File_name = nullptr;
     }
 
+    for (size_t i = 0; i < thread_transformations.size(); i++) {
+        proj_destroy(thread_transformations[i]);
+        proj_context_destroy(thread_contexts[i]);
+    }
     proj_destroy(transformation);
 
     proj_cleanup();
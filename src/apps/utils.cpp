@@ -28,6 +28,7 @@
 
 #include "utils.h"
 
+#include <stdarg.h>
 #include <stdlib.h>
 #include <string.h>
 
@@ -57,21 +58,46 @@ bool validate_form_string_for_numbers(const char *formatString) {
     return valid;
 }
 
+#if defined(__GNUC__)
+#define APPEND_PRINTF_FORMAT __attribute__((format(printf, 2, 3)))
+#else
+#define APPEND_PRINTF_FORMAT
+#endif
+
+static void append_printf(std::string &out, const char *fmt, ...)
+    APPEND_PRINTF_FORMAT;
+
+static void append_printf(std::string &out, const char *fmt, ...) {
+    va_list args;
+    va_start(args, fmt);
+    va_list args_copy;
+    va_copy(args_copy, args);
+    const int len = vsnprintf(nullptr, 0, fmt, args_copy);
+    va_end(args_copy);
+    if (len > 0) {
+        const size_t size = out.size();
+        out.resize(size + len + 1);
+        vsnprintf(&out[size], len + 1, fmt, args);
+        out.resize(size + len);
+    }
+    va_end(args);
+}
+
 // Some older versions of mingw_w64 do not support the F formatter
 // GCC 7 might not be the exact version...
 #if defined(__MINGW32__) && __GNUC__ <= 7
 #define MY_FPRINTF0(fmt0, fmt, ...)                                            \
     do {                                                                       \
         if (*ptr == 'e')                                                       \
-            fprintf(f, "%" fmt0 fmt "e", __VA_ARGS__);                         \
+            append_printf(out, "%" fmt0 fmt "e", __VA_ARGS__);                 \
         else if (*ptr == 'E')                                                  \
-            fprintf(f, "%" fmt0 fmt "E", __VA_ARGS__);                         \
+            append_printf(out, "%" fmt0 fmt "E", __VA_ARGS__);                 \
         else if (*ptr == 'f')                                                  \
-            fprintf(f, "%" fmt0 fmt "f", __VA_ARGS__);                         \
+            append_printf(out, "%" fmt0 fmt "f", __VA_ARGS__);                 \
         else if (*ptr == 'g')                                                  \
-            fprintf(f, "%" fmt0 fmt "g", __VA_ARGS__);                         \
+            append_printf(out, "%" fmt0 fmt "g", __VA_ARGS__);                 \
         else if (*ptr == 'G')                                                  \
-            fprintf(f, "%" fmt0 fmt "G", __VA_ARGS__);                         \
+            append_printf(out, "%" fmt0 fmt "G", __VA_ARGS__);                 \
         else {                                                                 \
             fprintf(stderr, "Wrong formatString '%s'\n", formatString);        \
             return;                                                            \
@@ -82,17 +108,17 @@ bool validate_form_string_for_numbers(const char *formatString) {
 #define MY_FPRINTF0(fmt0, fmt, ...)                                            \
     do {                                                                       \
         if (*ptr == 'e')                                                       \
-            fprintf(f, "%" fmt0 fmt "e", __VA_ARGS__);                         \
+            append_printf(out, "%" fmt0 fmt "e", __VA_ARGS__);                 \
         else if (*ptr == 'E')                                                  \
-            fprintf(f, "%" fmt0 fmt "E", __VA_ARGS__);                         \
+            append_printf(out, "%" fmt0 fmt "E", __VA_ARGS__);                 \
         else if (*ptr == 'f')                                                  \
-            fprintf(f, "%" fmt0 fmt "f", __VA_ARGS__);                         \
+            append_printf(out, "%" fmt0 fmt "f", __VA_ARGS__);                 \
         else if (*ptr == 'F')                                                  \
-            fprintf(f, "%" fmt0 fmt "F", __VA_ARGS__);                         \
+            append_printf(out, "%" fmt0 fmt "F", __VA_ARGS__);                 \
         else if (*ptr == 'g')                                                  \
-            fprintf(f, "%" fmt0 fmt "g", __VA_ARGS__);                         \
+            append_printf(out, "%" fmt0 fmt "g", __VA_ARGS__);                 \
         else if (*ptr == 'G')                                                  \
-            fprintf(f, "%" fmt0 fmt "G", __VA_ARGS__);                         \
+            append_printf(out, "%" fmt0 fmt "G", __VA_ARGS__);                 \
         else {                                                                 \
             fprintf(stderr, "Wrong formatString '%s'\n", formatString);        \
             return;                                                            \
@@ -126,6 +152,14 @@ static int parseInt(const char *&ptr) {
 // validate_form_string_for_numbers().
 // This methods makes CodeQL cpp/tainted-format-string check happy.
 void limited_fprintf_for_number(FILE *f, const char *formatString, double val) {
+    std::string out;
+    limited_append_for_number(out, formatString, val);
+    fputs(out.c_str(), f);
+}
+
+// Same as limited_fprintf_for_number(), but appending to out.
+void limited_append_for_number(std::string &out, const char *formatString,
+                               double val) {
     const char *ptr = formatString;
     if (*ptr != '%') {
         fprintf(stderr, "Wrong formatString '%s'\n", formatString);
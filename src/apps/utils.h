@@ -28,6 +28,91 @@
 
 #include <stdio.h>
 
+#include <algorithm>
+#include <string>
+#include <system_error>
+#include <thread>
+#include <utility>
+#include <vector>
+
 bool validate_form_string_for_numbers(const char *formatString);
 
 void limited_fprintf_for_number(FILE *f, const char *formatString, double val);
+
+void limited_append_for_number(std::string &out, const char *formatString,
+                               double val);
+
+// Runs processRecord() on records read sequentially with readRecord(),
+// spreading them over nThreads threads, and calls writeRecord() on each of
+// them in the order they were read.
+// readRecord(Record&) returns false when there is no more input, and is not
+// called anymore afterwards.
+// processRecord(int iThread, Record&) is called concurrently, with a
+// different iThread in [0, nThreads - 1] for each concurrent call.
+// Records are handled in batches, so that the next batch is read and the
+// previous one is written while the current one is processed.
+template <class Record, class Reader, class Processor, class Writer>
+void process_records_in_parallel(int nThreads, Reader readRecord,
+                                 Processor processRecord, Writer writeRecord) {
+    constexpr size_t RECORDS_PER_THREAD = 4096;
+    const size_t batchSize = RECORDS_PER_THREAD * nThreads;
+
+    // Record objects are reused from one batch to another, so that their
+    // buffers do not need to be allocated again.
+    std::vector<Record> previous(batchSize), current(batchSize),
+        next(batchSize);
+    size_t nPrevious = 0;
+    size_t nCurrent = 0;
+
+    bool endOfInput = false;
+    const auto readBatch = [&](std::vector<Record> &batch) {
+        size_t n = 0;
+        while (!endOfInput && n < batchSize) {
+            if (!readRecord(batch[n]))
+                endOfInput = true;
+            else
+                ++n;
+        }
+        return n;
+    };
+
+    nCurrent = readBatch(current);
+    while (nCurrent > 0 || nPrevious > 0) {
+        std::vector<std::thread> threads;
+        const size_t nPerThread = (nCurrent + nThreads - 1) / nThreads;
+        const auto processRange = [&current, &processRecord, nPerThread,
+                                   nCurrent](int iThread) {
+            const size_t start = iThread * nPerThread;
+            const size_t end = std::min(start + nPerThread, nCurrent);
+            for (size_t i = start; i < end; ++i)
+                processRecord(iThread, current[i]);
+        };
+        int iThread = 0;
+        for (; static_cast<size_t>(iThread) * nPerThread < nCurrent;
+             ++iThread) {
+            try {
+                threads.emplace_back(processRange, iThread);
+            } catch (const std::system_error &) {
+                // The thread cannot be started: the calling thread
+                // processes this range of records and the following ones
+                break;
+            }
+        }
+        for (; static_cast<size_t>(iThread) * nPerThread < nCurrent;
+             ++iThread) {
+            processRange(iThread);
+        }
+
+        for (size_t i = 0; i < nPrevious; ++i)
+            writeRecord(previous[i]);
+        const size_t nNext = readBatch(next);
+
+        for (auto &thread : threads)
+            thread.join();
+
+        std::swap(previous, current);
+        std::swap(current, next);
+        nPrevious = nCurrent;
+        nCurrent = nNext;
+    }
+}
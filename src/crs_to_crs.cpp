@@ -477,6 +477,37 @@ static const char *getOptionValue(const char *option,
 }
 //! @endcond
 
+/*****************************************************************************/
+static std::string
+get_operations_cache_options_key(const char *authority, double accuracy,
+                                 bool allowBallparkTransformations,
+                                 const PJ_AREA *area,
+                                 PROJ_GRID_AVAILABILITY_USE gridAvailabilityUse)
+/*****************************************************************************/
+{
+    std::string ret("authority=");
+    ret += authority ? authority : "";
+    ret += ";accuracy=";
+    ret += toString(accuracy);
+    ret += ";allow_ballpark=";
+    ret += allowBallparkTransformations ? "yes" : "no";
+    if (area && area->bbox_set) {
+        ret += ";area=";
+        ret += toString(area->west_lon_degree);
+        ret += ',';
+        ret += toString(area->south_lat_degree);
+        ret += ',';
+        ret += toString(area->east_lon_degree);
+        ret += ',';
+        ret += toString(area->north_lat_degree);
+        ret += ',';
+        ret += area->name;
+    }
+    ret += ";grid_availability=";
+    ret += toString(static_cast<int>(gridAvailabilityUse));
+    return ret;
+}
+
 /*****************************************************************************/
 PJ *proj_create_crs_to_crs_from_pj(PJ_CONTEXT *ctx, const PJ *source_crs,
                                    const PJ *target_crs, PJ_AREA *area,
@@ -567,16 +598,20 @@ PJ *proj_create_crs_to_crs_from_pj(PJ_CONTEXT *ctx, const PJ *source_crs,
 
     proj_operation_factory_context_set_spatial_criterion(
         ctx, operation_ctx, PROJ_SPATIAL_CRITERION_PARTIAL_INTERSECTION);
-    proj_operation_factory_context_set_grid_availability_use(
-        ctx, operation_ctx,
+    const auto gridAvailabilityUse =
         (errorIfBestTransformationNotAvailable ||
          warnIfBestTransformationNotAvailable ||
          proj_context_is_network_enabled(ctx))
             ? PROJ_GRID_AVAILABILITY_KNOWN_AVAILABLE
-            : PROJ_GRID_AVAILABILITY_DISCARD_OPERATION_IF_MISSING_GRID);
+            : PROJ_GRID_AVAILABILITY_DISCARD_OPERATION_IF_MISSING_GRID;
+    proj_operation_factory_context_set_grid_availability_use(
+        ctx, operation_ctx, gridAvailabilityUse);
 
-    auto op_list =
-        proj_create_operations(ctx, source_crs, target_crs, operation_ctx);
+    auto op_list = pj_create_operations_cached(
+        ctx, source_crs, target_crs, operation_ctx,
+        get_operations_cache_options_key(authority, accuracy,
+                                         allowBallparkTransformations, area,
+                                         gridAvailabilityUse));
     proj_operation_factory_context_destroy(operation_ctx);
 
     if (!op_list) {
@@ -717,8 +752,11 @@ PJ *proj_create_crs_to_crs_from_pj(PJ_CONTEXT *ctx, const PJ *source_crs,
                 ctx, operation_ctx,
                 PROJ_GRID_AVAILABILITY_DISCARD_OPERATION_IF_MISSING_GRID);
 
-            op_list = proj_create_operations(ctx, source_crs, target_crs,
-                                             operation_ctx);
+            op_list = pj_create_operations_cached(
+                ctx, source_crs, target_crs, operation_ctx,
+                get_operations_cache_options_key(
+                    authority, accuracy, allowBallparkTransformations, area,
+                    PROJ_GRID_AVAILABILITY_DISCARD_OPERATION_IF_MISSING_GRID));
             proj_operation_factory_context_destroy(operation_ctx);
 
             if (op_list) {
@@ -791,6 +829,8 @@ PJ *proj_create_crs_to_crs_from_pj(PJ_CONTEXT *ctx, const PJ *source_crs,
     P->inv3d = nullptr;
     P->fwd4d = nullptr;
     P->inv4d = nullptr;
+    P->fwd4d_array = nullptr;
+    P->inv4d_array = nullptr;
 
     return P;
 }
@@ -0,0 +1,558 @@
+/******************************************************************************
+ * Project:  PROJ
+ * Purpose:  Persistent cache of the candidate operations computed by
+ *           proj_create_crs_to_crs()
+ *
+ ******************************************************************************
+ * Copyright (c) 2026, PROJ contributors
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included
+ * in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+ * OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+ * THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE.
+ *****************************************************************************/
+
+#ifndef FROM_PROJ_CPP
+#define FROM_PROJ_CPP
+#endif
+
+#include <algorithm>
+#include <chrono>
+#include <ctime>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "filemanager.hpp"
+#include "proj.h"
+#include "proj/internal/internal.hpp"
+#include "proj/internal/io_internal.hpp"
+#include "proj/io.hpp"
+#include "proj_internal.h"
+#include "sqlite3_utils.hpp"
+
+using namespace NS_PROJ::internal;
+
+//! @cond Doxygen_Suppress
+
+NS_PROJ_START
+
+// Maximum number of entries of the cache. Least recently used entries are
+// evicted first.
+constexpr int CRS_TO_CRS_CACHE_MAX_ENTRIES = 1000;
+
+#ifdef _WIN32
+static const char searchPathSeparator = ';';
+#else
+static const char searchPathSeparator = ':';
+#endif
+
+// ---------------------------------------------------------------------------
+
+class CrsToCrsCache {
+  public:
+    // Returns the cache of the context, which is opened on first use and
+    // then kept by the context, or nullptr if it cannot be opened.
+    static CrsToCrsCache *get(PJ_CONTEXT *ctx);
+    ~CrsToCrsCache();
+
+    // Returns true if there is an entry for key whose fingerprint matches.
+    // hasOperations is set to false if the entry is a marker that caching
+    // is not worth for this key.
+    bool get(const std::string &key, const std::string &fingerprint,
+             bool &hasOperations, std::string &operations,
+             long long &computeTimeUs);
+
+    // operations == nullptr to record that caching is not worth for this
+    // key.
+    void put(const std::string &key, const std::string &fingerprint,
+             const std::string *operations, long long computeTimeUs);
+
+  private:
+    PJ_CONTEXT *ctx_ = nullptr;
+    std::string path_{};
+    std::string customVfsName_{};
+    sqlite3 *hDB_ = nullptr;
+    std::unique_ptr<SQLite3VFS> vfs_{};
+
+    CrsToCrsCache(PJ_CONTEXT *ctx, const std::string &path);
+    CrsToCrsCache(const CrsToCrsCache &) = delete;
+    CrsToCrsCache &operator=(const CrsToCrsCache &) = delete;
+
+    bool initialize();
+    std::unique_ptr<SQLiteStatement> prepare(const char *sql);
+};
+
+// ---------------------------------------------------------------------------
+
+CrsToCrsCache::CrsToCrsCache(PJ_CONTEXT *ctx, const std::string &path)
+    : ctx_(ctx), path_(path), customVfsName_(ctx->custom_sqlite3_vfs_name) {}
+
+// ---------------------------------------------------------------------------
+
+CrsToCrsCache::~CrsToCrsCache() {
+    if (hDB_) {
+        sqlite3_close(hDB_);
+    }
+}
+
+// ---------------------------------------------------------------------------
+
+CrsToCrsCache *CrsToCrsCache::get(PJ_CONTEXT *ctx) {
+    const auto cachePath = pj_context_get_crs_to_crs_cache_filename(ctx);
+    if (cachePath.empty()) {
+        return nullptr;
+    }
+
+    auto &handle = ctx->crsToCrsCache.handle;
+    if (handle && handle->path_ == cachePath &&
+        handle->customVfsName_ == ctx->custom_sqlite3_vfs_name) {
+        return handle.get();
+    }
+    handle.reset();
+
+    auto cache =
+        std::shared_ptr<CrsToCrsCache>(new CrsToCrsCache(ctx, cachePath));
+    if (!cache->initialize())
+        return nullptr;
+    handle = std::move(cache);
+    return handle.get();
+}
+
+// ---------------------------------------------------------------------------
+
+static const char *crs_to_crs_cache_db_structure_sql =
+    "CREATE TABLE IF NOT EXISTS crs_to_crs_cache("
+    " key           TEXT PRIMARY KEY NOT NULL,"
+    " fingerprint   TEXT NOT NULL,"
+    " operations    TEXT," // NULL if caching is not worth
+    " compute_time  INTEGER NOT NULL," // in microseconds
+    " last_access   INTEGER NOT NULL"
+    ");"
+    "CREATE INDEX IF NOT EXISTS idx_crs_to_crs_cache_last_access ON "
+    "crs_to_crs_cache(last_access);";
+
+bool CrsToCrsCache::initialize() {
+    std::string vfsName;
+    if (ctx_->custom_sqlite3_vfs_name.empty()) {
+        vfs_ = SQLite3VFS::create(true, false, false);
+        if (vfs_ == nullptr) {
+            return false;
+        }
+        vfsName = vfs_->name();
+    } else {
+        vfsName = ctx_->custom_sqlite3_vfs_name;
+    }
+    sqlite3_open_v2(path_.c_str(), &hDB_,
+                    SQLITE_OPEN_READWRITE | SQLITE_OPEN_CREATE,
+                    vfsName.c_str());
+    if (!hDB_ || sqlite3_errcode(hDB_) != SQLITE_OK) {
+        pj_log(ctx_, PJ_LOG_DEBUG, "Cannot open %s", path_.c_str());
+        return false;
+    }
+    // Other processes may be using the cache concurrently
+    sqlite3_busy_timeout(hDB_, 1000);
+
+    if (sqlite3_exec(hDB_, crs_to_crs_cache_db_structure_sql, nullptr,
+                     nullptr, nullptr) != SQLITE_OK) {
+        pj_log(ctx_, PJ_LOG_DEBUG, "%s", sqlite3_errmsg(hDB_));
+        return false;
+    }
+    return true;
+}
+
+// ---------------------------------------------------------------------------
+
+std::unique_ptr<SQLiteStatement> CrsToCrsCache::prepare(const char *sql) {
+    sqlite3_stmt *hStmt = nullptr;
+    sqlite3_prepare_v2(hDB_, sql, -1, &hStmt, nullptr);
+    if (!hStmt) {
+        pj_log(ctx_, PJ_LOG_DEBUG, "%s", sqlite3_errmsg(hDB_));
+        return nullptr;
+    }
+    return std::unique_ptr<SQLiteStatement>(new SQLiteStatement(hStmt));
+}
+
+// ---------------------------------------------------------------------------
+
+bool CrsToCrsCache::get(const std::string &key, const std::string &fingerprint,
+                        bool &hasOperations, std::string &operations,
+                        long long &computeTimeUs) {
+    auto stmt = prepare("SELECT fingerprint, operations, compute_time FROM "
+                        "crs_to_crs_cache WHERE key = ?");
+    if (!stmt)
+        return false;
+    stmt->bindText(key.c_str());
+    if (stmt->execute() != SQLITE_ROW)
+        return false;
+    const char *storedFingerprint = stmt->getText();
+    if (!storedFingerprint || fingerprint != storedFingerprint) {
+        // Stale entry: will be replaced by put()
+        return false;
+    }
+    const char *storedOperations = stmt->getText();
+    hasOperations = storedOperations != nullptr;
+    operations = storedOperations ? storedOperations : std::string();
+    computeTimeUs = stmt->getInt64();
+    stmt.reset();
+
+    auto update = prepare(
+        "UPDATE crs_to_crs_cache SET last_access = ? WHERE key = ?");
+    if (update) {
+        update->bindInt64(static_cast<sqlite3_int64>(time(nullptr)));
+        update->bindText(key.c_str());
+        update->execute();
+    }
+    return true;
+}
+
+// ---------------------------------------------------------------------------
+
+void CrsToCrsCache::put(const std::string &key, const std::string &fingerprint,
+                        const std::string *operations,
+                        long long computeTimeUs) {
+    auto stmt = prepare("INSERT OR REPLACE INTO crs_to_crs_cache(key, "
+                        "fingerprint, operations, compute_time, last_access) "
+                        "VALUES (?, ?, ?, ?, ?)");
+    if (!stmt)
+        return;
+    stmt->bindText(key.c_str());
+    stmt->bindText(fingerprint.c_str());
+    if (operations)
+        stmt->bindText(operations->c_str());
+    else
+        stmt->bindNull();
+    stmt->bindInt64(computeTimeUs);
+    stmt->bindInt64(static_cast<sqlite3_int64>(time(nullptr)));
+    if (stmt->execute() != SQLITE_DONE) {
+        pj_log(ctx_, PJ_LOG_DEBUG, "%s", sqlite3_errmsg(hDB_));
+        return;
+    }
+    stmt.reset();
+
+    auto evict = prepare(
+        "DELETE FROM crs_to_crs_cache WHERE key IN (SELECT key FROM "
+        "crs_to_crs_cache ORDER BY last_access DESC LIMIT -1 OFFSET ?)");
+    if (evict) {
+        evict->bindInt64(CRS_TO_CRS_CACHE_MAX_ENTRIES);
+        evict->execute();
+    }
+}
+
+// ---------------------------------------------------------------------------
+
+static void appendFileStatus(PJ_CONTEXT *ctx, std::string &out,
+                             const std::string &path) {
+    unsigned long long size = 0;
+    long long mtime = 0;
+    out += path;
+    if (FileManager::getFileStatus(ctx, path.c_str(), size, mtime)) {
+        out += ',';
+        out += std::to_string(size);
+        out += ',';
+        out += std::to_string(mtime);
+    }
+    out += '\n';
+}
+
+// ---------------------------------------------------------------------------
+
+static std::string stripTrailingSeparators(std::string path) {
+    while (path.size() > 1 && (path.back() == '/' || path.back() == '\\'))
+        path.pop_back();
+    return path;
+}
+
+// ---------------------------------------------------------------------------
+
+// Splits path into its directory and its file name
+static void splitPath(const std::string &path, std::string &dirname,
+                      std::string &basename) {
+    const auto pos = path.find_last_of("/\\");
+    if (pos == std::string::npos) {
+        dirname = ".";
+        basename = path;
+    } else {
+        dirname = stripTrailingSeparators(path.substr(0, pos + 1));
+        basename = path.substr(pos + 1);
+    }
+}
+
+// ---------------------------------------------------------------------------
+
+// Appends the status of the files of a directory, except the files whose
+// name starts with one of excludedPrefixes.
+static void
+appendDirectoryContentStatus(PJ_CONTEXT *ctx, std::string &out,
+                             const std::string &dirname,
+                             const std::vector<std::string> &excludedPrefixes) {
+    std::vector<std::string> names;
+    if (!FileManager::listDirectory(ctx, dirname.c_str(), names)) {
+        appendFileStatus(ctx, out, dirname);
+        return;
+    }
+    out += dirname;
+    out += '\n';
+    std::sort(names.begin(), names.end());
+    for (const auto &name : names) {
+        if (std::none_of(excludedPrefixes.begin(), excludedPrefixes.end(),
+                         [&name](const std::string &prefix) {
+                             return starts_with(name, prefix);
+                         })) {
+            appendFileStatus(ctx, out, dirname + '/' + name);
+        }
+    }
+}
+
+// ---------------------------------------------------------------------------
+
+// Returns a string that changes when the database or the set of grids
+// that can be found changes. Grid availability is detected from the
+// modification time of the directories of the search paths, which changes
+// when files are added to or removed from them.
+// The directories holding the cache databases are an exception, as each
+// write to a database creates and removes a journal file next to it, which
+// would invalidate the whole cache. The status of the files they contain,
+// except the databases and their journals, is used instead.
+static std::string getFingerprint(PJ_CONTEXT *ctx) {
+    std::string ret("PROJ ");
+    ret += std::to_string(PROJ_VERSION_MAJOR);
+    ret += '.';
+    ret += std::to_string(PROJ_VERSION_MINOR);
+    ret += '.';
+    ret += std::to_string(PROJ_VERSION_PATCH);
+    ret += '\n';
+
+    auto dbContext = ctx->get_cpp_context()->getDatabaseContext();
+    appendFileStatus(ctx, ret, dbContext->getPath());
+    for (const auto &auxDbPath : ctx->get_cpp_context()->getAuxDbPaths()) {
+        appendFileStatus(ctx, ret, auxDbPath);
+    }
+    for (const char *metadataKey :
+         {"DATABASE.LAYOUT.VERSION.MAJOR", "DATABASE.LAYOUT.VERSION.MINOR",
+          "EPSG.VERSION", "PROJ_DATA.VERSION"}) {
+        const char *value = dbContext->getMetadata(metadataKey);
+        ret += metadataKey;
+        ret += '=';
+        ret += value ? value : "";
+        ret += '\n';
+    }
+
+    std::vector<std::string> cacheDirnames;
+    std::vector<std::string> cacheBasenames;
+    for (const auto &cacheFilename :
+         {pj_context_get_crs_to_crs_cache_filename(ctx),
+          pj_context_get_grid_cache_filename(ctx)}) {
+        std::string dirname;
+        std::string basename;
+        splitPath(cacheFilename, dirname, basename);
+        cacheDirnames.push_back(std::move(dirname));
+        // Also excludes the -journal, -wal and -shm files
+        cacheBasenames.push_back(std::move(basename));
+    }
+
+    const auto searchPaths = ctx->search_paths.empty()
+                                 ? pj_get_default_searchpaths(ctx)
+                                 : ctx->search_paths;
+    for (const auto &searchPath : searchPaths) {
+        for (const auto &path : split(searchPath, searchPathSeparator)) {
+            const auto dirname = stripTrailingSeparators(stripQuotes(path));
+            if (std::find(cacheDirnames.begin(), cacheDirnames.end(),
+                          dirname) != cacheDirnames.end()) {
+                appendDirectoryContentStatus(ctx, ret, dirname,
+                                             cacheBasenames);
+            } else {
+                appendFileStatus(ctx, ret, dirname);
+            }
+        }
+    }
+
+    if (proj_context_is_network_enabled(ctx)) {
+        ret += "network=";
+        ret += proj_context_get_url_endpoint(ctx);
+        ret += '\n';
+    }
+    return ret;
+}
+
+// ---------------------------------------------------------------------------
+
+static bool exportCRSToJSON(const PJ *crs, std::string &out) {
+    auto exportable =
+        dynamic_cast<const io::IJSONExportable *>(crs->iso_obj.get());
+    if (!exportable)
+        return false;
+    try {
+        auto formatter = io::JSONFormatter::create();
+        formatter->setMultiLine(false);
+        out = exportable->exportToJSON(formatter.get());
+        return true;
+    } catch (const std::exception &) {
+        return false;
+    }
+}
+
+NS_PROJ_END
+
+// ---------------------------------------------------------------------------
+
+std::string pj_context_get_crs_to_crs_cache_filename(PJ_CONTEXT *ctx) {
+    pj_load_ini(ctx);
+    if (!ctx->crsToCrsCache.filename.empty()) {
+        return ctx->crsToCrsCache.filename;
+    }
+    const std::string path(proj_context_get_user_writable_directory(ctx, true));
+    ctx->crsToCrsCache.filename = path + "/crs_to_crs_cache.db";
+    return ctx->crsToCrsCache.filename;
+}
+
+// ---------------------------------------------------------------------------
+
+PJ_OBJ_LIST *
+pj_create_operations_cached(PJ_CONTEXT *ctx, const PJ *source_crs,
+                            const PJ *target_crs,
+                            const PJ_OPERATION_FACTORY_CONTEXT *operation_ctx,
+                            const std::string &optionsKey) {
+    using namespace NS_PROJ;
+
+    CrsToCrsCache *cache = nullptr;
+    std::string key;
+    std::string fingerprint;
+    // The cache cannot detect changes of grid availability when files are
+    // resolved by user callbacks.
+    if (ctx->crsToCrsCache.enabled && ctx->file_finder == nullptr &&
+        ctx->fileApi.open_cbk == nullptr) {
+        std::string sourceJSON;
+        std::string targetJSON;
+        if (exportCRSToJSON(source_crs, sourceJSON) &&
+            exportCRSToJSON(target_crs, targetJSON)) {
+            try {
+                fingerprint = getFingerprint(ctx);
+                key = sourceJSON;
+                key += '\n';
+                key += targetJSON;
+                key += '\n';
+                key += optionsKey;
+                cache = CrsToCrsCache::get(ctx);
+            } catch (const std::exception &e) {
+                pj_log(ctx, PJ_LOG_DEBUG, "%s", e.what());
+            }
+        }
+    }
+
+    if (cache) {
+        bool hasOperations = false;
+        std::string operations;
+        long long computeTimeUs = 0;
+        if (cache->get(key, fingerprint, hasOperations, operations,
+                       computeTimeUs)) {
+            if (!hasOperations) {
+                cache = nullptr;
+            } else {
+                const auto start = std::chrono::steady_clock::now();
+                auto op_list = pj_operation_list_import(
+                    ctx, source_crs, target_crs,
+                    operations.empty() ? std::vector<std::string>()
+                                       : split(operations, '\n'));
+                const auto parseTimeUs =
+                    std::chrono::duration_cast<std::chrono::microseconds>(
+                        std::chrono::steady_clock::now() - start)
+                        .count();
+                if (op_list) {
+                    // PROJJSON parsing of many complex operations may
+                    // be slower than recomputing them
+                    if (parseTimeUs > computeTimeUs) {
+                        cache->put(key, fingerprint, nullptr, computeTimeUs);
+                    }
+                    return op_list;
+                }
+            }
+        }
+    }
+
+    const auto start = std::chrono::steady_clock::now();
+    auto op_list =
+        proj_create_operations(ctx, source_crs, target_crs, operation_ctx);
+    const auto computeTimeUs =
+        std::chrono::duration_cast<std::chrono::microseconds>(
+            std::chrono::steady_clock::now() - start)
+            .count();
+    if (cache && op_list) {
+        std::vector<std::string> operations;
+        if (pj_operation_list_export(ctx, op_list, operations)) {
+            std::string joined;
+            for (const auto &operation : operations) {
+                if (!joined.empty())
+                    joined += '\n';
+                joined += operation;
+            }
+            cache->put(key, fingerprint, &joined, computeTimeUs);
+        }
+    }
+    return op_list;
+}
+
+//! @endcond
+
+// ---------------------------------------------------------------------------
+
+/** Enable or disable the persistent cache of the candidate operations
+ * computed by proj_create_crs_to_crs() and proj_create_crs_to_crs_from_pj().
+ *
+ * The cache is a SQLite database, by default crs_to_crs_cache.db in the
+ * user writable directory. Entries are keyed by the source and target CRS
+ * and the options of the call, and are automatically invalidated when the
+ * database or the set of available grids changes. It is disabled by
+ * default.
+ *
+ * This overrides the setting in the PROJ configuration file.
+ *
+ * @param ctx PROJ context, or NULL
+ * @param enabled TRUE if the cache is enabled.
+ * @since 9.8
+ */
+void proj_crs_to_crs_cache_set_enable(PJ_CONTEXT *ctx, int enabled) {
+    if (ctx == nullptr) {
+        ctx = pj_get_default_ctx();
+    }
+    // Load ini file, now so as to override its settings
+    pj_load_ini(ctx);
+    ctx->crsToCrsCache.enabled = enabled != FALSE;
+    if (!ctx->crsToCrsCache.enabled)
+        ctx->crsToCrsCache.handle.reset();
+}
+
+// ---------------------------------------------------------------------------
+
+/** Override, for the considered context, the path and file of the
+ * persistent cache of the candidate operations computed by
+ * proj_create_crs_to_crs().
+ *
+ * @param ctx PROJ context, or NULL
+ * @param fullname Full name to the cache (encoded in UTF-8). If set to NULL,
+ *                 the default file in the user writable directory is used.
+ * @since 9.8
+ */
+void proj_crs_to_crs_cache_set_filename(PJ_CONTEXT *ctx,
+                                        const char *fullname) {
+    if (ctx == nullptr) {
+        ctx = pj_get_default_ctx();
+    }
+    // Load ini file, now so as to override its settings
+    pj_load_ini(ctx);
+    ctx->crsToCrsCache.filename = fullname ? fullname : std::string();
+    ctx->crsToCrsCache.handle.reset();
+}
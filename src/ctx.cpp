@@ -174,11 +174,13 @@ pj_ctx::pj_ctx(const pj_ctx &other)
       iniFileLoaded(other.iniFileLoaded), endpoint(other.endpoint),
       networking(other.networking), ca_bundle_path(other.ca_bundle_path),
       native_ca(other.native_ca), gridChunkCache(other.gridChunkCache),
+      crsToCrsCache(other.crsToCrsCache),
       defaultTmercAlgo(other.defaultTmercAlgo),
       // END ini file settings
       projStringParserCreateFromPROJStringRecursionCounter(0),
       pipelineInitRecursiongCounter(0) {
     set_search_paths(other.search_paths);
+    crsToCrsCache.handle.reset();
 }
 
 /************************************************************************/
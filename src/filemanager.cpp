@@ -66,6 +66,8 @@
 #ifdef HAVE_LIBDL
 #include <dlfcn.h>
 #endif
+#include <dirent.h>
+#include <sys/mman.h>
 #include <sys/types.h>
 #include <unistd.h>
 #endif
@@ -90,6 +92,10 @@ File::~File() = default;
 
 // ---------------------------------------------------------------------------
 
+FileMapping::~FileMapping() = default;
+
+// ---------------------------------------------------------------------------
+
 std::string File::read_line(size_t maxLen, bool &maxLenReached,
                             bool &eofReached) {
     constexpr size_t MAX_MAXLEN = 1024 * 1024;
@@ -619,6 +625,8 @@ class FileWin32 : public File {
     // We may lie, but the real use case is only for network files
     bool hasChanged() const override { return false; }
 
+    std::unique_ptr<FileMapping> map() override;
+
     static std::unique_ptr<File> open(PJ_CONTEXT *ctx, const char *filename,
                                       FileAccess access);
 };
@@ -629,6 +637,48 @@ FileWin32::~FileWin32() { CloseHandle(m_handle); }
 
 // ---------------------------------------------------------------------------
 
+class FileMappingWin32 : public FileMapping {
+    HANDLE m_hMapping;
+
+  public:
+    FileMappingWin32(HANDLE hMapping, const void *data, size_t size)
+        : FileMapping(static_cast<const unsigned char *>(data), size),
+          m_hMapping(hMapping) {}
+
+    ~FileMappingWin32() override {
+        UnmapViewOfFile(data_);
+        CloseHandle(m_hMapping);
+    }
+};
+
+// ---------------------------------------------------------------------------
+
+std::unique_ptr<FileMapping> FileWin32::map() {
+#if UWP
+    return nullptr;
+#else
+    LARGE_INTEGER fileSize;
+    if (!GetFileSizeEx(m_handle, &fileSize) || fileSize.QuadPart <= 0 ||
+        static_cast<unsigned long long>(fileSize.QuadPart) >
+            std::numeric_limits<size_t>::max()) {
+        return nullptr;
+    }
+    HANDLE hMapping =
+        CreateFileMappingW(m_handle, nullptr, PAGE_READONLY, 0, 0, nullptr);
+    if (hMapping == nullptr)
+        return nullptr;
+    const void *data = MapViewOfFile(hMapping, FILE_MAP_READ, 0, 0, 0);
+    if (data == nullptr) {
+        CloseHandle(hMapping);
+        return nullptr;
+    }
+    return std::unique_ptr<FileMapping>(new FileMappingWin32(
+        hMapping, data, static_cast<size_t>(fileSize.QuadPart)));
+#endif
+}
+
+// ---------------------------------------------------------------------------
+
 size_t FileWin32::read(void *buffer, size_t sizeBytes) {
     DWORD dwSizeRead = 0;
     size_t nResult = 0;
@@ -761,6 +811,8 @@ class FileStdio : public File {
     // We may lie, but the real use case is only for network files
     bool hasChanged() const override { return false; }
 
+    std::unique_ptr<FileMapping> map() override;
+
     static std::unique_ptr<File> open(PJ_CONTEXT *ctx, const char *filename,
                                       FileAccess access);
 };
@@ -771,6 +823,38 @@ FileStdio::~FileStdio() { fclose(m_fp); }
 
 // ---------------------------------------------------------------------------
 
+class FileMappingMMap : public FileMapping {
+  public:
+    FileMappingMMap(const void *data, size_t size)
+        : FileMapping(static_cast<const unsigned char *>(data), size) {}
+
+    ~FileMappingMMap() override {
+        munmap(const_cast<unsigned char *>(data_), size_);
+    }
+};
+
+// ---------------------------------------------------------------------------
+
+std::unique_ptr<FileMapping> FileStdio::map() {
+    const int fd = fileno(m_fp);
+    struct stat sStat;
+    if (fd < 0 || fstat(fd, &sStat) != 0 || !S_ISREG(sStat.st_mode) ||
+        sStat.st_size <= 0 ||
+        static_cast<unsigned long long>(sStat.st_size) >
+            std::numeric_limits<size_t>::max()) {
+        return nullptr;
+    }
+    const auto size = static_cast<size_t>(sStat.st_size);
+    void *data = mmap(nullptr, size, PROT_READ, MAP_SHARED, fd, 0);
+    if (data == MAP_FAILED) {
+        pj_log(m_ctx, PJ_LOG_DEBUG, "Cannot map %s in memory", name_.c_str());
+        return nullptr;
+    }
+    return std::unique_ptr<FileMapping>(new FileMappingMMap(data, size));
+}
+
+// ---------------------------------------------------------------------------
+
 size_t FileStdio::read(void *buffer, size_t sizeBytes) {
     return fread(buffer, 1, sizeBytes, m_fp);
 }
@@ -928,6 +1012,8 @@ class FileMemory : public File {
 
     bool hasChanged() const override { return false; }
 
+    std::unique_ptr<FileMapping> map() override;
+
     static std::unique_ptr<File> open(PJ_CONTEXT *ctx, const char *filename,
                                       FileAccess access,
                                       const unsigned char *data, size_t size) {
@@ -937,6 +1023,17 @@ class FileMemory : public File {
     }
 };
 
+// Embedded resources are already in memory, and outlive any FileMemory
+class FileMappingMemory : public FileMapping {
+  public:
+    FileMappingMemory(const unsigned char *data, size_t size)
+        : FileMapping(data, size) {}
+};
+
+std::unique_ptr<FileMapping> FileMemory::map() {
+    return std::unique_ptr<FileMapping>(new FileMappingMemory(m_data, m_size));
+}
+
 size_t FileMemory::read(void *buffer, size_t sizeBytes) {
     if (m_pos >= m_size)
         return 0;
@@ -1045,6 +1142,73 @@ bool FileManager::exists(PJ_CONTEXT *ctx, const char *filename) {
 
 // ---------------------------------------------------------------------------
 
+bool FileManager::getFileStatus(PJ_CONTEXT *ctx, const char *filename,
+                                unsigned long long &size, long long &mtime) {
+#ifdef _WIN32
+    struct __stat64 buf;
+    try {
+        if (_wstat64(UTF8ToWString(filename).c_str(), &buf) != 0)
+            return false;
+    } catch (const std::exception &e) {
+        pj_log(ctx, PJ_LOG_DEBUG, "%s", e.what());
+        return false;
+    }
+#else
+    (void)ctx;
+    struct stat buf;
+    if (stat(filename, &buf) != 0)
+        return false;
+#endif
+    size = static_cast<unsigned long long>(buf.st_size);
+    mtime = static_cast<long long>(buf.st_mtime);
+    return true;
+}
+
+// ---------------------------------------------------------------------------
+
+bool FileManager::listDirectory(PJ_CONTEXT *ctx, const char *dirname,
+                                std::vector<std::string> &names) {
+    names.clear();
+#ifdef _WIN32
+    WIN32_FIND_DATAW findData;
+    HANDLE hFind;
+    try {
+        hFind = FindFirstFileW(
+            UTF8ToWString(std::string(dirname) + "\\*").c_str(), &findData);
+    } catch (const std::exception &e) {
+        pj_log(ctx, PJ_LOG_DEBUG, "%s", e.what());
+        return false;
+    }
+    if (hFind == INVALID_HANDLE_VALUE)
+        return false;
+    do {
+        try {
+            names.push_back(WStringToUTF8(findData.cFileName));
+        } catch (const std::exception &e) {
+            pj_log(ctx, PJ_LOG_DEBUG, "%s", e.what());
+        }
+    } while (FindNextFileW(hFind, &findData));
+    FindClose(hFind);
+#else
+    (void)ctx;
+    DIR *dir = opendir(dirname);
+    if (dir == nullptr)
+        return false;
+    while (const struct dirent *entry = readdir(dir)) {
+        names.push_back(entry->d_name);
+    }
+    closedir(dir);
+#endif
+    names.erase(std::remove_if(names.begin(), names.end(),
+                               [](const std::string &name) {
+                                   return name == "." || name == "..";
+                               }),
+                names.end());
+    return true;
+}
+
+// ---------------------------------------------------------------------------
+
 bool FileManager::mkdir(PJ_CONTEXT *ctx, const char *filename) {
     if (ctx->fileApi.mkdir_cbk) {
         return ctx->fileApi.mkdir_cbk(ctx, filename, ctx->fileApi.user_data) !=
@@ -2082,6 +2246,10 @@ void pj_load_ini(PJ_CONTEXT *ctx) {
                     val > 0 ? static_cast<long long>(val) * 1024 * 1024 : -1;
             } else if (key == "cache_ttl_sec") {
                 ctx->gridChunkCache.ttl = atoi(value.c_str());
+            } else if (key == "crs_to_crs_cache_enabled") {
+                ctx->crsToCrsCache.enabled = ci_equal(value, "ON") ||
+                                             ci_equal(value, "YES") ||
+                                             ci_equal(value, "TRUE");
             } else if (key == "tmerc_default_algo") {
                 if (value == "auto") {
                     ctx->defaultTmercAlgo = TMercAlgo::AUTO;
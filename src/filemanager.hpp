@@ -30,6 +30,7 @@
 
 #include <memory>
 #include <string>
+#include <utility>
 #include <vector>
 
 #include "proj.h"
@@ -56,6 +57,14 @@ class FileManager {
     static PROJ_DLL std::unique_ptr<File>
     open(PJ_CONTEXT *ctx, const char *filename, FileAccess access);
     static PROJ_DLL bool exists(PJ_CONTEXT *ctx, const char *filename);
+    // Size and modification time (in seconds) of a file or directory of the
+    // local file system. Does not use the file API callbacks.
+    static bool getFileStatus(PJ_CONTEXT *ctx, const char *filename,
+                              unsigned long long &size, long long &mtime);
+    // Names of the entries of a directory of the local file system, without
+    // "." and "..". Does not use the file API callbacks.
+    static bool listDirectory(PJ_CONTEXT *ctx, const char *dirname,
+                              std::vector<std::string> &names);
     static bool mkdir(PJ_CONTEXT *ctx, const char *filename);
     static bool unlink(PJ_CONTEXT *ctx, const char *filename);
     static bool rename(PJ_CONTEXT *ctx, const char *oldPath,
@@ -75,6 +84,25 @@ class FileManager {
 
 // ---------------------------------------------------------------------------
 
+// Read-only mapping of the whole content of a File in memory
+class FileMapping {
+  protected:
+    const unsigned char *data_;
+    size_t size_;
+    FileMapping(const unsigned char *data, size_t size)
+        : data_(data), size_(size) {}
+
+    FileMapping(const FileMapping &) = delete;
+    FileMapping &operator=(const FileMapping &) = delete;
+
+  public:
+    virtual ~FileMapping();
+    const unsigned char *data() const { return data_; }
+    size_t size() const { return size_; }
+};
+
+// ---------------------------------------------------------------------------
+
 class File {
   protected:
     std::string name_;
@@ -90,6 +118,9 @@ class File {
     virtual unsigned long long tell() = 0;
     virtual void reassign_context(PJ_CONTEXT *ctx) = 0;
     virtual bool hasChanged() const = 0;
+    // Returns nullptr if the file cannot be mapped (network file, file
+    // accessed through a user-provided file API, ...)
+    virtual std::unique_ptr<FileMapping> map() { return nullptr; }
     std::string PROJ_DLL read_line(size_t maxLen, bool &maxLenReached,
                                    bool &eofReached);
 
@@ -100,6 +131,15 @@ class File {
 
 std::unique_ptr<File> pj_network_file_open(PJ_CONTEXT *ctx,
                                            const char *filename);
+
+// Download the chunks of the remote file url covering the (offset, size)
+// byte ranges which are not already cached, with up to maxParallelRequests
+// concurrent requests, and put them in the chunk cache.
+bool pj_network_file_prefetch(
+    PJ_CONTEXT *ctx, const std::string &url,
+    const std::vector<std::pair<unsigned long long, unsigned long long>>
+        &ranges,
+    int maxParallelRequests);
 NS_PROJ_END
 
 // Exported for projsync
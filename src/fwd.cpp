@@ -294,3 +294,53 @@ bool pj_fwd4d(PJ_COORD &coo, PJ *P) {
     P->ctx->last_errno = last_errno;
     return true;
 }
+
+void pj_fwd4d_array(PJ_COORD *coo, size_t n, int *err, PJ *P) {
+
+    const int last_errno = P->ctx->last_errno;
+
+    if (!P->fwd4d_array) {
+        for (size_t i = 0; i < n; ++i) {
+            if (HUGE_VAL == coo[i].v[0])
+                continue;
+            P->ctx->last_errno = 0;
+            if (!pj_fwd4d(coo[i], P))
+                err[i] = P->ctx->last_errno;
+        }
+        P->ctx->last_errno = last_errno;
+        return;
+    }
+
+    if (!P->skip_fwd_prepare) {
+        for (size_t i = 0; i < n; ++i) {
+            if (HUGE_VAL == coo[i].v[0])
+                continue;
+            P->ctx->last_errno = 0;
+            fwd_prepare(P, coo[i]);
+            if (HUGE_VAL == coo[i].v[0]) {
+                coo[i] = proj_coord_error();
+                err[i] = P->ctx->last_errno;
+            }
+        }
+    }
+
+    P->ctx->last_errno = 0;
+    P->fwd4d_array(coo, n, err, P);
+
+    for (size_t i = 0; i < n; ++i) {
+        if (HUGE_VAL == coo[i].v[0]) {
+            coo[i] = proj_coord_error();
+            continue;
+        }
+        if (!P->skip_fwd_finalize) {
+            P->ctx->last_errno = 0;
+            fwd_finalize(P, coo[i]);
+            if (P->ctx->last_errno) {
+                coo[i] = proj_coord_error();
+                err[i] = P->ctx->last_errno;
+            }
+        }
+    }
+
+    P->ctx->last_errno = last_errno;
+}
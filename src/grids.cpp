@@ -42,10 +42,17 @@
 #endif
 
 #include <algorithm>
+#include <atomic>
 #include <cmath>
 #include <cstdint>
+#include <cstdlib>
 #include <cstring>
+#include <functional>
 #include <limits>
+#include <list>
+#include <memory>
+#include <mutex>
+#include <unordered_map>
 
 NS_PROJ_START
 
@@ -107,6 +114,195 @@ bool ExtentAndRes::intersects(const ExtentAndRes &other) const {
 
 // ---------------------------------------------------------------------------
 
+// Uniform bucket index over the extents of sibling grids (the top-level
+// grids of a set, or the children of a grid), so that gridAt() does not
+// need to test each of them when a file has hundreds of subgrids.
+// Each bucket lists, in increasing order, the position of the grids whose
+// extent may contain a point of the bucket, so that testing them in that
+// order gives the same first match as scanning all grids.
+class GridExtentIndex {
+    double m_minX = 0;
+    double m_minY = 0;
+    double m_maxX = 0;
+    double m_maxY = 0;
+    double m_invBucketSizeX = 0;
+    double m_invBucketSizeY = 0;
+    int m_countX = 0;
+    int m_countY = 0;
+    // Whether a point outside of [m_minX, m_maxX] may still be in a grid
+    // after wrapping its longitude.
+    bool m_longitudeWrap = false;
+    std::vector<std::vector<int>> m_buckets{};
+    std::vector<int> m_empty{};
+
+    // Below that number of grids, a linear scan is as fast.
+    static constexpr size_t MIN_GRID_COUNT = 8;
+    static constexpr int MAX_BUCKETS_PER_DIMENSION = 256;
+
+    int bucketX(double x) const {
+        return std::min(m_countX - 1,
+                        std::max(0, static_cast<int>((x - m_minX) *
+                                                     m_invBucketSizeX)));
+    }
+
+    int bucketY(double y) const {
+        return std::min(m_countY - 1,
+                        std::max(0, static_cast<int>((y - m_minY) *
+                                                     m_invBucketSizeY)));
+    }
+
+    void insert(int idx, double west, double south, double east,
+                double north) {
+        west = std::max(west, m_minX);
+        east = std::min(east, m_maxX);
+        if (!(west <= east))
+            return;
+        const int x0 = bucketX(west);
+        const int x1 = bucketX(east);
+        const int y0 = bucketY(south);
+        const int y1 = bucketY(north);
+        for (int y = y0; y <= y1; ++y) {
+            for (int x = x0; x <= x1; ++x) {
+                m_buckets[static_cast<size_t>(y) * m_countX + x].push_back(
+                    idx);
+            }
+        }
+    }
+
+  public:
+    // Returns nullptr if the grids are too few, or are such that the index
+    // would not help (null grid, invalid extents).
+    // relTolerance is the tolerance used by gridAt() on the extent of each
+    // grid, relative to its resolution.
+    template <class GridType>
+    static std::unique_ptr<GridExtentIndex>
+    create(const std::vector<std::unique_ptr<GridType>> &grids,
+           double relTolerance) {
+        if (grids.size() < MIN_GRID_COUNT)
+            return nullptr;
+
+        // The extents are slightly enlarged compared to the tolerance of
+        // gridAt(), so that rounding errors can only add candidates.
+        relTolerance += 1e-6;
+
+        auto index = std::make_unique<GridExtentIndex>();
+        bool first = true;
+        for (const auto &grid : grids) {
+            if (grid->isNullGrid())
+                return nullptr;
+            const auto &extent = grid->extentAndRes();
+            const double eps = (extent.resX + extent.resY) * relTolerance;
+            const double west = extent.west - eps;
+            const double south = extent.south - eps;
+            const double east = extent.east + eps;
+            const double north = extent.north + eps;
+            if (!std::isfinite(west) || !std::isfinite(south) ||
+                !std::isfinite(east) || !std::isfinite(north) ||
+                !(west <= east) || !(south <= north)) {
+                return nullptr;
+            }
+            if (first) {
+                index->m_minX = west;
+                index->m_minY = south;
+                index->m_maxX = east;
+                index->m_maxY = north;
+                first = false;
+            } else {
+                index->m_minX = std::min(index->m_minX, west);
+                index->m_minY = std::min(index->m_minY, south);
+                index->m_maxX = std::max(index->m_maxX, east);
+                index->m_maxY = std::max(index->m_maxY, north);
+            }
+            if (extent.isGeographic)
+                index->m_longitudeWrap = true;
+        }
+
+        const int count = std::min(
+            MAX_BUCKETS_PER_DIMENSION,
+            static_cast<int>(std::ceil(2 * std::sqrt(double(grids.size())))));
+        index->m_countX = count;
+        index->m_countY = count;
+        const double sizeX = index->m_maxX - index->m_minX;
+        const double sizeY = index->m_maxY - index->m_minY;
+        index->m_invBucketSizeX = sizeX > 0 ? count / sizeX : 0;
+        index->m_invBucketSizeY = sizeY > 0 ? count / sizeY : 0;
+        index->m_buckets.resize(static_cast<size_t>(count) * count);
+
+        for (size_t i = 0; i < grids.size(); ++i) {
+            const int idx = static_cast<int>(i);
+            const auto &extent = grids[i]->extentAndRes();
+            const double eps = (extent.resX + extent.resY) * relTolerance;
+            const double south = extent.south - eps;
+            const double north = extent.north + eps;
+            if (extent.fullWorldLongitude()) {
+                index->insert(idx, index->m_minX, south, index->m_maxX,
+                              north);
+                continue;
+            }
+            const double west = extent.west - eps;
+            const double east = extent.east + eps;
+            index->insert(idx, west, south, east, north);
+            if (extent.isGeographic) {
+                // Points that only fall in the extent once their longitude
+                // is wrapped
+                index->insert(idx, west - 2 * M_PI, south, east - 2 * M_PI,
+                              north);
+                index->insert(idx, west + 2 * M_PI, south, east + 2 * M_PI,
+                              north);
+            }
+        }
+        for (auto &bucket : index->m_buckets) {
+            std::sort(bucket.begin(), bucket.end());
+            bucket.erase(std::unique(bucket.begin(), bucket.end()),
+                         bucket.end());
+            bucket.shrink_to_fit();
+        }
+        return index;
+    }
+
+    // Returns the position of the grids that may contain (x, y), in
+    // increasing order, or nullptr if all grids must be tested.
+    const std::vector<int> *candidates(double x, double y) const {
+        if (!(y >= m_minY && y <= m_maxY))
+            return std::isnan(y) ? nullptr : &m_empty;
+        if (!(x >= m_minX && x <= m_maxX)) {
+            if (m_longitudeWrap || std::isnan(x))
+                return nullptr;
+            return &m_empty;
+        }
+        return &m_buckets[static_cast<size_t>(bucketY(y)) * m_countX +
+                          bucketX(x)];
+    }
+};
+
+// ---------------------------------------------------------------------------
+
+// Returns the first grid of grids for which matches() is true, only testing
+// the ones that index (if not null) reports as candidates for (x, y).
+template <class GridType, class Matches>
+static const GridType *
+findFirstGrid(const std::vector<std::unique_ptr<GridType>> &grids,
+              const GridExtentIndex *index, double x, double y,
+              Matches matches) {
+    const std::vector<int> *candidates =
+        index ? index->candidates(x, y) : nullptr;
+    if (candidates) {
+        for (int idx : *candidates) {
+            const auto &grid = grids[idx];
+            if (matches(*grid))
+                return grid.get();
+        }
+        return nullptr;
+    }
+    for (const auto &grid : grids) {
+        if (matches(*grid))
+            return grid.get();
+    }
+    return nullptr;
+}
+
+// ---------------------------------------------------------------------------
+
 Grid::Grid(const std::string &nameIn, int widthIn, int heightIn,
            const ExtentAndRes &extentIn)
     : m_name(nameIn), m_width(widthIn), m_height(heightIn), m_extent(extentIn) {
@@ -128,6 +324,20 @@ VerticalShiftGrid::~VerticalShiftGrid() = default;
 
 // ---------------------------------------------------------------------------
 
+bool VerticalShiftGrid::valuesAt(int x_start, int y_start, int x_count,
+                                 int y_count, float *out) const {
+    for (int y = y_start; y < y_start + y_count; ++y) {
+        for (int x = x_start; x < x_start + x_count; ++x) {
+            if (!valueAt(x, y, *out))
+                return false;
+            ++out;
+        }
+    }
+    return true;
+}
+
+// ---------------------------------------------------------------------------
+
 static ExtentAndRes globalExtent() {
     ExtentAndRes extent;
     extent.isGeographic = true;
@@ -384,6 +594,210 @@ static bool IsTIFF(size_t header_size, const unsigned char *header) {
                                  (header[3] == 0x2B && header[2] == 0)));
 }
 
+// ---------------------------------------------------------------------------
+
+// Process-wide cache of decoded blocks of grids, shared by all contexts and
+// threads, and bounded by a size in bytes.
+// It is split into shards, each with its own lock and an equal part of the
+// size budget, to limit contention between threads.
+class SharedBlockCache {
+  public:
+    typedef std::shared_ptr<const std::vector<unsigned char>> Block;
+
+    SharedBlockCache();
+
+    Block get(const std::string &fileId, uint32_t ifdIdx, uint32_t blockNumber);
+
+    void insert(const std::string &fileId, uint32_t ifdIdx,
+                uint32_t blockNumber, const Block &block);
+
+    void removeFile(const std::string &fileId);
+
+    void clear();
+
+    void setMaxSize(unsigned long long maxSizeBytes);
+
+    void getStats(unsigned long long &hits, unsigned long long &misses,
+                  unsigned long long &evictions) const;
+
+  private:
+    struct Key {
+        std::string fileId;
+        uint32_t ifdIdx;
+        uint32_t blockNumber;
+
+        Key(const std::string &fileIdIn, uint32_t ifdIdxIn,
+            uint32_t blockNumberIn)
+            : fileId(fileIdIn), ifdIdx(ifdIdxIn), blockNumber(blockNumberIn) {}
+        bool operator==(const Key &other) const {
+            return ifdIdx == other.ifdIdx &&
+                   blockNumber == other.blockNumber && fileId == other.fileId;
+        }
+    };
+
+    struct KeyHasher {
+        std::size_t operator()(const Key &k) const {
+            return std::hash<std::string>{}(k.fileId) ^
+                   (std::hash<uint64_t>{}(
+                        (static_cast<uint64_t>(k.ifdIdx) << 32) |
+                        k.blockNumber)
+                    << 1);
+        }
+    };
+
+    typedef std::list<std::pair<Key, Block>> LRUList;
+
+    struct Shard {
+        std::mutex mutex{};
+        LRUList lru{}; // most recently used first
+        std::unordered_map<Key, LRUList::iterator, KeyHasher> map{};
+        unsigned long long sizeBytes = 0;
+    };
+
+    static constexpr int NUM_SHARDS = 16;
+    static constexpr unsigned long long DEFAULT_MAX_SIZE_MB = 64;
+
+    Shard shards_[NUM_SHARDS];
+    std::atomic<unsigned long long> maxSizeBytes_{DEFAULT_MAX_SIZE_MB * 1024 *
+                                                  1024};
+    std::atomic<unsigned long long> hits_{0};
+    std::atomic<unsigned long long> misses_{0};
+    std::atomic<unsigned long long> evictions_{0};
+
+    Shard &shardFor(const Key &key) {
+        return shards_[KeyHasher{}(key) % NUM_SHARDS];
+    }
+
+    // Must be called with shard.mutex locked
+    void trim(Shard &shard, unsigned long long maxShardSize);
+};
+
+// ---------------------------------------------------------------------------
+
+SharedBlockCache::SharedBlockCache() {
+    const char *env_var = getenv("PROJ_GRID_BLOCK_CACHE_MAX_SIZE_MB");
+    if (env_var && env_var[0] != '\0') {
+        // Clamp before converting to bytes, to avoid overflows
+        constexpr unsigned long long maxSizeMBLimit =
+            std::numeric_limits<unsigned long long>::max() / (1024 * 1024);
+        const long long maxSizeMB = strtoll(env_var, nullptr, 10);
+        maxSizeBytes_ =
+            maxSizeMB < 0 ||
+                    static_cast<unsigned long long>(maxSizeMB) > maxSizeMBLimit
+                ? std::numeric_limits<unsigned long long>::max()
+                : static_cast<unsigned long long>(maxSizeMB) * 1024 * 1024;
+    }
+}
+
+// ---------------------------------------------------------------------------
+
+SharedBlockCache::Block SharedBlockCache::get(const std::string &fileId,
+                                              uint32_t ifdIdx,
+                                              uint32_t blockNumber) {
+    const Key key(fileId, ifdIdx, blockNumber);
+    auto &shard = shardFor(key);
+    std::lock_guard<std::mutex> lock(shard.mutex);
+    auto iter = shard.map.find(key);
+    if (iter == shard.map.end()) {
+        ++misses_;
+        return nullptr;
+    }
+    ++hits_;
+    shard.lru.splice(shard.lru.begin(), shard.lru, iter->second);
+    return iter->second->second;
+}
+
+// ---------------------------------------------------------------------------
+
+void SharedBlockCache::insert(const std::string &fileId, uint32_t ifdIdx,
+                              uint32_t blockNumber, const Block &block) {
+    const unsigned long long maxShardSize = maxSizeBytes_ / NUM_SHARDS;
+    if (block->size() > maxShardSize)
+        return;
+    const Key key(fileId, ifdIdx, blockNumber);
+    auto &shard = shardFor(key);
+    std::lock_guard<std::mutex> lock(shard.mutex);
+    auto iter = shard.map.find(key);
+    if (iter != shard.map.end()) {
+        // Another thread has decoded the same block in the meantime
+        shard.lru.splice(shard.lru.begin(), shard.lru, iter->second);
+        return;
+    }
+    shard.lru.emplace_front(key, block);
+    shard.map[key] = shard.lru.begin();
+    shard.sizeBytes += block->size();
+    trim(shard, maxShardSize);
+}
+
+// ---------------------------------------------------------------------------
+
+void SharedBlockCache::trim(Shard &shard, unsigned long long maxShardSize) {
+    while (shard.sizeBytes > maxShardSize && !shard.lru.empty()) {
+        const auto &last = shard.lru.back();
+        shard.sizeBytes -= last.second->size();
+        shard.map.erase(last.first);
+        shard.lru.pop_back();
+        ++evictions_;
+    }
+}
+
+// ---------------------------------------------------------------------------
+
+void SharedBlockCache::removeFile(const std::string &fileId) {
+    for (auto &shard : shards_) {
+        std::lock_guard<std::mutex> lock(shard.mutex);
+        for (auto iter = shard.lru.begin(); iter != shard.lru.end();) {
+            if (iter->first.fileId == fileId) {
+                shard.sizeBytes -= iter->second->size();
+                shard.map.erase(iter->first);
+                iter = shard.lru.erase(iter);
+            } else {
+                ++iter;
+            }
+        }
+    }
+}
+
+// ---------------------------------------------------------------------------
+
+void SharedBlockCache::clear() {
+    for (auto &shard : shards_) {
+        std::lock_guard<std::mutex> lock(shard.mutex);
+        shard.map.clear();
+        shard.lru.clear();
+        shard.sizeBytes = 0;
+    }
+}
+
+// ---------------------------------------------------------------------------
+
+void SharedBlockCache::setMaxSize(unsigned long long maxSizeBytes) {
+    maxSizeBytes_ = maxSizeBytes;
+    for (auto &shard : shards_) {
+        std::lock_guard<std::mutex> lock(shard.mutex);
+        trim(shard, maxSizeBytes / NUM_SHARDS);
+    }
+}
+
+// ---------------------------------------------------------------------------
+
+void SharedBlockCache::getStats(unsigned long long &hits,
+                                unsigned long long &misses,
+                                unsigned long long &evictions) const {
+    hits = hits_;
+    misses = misses_;
+    evictions = evictions_;
+}
+
+// ---------------------------------------------------------------------------
+
+static SharedBlockCache &getSharedBlockCache() {
+    static SharedBlockCache cache;
+    return cache;
+}
+
+// ---------------------------------------------------------------------------
+
 #ifdef TIFF_ENABLED
 
 // ---------------------------------------------------------------------------
@@ -406,34 +820,48 @@ constexpr uint16_t TIFFTAG_GDAL_NODATA = 42113;
 
 // ---------------------------------------------------------------------------
 
+// Small cache of the blocks recently used by a dataset, in front of the
+// process-wide SharedBlockCache, so that blocks stay available to it even
+// if they have been evicted from the shared cache.
 class BlockCache {
   public:
-    void insert(uint32_t ifdIdx, uint32_t blockNumber,
-                const std::vector<unsigned char> &data);
-    const std::vector<unsigned char> *get(uint32_t ifdIdx,
-                                          uint32_t blockNumber);
+    typedef SharedBlockCache::Block Block;
+
+    void setFileId(const std::string &fileId) { fileId_ = fileId; }
+    const std::string &fileId() const { return fileId_; }
+
+    void insert(uint32_t ifdIdx, uint32_t blockNumber, const Block &block);
+    Block get(uint32_t ifdIdx, uint32_t blockNumber);
 
   private:
     typedef uint64_t Key;
 
     static constexpr int NUM_BLOCKS_AT_CROSSING_TILES = 4;
     static constexpr int MAX_SAMPLE_COUNT = 3;
-    lru11::Cache<Key, std::vector<unsigned char>, lru11::NullLock> cache_{
+    std::string fileId_{};
+    lru11::Cache<Key, Block, lru11::NullLock> cache_{
         NUM_BLOCKS_AT_CROSSING_TILES * MAX_SAMPLE_COUNT};
 };
 
 // ---------------------------------------------------------------------------
 
 void BlockCache::insert(uint32_t ifdIdx, uint32_t blockNumber,
-                        const std::vector<unsigned char> &data) {
-    cache_.insert((static_cast<uint64_t>(ifdIdx) << 32) | blockNumber, data);
+                        const Block &block) {
+    cache_.insert((static_cast<uint64_t>(ifdIdx) << 32) | blockNumber, block);
+    getSharedBlockCache().insert(fileId_, ifdIdx, blockNumber, block);
 }
 
 // ---------------------------------------------------------------------------
 
-const std::vector<unsigned char> *BlockCache::get(uint32_t ifdIdx,
-                                                  uint32_t blockNumber) {
-    return cache_.getPtr((static_cast<uint64_t>(ifdIdx) << 32) | blockNumber);
+BlockCache::Block BlockCache::get(uint32_t ifdIdx, uint32_t blockNumber) {
+    const Key key = (static_cast<uint64_t>(ifdIdx) << 32) | blockNumber;
+    const Block *pBlock = cache_.getPtr(key);
+    if (pBlock)
+        return *pBlock;
+    auto block = getSharedBlockCache().get(fileId_, ifdIdx, blockNumber);
+    if (block)
+        cache_.insert(key, block);
+    return block;
 }
 
 // ---------------------------------------------------------------------------
@@ -443,6 +871,9 @@ class GTiffGrid : public Grid {
     TIFF *m_hTIFF;       // owned by the belonging GTiffDataset
     BlockCache &m_cache; // owned by the belonging GTiffDataset
     File *m_fp;          // owned by the belonging GTiffDataset
+    // owned by the belonging GTiffDataset. Set only if blocks can be read
+    // directly from it
+    const FileMapping *m_mapping;
     uint32_t m_ifdIdx;
     TIFFDataType m_dt;
     uint16_t m_samplesPerPixel;
@@ -452,8 +883,10 @@ class GTiffGrid : public Grid {
     bool m_tiled;
     uint32_t m_blockWidth = 0;
     uint32_t m_blockHeight = 0;
-    mutable std::vector<unsigned char> m_buffer{};
-    mutable uint32_t m_bufferBlockId = std::numeric_limits<uint32_t>::max();
+    size_t m_blockSize = 0;
+    std::vector<uint64_t> m_blockOffsets{}; // only used if m_mapping != null
+    mutable BlockCache::Block m_lastBlock{};
+    mutable uint32_t m_lastBlockId = std::numeric_limits<uint32_t>::max();
     unsigned m_blocksPerRow = 0;
     unsigned m_blocksPerCol = 0;
     unsigned m_blocks = 0;
@@ -470,13 +903,18 @@ class GTiffGrid : public Grid {
     GTiffGrid &operator=(const GTiffGrid &) = delete;
 
     template <class T>
-    float readValue(const std::vector<unsigned char> &buffer,
-                    uint32_t offsetInBlock, uint16_t sample) const;
+    float readValue(const unsigned char *blockData, uint32_t offsetInBlock,
+                    uint16_t sample) const;
+
+    bool canReadBlocksFromMapping();
+
+    const unsigned char *getBlockData(uint32_t blockId) const;
 
   public:
     GTiffGrid(PJ_CONTEXT *ctx, TIFF *hTIFF, BlockCache &cache, File *fp,
-              uint32_t ifdIdx, const std::string &nameIn, int widthIn,
-              int heightIn, const ExtentAndRes &extentIn, TIFFDataType dtIn,
+              const FileMapping *mapping, uint32_t ifdIdx,
+              const std::string &nameIn, int widthIn, int heightIn,
+              const ExtentAndRes &extentIn, TIFFDataType dtIn,
               uint16_t samplesPerPixelIn, uint16_t planarConfig,
               bool bottomUpIn);
 
@@ -497,6 +935,11 @@ class GTiffGrid : public Grid {
 
     uint32_t subfileType() const { return m_subfileType; }
 
+    void collectBlockRanges(
+        double west, double south, double east, double north,
+        std::vector<std::pair<unsigned long long, unsigned long long>>
+            &ranges) const;
+
     void reassign_context(PJ_CONTEXT *ctx) { m_ctx = ctx; }
 
     bool hasChanged() const override { return m_fp->hasChanged(); }
@@ -505,12 +948,14 @@ class GTiffGrid : public Grid {
 // ---------------------------------------------------------------------------
 
 GTiffGrid::GTiffGrid(PJ_CONTEXT *ctx, TIFF *hTIFF, BlockCache &cache, File *fp,
-                     uint32_t ifdIdx, const std::string &nameIn, int widthIn,
-                     int heightIn, const ExtentAndRes &extentIn,
-                     TIFFDataType dtIn, uint16_t samplesPerPixelIn,
-                     uint16_t planarConfig, bool bottomUpIn)
+                     const FileMapping *mapping, uint32_t ifdIdx,
+                     const std::string &nameIn, int widthIn, int heightIn,
+                     const ExtentAndRes &extentIn, TIFFDataType dtIn,
+                     uint16_t samplesPerPixelIn, uint16_t planarConfig,
+                     bool bottomUpIn)
     : Grid(nameIn, widthIn, heightIn, extentIn), m_ctx(ctx), m_hTIFF(hTIFF),
-      m_cache(cache), m_fp(fp), m_ifdIdx(ifdIdx), m_dt(dtIn),
+      m_cache(cache), m_fp(fp), m_mapping(mapping), m_ifdIdx(ifdIdx),
+      m_dt(dtIn),
       m_samplesPerPixel(samplesPerPixelIn),
       m_planarConfig(samplesPerPixelIn == 1 ? static_cast<uint16_t>(-1)
                                             : planarConfig),
@@ -537,6 +982,13 @@ GTiffGrid::GTiffGrid(PJ_CONTEXT *ctx, TIFF *hTIFF, BlockCache &cache, File *fp,
     m_blocksPerCol = (m_height + m_blockHeight - 1) / m_blockHeight;
     m_blocks = m_blocksPerRow * m_blocksPerCol;
 
+    m_blockSize = static_cast<size_t>(m_tiled ? TIFFTileSize64(m_hTIFF)
+                                              : TIFFStripSize64(m_hTIFF));
+    if (m_mapping && !canReadBlocksFromMapping()) {
+        m_mapping = nullptr;
+        m_blockOffsets.clear();
+    }
+
     const char *text = nullptr;
     // Poor-man XML parsing of TIFFTAG_GDAL_METADATA tag. Hopefully good
     // enough for our purposes.
@@ -637,12 +1089,233 @@ GTiffGrid::~GTiffGrid() = default;
 
 // ---------------------------------------------------------------------------
 
+// Checks that the blocks of the current directory are stored uncompressed
+// in the file with the layout expected by readValue(), and collects their
+// offsets in m_blockOffsets.
+bool GTiffGrid::canReadBlocksFromMapping() {
+    uint16_t compression = COMPRESSION_NONE;
+    if (!TIFFGetField(m_hTIFF, TIFFTAG_COMPRESSION, &compression))
+        compression = COMPRESSION_NONE;
+    if (compression != COMPRESSION_NONE || TIFFIsByteSwapped(m_hTIFF))
+        return false;
+
+    size_t dtSize = 0;
+    switch (m_dt) {
+    case TIFFDataType::Int16:
+    case TIFFDataType::UInt16:
+        dtSize = 2;
+        break;
+    case TIFFDataType::Int32:
+    case TIFFDataType::UInt32:
+    case TIFFDataType::Float32:
+        dtSize = 4;
+        break;
+    case TIFFDataType::Float64:
+        dtSize = 8;
+        break;
+    }
+
+    const uint32_t nBlocks =
+        m_planarConfig == PLANARCONFIG_SEPARATE
+            ? m_blocks * static_cast<uint32_t>(m_samplesPerPixel)
+            : m_blocks;
+    if ((m_tiled ? TIFFNumberOfTiles(m_hTIFF) : TIFFNumberOfStrips(m_hTIFF)) !=
+        nBlocks) {
+        return false;
+    }
+    uint64_t *offsets = nullptr;
+    uint64_t *byteCounts = nullptr;
+    if (!TIFFGetField(m_hTIFF,
+                      m_tiled ? TIFFTAG_TILEOFFSETS : TIFFTAG_STRIPOFFSETS,
+                      &offsets) ||
+        !TIFFGetField(m_hTIFF,
+                      m_tiled ? TIFFTAG_TILEBYTECOUNTS
+                              : TIFFTAG_STRIPBYTECOUNTS,
+                      &byteCounts) ||
+        offsets == nullptr || byteCounts == nullptr) {
+        return false;
+    }
+
+    const uint64_t rowSize =
+        static_cast<uint64_t>(m_blockWidth) * dtSize *
+        (m_planarConfig == PLANARCONFIG_CONTIG ? m_samplesPerPixel : 1);
+    const uint64_t fileSize = m_mapping->size();
+    try {
+        m_blockOffsets.resize(nBlocks);
+    } catch (const std::exception &) {
+        return false;
+    }
+    for (uint32_t i = 0; i < nBlocks; ++i) {
+        // Tiles are always complete, but the last strip may be truncated to
+        // the height of the image.
+        uint64_t rows = m_blockHeight;
+        if (!m_tiled) {
+            const uint64_t blockY = (i % m_blocks) / m_blocksPerRow;
+            rows = std::min(rows, static_cast<uint64_t>(m_height) -
+                                      blockY * m_blockHeight);
+        }
+        const uint64_t neededSize = rows * rowSize;
+        // Reject sparse blocks and truncated files
+        if (offsets[i] == 0 || byteCounts[i] < neededSize ||
+            offsets[i] > fileSize || fileSize - offsets[i] < neededSize) {
+            return false;
+        }
+        m_blockOffsets[i] = offsets[i];
+    }
+    return true;
+}
+
+// ---------------------------------------------------------------------------
+
+// Returns a pointer to the uncompressed content of a block, either directly
+// in the file mapping, or decoded by libtiff.
+const unsigned char *GTiffGrid::getBlockData(uint32_t blockId) const {
+    if (m_mapping) {
+        return m_mapping->data() + m_blockOffsets[blockId];
+    }
+
+    if (blockId == m_lastBlockId) {
+        return m_lastBlock->data();
+    }
+
+    auto block = m_cache.get(m_ifdIdx, blockId);
+    if (block == nullptr) {
+        if (TIFFCurrentDirOffset(m_hTIFF) != m_dirOffset &&
+            !TIFFSetSubDirectory(m_hTIFF, m_dirOffset)) {
+            return nullptr;
+        }
+        std::shared_ptr<std::vector<unsigned char>> buffer;
+        try {
+            buffer = std::make_shared<std::vector<unsigned char>>(m_blockSize);
+        } catch (const std::exception &e) {
+            pj_log(m_ctx, PJ_LOG_ERROR, _("Exception %s"), e.what());
+            return nullptr;
+        }
+
+        if (m_tiled) {
+            if (TIFFReadEncodedTile(m_hTIFF, blockId, buffer->data(),
+                                    buffer->size()) == -1) {
+                return nullptr;
+            }
+        } else {
+            if (TIFFReadEncodedStrip(m_hTIFF, blockId, buffer->data(),
+                                     buffer->size()) == -1) {
+                return nullptr;
+            }
+        }
+
+        block = std::move(buffer);
+        try {
+            m_cache.insert(m_ifdIdx, blockId, block);
+        } catch (const std::exception &e) {
+            // Should normally not happen
+            pj_log(m_ctx, PJ_LOG_ERROR, _("Exception %s"), e.what());
+        }
+    }
+    m_lastBlock = std::move(block);
+    m_lastBlockId = blockId;
+    return m_lastBlock->data();
+}
+
+// ---------------------------------------------------------------------------
+
+// Appends to ranges the (offset, size) in the file of the blocks needed to
+// interpolate values in the area, in radians for geographic grids. All the
+// blocks of grids in a projected CRS are collected.
+void GTiffGrid::collectBlockRanges(
+    double west, double south, double east, double north,
+    std::vector<std::pair<unsigned long long, unsigned long long>> &ranges)
+    const {
+    int xMin = 0;
+    int xMax = m_width - 1;
+    int yMin = 0;
+    int yMax = m_height - 1;
+    if (m_extent.isGeographic) {
+        if (north < m_extent.south || south > m_extent.north)
+            return;
+        // Nodes surrounding the area
+        const auto toX = [this](double lon) {
+            return std::max(0.0, std::min(static_cast<double>(m_width - 1),
+                                          (lon - m_extent.west) *
+                                              m_extent.invResX));
+        };
+        const auto toY = [this](double lat) {
+            return std::max(0.0, std::min(static_cast<double>(m_height - 1),
+                                          (lat - m_extent.south) *
+                                              m_extent.invResY));
+        };
+        yMin = static_cast<int>(std::floor(toY(south)));
+        yMax = static_cast<int>(std::ceil(toY(north)));
+        if (!m_extent.fullWorldLongitude()) {
+            // Longitudes of the area may have to be wrapped to match the
+            // ones of the grid
+            bool found = false;
+            for (int k = -1; k <= 1; ++k) {
+                const double w = west + k * 2 * M_PI;
+                const double e = east + k * 2 * M_PI;
+                if (e < m_extent.west || w > m_extent.east)
+                    continue;
+                const int x0 = static_cast<int>(std::floor(toX(w)));
+                const int x1 = static_cast<int>(std::ceil(toX(e)));
+                xMin = found ? std::min(xMin, x0) : x0;
+                xMax = found ? std::max(xMax, x1) : x1;
+                found = true;
+            }
+            if (!found)
+                return;
+        }
+    }
+
+    if (TIFFCurrentDirOffset(m_hTIFF) != m_dirOffset &&
+        !TIFFSetSubDirectory(m_hTIFF, m_dirOffset)) {
+        return;
+    }
+    uint64_t *offsets = nullptr;
+    uint64_t *byteCounts = nullptr;
+    if (!TIFFGetField(m_hTIFF,
+                      m_tiled ? TIFFTAG_TILEOFFSETS : TIFFTAG_STRIPOFFSETS,
+                      &offsets) ||
+        !TIFFGetField(m_hTIFF,
+                      m_tiled ? TIFFTAG_TILEBYTECOUNTS
+                              : TIFFTAG_STRIPBYTECOUNTS,
+                      &byteCounts) ||
+        offsets == nullptr || byteCounts == nullptr) {
+        return;
+    }
+    const uint32_t nBlocks =
+        m_tiled ? TIFFNumberOfTiles(m_hTIFF) : TIFFNumberOfStrips(m_hTIFF);
+
+    const int yTIFFMin = m_bottomUp ? yMin : m_height - 1 - yMax;
+    const int yTIFFMax = m_bottomUp ? yMax : m_height - 1 - yMin;
+    const uint32_t nPlanes = m_planarConfig == PLANARCONFIG_SEPARATE
+                                 ? static_cast<uint32_t>(m_samplesPerPixel)
+                                 : 1;
+    for (uint32_t plane = 0; plane < nPlanes; ++plane) {
+        for (uint32_t blockY = yTIFFMin / m_blockHeight;
+             blockY <= yTIFFMax / m_blockHeight; ++blockY) {
+            for (uint32_t blockX = xMin / m_blockWidth;
+                 blockX <= xMax / m_blockWidth; ++blockX) {
+                const uint32_t blockId =
+                    plane * m_blocks + blockY * m_blocksPerRow + blockX;
+                // Sparse blocks have no data to fetch
+                if (blockId < nBlocks && offsets[blockId] != 0 &&
+                    byteCounts[blockId] != 0) {
+                    ranges.emplace_back(offsets[blockId], byteCounts[blockId]);
+                }
+            }
+        }
+    }
+}
+
+// ---------------------------------------------------------------------------
+
 template <class T>
-float GTiffGrid::readValue(const std::vector<unsigned char> &buffer,
+float GTiffGrid::readValue(const unsigned char *blockData,
                            uint32_t offsetInBlock, uint16_t sample) const {
-    const auto ptr = reinterpret_cast<const T *>(buffer.data());
-    assert(offsetInBlock < buffer.size() / sizeof(T));
-    const auto val = ptr[offsetInBlock];
+    assert(offsetInBlock < m_blockSize / sizeof(T));
+    // Blocks read from the file mapping may not be aligned on sizeof(T)
+    T val;
+    memcpy(&val, blockData + offsetInBlock * sizeof(T), sizeof(T));
     if ((!m_hasNodata || static_cast<float>(val) != m_noData) &&
         sample < m_adfScale.size()) {
         double scale = m_adfScale[sample];
@@ -693,45 +1366,9 @@ bool GTiffGrid::valueAt(uint16_t sample, int x, int yFromBottom,
         blockId += sample * m_blocks;
     }
 
-    const std::vector<unsigned char> *pBuffer =
-        blockId == m_bufferBlockId ? &m_buffer : m_cache.get(m_ifdIdx, blockId);
-    if (pBuffer == nullptr) {
-        if (TIFFCurrentDirOffset(m_hTIFF) != m_dirOffset &&
-            !TIFFSetSubDirectory(m_hTIFF, m_dirOffset)) {
-            return false;
-        }
-        if (m_buffer.empty()) {
-            const auto blockSize = static_cast<size_t>(
-                m_tiled ? TIFFTileSize64(m_hTIFF) : TIFFStripSize64(m_hTIFF));
-            try {
-                m_buffer.resize(blockSize);
-            } catch (const std::exception &e) {
-                pj_log(m_ctx, PJ_LOG_ERROR, _("Exception %s"), e.what());
-                return false;
-            }
-        }
-
-        if (m_tiled) {
-            if (TIFFReadEncodedTile(m_hTIFF, blockId, m_buffer.data(),
-                                    m_buffer.size()) == -1) {
-                return false;
-            }
-        } else {
-            if (TIFFReadEncodedStrip(m_hTIFF, blockId, m_buffer.data(),
-                                     m_buffer.size()) == -1) {
-                return false;
-            }
-        }
-
-        pBuffer = &m_buffer;
-        try {
-            m_cache.insert(m_ifdIdx, blockId, m_buffer);
-            m_bufferBlockId = blockId;
-        } catch (const std::exception &e) {
-            // Should normally not happen
-            pj_log(m_ctx, PJ_LOG_ERROR, _("Exception %s"), e.what());
-        }
-    }
+    const unsigned char *blockData = getBlockData(blockId);
+    if (blockData == nullptr)
+        return false;
 
     uint32_t offsetInBlock;
     if (m_blockIs256Pixel)
@@ -743,27 +1380,27 @@ bool GTiffGrid::valueAt(uint16_t sample, int x, int yFromBottom,
 
     switch (m_dt) {
     case TIFFDataType::Int16:
-        out = readValue<short>(*pBuffer, offsetInBlock, sample);
+        out = readValue<short>(blockData, offsetInBlock, sample);
         break;
 
     case TIFFDataType::UInt16:
-        out = readValue<unsigned short>(*pBuffer, offsetInBlock, sample);
+        out = readValue<unsigned short>(blockData, offsetInBlock, sample);
         break;
 
     case TIFFDataType::Int32:
-        out = readValue<int>(*pBuffer, offsetInBlock, sample);
+        out = readValue<int>(blockData, offsetInBlock, sample);
         break;
 
     case TIFFDataType::UInt32:
-        out = readValue<unsigned int>(*pBuffer, offsetInBlock, sample);
+        out = readValue<unsigned int>(blockData, offsetInBlock, sample);
         break;
 
     case TIFFDataType::Float32:
-        out = readValue<float>(*pBuffer, offsetInBlock, sample);
+        out = readValue<float>(blockData, offsetInBlock, sample);
         break;
 
     case TIFFDataType::Float64:
-        out = readValue<double>(*pBuffer, offsetInBlock, sample);
+        out = readValue<double>(blockData, offsetInBlock, sample);
         break;
     }
 
@@ -798,47 +1435,9 @@ bool GTiffGrid::valuesAt(int x_start, int y_start, int x_count, int y_count,
         blockYOff = yTIFF % 256;
         blockId = blockY * m_blocksPerRow + blockX;
 
-        const std::vector<unsigned char> *pBuffer =
-            blockId == m_bufferBlockId ? &m_buffer
-                                       : m_cache.get(m_ifdIdx, blockId);
-        if (pBuffer == nullptr) {
-            if (TIFFCurrentDirOffset(m_hTIFF) != m_dirOffset &&
-                !TIFFSetSubDirectory(m_hTIFF, m_dirOffset)) {
-                return false;
-            }
-            if (m_buffer.empty()) {
-                const auto blockSize =
-                    static_cast<size_t>(m_tiled ? TIFFTileSize64(m_hTIFF)
-                                                : TIFFStripSize64(m_hTIFF));
-                try {
-                    m_buffer.resize(blockSize);
-                } catch (const std::exception &e) {
-                    pj_log(m_ctx, PJ_LOG_ERROR, _("Exception %s"), e.what());
-                    return false;
-                }
-            }
-
-            if (m_tiled) {
-                if (TIFFReadEncodedTile(m_hTIFF, blockId, m_buffer.data(),
-                                        m_buffer.size()) == -1) {
-                    return false;
-                }
-            } else {
-                if (TIFFReadEncodedStrip(m_hTIFF, blockId, m_buffer.data(),
-                                         m_buffer.size()) == -1) {
-                    return false;
-                }
-            }
-
-            pBuffer = &m_buffer;
-            try {
-                m_cache.insert(m_ifdIdx, blockId, m_buffer);
-                m_bufferBlockId = blockId;
-            } catch (const std::exception &e) {
-                // Should normally not happen
-                pj_log(m_ctx, PJ_LOG_ERROR, _("Exception %s"), e.what());
-            }
-        }
+        const unsigned char *blockData = getBlockData(blockId);
+        if (blockData == nullptr)
+            return false;
 
         uint32_t offsetInBlockStart = blockXOff + blockYOff * 256U;
 
@@ -850,9 +1449,7 @@ bool GTiffGrid::valuesAt(int x_start, int y_start, int x_count, int y_count,
                      256 * (m_bottomUp ? y : y_count - 1 - y)) *
                         m_samplesPerPixel +
                     sample_idx[0];
-                memcpy(out,
-                       reinterpret_cast<const float *>(pBuffer->data()) +
-                           offsetInBlock,
+                memcpy(out, blockData + offsetInBlock * sizeof(float),
                        sample_count_mul_x_count * sizeof(float));
                 out += sample_count_mul_x_count;
             }
@@ -865,12 +1462,11 @@ bool GTiffGrid::valuesAt(int x_start, int y_start, int x_count, int y_count,
                          256 * (m_bottomUp ? y : y_count - 1 - y)) *
                             m_samplesPerPixel +
                         sample_idx[0];
-                    const float *in_ptr =
-                        reinterpret_cast<const float *>(pBuffer->data()) +
-                        offsetInBlock;
+                    const unsigned char *in_ptr =
+                        blockData + offsetInBlock * sizeof(float);
                     for (int x = 0; x < x_count; ++x) {
                         memcpy(out, in_ptr, sample_count * sizeof(float));
-                        in_ptr += m_samplesPerPixel;
+                        in_ptr += m_samplesPerPixel * sizeof(float);
                         out += sample_count;
                     }
                 }
@@ -882,12 +1478,11 @@ bool GTiffGrid::valuesAt(int x_start, int y_start, int x_count, int y_count,
                          256 * (m_bottomUp ? y : y_count - 1 - y)) *
                             m_samplesPerPixel +
                         sample_idx[0];
-                    const float *in_ptr =
-                        reinterpret_cast<const float *>(pBuffer->data()) +
-                        offsetInBlock;
+                    const unsigned char *in_ptr =
+                        blockData + offsetInBlock * sizeof(float);
                     for (int x = 0; x < x_count; ++x) {
                         memcpy(out, in_ptr, sample_count * sizeof(float));
-                        in_ptr += m_samplesPerPixel;
+                        in_ptr += m_samplesPerPixel * sizeof(float);
                         out += sample_count;
                     }
                 }
@@ -899,12 +1494,11 @@ bool GTiffGrid::valuesAt(int x_start, int y_start, int x_count, int y_count,
                          256 * (m_bottomUp ? y : y_count - 1 - y)) *
                             m_samplesPerPixel +
                         sample_idx[0];
-                    const float *in_ptr =
-                        reinterpret_cast<const float *>(pBuffer->data()) +
-                        offsetInBlock;
+                    const unsigned char *in_ptr =
+                        blockData + offsetInBlock * sizeof(float);
                     for (int x = 0; x < x_count; ++x) {
                         memcpy(out, in_ptr, sample_count * sizeof(float));
-                        in_ptr += m_samplesPerPixel;
+                        in_ptr += m_samplesPerPixel * sizeof(float);
                         out += sample_count;
                     }
                 }
@@ -952,6 +1546,8 @@ const std::string &GTiffGrid::metadataItem(const std::string &key,
 class GTiffDataset {
     PJ_CONTEXT *m_ctx;
     std::unique_ptr<File> m_fp;
+    std::unique_ptr<FileMapping> m_mapping{};
+    bool m_mappingAttempted = false;
     TIFF *m_hTIFF = nullptr;
     bool m_hasNextGrid = false;
     uint32_t m_ifdIdx = 0;
@@ -1012,6 +1608,11 @@ class GTiffDataset {
         m_ctx = ctx;
         m_fp->reassign_context(ctx);
     }
+
+    // Remove the blocks of this file from the process-wide block cache.
+    void evictSharedBlocks() {
+        getSharedBlockCache().removeFile(m_cache.fileId());
+    }
 };
 
 // ---------------------------------------------------------------------------
@@ -1082,7 +1683,20 @@ bool GTiffDataset::openTIFF(const std::string &filename) {
 
     m_filename = filename;
     m_hasNextGrid = true;
-    return m_hTIFF != nullptr;
+    if (m_hTIFF == nullptr)
+        return false;
+
+    // Blocks are shared with other datasets opened on the same file, which
+    // is identified by its name, size and modification time (when it is a
+    // local file), so that a file replaced on disk does not reuse them.
+    unsigned long long size = 0;
+    long long mtime = 0;
+    FileManager::getFileStatus(m_ctx, m_fp->name().c_str(), size, mtime);
+    m_cache.setFileId(
+        filename + '\0' +
+        std::to_string(tiffSizeProc(static_cast<thandle_t>(this))) + '\0' +
+        std::to_string(mtime));
+    return true;
 }
 // ---------------------------------------------------------------------------
 
@@ -1316,9 +1930,17 @@ std::unique_ptr<GTiffGrid> GTiffDataset::nextGrid() {
         return nullptr;
     }
 
+    // Uncompressed local files are mapped in memory, so that their blocks can
+    // be accessed without being copied into the block cache.
+    if (compression == COMPRESSION_NONE && !m_mappingAttempted) {
+        m_mappingAttempted = true;
+        m_mapping = m_fp->map();
+    }
+
     auto ret = std::unique_ptr<GTiffGrid>(new GTiffGrid(
-        m_ctx, m_hTIFF, m_cache, m_fp.get(), m_ifdIdx, m_filename, width,
-        height, extent, dt, samplesPerPixel, planarConfig, vRes < 0));
+        m_ctx, m_hTIFF, m_cache, m_fp.get(), m_mapping.get(), m_ifdIdx,
+        m_filename, width, height, extent, dt, samplesPerPixel, planarConfig,
+        vRes < 0));
     m_ifdIdx++;
     m_hasNextGrid = TIFFReadDirectory(m_hTIFF) != 0;
     m_nextDirOffset = TIFFCurrentDirOffset(m_hTIFF);
@@ -1361,6 +1983,9 @@ class GTiffVGridShiftSet : public VerticalShiftGridSet {
         pj_log(ctx, PJ_LOG_DEBUG, "Grid %s has changed. Re-loading it",
                m_name.c_str());
         m_grids.clear();
+        m_gridsIndex.reset();
+        if (m_GTiffDataset)
+            m_GTiffDataset->evictSharedBlocks();
         m_GTiffDataset.reset();
         auto fp = FileManager::open_resource_file(ctx, m_name.c_str());
         if (!fp) {
@@ -1369,6 +1994,7 @@ class GTiffVGridShiftSet : public VerticalShiftGridSet {
         auto newGS = open(ctx, std::move(fp), m_name);
         if (newGS) {
             m_grids = std::move(newGS->m_grids);
+            m_gridsIndex = std::move(newGS->m_gridsIndex);
             m_GTiffDataset = std::move(newGS->m_GTiffDataset);
         }
         return !m_grids.empty();
@@ -1460,6 +2086,14 @@ class GTiffVGrid : public VerticalShiftGrid {
         return m_grid->valueAt(m_idxSample, x, y, out);
     }
 
+    bool valuesAt(int x_start, int y_start, int x_count, int y_count,
+                  float *out) const override {
+        const int idxSample = m_idxSample;
+        bool nodataFound = false;
+        return m_grid->valuesAt(x_start, y_start, x_count, y_count, 1,
+                                &idxSample, out, nodataFound);
+    }
+
     bool isNodata(float val, double /* multiplier */) const override {
         return m_grid->isNodata(val);
     }
@@ -1604,6 +2238,7 @@ GTiffVGridShiftSet::open(PJ_CONTEXT *ctx, std::unique_ptr<File> fp,
         insertIntoHierarchy(ctx, std::move(vgrid), gridName, parentName,
                             set->m_grids, mapGrids);
     }
+    set->buildIndex();
     return set;
 }
 #endif // TIFF_ENABLED
@@ -1678,8 +2313,10 @@ bool VerticalShiftGridSet::reopen(PJ_CONTEXT *ctx) {
            m_name.c_str());
     auto newGS = open(ctx, m_name);
     m_grids.clear();
+    m_gridsIndex.reset();
     if (newGS) {
         m_grids = std::move(newGS->m_grids);
+        m_gridsIndex = std::move(newGS->m_gridsIndex);
     }
     return !m_grids.empty();
 }
@@ -1707,28 +2344,51 @@ static bool isPointInExtent(double x, double y, const ExtentAndRes &extent,
 
 const VerticalShiftGrid *VerticalShiftGrid::gridAt(double longitude,
                                                    double lat) const {
-    for (const auto &child : m_children) {
-        const auto &extentChild = child->extentAndRes();
-        if (isPointInExtent(longitude, lat, extentChild)) {
-            return child->gridAt(longitude, lat);
-        }
+    const auto child =
+        findFirstGrid(m_children, m_childrenIndex.get(), longitude, lat,
+                      [longitude, lat](const VerticalShiftGrid &grid) {
+                          return isPointInExtent(longitude, lat,
+                                                 grid.extentAndRes());
+                      });
+    if (child) {
+        return child->gridAt(longitude, lat);
     }
     return this;
 }
+
+// ---------------------------------------------------------------------------
+
+void VerticalShiftGrid::buildIndex() {
+    m_childrenIndex = GridExtentIndex::create(m_children, 0);
+    for (const auto &child : m_children) {
+        child->buildIndex();
+    }
+}
+
 // ---------------------------------------------------------------------------
 
 const VerticalShiftGrid *VerticalShiftGridSet::gridAt(double longitude,
                                                       double lat) const {
+    const auto grid =
+        findFirstGrid(m_grids, m_gridsIndex.get(), longitude, lat,
+                      [longitude, lat](const VerticalShiftGrid &candidate) {
+                          return candidate.isNullGrid() ||
+                                 isPointInExtent(longitude, lat,
+                                                 candidate.extentAndRes());
+                      });
+    if (!grid || grid->isNullGrid()) {
+        return grid;
+    }
+    return grid->gridAt(longitude, lat);
+}
+
+// ---------------------------------------------------------------------------
+
+void VerticalShiftGridSet::buildIndex() {
+    m_gridsIndex = GridExtentIndex::create(m_grids, 0);
     for (const auto &grid : m_grids) {
-        if (grid->isNullGrid()) {
-            return grid.get();
-        }
-        const auto &extent = grid->extentAndRes();
-        if (isPointInExtent(longitude, lat, extent)) {
-            return grid->gridAt(longitude, lat);
-        }
+        grid->buildIndex();
     }
-    return nullptr;
 }
 
 // ---------------------------------------------------------------------------
@@ -1752,6 +2412,22 @@ HorizontalShiftGrid::~HorizontalShiftGrid() = default;
 
 // ---------------------------------------------------------------------------
 
+bool HorizontalShiftGrid::valuesAt(int x_start, int y_start, int x_count,
+                                   int y_count, bool compensateNTConvention,
+                                   float *longShift, float *latShift) const {
+    for (int y = y_start; y < y_start + y_count; ++y) {
+        for (int x = x_start; x < x_start + x_count; ++x) {
+            if (!valueAt(x, y, compensateNTConvention, *longShift, *latShift))
+                return false;
+            ++longShift;
+            ++latShift;
+        }
+    }
+    return true;
+}
+
+// ---------------------------------------------------------------------------
+
 HorizontalShiftGridSet::HorizontalShiftGridSet() = default;
 
 // ---------------------------------------------------------------------------
@@ -2339,6 +3015,7 @@ std::unique_ptr<NTv2GridSet> NTv2GridSet::open(PJ_CONTEXT *ctx,
         kv.second->setCache(set->m_cache.get());
     }
 
+    set->buildIndex();
     return set;
 }
 
@@ -2371,6 +3048,9 @@ class GTiffHGridShiftSet : public HorizontalShiftGridSet {
         pj_log(ctx, PJ_LOG_DEBUG, "Grid %s has changed. Re-loading it",
                m_name.c_str());
         m_grids.clear();
+        m_gridsIndex.reset();
+        if (m_GTiffDataset)
+            m_GTiffDataset->evictSharedBlocks();
         m_GTiffDataset.reset();
         auto fp = FileManager::open_resource_file(ctx, m_name.c_str());
         if (!fp) {
@@ -2379,6 +3059,7 @@ class GTiffHGridShiftSet : public HorizontalShiftGridSet {
         auto newGS = open(ctx, std::move(fp), m_name);
         if (newGS) {
             m_grids = std::move(newGS->m_grids);
+            m_gridsIndex = std::move(newGS->m_gridsIndex);
             m_GTiffDataset = std::move(newGS->m_GTiffDataset);
         }
         return !m_grids.empty();
@@ -2410,6 +3091,10 @@ class GTiffHGrid : public HorizontalShiftGrid {
     bool valueAt(int x, int y, bool, float &longShift,
                  float &latShift) const override;
 
+    bool valuesAt(int x_start, int y_start, int x_count, int y_count,
+                  bool compensateNTConvention, float *longShift,
+                  float *latShift) const override;
+
     const std::string &metadataItem(const std::string &key,
                                     int sample = -1) const override {
         return m_grid->metadataItem(key, sample);
@@ -2462,6 +3147,44 @@ bool GTiffHGrid::valueAt(int x, int y, bool, float &longShift,
 
 // ---------------------------------------------------------------------------
 
+bool GTiffHGrid::valuesAt(int x_start, int y_start, int x_count, int y_count,
+                          bool compensateNTConvention, float *longShift,
+                          float *latShift) const {
+    constexpr int MAX_NODES = 9;
+    const int nodes = x_count * y_count;
+    const bool latFirst = m_idxLongShift == m_idxLatShift + 1;
+    if (nodes > MAX_NODES ||
+        (!latFirst && m_idxLatShift != m_idxLongShift + 1)) {
+        return HorizontalShiftGrid::valuesAt(x_start, y_start, x_count,
+                                             y_count, compensateNTConvention,
+                                             longShift, latShift);
+    }
+
+    // Read both samples at once, in the order they are stored
+    const int sampleIdx[2] = {std::min(m_idxLatShift, m_idxLongShift),
+                              std::max(m_idxLatShift, m_idxLongShift)};
+    float values[2 * MAX_NODES];
+    bool nodataFound = false;
+    if (!m_grid->valuesAt(x_start, y_start, x_count, y_count, 2, sampleIdx,
+                          values, nodataFound)) {
+        return false;
+    }
+    const int latOffset = latFirst ? 0 : 1;
+    for (int i = 0; i < nodes; ++i) {
+        // From arc-seconds to radians
+        latShift[i] = static_cast<float>(values[2 * i + latOffset] *
+                                         m_convFactorToRadian);
+        longShift[i] = static_cast<float>(values[2 * i + 1 - latOffset] *
+                                          m_convFactorToRadian);
+        if (!m_positiveEast) {
+            longShift[i] = -longShift[i];
+        }
+    }
+    return true;
+}
+
+// ---------------------------------------------------------------------------
+
 void GTiffHGrid::insertGrid(PJ_CONTEXT *ctx,
                             std::unique_ptr<GTiffHGrid> &&subgrid) {
     bool gridInserted = false;
@@ -2650,6 +3373,7 @@ GTiffHGridShiftSet::open(PJ_CONTEXT *ctx, std::unique_ptr<File> fp,
         insertIntoHierarchy(ctx, std::move(hgrid), gridName, parentName,
                             set->m_grids, mapGrids);
     }
+    set->buildIndex();
     return set;
 }
 #endif // TIFF_ENABLED
@@ -2748,8 +3472,10 @@ bool HorizontalShiftGridSet::reopen(PJ_CONTEXT *ctx) {
            m_name.c_str());
     auto newGS = open(ctx, m_name);
     m_grids.clear();
+    m_gridsIndex.reset();
     if (newGS) {
         m_grids = std::move(newGS->m_grids);
+        m_gridsIndex = std::move(newGS->m_gridsIndex);
     }
     return !m_grids.empty();
 }
@@ -2758,34 +3484,63 @@ bool HorizontalShiftGridSet::reopen(PJ_CONTEXT *ctx) {
 
 #define REL_TOLERANCE_HGRIDSHIFT 1e-5
 
+static bool isPointInHGridExtent(double longitude, double lat,
+                                 const HorizontalShiftGrid &grid) {
+    const auto &extent = grid.extentAndRes();
+    const double epsilon =
+        (extent.resX + extent.resY) * REL_TOLERANCE_HGRIDSHIFT;
+    return isPointInExtent(longitude, lat, extent, epsilon);
+}
+
+// ---------------------------------------------------------------------------
+
 const HorizontalShiftGrid *HorizontalShiftGrid::gridAt(double longitude,
                                                        double lat) const {
-    for (const auto &child : m_children) {
-        const auto &extentChild = child->extentAndRes();
-        const double epsilon =
-            (extentChild.resX + extentChild.resY) * REL_TOLERANCE_HGRIDSHIFT;
-        if (isPointInExtent(longitude, lat, extentChild, epsilon)) {
-            return child->gridAt(longitude, lat);
-        }
+    const auto child =
+        findFirstGrid(m_children, m_childrenIndex.get(), longitude, lat,
+                      [longitude, lat](const HorizontalShiftGrid &grid) {
+                          return isPointInHGridExtent(longitude, lat, grid);
+                      });
+    if (child) {
+        return child->gridAt(longitude, lat);
     }
     return this;
 }
+
+// ---------------------------------------------------------------------------
+
+void HorizontalShiftGrid::buildIndex() {
+    m_childrenIndex =
+        GridExtentIndex::create(m_children, REL_TOLERANCE_HGRIDSHIFT);
+    for (const auto &child : m_children) {
+        child->buildIndex();
+    }
+}
+
 // ---------------------------------------------------------------------------
 
 const HorizontalShiftGrid *HorizontalShiftGridSet::gridAt(double longitude,
                                                           double lat) const {
+    const auto grid =
+        findFirstGrid(m_grids, m_gridsIndex.get(), longitude, lat,
+                      [longitude, lat](const HorizontalShiftGrid &candidate) {
+                          return candidate.isNullGrid() ||
+                                 isPointInHGridExtent(longitude, lat,
+                                                      candidate);
+                      });
+    if (!grid || grid->isNullGrid()) {
+        return grid;
+    }
+    return grid->gridAt(longitude, lat);
+}
+
+// ---------------------------------------------------------------------------
+
+void HorizontalShiftGridSet::buildIndex() {
+    m_gridsIndex = GridExtentIndex::create(m_grids, REL_TOLERANCE_HGRIDSHIFT);
     for (const auto &grid : m_grids) {
-        if (grid->isNullGrid()) {
-            return grid.get();
-        }
-        const auto &extent = grid->extentAndRes();
-        const double epsilon =
-            (extent.resX + extent.resY) * REL_TOLERANCE_HGRIDSHIFT;
-        if (isPointInExtent(longitude, lat, extent, epsilon)) {
-            return grid->gridAt(longitude, lat);
-        }
+        grid->buildIndex();
     }
-    return nullptr;
 }
 
 // ---------------------------------------------------------------------------
@@ -2824,6 +3579,9 @@ class GTiffGenericGridShiftSet : public GenericShiftGridSet {
         pj_log(ctx, PJ_LOG_DEBUG, "Grid %s has changed. Re-loading it",
                m_name.c_str());
         m_grids.clear();
+        m_gridsIndex.reset();
+        if (m_GTiffDataset)
+            m_GTiffDataset->evictSharedBlocks();
         m_GTiffDataset.reset();
         auto fp = FileManager::open_resource_file(ctx, m_name.c_str());
         if (!fp) {
@@ -2832,6 +3590,7 @@ class GTiffGenericGridShiftSet : public GenericShiftGridSet {
         auto newGS = open(ctx, std::move(fp), m_name);
         if (newGS) {
             m_grids = std::move(newGS->m_grids);
+            m_gridsIndex = std::move(newGS->m_gridsIndex);
             m_GTiffDataset = std::move(newGS->m_GTiffDataset);
         }
         return !m_grids.empty();
@@ -3049,6 +3808,7 @@ GTiffGenericGridShiftSet::open(PJ_CONTEXT *ctx, std::unique_ptr<File> fp,
         insertIntoHierarchy(ctx, std::move(ggrid), gridName, parentName,
                             set->m_grids, mapGrids);
     }
+    set->buildIndex();
     return set;
 }
 #endif // TIFF_ENABLED
@@ -3148,8 +3908,10 @@ bool GenericShiftGridSet::reopen(PJ_CONTEXT *ctx) {
            m_name.c_str());
     auto newGS = open(ctx, m_name);
     m_grids.clear();
+    m_gridsIndex.reset();
     if (newGS) {
         m_grids = std::move(newGS->m_grids);
+        m_gridsIndex = std::move(newGS->m_gridsIndex);
     }
     return !m_grids.empty();
 }
@@ -3157,47 +3919,65 @@ bool GenericShiftGridSet::reopen(PJ_CONTEXT *ctx) {
 // ---------------------------------------------------------------------------
 
 const GenericShiftGrid *GenericShiftGrid::gridAt(double x, double y) const {
-    for (const auto &child : m_children) {
-        const auto &extentChild = child->extentAndRes();
-        if (isPointInExtent(x, y, extentChild)) {
-            return child->gridAt(x, y);
-        }
+    const auto child = findFirstGrid(
+        m_children, m_childrenIndex.get(), x, y,
+        [x, y](const GenericShiftGrid &grid) {
+            return isPointInExtent(x, y, grid.extentAndRes());
+        });
+    if (child) {
+        return child->gridAt(x, y);
     }
     return this;
 }
 
 // ---------------------------------------------------------------------------
 
-const GenericShiftGrid *GenericShiftGridSet::gridAt(double x, double y) const {
-    for (const auto &grid : m_grids) {
-        if (grid->isNullGrid()) {
-            return grid.get();
-        }
-        const auto &extent = grid->extentAndRes();
-        if (isPointInExtent(x, y, extent)) {
-            return grid->gridAt(x, y);
-        }
+void GenericShiftGrid::buildIndex() {
+    m_childrenIndex = GridExtentIndex::create(m_children, 0);
+    for (const auto &child : m_children) {
+        child->buildIndex();
     }
-    return nullptr;
+}
+
+// ---------------------------------------------------------------------------
+
+const GenericShiftGrid *GenericShiftGridSet::gridAt(double x, double y) const {
+    const auto grid = findFirstGrid(
+        m_grids, m_gridsIndex.get(), x, y,
+        [x, y](const GenericShiftGrid &candidate) {
+            return candidate.isNullGrid() ||
+                   isPointInExtent(x, y, candidate.extentAndRes());
+        });
+    if (!grid || grid->isNullGrid()) {
+        return grid;
+    }
+    return grid->gridAt(x, y);
 }
 
 // ---------------------------------------------------------------------------
 
 const GenericShiftGrid *GenericShiftGridSet::gridAt(const std::string &type,
                                                     double x, double y) const {
+    const auto grid = findFirstGrid(
+        m_grids, m_gridsIndex.get(), x, y,
+        [&type, x, y](const GenericShiftGrid &candidate) {
+            return candidate.isNullGrid() ||
+                   (candidate.type() == type &&
+                    isPointInExtent(x, y, candidate.extentAndRes()));
+        });
+    if (!grid || grid->isNullGrid()) {
+        return grid;
+    }
+    return grid->gridAt(x, y);
+}
+
+// ---------------------------------------------------------------------------
+
+void GenericShiftGridSet::buildIndex() {
+    m_gridsIndex = GridExtentIndex::create(m_grids, 0);
     for (const auto &grid : m_grids) {
-        if (grid->isNullGrid()) {
-            return grid.get();
-        }
-        if (grid->type() != type) {
-            continue;
-        }
-        const auto &extent = grid->extentAndRes();
-        if (isPointInExtent(x, y, extent)) {
-            return grid->gridAt(x, y);
-        }
+        grid->buildIndex();
     }
-    return nullptr;
 }
 
 // ---------------------------------------------------------------------------
@@ -3321,11 +4101,11 @@ typedef struct {
     int32_t lam, phi;
 } ILP;
 
-// Apply bilinear interpolation for horizontal shift grids
-static PJ_LP pj_hgrid_interpolate(PJ_LP t, const HorizontalShiftGrid *grid,
-                                  bool compensateNTConvention) {
-    PJ_LP val, frct;
-    ILP indx;
+// Compute the lower-left node of the cell of the grid that contains t,
+// expressed relatively to the lower-left corner of the grid, and the
+// position of t in that cell. Returns false if t is outside of the grid.
+static bool pj_hgrid_cell(PJ_LP t, const HorizontalShiftGrid *grid, ILP &indx,
+                          PJ_LP &frct) {
     int in;
 
     const auto &extent = grid->extentAndRes();
@@ -3336,49 +4116,42 @@ static PJ_LP pj_hgrid_interpolate(PJ_LP t, const HorizontalShiftGrid *grid,
 
     frct.lam = t.lam - indx.lam;
     frct.phi = t.phi - indx.phi;
-    val.lam = val.phi = HUGE_VAL;
     if (indx.lam < 0) {
         if (indx.lam == -1 && frct.lam > 1 - 10 * REL_TOLERANCE_HGRIDSHIFT) {
             ++indx.lam;
             frct.lam = 0.;
         } else
-            return val;
+            return false;
     } else if ((in = indx.lam + 1) >= grid->width()) {
         if (in == grid->width() && frct.lam < 10 * REL_TOLERANCE_HGRIDSHIFT) {
             --indx.lam;
             frct.lam = 1.;
         } else
-            return val;
+            return false;
     }
     if (indx.phi < 0) {
         if (indx.phi == -1 && frct.phi > 1 - 10 * REL_TOLERANCE_HGRIDSHIFT) {
             ++indx.phi;
             frct.phi = 0.;
         } else
-            return val;
+            return false;
     } else if ((in = indx.phi + 1) >= grid->height()) {
         if (in == grid->height() && frct.phi < 10 * REL_TOLERANCE_HGRIDSHIFT) {
             --indx.phi;
             frct.phi = 1.;
         } else
-            return val;
-    }
-
-    float f00Long = 0, f00Lat = 0;
-    float f10Long = 0, f10Lat = 0;
-    float f01Long = 0, f01Lat = 0;
-    float f11Long = 0, f11Lat = 0;
-    if (!grid->valueAt(indx.lam, indx.phi, compensateNTConvention, f00Long,
-                       f00Lat) ||
-        !grid->valueAt(indx.lam + 1, indx.phi, compensateNTConvention, f10Long,
-                       f10Lat) ||
-        !grid->valueAt(indx.lam, indx.phi + 1, compensateNTConvention, f01Long,
-                       f01Lat) ||
-        !grid->valueAt(indx.lam + 1, indx.phi + 1, compensateNTConvention,
-                       f11Long, f11Lat)) {
-        return val;
+            return false;
     }
+    return true;
+}
+
+// ---------------------------------------------------------------------------
 
+// Bilinear interpolation of the shifts at the 4 nodes of a cell, stored as
+// lower-left, lower-right, upper-left, upper-right.
+static inline PJ_LP pj_hgrid_bilinear(PJ_LP frct, const float *longShift,
+                                      const float *latShift) {
+    PJ_LP val;
     double m10 = frct.lam;
     double m11 = m10;
     double m01 = 1. - frct.lam;
@@ -3388,13 +4161,52 @@ static PJ_LP pj_hgrid_interpolate(PJ_LP t, const HorizontalShiftGrid *grid,
     frct.phi = 1. - frct.phi;
     m00 *= frct.phi;
     m10 *= frct.phi;
-    val.lam = m00 * f00Long + m10 * f10Long + m01 * f01Long + m11 * f11Long;
-    val.phi = m00 * f00Lat + m10 * f10Lat + m01 * f01Lat + m11 * f11Lat;
+    val.lam = m00 * longShift[0] + m10 * longShift[1] + m01 * longShift[2] +
+              m11 * longShift[3];
+    val.phi = m00 * latShift[0] + m10 * latShift[1] + m01 * latShift[2] +
+              m11 * latShift[3];
     return val;
 }
 
 // ---------------------------------------------------------------------------
 
+// Apply bilinear interpolation for horizontal shift grids
+static PJ_LP pj_hgrid_interpolate(PJ_LP t, const HorizontalShiftGrid *grid,
+                                  bool compensateNTConvention) {
+    PJ_LP val, frct;
+    ILP indx;
+
+    val.lam = val.phi = HUGE_VAL;
+    if (!pj_hgrid_cell(t, grid, indx, frct))
+        return val;
+
+    float longShift[4];
+    float latShift[4];
+    if (!grid->valuesAt(indx.lam, indx.phi, 2, 2, compensateNTConvention,
+                        longShift, latShift)) {
+        return val;
+    }
+
+    return pj_hgrid_bilinear(frct, longShift, latShift);
+}
+
+// ---------------------------------------------------------------------------
+
+// Express lp relatively to the lower-left corner of the grid
+static PJ_LP pj_hgrid_normalize(PJ_LP lp, const ExtentAndRes &extent) {
+    const double epsilon =
+        (extent.resX + extent.resY) * REL_TOLERANCE_HGRIDSHIFT;
+    lp.lam -= extent.west;
+    if (lp.lam + epsilon < 0)
+        lp.lam += 2 * M_PI;
+    else if (lp.lam - epsilon > extent.east - extent.west)
+        lp.lam -= 2 * M_PI;
+    lp.phi -= extent.south;
+    return lp;
+}
+
+// ---------------------------------------------------------------------------
+
 #define MAX_ITERATIONS 10
 #define TOL 1e-12
 
@@ -3413,16 +4225,8 @@ static PJ_LP pj_hgrid_apply_internal(PJ_CONTEXT *ctx, PJ_LP in,
         return in;
 
     /* normalize input to ll origin */
-    tb = in;
     const auto *extent = &(grid->extentAndRes());
-    const double epsilon =
-        (extent->resX + extent->resY) * REL_TOLERANCE_HGRIDSHIFT;
-    tb.lam -= extent->west;
-    if (tb.lam + epsilon < 0)
-        tb.lam += 2 * M_PI;
-    else if (tb.lam - epsilon > extent->east - extent->west)
-        tb.lam -= 2 * M_PI;
-    tb.phi -= extent->south;
+    tb = pj_hgrid_normalize(in, *extent);
 
     t = pj_hgrid_interpolate(tb, grid, true);
     if (grid->hasChanged()) {
@@ -3463,13 +4267,7 @@ static PJ_LP pj_hgrid_apply_internal(PJ_CONTEXT *ctx, PJ_LP in,
             extent = &(grid->extentAndRes());
             t.lam = lp.lam - extent->west;
             t.phi = lp.phi - extent->south;
-            tb = in;
-            tb.lam -= extent->west;
-            if (tb.lam + epsilon < 0)
-                tb.lam += 2 * M_PI;
-            else if (tb.lam - epsilon > extent->east - extent->west)
-                tb.lam -= 2 * M_PI;
-            tb.phi -= extent->south;
+            tb = pj_hgrid_normalize(in, *extent);
             dif.lam = std::numeric_limits<double>::max();
             dif.phi = std::numeric_limits<double>::max();
             continue;
@@ -3537,6 +4335,134 @@ PJ_LP pj_hgrid_apply(PJ_CONTEXT *ctx, const ListOfHGrids &grids, PJ_LP lp,
     return out;
 }
 
+// ---------------------------------------------------------------------------
+
+static void pj_hgrid_apply_one(PJ_CONTEXT *ctx, const ListOfHGrids &grids,
+                               PJ_COORD &coo, int &err,
+                               PJ_DIRECTION direction) {
+    const int last_errno = proj_context_errno(ctx);
+    proj_context_errno_set(ctx, 0);
+    const PJ_LP lp = pj_hgrid_apply(ctx, grids, coo.lp, direction);
+    if (lp.lam == HUGE_VAL || proj_context_errno(ctx) != 0) {
+        err = proj_context_errno(ctx);
+        coo = proj_coord_error();
+    } else {
+        coo.lp = lp;
+    }
+    proj_context_errno_set(ctx, last_errno);
+}
+
+// ---------------------------------------------------------------------------
+
+void pj_hgrid_apply_array(PJ_CONTEXT *ctx, const ListOfHGrids &grids,
+                          PJ_COORD *coo, size_t n, int *err,
+                          PJ_DIRECTION direction) {
+    if (direction != PJ_FWD) {
+        // The inverse is iterative, and may switch of grid between
+        // iterations: process coordinates one at a time.
+        for (size_t i = 0; i < n; ++i) {
+            if (coo[i].v[0] != HUGE_VAL)
+                pj_hgrid_apply_one(ctx, grids, coo[i], err[i], direction);
+        }
+        return;
+    }
+
+    struct Item {
+        const HorizontalShiftGrid *grid;
+        HorizontalShiftGridSet *gridset;
+        ILP indx;
+        PJ_LP frct;
+        size_t idx;
+        bool ok;
+        float longShift[4];
+        float latShift[4];
+    };
+    std::vector<Item> items;
+    items.reserve(n);
+
+    const auto setError = [coo, err](size_t i) {
+        coo[i] = proj_coord_error();
+        err[i] = PROJ_ERR_COORD_TRANSFM_OUTSIDE_GRID;
+    };
+
+    // Locate the grid and the cell of each coordinate
+    for (size_t i = 0; i < n; ++i) {
+        if (coo[i].v[0] == HUGE_VAL)
+            continue;
+        Item item;
+        item.gridset = nullptr;
+        item.grid = findGrid(grids, coo[i].lp, item.gridset);
+        if (!item.grid) {
+            setError(i);
+            continue;
+        }
+        if (item.grid->isNullGrid())
+            continue;
+        const PJ_LP tb =
+            pj_hgrid_normalize(coo[i].lp, item.grid->extentAndRes());
+        if (!pj_hgrid_cell(tb, item.grid, item.indx, item.frct)) {
+            setError(i);
+            continue;
+        }
+        item.idx = i;
+        items.push_back(item);
+    }
+
+    // Read the nodes of each cell once, going through the cells of a grid
+    // in the order they are stored, which is the most favorable one for the
+    // block caches of the grids.
+    std::sort(items.begin(), items.end(), [](const Item &a, const Item &b) {
+        if (a.grid != b.grid)
+            return std::less<const HorizontalShiftGrid *>()(a.grid, b.grid);
+        if (a.indx.phi != b.indx.phi)
+            return a.indx.phi < b.indx.phi;
+        return a.indx.lam < b.indx.lam;
+    });
+    bool gridChanged = false;
+    for (size_t j = 0; j < items.size(); ++j) {
+        auto &item = items[j];
+        if (j > 0 && item.grid == items[j - 1].grid &&
+            item.indx.lam == items[j - 1].indx.lam &&
+            item.indx.phi == items[j - 1].indx.phi) {
+            item.ok = items[j - 1].ok;
+            memcpy(item.longShift, items[j - 1].longShift,
+                   sizeof(item.longShift));
+            memcpy(item.latShift, items[j - 1].latShift,
+                   sizeof(item.latShift));
+        } else {
+            item.ok = item.grid->valuesAt(item.indx.lam, item.indx.phi, 2, 2,
+                                          true, item.longShift,
+                                          item.latShift);
+        }
+        if (j + 1 == items.size() || items[j + 1].grid != item.grid) {
+            gridChanged |= item.grid->hasChanged();
+        }
+    }
+
+    if (gridChanged) {
+        // Let the per-coordinate code reopen the grids and retry
+        for (const auto &item : items) {
+            pj_hgrid_apply_one(ctx, grids, coo[item.idx], err[item.idx],
+                               direction);
+        }
+        return;
+    }
+
+    for (const auto &item : items) {
+        if (!item.ok) {
+            setError(item.idx);
+            continue;
+        }
+        const PJ_LP t =
+            pj_hgrid_bilinear(item.frct, item.longShift, item.latShift);
+        auto &lp = coo[item.idx].lp;
+        lp.lam += t.lam;
+        lp.phi += t.phi;
+        if (lp.lam == HUGE_VAL || lp.phi == HUGE_VAL)
+            setError(item.idx);
+    }
+}
+
 /********************************************/
 /*           proj_hgrid_value()             */
 /*                                          */
@@ -3589,39 +4515,42 @@ PJ_LP pj_hgrid_value(PJ *P, const ListOfHGrids &grids, PJ_LP lp) {
 
 // ---------------------------------------------------------------------------
 
-static double read_vgrid_value(PJ_CONTEXT *ctx, const ListOfVGrids &grids,
-                               const PJ_LP &input, const double vmultiplier) {
+// Location of a coordinate in a vertical shift grid
+struct VGridCell {
+    int ix;
+    int iy;
+    int ix2;
+    int iy2;
+    double x; // position in the cell, in [0,1[ range
+    double y; // position in the cell, in [0,1[ range
+};
 
-    /* do not deal with NaN coordinates */
-    /* cppcheck-suppress duplicateExpression */
-    if (std::isnan(input.phi) || std::isnan(input.lam)) {
-        return HUGE_VAL;
-    }
+// ---------------------------------------------------------------------------
 
-    VerticalShiftGridSet *curGridset = nullptr;
-    const VerticalShiftGrid *grid = nullptr;
+static const VerticalShiftGrid *findVGrid(const ListOfVGrids &grids,
+                                          const PJ_LP &input,
+                                          VerticalShiftGridSet *&gridSetOut) {
     for (const auto &gridset : grids) {
-        grid = gridset->gridAt(input.lam, input.phi);
+        auto grid = gridset->gridAt(input.lam, input.phi);
         if (grid) {
-            curGridset = gridset.get();
-            break;
+            gridSetOut = gridset.get();
+            return grid;
         }
     }
-    if (!grid) {
-        proj_context_errno_set(ctx, PROJ_ERR_COORD_TRANSFM_OUTSIDE_GRID);
-        return HUGE_VAL;
-    }
-    if (grid->isNullGrid()) {
-        return 0;
-    }
+    return nullptr;
+}
+
+// ---------------------------------------------------------------------------
 
+static bool pj_vgrid_cell(PJ_CONTEXT *ctx, const VerticalShiftGrid *grid,
+                          const PJ_LP &input, VGridCell &cell) {
     const auto &extent = grid->extentAndRes();
     if (!extent.isGeographic) {
         pj_log(ctx, PJ_LOG_ERROR,
                _("Can only handle grids referenced in a geographic CRS"));
         proj_context_errno_set(ctx,
                                PROJ_ERR_INVALID_OP_FILE_NOT_FOUND_OR_INVALID);
-        return HUGE_VAL;
+        return false;
     }
 
     /* Interpolation of a location within the grid */
@@ -3653,7 +4582,7 @@ static double read_vgrid_value(PJ_CONTEXT *ctx, const ListOfVGrids &grids,
         // in the unlikely case we end up here...
         pj_log(ctx, PJ_LOG_ERROR, _("grid_ix not in grid"));
         proj_context_errno_set(ctx, PROJ_ERR_COORD_TRANSFM_OUTSIDE_GRID);
-        return HUGE_VAL;
+        return false;
     }
     int grid_iy = static_cast<int>(lround(floor(grid_y)));
     assert(grid_iy >= 0 && grid_iy < grid->height());
@@ -3672,24 +4601,42 @@ static double read_vgrid_value(PJ_CONTEXT *ctx, const ListOfVGrids &grids,
     if (grid_iy2 >= grid->height())
         grid_iy2 = grid->height() - 1;
 
-    float value_a = 0;
-    float value_b = 0;
-    float value_c = 0;
-    float value_d = 0;
-    bool error = (!grid->valueAt(grid_ix, grid_iy, value_a) ||
-                  !grid->valueAt(grid_ix2, grid_iy, value_b) ||
-                  !grid->valueAt(grid_ix, grid_iy2, value_c) ||
-                  !grid->valueAt(grid_ix2, grid_iy2, value_d));
-    if (grid->hasChanged()) {
-        if (curGridset->reopen(ctx)) {
-            return read_vgrid_value(ctx, grids, input, vmultiplier);
-        }
-        error = true;
-    }
+    cell.ix = grid_ix;
+    cell.iy = grid_iy;
+    cell.ix2 = grid_ix2;
+    cell.iy2 = grid_iy2;
+    cell.x = grid_x;
+    cell.y = grid_y;
+    return true;
+}
 
-    if (error) {
-        return HUGE_VAL;
-    }
+// ---------------------------------------------------------------------------
+
+// Read the values at the 4 nodes of the cell, stored as lower-left,
+// lower-right, upper-left, upper-right.
+static bool pj_vgrid_cell_values(const VerticalShiftGrid *grid,
+                                 const VGridCell &cell, float *values) {
+    if (cell.ix2 == cell.ix + 1 && cell.iy2 == cell.iy + 1) {
+        return grid->valuesAt(cell.ix, cell.iy, 2, 2, values);
+    }
+    return grid->valueAt(cell.ix, cell.iy, values[0]) &&
+           grid->valueAt(cell.ix2, cell.iy, values[1]) &&
+           grid->valueAt(cell.ix, cell.iy2, values[2]) &&
+           grid->valueAt(cell.ix2, cell.iy2, values[3]);
+}
+
+// ---------------------------------------------------------------------------
+
+static double pj_vgrid_interpolate(PJ_CONTEXT *ctx,
+                                   const VerticalShiftGrid *grid,
+                                   const VGridCell &cell, const float *values,
+                                   const double vmultiplier) {
+    const double grid_x = cell.x;
+    const double grid_y = cell.y;
+    const float value_a = values[0];
+    const float value_b = values[1];
+    const float value_c = values[2];
+    const float value_d = values[3];
 
     double value = 0.0;
 
@@ -3749,6 +4696,48 @@ static double read_vgrid_value(PJ_CONTEXT *ctx, const ListOfVGrids &grids,
     return value * vmultiplier;
 }
 
+// ---------------------------------------------------------------------------
+
+static double read_vgrid_value(PJ_CONTEXT *ctx, const ListOfVGrids &grids,
+                               const PJ_LP &input, const double vmultiplier) {
+
+    /* do not deal with NaN coordinates */
+    /* cppcheck-suppress duplicateExpression */
+    if (std::isnan(input.phi) || std::isnan(input.lam)) {
+        return HUGE_VAL;
+    }
+
+    VerticalShiftGridSet *curGridset = nullptr;
+    const VerticalShiftGrid *grid = findVGrid(grids, input, curGridset);
+    if (!grid) {
+        proj_context_errno_set(ctx, PROJ_ERR_COORD_TRANSFM_OUTSIDE_GRID);
+        return HUGE_VAL;
+    }
+    if (grid->isNullGrid()) {
+        return 0;
+    }
+
+    VGridCell cell;
+    if (!pj_vgrid_cell(ctx, grid, input, cell)) {
+        return HUGE_VAL;
+    }
+
+    float values[4] = {0, 0, 0, 0};
+    bool error = !pj_vgrid_cell_values(grid, cell, values);
+    if (grid->hasChanged()) {
+        if (curGridset->reopen(ctx)) {
+            return read_vgrid_value(ctx, grids, input, vmultiplier);
+        }
+        error = true;
+    }
+
+    if (error) {
+        return HUGE_VAL;
+    }
+
+    return pj_vgrid_interpolate(ctx, grid, cell, values, vmultiplier);
+}
+
 /**********************************************/
 ListOfVGrids pj_vgrid_init(PJ *P, const char *gridkey) {
     /**********************************************
@@ -3824,6 +4813,122 @@ double pj_vgrid_value(PJ *P, const ListOfVGrids &grids, PJ_LP lp,
 
 // ---------------------------------------------------------------------------
 
+static void pj_vgrid_value_one(PJ *P, const ListOfVGrids &grids,
+                               const PJ_COORD &coo, double vmultiplier,
+                               double &value, int &err) {
+    const int last_errno = proj_context_errno(P->ctx);
+    proj_context_errno_set(P->ctx, 0);
+    value = pj_vgrid_value(P, grids, coo.lp, vmultiplier);
+    if (proj_context_errno(P->ctx) != 0)
+        err = proj_context_errno(P->ctx);
+    proj_context_errno_set(P->ctx, last_errno);
+}
+
+// ---------------------------------------------------------------------------
+
+void pj_vgrid_value_array(PJ *P, const ListOfVGrids &grids,
+                          const PJ_COORD *coo, size_t n, double vmultiplier,
+                          double *values, int *err) {
+    if (pj_log_active(P->ctx, PJ_LOG_TRACE)) {
+        for (size_t i = 0; i < n; ++i) {
+            if (coo[i].v[0] != HUGE_VAL)
+                pj_vgrid_value_one(P, grids, coo[i], vmultiplier, values[i],
+                                   err[i]);
+        }
+        return;
+    }
+
+    struct Item {
+        const VerticalShiftGrid *grid;
+        VGridCell cell;
+        size_t idx;
+        bool ok;
+        float values[4];
+    };
+    std::vector<Item> items;
+    items.reserve(n);
+
+    const int last_errno = proj_context_errno(P->ctx);
+
+    // Locate the grid and the cell of each coordinate
+    for (size_t i = 0; i < n; ++i) {
+        if (coo[i].v[0] == HUGE_VAL)
+            continue;
+        const PJ_LP &lp = coo[i].lp;
+        values[i] = HUGE_VAL;
+        /* do not deal with NaN coordinates */
+        /* cppcheck-suppress duplicateExpression */
+        if (std::isnan(lp.phi) || std::isnan(lp.lam))
+            continue;
+        Item item;
+        VerticalShiftGridSet *gridset = nullptr;
+        item.grid = findVGrid(grids, lp, gridset);
+        if (!item.grid) {
+            err[i] = PROJ_ERR_COORD_TRANSFM_OUTSIDE_GRID;
+            continue;
+        }
+        if (item.grid->isNullGrid()) {
+            values[i] = 0;
+            continue;
+        }
+        proj_context_errno_set(P->ctx, 0);
+        if (!pj_vgrid_cell(P->ctx, item.grid, lp, item.cell)) {
+            err[i] = proj_context_errno(P->ctx);
+            continue;
+        }
+        item.idx = i;
+        items.push_back(item);
+    }
+
+    // Read the nodes of each cell once, going through the cells of a grid
+    // in the order they are stored.
+    std::sort(items.begin(), items.end(), [](const Item &a, const Item &b) {
+        if (a.grid != b.grid)
+            return std::less<const VerticalShiftGrid *>()(a.grid, b.grid);
+        if (a.cell.iy != b.cell.iy)
+            return a.cell.iy < b.cell.iy;
+        return a.cell.ix < b.cell.ix;
+    });
+    bool gridChanged = false;
+    for (size_t j = 0; j < items.size(); ++j) {
+        auto &item = items[j];
+        if (j > 0 && item.grid == items[j - 1].grid &&
+            item.cell.ix == items[j - 1].cell.ix &&
+            item.cell.iy == items[j - 1].cell.iy) {
+            item.ok = items[j - 1].ok;
+            memcpy(item.values, items[j - 1].values, sizeof(item.values));
+        } else {
+            item.ok = pj_vgrid_cell_values(item.grid, item.cell, item.values);
+        }
+        if (j + 1 == items.size() || items[j + 1].grid != item.grid) {
+            gridChanged |= item.grid->hasChanged();
+        }
+    }
+
+    if (gridChanged) {
+        // Let the per-coordinate code reopen the grids and retry
+        proj_context_errno_set(P->ctx, last_errno);
+        for (const auto &item : items) {
+            pj_vgrid_value_one(P, grids, coo[item.idx], vmultiplier,
+                               values[item.idx], err[item.idx]);
+        }
+        return;
+    }
+
+    for (const auto &item : items) {
+        if (!item.ok)
+            continue;
+        proj_context_errno_set(P->ctx, 0);
+        values[item.idx] = pj_vgrid_interpolate(P->ctx, item.grid, item.cell,
+                                                item.values, vmultiplier);
+        if (proj_context_errno(P->ctx) != 0)
+            err[item.idx] = proj_context_errno(P->ctx);
+    }
+    proj_context_errno_set(P->ctx, last_errno);
+}
+
+// ---------------------------------------------------------------------------
+
 const GenericShiftGrid *pj_find_generic_grid(const ListOfGenericGrids &grids,
                                              const PJ_LP &input,
                                              GenericShiftGridSet *&gridSetOut) {
@@ -3921,8 +5026,169 @@ bool pj_bilinear_interpolation_three_samples(
     return true;
 }
 
+// ---------------------------------------------------------------------------
+
+void pj_clear_grid_block_cache() { getSharedBlockCache().clear(); }
+
 NS_PROJ_END
 
+// ---------------------------------------------------------------------------
+
+/** Set the maximum size of the in-memory cache of decoded blocks of
+ * GeoTIFF grids.
+ *
+ * This cache is shared by all contexts and threads of the process, so the
+ * setting applies to all of them. Its default size is 64 MB, unless
+ * overridden with the PROJ_GRID_BLOCK_CACHE_MAX_SIZE_MB environment variable.
+ *
+ * @param ctx PROJ context, or NULL
+ * @param max_size_MB Maximum size, in mega-bytes (1024*1024 bytes), 0 to
+ *                    disable the cache, or negative value to set unlimited
+ *                    size.
+ * @since 9.8
+ */
+void proj_grid_block_cache_set_max_size(PJ_CONTEXT *ctx, int max_size_MB) {
+    (void)ctx;
+    NS_PROJ::getSharedBlockCache().setMaxSize(
+        max_size_MB < 0
+            ? std::numeric_limits<unsigned long long>::max()
+            : static_cast<unsigned long long>(max_size_MB) * 1024 * 1024);
+}
+
+// ---------------------------------------------------------------------------
+
+/** Return statistics on the use of the in-memory cache of decoded blocks of
+ * GeoTIFF grids, since the start of the process.
+ *
+ * @param ctx PROJ context, or NULL
+ * @param out_hits Pointer to the number of blocks found in the cache, or NULL
+ * @param out_misses Pointer to the number of blocks that had to be read and
+ *                   decoded, or NULL
+ * @param out_evictions Pointer to the number of blocks evicted from the cache
+ *                      to respect its maximum size, or NULL
+ * @since 9.8
+ */
+void proj_grid_block_cache_get_stats(PJ_CONTEXT *ctx,
+                                     unsigned long long *out_hits,
+                                     unsigned long long *out_misses,
+                                     unsigned long long *out_evictions) {
+    (void)ctx;
+    unsigned long long hits = 0;
+    unsigned long long misses = 0;
+    unsigned long long evictions = 0;
+    NS_PROJ::getSharedBlockCache().getStats(hits, misses, evictions);
+    if (out_hits)
+        *out_hits = hits;
+    if (out_misses)
+        *out_misses = misses;
+    if (out_evictions)
+        *out_evictions = evictions;
+}
+
+// ---------------------------------------------------------------------------
+
+/** Download the parts of a remote GeoTIFF grid needed to transform
+ * coordinates in an area.
+ *
+ * The blocks of the grid (and of its subgrids) that intersect the area are
+ * downloaded with up to max_parallel_requests concurrent range requests,
+ * and stored in the cache of network chunks, so that later transformations
+ * in that area do not wait for the network. All the blocks of grids in a
+ * projected CRS are downloaded.
+ *
+ * Networking must be enabled. When max_parallel_requests is greater than 1,
+ * the network callbacks are called concurrently from several threads, with
+ * a different context and handle for each thread.
+ * Only 1 MB of chunks is retained in memory, so the disk cache
+ * (see proj_grid_cache_set_enable()) should be enabled to prefetch larger
+ * parts of grids.
+ *
+ * @param ctx PROJ context, or NULL
+ * @param grid_name Grid name (e.g. as returned by
+ *                  proj_coordoperation_get_grid_used()), or URL.
+ * @param west_lon_degree West-most longitude of the area, in degrees.
+ * @param south_lat_degree South-most latitude of the area, in degrees.
+ * @param east_lon_degree East-most longitude of the area, in degrees. It
+ *                        may be lower than west_lon_degree for an area
+ *                        crossing the antimeridian.
+ * @param north_lat_degree North-most latitude of the area, in degrees.
+ * @param max_parallel_requests Maximum number of concurrent requests, or 0
+ *                              for the default (4).
+ * @return TRUE if the needed parts of the grid are available (including if
+ *         it is a local file), FALSE otherwise.
+ * @since 9.8
+ */
+int proj_grid_prefetch_for_area(PJ_CONTEXT *ctx, const char *grid_name,
+                                double west_lon_degree,
+                                double south_lat_degree,
+                                double east_lon_degree,
+                                double north_lat_degree,
+                                int max_parallel_requests) {
+    if (ctx == nullptr) {
+        ctx = pj_get_default_ctx();
+    }
+    if (grid_name == nullptr) {
+        pj_log(ctx, PJ_LOG_ERROR, "%s: missing required input", __FUNCTION__);
+        proj_context_errno_set(ctx, PROJ_ERR_OTHER_API_MISUSE);
+        return false;
+    }
+    auto fp = NS_PROJ::FileManager::open_resource_file(ctx, grid_name);
+    if (!fp) {
+        return false;
+    }
+    const std::string name(fp->name());
+    if (!NS_PROJ::internal::starts_with(name, "http://") &&
+        !NS_PROJ::internal::starts_with(name, "https://")) {
+        // Nothing to download
+        return true;
+    }
+
+    unsigned char header[4];
+    const size_t header_size = fp->read(header, sizeof(header));
+    fp->seek(0);
+    if (!NS_PROJ::IsTIFF(header_size, header)) {
+        pj_log(ctx, PJ_LOG_ERROR, "%s is not a GeoTIFF grid", name.c_str());
+        return false;
+    }
+#ifdef TIFF_ENABLED
+    NS_PROJ::GTiffDataset dataset(ctx, std::move(fp));
+    if (!dataset.openTIFF(name)) {
+        return false;
+    }
+
+    const double west = west_lon_degree * DEG_TO_RAD;
+    const double south = south_lat_degree * DEG_TO_RAD;
+    double east = east_lon_degree * DEG_TO_RAD;
+    const double north = north_lat_degree * DEG_TO_RAD;
+    if (east < west) {
+        east += 2 * M_PI;
+    }
+
+    std::vector<std::pair<unsigned long long, unsigned long long>> ranges;
+    while (true) {
+        auto grid = dataset.nextGrid();
+        if (!grid)
+            break;
+        const auto subfileType = grid->subfileType();
+        // Overviews are not used
+        if (subfileType != 0 && subfileType != FILETYPE_PAGE)
+            continue;
+        grid->collectBlockRanges(west, south, east, north, ranges);
+    }
+    return NS_PROJ::pj_network_file_prefetch(ctx, name, ranges,
+                                             max_parallel_requests);
+#else
+    (void)west_lon_degree;
+    (void)south_lat_degree;
+    (void)east_lon_degree;
+    (void)north_lat_degree;
+    (void)max_parallel_requests;
+    pj_log(ctx, PJ_LOG_ERROR,
+           _("TIFF grid, but TIFF support disabled in this build"));
+    return false;
+#endif
+}
+
 /*****************************************************************************/
 PJ_GRID_INFO proj_grid_info(const char *gridname) {
     /******************************************************************************
@@ -57,6 +57,10 @@ struct ExtentAndRes {
 
 // ---------------------------------------------------------------------------
 
+class GridExtentIndex;
+
+// ---------------------------------------------------------------------------
+
 class PROJ_GCC_DLL Grid {
   protected:
     friend class GTiffDataset;
@@ -88,6 +92,7 @@ class PROJ_GCC_DLL Grid {
 class PROJ_GCC_DLL VerticalShiftGrid : public Grid {
   protected:
     std::vector<std::unique_ptr<VerticalShiftGrid>> m_children{};
+    std::unique_ptr<GridExtentIndex> m_childrenIndex{};
 
   public:
     PROJ_FOR_TEST VerticalShiftGrid(const std::string &nameIn, int widthIn,
@@ -103,6 +108,14 @@ class PROJ_GCC_DLL VerticalShiftGrid : public Grid {
     // x = 0 is western-most column, y = 0 is southern-most line
     PROJ_FOR_TEST virtual bool valueAt(int x, int y, float &out) const = 0;
 
+    // Values of the x_count * y_count nodes starting at (x_start, y_start),
+    // stored line after line in out.
+    PROJ_FOR_TEST virtual bool valuesAt(int x_start, int y_start, int x_count,
+                                        int y_count, float *out) const;
+
+    // Build the index of m_children, recursively.
+    void buildIndex();
+
     PROJ_FOR_TEST virtual void reassign_context(PJ_CONTEXT *ctx) = 0;
 };
 
@@ -113,6 +126,7 @@ class PROJ_GCC_DLL VerticalShiftGridSet {
     std::string m_name{};
     std::string m_format{};
     std::vector<std::unique_ptr<VerticalShiftGrid>> m_grids{};
+    std::unique_ptr<GridExtentIndex> m_gridsIndex{};
 
     VerticalShiftGridSet();
 
@@ -131,6 +145,9 @@ class PROJ_GCC_DLL VerticalShiftGridSet {
     PROJ_FOR_TEST const VerticalShiftGrid *gridAt(double longitude,
                                                   double lat) const;
 
+    // Build the index of m_grids and of their children.
+    void buildIndex();
+
     PROJ_FOR_TEST virtual void reassign_context(PJ_CONTEXT *ctx);
     PROJ_FOR_TEST virtual bool reopen(PJ_CONTEXT *ctx);
 };
@@ -140,6 +157,7 @@ class PROJ_GCC_DLL VerticalShiftGridSet {
 class PROJ_GCC_DLL HorizontalShiftGrid : public Grid {
   protected:
     std::vector<std::unique_ptr<HorizontalShiftGrid>> m_children{};
+    std::unique_ptr<GridExtentIndex> m_childrenIndex{};
 
   public:
     PROJ_FOR_TEST HorizontalShiftGrid(const std::string &nameIn, int widthIn,
@@ -156,6 +174,17 @@ class PROJ_GCC_DLL HorizontalShiftGrid : public Grid {
                                        float &longShift,
                                        float &latShift) const = 0;
 
+    // Shifts of the x_count * y_count nodes starting at (x_start, y_start),
+    // stored line after line in longShift and latShift.
+    PROJ_FOR_TEST virtual bool valuesAt(int x_start, int y_start, int x_count,
+                                        int y_count,
+                                        bool compensateNTConvention,
+                                        float *longShift,
+                                        float *latShift) const;
+
+    // Build the index of m_children, recursively.
+    void buildIndex();
+
     PROJ_FOR_TEST virtual void reassign_context(PJ_CONTEXT *ctx) = 0;
 };
 
@@ -166,6 +195,7 @@ class PROJ_GCC_DLL HorizontalShiftGridSet {
     std::string m_name{};
     std::string m_format{};
     std::vector<std::unique_ptr<HorizontalShiftGrid>> m_grids{};
+    std::unique_ptr<GridExtentIndex> m_gridsIndex{};
 
     HorizontalShiftGridSet();
 
@@ -184,6 +214,9 @@ class PROJ_GCC_DLL HorizontalShiftGridSet {
     PROJ_FOR_TEST const HorizontalShiftGrid *gridAt(double longitude,
                                                     double lat) const;
 
+    // Build the index of m_grids and of their children.
+    void buildIndex();
+
     PROJ_FOR_TEST virtual void reassign_context(PJ_CONTEXT *ctx);
     PROJ_FOR_TEST virtual bool reopen(PJ_CONTEXT *ctx);
 };
@@ -193,6 +226,7 @@ class PROJ_GCC_DLL HorizontalShiftGridSet {
 class PROJ_GCC_DLL GenericShiftGrid : public Grid {
   protected:
     std::vector<std::unique_ptr<GenericShiftGrid>> m_children{};
+    std::unique_ptr<GridExtentIndex> m_childrenIndex{};
 
   public:
     PROJ_FOR_TEST GenericShiftGrid(const std::string &nameIn, int widthIn,
@@ -219,6 +253,9 @@ class PROJ_GCC_DLL GenericShiftGrid : public Grid {
                                         const int *sample_idx, float *out,
                                         bool &nodataFound) const;
 
+    // Build the index of m_children, recursively.
+    void buildIndex();
+
     PROJ_FOR_TEST virtual void reassign_context(PJ_CONTEXT *ctx) = 0;
 };
 
@@ -229,6 +266,7 @@ class PROJ_GCC_DLL GenericShiftGridSet {
     std::string m_name{};
     std::string m_format{};
     std::vector<std::unique_ptr<GenericShiftGrid>> m_grids{};
+    std::unique_ptr<GridExtentIndex> m_gridsIndex{};
 
     GenericShiftGridSet();
 
@@ -248,6 +286,9 @@ class PROJ_GCC_DLL GenericShiftGridSet {
     PROJ_FOR_TEST const GenericShiftGrid *gridAt(const std::string &type,
                                                  double x, double y) const;
 
+    // Build the index of m_grids and of their children.
+    void buildIndex();
+
     PROJ_FOR_TEST virtual void reassign_context(PJ_CONTEXT *ctx);
     PROJ_FOR_TEST virtual bool reopen(PJ_CONTEXT *ctx);
 };
@@ -268,6 +309,17 @@ double pj_vgrid_value(PJ *P, const ListOfVGrids &, PJ_LP lp,
 PJ_LP pj_hgrid_apply(PJ_CONTEXT *ctx, const ListOfHGrids &grids, PJ_LP lp,
                      PJ_DIRECTION direction);
 
+// Batched versions of pj_hgrid_apply() and pj_vgrid_value(), following the
+// conventions of PJ_ARRAY_OPERATOR: coordinates whose x is HUGE_VAL are
+// skipped, and the error code of the ones that fail is set in err.
+void pj_hgrid_apply_array(PJ_CONTEXT *ctx, const ListOfHGrids &grids,
+                          PJ_COORD *coo, size_t n, int *err,
+                          PJ_DIRECTION direction);
+// values[i] is set to HUGE_VAL for coordinates that fail.
+void pj_vgrid_value_array(PJ *P, const ListOfVGrids &grids,
+                          const PJ_COORD *coo, size_t n, double vmultiplier,
+                          double *values, int *err);
+
 const GenericShiftGrid *pj_find_generic_grid(const ListOfGenericGrids &grids,
                                              const PJ_LP &input,
                                              GenericShiftGridSet *&gridSetOut);
@@ -275,6 +327,8 @@ bool pj_bilinear_interpolation_three_samples(
     PJ_CONTEXT *ctx, const GenericShiftGrid *grid, const PJ_LP &lp, int idx1,
     int idx2, int idx3, double &v1, double &v2, double &v3, bool &must_retry);
 
+void pj_clear_grid_block_cache();
+
 NS_PROJ_END
 
 #endif // GRIDS_HPP_INCLUDED
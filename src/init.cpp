@@ -33,6 +33,9 @@
 #include <stdio.h>
 #include <string.h>
 
+#include <algorithm>
+#include <vector>
+
 #include "filemanager.hpp"
 #include "geodesic.h"
 #include "proj.h"
@@ -420,15 +423,27 @@ paralist *pj_expand_init(PJ_CONTEXT *ctx, paralist *init) {
 /************************************************************************/
 
 static PJ_CONSTRUCTOR locate_constructor(const char *name) {
-    int i;
-    const char *s;
-    const PJ_OPERATIONS *operations;
-    operations = proj_list_operations();
-    for (i = 0; (s = operations[i].id) && strcmp(name, s); ++i)
-        ;
-    if (nullptr == s)
+    // proj_list_operations() is only roughly in alphabetical order, so build
+    // once a sorted index of it for binary searches.
+    // C++11 rules guarantee a thread-safe instantiation.
+    static const std::vector<const PJ_OPERATIONS *> sortedOperations = []() {
+        std::vector<const PJ_OPERATIONS *> res;
+        for (const PJ_OPERATIONS *op = proj_list_operations(); op->id; ++op)
+            res.push_back(op);
+        std::stable_sort(res.begin(), res.end(),
+                         [](const PJ_OPERATIONS *a, const PJ_OPERATIONS *b) {
+                             return strcmp(a->id, b->id) < 0;
+                         });
+        return res;
+    }();
+    const auto iter = std::lower_bound(
+        sortedOperations.begin(), sortedOperations.end(), name,
+        [](const PJ_OPERATIONS *op, const char *key) {
+            return strcmp(op->id, key) < 0;
+        });
+    if (iter == sortedOperations.end() || strcmp((*iter)->id, name) != 0)
         return nullptr;
-    return (PJ_CONSTRUCTOR)operations[i].proj;
+    return (PJ_CONSTRUCTOR)(*iter)->proj;
 }
 
 PJ *pj_init_ctx_with_allow_init_epsg(PJ_CONTEXT *ctx, int argc, char **argv,
@@ -548,6 +563,9 @@ PJ *pj_init_ctx_with_allow_init_epsg(PJ_CONTEXT *ctx, int argc, char **argv,
 
     PIN->ctx = ctx;
     PIN->params = start;
+
+    /* From now on, look up the parameters through a hashed index */
+    PJParamIndex paramIndex(ctx, start);
     PIN->is_latlong = 0;
     PIN->is_geocent = 0;
     PIN->is_long_wrap_set = 0;
@@ -28,13 +28,43 @@
 #include <assert.h>
 #include <string.h>
 
+#include <memory>
+#include <mutex>
+#include <shared_mutex>
+#include <string>
+#include <unordered_map>
+
 #include "proj.h"
 #include "proj_internal.h"
 
-static int cache_count = 0;
-static int cache_alloc = 0;
-static char **cache_key = nullptr;
-static paralist **cache_paralist = nullptr;
+namespace {
+
+/* Immutable parameter list of a cached definition. Lookups share it and
+ * clone it without holding the cache lock. */
+struct InitCacheEntry {
+    paralist *list = nullptr;
+
+    explicit InitCacheEntry(paralist *listIn) : list(listIn) {}
+    ~InitCacheEntry() {
+        paralist *n;
+        for (paralist *t = list; t != nullptr; t = n) {
+            n = t->next;
+            free(t);
+        }
+    }
+    InitCacheEntry(const InitCacheEntry &) = delete;
+    InitCacheEntry &operator=(const InitCacheEntry &) = delete;
+};
+
+using InitCacheMap =
+    std::unordered_map<std::string, std::shared_ptr<const InitCacheEntry>>;
+
+} // namespace
+
+/* Lookups only take a shared lock, instead of the process-wide
+ * pj_acquire_lock(), so that they do not serialize threads. */
+static std::shared_mutex gInitCacheMutex{};
+static InitCacheMap gInitCache{};
 
 /************************************************************************/
 /*                            pj_clone_paralist()                       */
@@ -72,31 +102,10 @@ paralist *pj_clone_paralist(const paralist *list) {
 /************************************************************************/
 
 void pj_clear_initcache() {
-    if (cache_alloc > 0) {
-        int i;
-
-        pj_acquire_lock();
-
-        for (i = 0; i < cache_count; i++) {
-            paralist *n, *t = cache_paralist[i];
-
-            free(cache_key[i]);
-
-            /* free parameter list elements */
-            for (; t != nullptr; t = n) {
-                n = t->next;
-                free(t);
-            }
-        }
-
-        free(cache_key);
-        free(cache_paralist);
-        cache_count = 0;
-        cache_alloc = 0;
-        cache_key = nullptr;
-        cache_paralist = nullptr;
-
-        pj_release_lock();
+    InitCacheMap oldCache;
+    {
+        std::unique_lock<std::shared_mutex> lock(gInitCacheMutex);
+        oldCache.swap(gInitCache);
     }
 }
 
@@ -109,20 +118,16 @@ void pj_clear_initcache() {
 paralist *pj_search_initcache(const char *filekey)
 
 {
-    int i;
-    paralist *result = nullptr;
-
-    pj_acquire_lock();
-
-    for (i = 0; result == nullptr && i < cache_count; i++) {
-        if (strcmp(filekey, cache_key[i]) == 0) {
-            result = pj_clone_paralist(cache_paralist[i]);
-        }
+    std::shared_ptr<const InitCacheEntry> entry;
+    {
+        std::shared_lock<std::shared_mutex> lock(gInitCacheMutex);
+        auto iter = gInitCache.find(filekey);
+        if (iter == gInitCache.end())
+            return nullptr;
+        entry = iter->second;
     }
 
-    pj_release_lock();
-
-    return result;
+    return pj_clone_paralist(entry->list);
 }
 
 /************************************************************************/
@@ -134,46 +139,14 @@ paralist *pj_search_initcache(const char *filekey)
 void pj_insert_initcache(const char *filekey, const paralist *list)
 
 {
-    pj_acquire_lock();
-
     /*
-    ** Grow list if required.
+    ** Duplicate the filekey and paralist, and insert in cache. If another
+    ** thread inserted the same key meanwhile, its definition is kept.
     */
-    if (cache_count == cache_alloc) {
-        char **cache_key_new;
-        paralist **cache_paralist_new;
-
-        cache_alloc = cache_alloc * 2 + 15;
-
-        cache_key_new = (char **)malloc(sizeof(char *) * cache_alloc);
-        assert(cache_key_new);
-        if (cache_key && cache_count) {
-            memcpy(cache_key_new, cache_key, sizeof(char *) * cache_count);
-        }
-        free(cache_key);
-        cache_key = cache_key_new;
-
-        cache_paralist_new =
-            (paralist **)malloc(sizeof(paralist *) * cache_alloc);
-        assert(cache_paralist_new);
-        if (cache_paralist && cache_count) {
-            memcpy(cache_paralist_new, cache_paralist,
-                   sizeof(paralist *) * cache_count);
-        }
-        free(cache_paralist);
-        cache_paralist = cache_paralist_new;
-    }
-
-    /*
-    ** Duplicate the filekey and paralist, and insert in cache.
-    */
-    cache_key[cache_count] = (char *)malloc(strlen(filekey) + 1);
-    assert(cache_key[cache_count]);
-    strcpy(cache_key[cache_count], filekey);
-
-    cache_paralist[cache_count] = pj_clone_paralist(list);
-
-    cache_count++;
+    auto entry =
+        std::make_shared<const InitCacheEntry>(pj_clone_paralist(list));
+    std::string key(filekey);
 
-    pj_release_lock();
+    std::unique_lock<std::shared_mutex> lock(gInitCacheMutex);
+    gInitCache.emplace(std::move(key), std::move(entry));
 }
@@ -585,6 +585,285 @@ PJ *proj_clone(PJ_CONTEXT *ctx, const PJ *obj) {
 
 // ---------------------------------------------------------------------------
 
+//! @cond Doxygen_Suppress
+struct PJ_OPERATION_PLAN {
+    // What is needed to instantiate again a PJ, without going through the
+    // export of its ISO-19111 object.
+    struct Node {
+        BaseObjectPtr iso_obj{};
+        // Empty if the object cannot be exported as a PROJ string, in which
+        // case pj_obj_create() is used.
+        std::string projString{};
+        bool hasCoordinateEpoch = false;
+        double coordinateEpoch = 0;
+        int over = 0;
+        bool errorIfBestTransformationNotAvailable = false;
+        bool warnIfBestTransformationNotAvailable = true;
+        bool skipNonInstantiable = true;
+    };
+
+    struct Operation {
+        // Copy of the metadata of the alternative operation, without its
+        // PJ objects.
+        PJCoordOperation metadata;
+        Node pj{};
+        bool hasSrcGeocentricToLonLat = false;
+        Node pjSrcGeocentricToLonLat{};
+        bool hasDstGeocentricToLonLat = false;
+        Node pjDstGeocentricToLonLat{};
+
+        explicit Operation(const PJCoordOperation &op)
+            : metadata(op, nullptr, nullptr, nullptr) {}
+    };
+
+    // Used when there is no alternative operation
+    Node single{};
+    // Only used for the state flags when there are alternative operations
+    Node set{};
+    std::vector<Operation> operations{};
+
+    PJ_OPERATION_PLAN() = default;
+    PJ_OPERATION_PLAN(const PJ_OPERATION_PLAN &) = delete;
+    PJ_OPERATION_PLAN &operator=(const PJ_OPERATION_PLAN &) = delete;
+};
+
+// ---------------------------------------------------------------------------
+
+static void planNodeCopyState(PJ_OPERATION_PLAN::Node &node, const PJ *obj) {
+    node.over = obj->over;
+    node.errorIfBestTransformationNotAvailable =
+        obj->errorIfBestTransformationNotAvailable;
+    node.warnIfBestTransformationNotAvailable =
+        obj->warnIfBestTransformationNotAvailable;
+    node.skipNonInstantiable = obj->skipNonInstantiable;
+}
+
+// ---------------------------------------------------------------------------
+
+static bool planNodeInit(PJ_OPERATION_PLAN::Node &node, const PJ *obj) {
+    if (!obj->iso_obj)
+        return false;
+    node.iso_obj = obj->iso_obj;
+    node.hasCoordinateEpoch = obj->hasCoordinateEpoch;
+    node.coordinateEpoch = obj->coordinateEpoch;
+    planNodeCopyState(node, obj);
+
+    // Same logic as pj_obj_create()
+    auto coordop =
+        dynamic_cast<const CoordinateOperation *>(obj->iso_obj.get());
+    if (coordop) {
+        auto singleOp = dynamic_cast<const SingleOperation *>(coordop);
+        if (!singleOp || singleOp->method()->nameStr() != "unnamed") {
+            try {
+                auto formatter = PROJStringFormatter::create(
+                    PROJStringFormatter::Convention::PROJ_5, nullptr);
+                node.projString = coordop->exportToPROJString(formatter.get());
+            } catch (const std::exception &) {
+                node.projString.clear();
+            }
+        }
+    }
+    return true;
+}
+
+// ---------------------------------------------------------------------------
+
+static PJ *planNodeInstantiate(PJ_CONTEXT *ctx,
+                               const PJ_OPERATION_PLAN::Node &node) {
+    PJ *pj = nullptr;
+    ctx->forceOver = node.over != 0;
+    if (!node.projString.empty()) {
+        // Grids were successfully opened when the plan was created. Defer
+        // their opening to their first use, so that only the grids of the
+        // operations actually used by this handle are opened.
+        const bool defer_grid_opening_backup = ctx->defer_grid_opening;
+        ctx->defer_grid_opening = true;
+        pj = pj_create_internal(ctx, node.projString.c_str());
+        ctx->defer_grid_opening = defer_grid_opening_backup;
+        if (pj) {
+            pj->iso_obj = node.iso_obj;
+            pj->iso_obj_is_coordinate_operation = true;
+            pj->hasCoordinateEpoch = node.hasCoordinateEpoch;
+            pj->coordinateEpoch = node.coordinateEpoch;
+        }
+    } else {
+        try {
+            pj = pj_obj_create(ctx, NN_NO_CHECK(node.iso_obj));
+        } catch (const std::exception &e) {
+            proj_log_error(ctx, __FUNCTION__, e.what());
+        }
+    }
+    ctx->forceOver = false;
+    if (pj) {
+        pj->over = node.over;
+        pj->errorIfBestTransformationNotAvailable =
+            node.errorIfBestTransformationNotAvailable;
+        pj->warnIfBestTransformationNotAvailable =
+            node.warnIfBestTransformationNotAvailable;
+        pj->skipNonInstantiable = node.skipNonInstantiable;
+    }
+    return pj;
+}
+//! @endcond
+
+// ---------------------------------------------------------------------------
+
+/** \brief Create a plan from which handles equivalent to an object can be
+ * quickly created.
+ *
+ * The plan captures what is needed to instantiate again obj, and its
+ * alternative coordinate operations when it has been created by
+ * proj_create_crs_to_crs() or similar functions, in a form that does not
+ * require going through the ISO-19111 to PROJ string export, or opening the
+ * grids that will not be used. Handles are created from the plan with
+ * proj_operation_plan_create_handle().
+ *
+ * Once created, the plan is read-only: it may be used concurrently by
+ * several threads to create handles, each thread using its own context.
+ * The plan does not reference obj, which may be destroyed afterwards.
+ *
+ * @param ctx PROJ context, or NULL for default context
+ * @param obj Object from which to create the plan. Must not be NULL.
+ * @return Plan that must be destroyed with proj_operation_plan_destroy(), or
+ * NULL in case of error.
+ *
+ * @since 9.8
+ */
+PJ_OPERATION_PLAN *proj_operation_plan_create(PJ_CONTEXT *ctx, const PJ *obj) {
+    SANITIZE_CTX(ctx);
+    if (!obj) {
+        proj_context_errno_set(ctx, PROJ_ERR_OTHER_API_MISUSE);
+        proj_log_error(ctx, __FUNCTION__, "missing required input");
+        return nullptr;
+    }
+    auto plan = std::unique_ptr<PJ_OPERATION_PLAN>(new PJ_OPERATION_PLAN());
+    if (obj->alternativeCoordinateOperations.empty()) {
+        if (!planNodeInit(plan->single, obj)) {
+            proj_context_errno_set(ctx, PROJ_ERR_OTHER_API_MISUSE);
+            proj_log_error(ctx, __FUNCTION__,
+                           "Object not created from an ISO-19111 object");
+            return nullptr;
+        }
+        return plan.release();
+    }
+
+    planNodeCopyState(plan->set, obj);
+    for (const auto &alt : obj->alternativeCoordinateOperations) {
+        // Compute it now, so that handles do not need to look for the grids
+        alt.isInstantiable();
+        plan->operations.emplace_back(alt);
+        auto &op = plan->operations.back();
+        bool ok = alt.pj && planNodeInit(op.pj, alt.pj);
+        if (ok && alt.pjSrcGeocentricToLonLat) {
+            op.hasSrcGeocentricToLonLat = true;
+            ok = planNodeInit(op.pjSrcGeocentricToLonLat,
+                              alt.pjSrcGeocentricToLonLat);
+        }
+        if (ok && alt.pjDstGeocentricToLonLat) {
+            op.hasDstGeocentricToLonLat = true;
+            ok = planNodeInit(op.pjDstGeocentricToLonLat,
+                              alt.pjDstGeocentricToLonLat);
+        }
+        if (!ok) {
+            proj_context_errno_set(ctx, PROJ_ERR_OTHER_API_MISUSE);
+            proj_log_error(ctx, __FUNCTION__,
+                           "Alternative operation not created from an "
+                           "ISO-19111 object");
+            return nullptr;
+        }
+    }
+    return plan.release();
+}
+
+// ---------------------------------------------------------------------------
+
+/** \brief Create a handle from a plan.
+ *
+ * The returned object is equivalent to the one passed to
+ * proj_operation_plan_create(). It holds the state that changes when
+ * transforming coordinates (error code, grids opened and their caches,
+ * last used alternative operation), and must thus be used by at most one
+ * thread at a time. Grids are only opened when first needed.
+ *
+ * This function may be called concurrently on the same plan from several
+ * threads, provided that each thread uses its own context.
+ *
+ * @param ctx PROJ context, or NULL for default context
+ * @param plan Plan. Must not be NULL.
+ * @return Object that must be unreferenced with proj_destroy(), or NULL in
+ * case of error.
+ *
+ * @since 9.8
+ */
+PJ *proj_operation_plan_create_handle(PJ_CONTEXT *ctx,
+                                      const PJ_OPERATION_PLAN *plan) {
+    SANITIZE_CTX(ctx);
+    if (!plan) {
+        proj_context_errno_set(ctx, PROJ_ERR_OTHER_API_MISUSE);
+        proj_log_error(ctx, __FUNCTION__, "missing required input");
+        return nullptr;
+    }
+    if (plan->operations.empty()) {
+        return planNodeInstantiate(ctx, plan->single);
+    }
+
+    auto newPj = pj_new();
+    if (!newPj)
+        return nullptr;
+    newPj->descr = "Set of coordinate operations";
+    newPj->ctx = ctx;
+    newPj->over = plan->set.over;
+    newPj->errorIfBestTransformationNotAvailable =
+        plan->set.errorIfBestTransformationNotAvailable;
+    newPj->warnIfBestTransformationNotAvailable =
+        plan->set.warnIfBestTransformationNotAvailable;
+    newPj->skipNonInstantiable = plan->set.skipNonInstantiable;
+
+    const int old_debug_level = ctx->debug_level;
+    ctx->debug_level = PJ_LOG_NONE;
+    bool ok = true;
+    newPj->alternativeCoordinateOperations.reserve(plan->operations.size());
+    for (const auto &op : plan->operations) {
+        PJ *pj = planNodeInstantiate(ctx, op.pj);
+        PJ *pjSrc = op.hasSrcGeocentricToLonLat
+                        ? planNodeInstantiate(ctx, op.pjSrcGeocentricToLonLat)
+                        : nullptr;
+        PJ *pjDst = op.hasDstGeocentricToLonLat
+                        ? planNodeInstantiate(ctx, op.pjDstGeocentricToLonLat)
+                        : nullptr;
+        // Constructed before checking, so that it takes ownership of them
+        newPj->alternativeCoordinateOperations.emplace_back(op.metadata, pj,
+                                                            pjSrc, pjDst);
+        if (!pj || (op.hasSrcGeocentricToLonLat && !pjSrc) ||
+            (op.hasDstGeocentricToLonLat && !pjDst)) {
+            ok = false;
+            break;
+        }
+    }
+    ctx->debug_level = old_debug_level;
+    if (!ok) {
+        proj_log_error(ctx, __FUNCTION__,
+                       "Cannot instantiate alternative operation");
+        proj_destroy(newPj);
+        return nullptr;
+    }
+    return newPj;
+}
+
+// ---------------------------------------------------------------------------
+
+/** \brief Destroy a plan created by proj_operation_plan_create().
+ *
+ * Handles created from the plan remain valid.
+ *
+ * @param plan Plan, or NULL.
+ *
+ * @since 9.8
+ */
+void proj_operation_plan_destroy(PJ_OPERATION_PLAN *plan) { delete plan; }
+
+// ---------------------------------------------------------------------------
+
 /** \brief Instantiate an object from a WKT string, PROJ string, object code
  * (like "EPSG:4326", "urn:ogc:def:crs:EPSG::4326",
  * "urn:ogc:def:coordinateOperation:EPSG::1671"), a PROJJSON string, an object
@@ -672,6 +951,8 @@ PJ *proj_create(PJ_CONTEXT *ctx, const char *text) {
  * @param out_grammar_errors Pointer to a PROJ_STRING_LIST object, or NULL.
  * If provided, *out_grammar_errors will contain a list of errors regarding the
  * WKT grammar. It must be freed with proj_string_list_destroy().
+ * When it is NULL and STRICT=NO, the validation of the WKT grammar, which is a
+ * second pass over the string, is skipped (since PROJ 9.8).
  * @return Object that must be unreferenced with proj_destroy(), or NULL in
  * case of error.
  */
@@ -699,11 +980,11 @@ PJ *proj_create_from_wkt(PJ_CONTEXT *ctx, const char *wkt,
         if (dbContext) {
             parser.attachDatabaseContext(NN_NO_CHECK(dbContext));
         }
-        parser.setStrict(false);
+        bool strict = false;
         for (auto iter = options; iter && iter[0]; ++iter) {
             const char *value;
             if ((value = getOptionValue(*iter, "STRICT="))) {
-                parser.setStrict(ci_equal(value, "YES"));
+                strict = ci_equal(value, "YES");
             } else if ((value = getOptionValue(
                             *iter, "UNSET_IDENTIFIERS_IF_INCOMPATIBLE_DEF="))) {
                 parser.setUnsetIdentifiersIfIncompatibleDef(
@@ -715,6 +996,10 @@ PJ *proj_create_from_wkt(PJ_CONTEXT *ctx, const char *wkt,
                 return nullptr;
             }
         }
+        parser.setStrict(strict);
+        // Grammar errors are only reported through out_grammar_errors in
+        // non-strict mode, so avoid the cost of looking for them otherwise.
+        parser.setCheckGrammar(strict || out_grammar_errors != nullptr);
         auto obj = parser.createFromWKT(wkt);
 
         if (out_grammar_errors) {
@@ -8606,6 +8891,78 @@ proj_create_operations(PJ_CONTEXT *ctx, const PJ *source_crs,
 
 // ---------------------------------------------------------------------------
 
+//! @cond Doxygen_Suppress
+
+/** Serialize the operations of a list returned by proj_create_operations()
+ * as single-line PROJJSON strings, each prefixed with '1' or '0' depending
+ * on whether the operation has a ballpark transformation (which PROJJSON
+ * does not record).
+ *
+ * Used by the persistent cache of proj_create_crs_to_crs() results.
+ * Returns false if an operation cannot be exported.
+ */
+bool pj_operation_list_export(PJ_CONTEXT *ctx, const PJ_OBJ_LIST *op_list,
+                              std::vector<std::string> &out) {
+    out.clear();
+    try {
+        for (const auto &obj : op_list->objects) {
+            auto op = dynamic_cast<const CoordinateOperation *>(obj.get());
+            if (!op) {
+                return false;
+            }
+            auto formatter = JSONFormatter::create();
+            formatter->setMultiLine(false);
+            out.emplace_back(std::string(op->hasBallparkTransformation() ? "1"
+                                                                         : "0")
+                                 .append(op->exportToJSON(formatter.get())));
+        }
+        return true;
+    } catch (const std::exception &e) {
+        pj_log(ctx, PJ_LOG_DEBUG, "Cannot serialize operation: %s", e.what());
+        out.clear();
+        return false;
+    }
+}
+
+// ---------------------------------------------------------------------------
+
+/** Recreate a list of operations, as returned by proj_create_operations(),
+ * from strings generated by pj_operation_list_export().
+ *
+ * The operations are parsed without a database context, which is
+ * not needed as they are fully described by their PROJJSON encoding.
+ */
+PJ_OBJ_LIST *pj_operation_list_import(PJ_CONTEXT *ctx, const PJ *source_crs,
+                                      const PJ *target_crs,
+                                      const std::vector<std::string> &in) {
+    try {
+        std::vector<IdentifiedObjectNNPtr> objects;
+        objects.reserve(in.size());
+        for (const auto &str : in) {
+            if (str.size() < 2) {
+                return nullptr;
+            }
+            auto op = nn_dynamic_pointer_cast<CoordinateOperation>(
+                createFromUserInput(str.substr(1), DatabaseContextPtr()));
+            if (!op) {
+                return nullptr;
+            }
+            op->setHasBallparkTransformation(str[0] == '1');
+            objects.emplace_back(NN_NO_CHECK(op));
+        }
+        return new PJ_OPERATION_LIST(ctx, source_crs, target_crs,
+                                     std::move(objects));
+    } catch (const std::exception &e) {
+        pj_log(ctx, PJ_LOG_DEBUG, "Cannot deserialize operation: %s",
+               e.what());
+        return nullptr;
+    }
+}
+
+//! @endcond
+
+// ---------------------------------------------------------------------------
+
 /** Return the index of the operation that would be the most appropriate to
  * transform the specified coordinates.
  *
@@ -52,6 +52,7 @@
 #include "sqlite3_utils.hpp"
 
 #include <algorithm>
+#include <chrono>
 #include <cmath>
 #include <cstdlib>
 #include <cstring>
@@ -854,7 +855,19 @@ struct DatabaseContext::Private {
     std::vector<std::string> auxiliaryDatabasePaths_{};
     std::shared_ptr<SQLiteHandle> sqlite_handle_{};
     unsigned int queryCounter_ = 0;
-    std::map<std::string, sqlite3_stmt *> mapSqlToStatement_{};
+
+    // Prepared statements, and their execution statistics, by SQL text.
+    // They are per DatabaseContext (and not per SQLiteHandle), as a
+    // SQLiteHandle may be shared by contexts used in different threads.
+    // Statistics are dropped with their statement when it is evicted.
+    struct PreparedStatement {
+        std::shared_ptr<sqlite3_stmt> stmt{};
+        QueryStatistics stats{};
+    };
+    static constexpr size_t PREPARED_STATEMENT_CACHE_SIZE = 512;
+    lru11::Cache<std::string, std::shared_ptr<PreparedStatement>>
+        cachePreparedStatements_{PREPARED_STATEMENT_CACHE_SIZE};
+    bool queryStatisticsEnabled_ = false;
     PJ_CONTEXT *pjCtxt_ = nullptr;
     int recLevel_ = 0;
     bool detach_ = false;
@@ -1026,10 +1039,8 @@ void DatabaseContext::Private::closeDB() noexcept {
         detach_ = false;
     }
 
-    for (auto &pair : mapSqlToStatement_) {
-        sqlite3_finalize(pair.second);
-    }
-    mapSqlToStatement_.clear();
+    // Finalize the prepared statements before closing the handle
+    cachePreparedStatements_.clear();
 
     sqlite_handle_.reset();
 }
@@ -1437,12 +1448,14 @@ SQLResultSet DatabaseContext::Private::run(const std::string &sql,
     auto l_handle = handle();
     assert(l_handle);
 
-    sqlite3_stmt *stmt = nullptr;
-    auto iter = mapSqlToStatement_.find(sql);
-    if (iter != mapSqlToStatement_.end()) {
-        stmt = iter->second;
-        sqlite3_reset(stmt);
+    std::shared_ptr<PreparedStatement> prepared;
+    if (cachePreparedStatements_.tryGet(sql, prepared)) {
+        sqlite3_reset(prepared->stmt.get());
+        sqlite3_clear_bindings(prepared->stmt.get());
+        if (queryStatisticsEnabled_)
+            ++prepared->stats.preparedStatementHitCount;
     } else {
+        sqlite3_stmt *stmt = nullptr;
         if (sqlite3_prepare_v2(l_handle->handle(), sql.c_str(),
                                static_cast<int>(sql.size()), &stmt,
                                nullptr) != SQLITE_OK) {
@@ -1452,13 +1465,26 @@ SQLResultSet DatabaseContext::Private::run(const std::string &sql,
                     .append(" ] on ")
                     .append(sql));
         }
-        mapSqlToStatement_.insert(
-            std::pair<std::string, sqlite3_stmt *>(sql, stmt));
+        prepared = std::make_shared<PreparedStatement>();
+        prepared->stmt.reset(stmt, sqlite3_finalize);
+        cachePreparedStatements_.insert(sql, prepared);
     }
 
     ++queryCounter_;
-
-    return l_handle->run(stmt, sql, parameters, useMaxFloatPrecision);
+    if (!queryStatisticsEnabled_) {
+        return l_handle->run(prepared->stmt.get(), sql, parameters,
+                             useMaxFloatPrecision);
+    }
+    ++prepared->stats.executionCount;
+
+    const auto start = std::chrono::steady_clock::now();
+    auto ret = l_handle->run(prepared->stmt.get(), sql, parameters,
+                             useMaxFloatPrecision);
+    prepared->stats.totalTimeUs +=
+        std::chrono::duration_cast<std::chrono::microseconds>(
+            std::chrono::steady_clock::now() - start)
+            .count();
+    return ret;
 }
 
 // ---------------------------------------------------------------------------
@@ -3564,6 +3590,47 @@ unsigned int DatabaseContext::getQueryCounter() const {
 
 // ---------------------------------------------------------------------------
 
+/** Enable or disable the collection of the execution statistics of the SQL
+ * statements, returned by getQueryStatistics(). They are disabled by default,
+ * as measuring execution times has a cost.
+ *
+ * @since 9.8
+ */
+void DatabaseContext::setQueryStatisticsEnabled(bool enabled) {
+    d->queryStatisticsEnabled_ = enabled;
+}
+
+// ---------------------------------------------------------------------------
+
+/** Returns the execution statistics of the SQL statements run while their
+ * collection was enabled with setQueryStatisticsEnabled(), sorted by
+ * decreasing cumulated execution time.
+ *
+ * Only the statements still in the cache of the most recently used prepared
+ * statements are reported.
+ */
+std::vector<DatabaseContext::QueryStatistics>
+DatabaseContext::getQueryStatistics() const {
+    std::vector<QueryStatistics> res;
+    const auto collect =
+        [&res](const lru11::KeyValuePair<
+               std::string, std::shared_ptr<Private::PreparedStatement>>
+                   &entry) {
+            if (entry.value->stats.executionCount == 0)
+                return;
+            res.push_back(entry.value->stats);
+            res.back().sql = entry.key;
+        };
+    d->cachePreparedStatements_.cwalk(collect);
+    std::stable_sort(res.begin(), res.end(),
+                     [](const QueryStatistics &a, const QueryStatistics &b) {
+                         return a.totalTimeUs > b.totalTimeUs;
+                     });
+    return res;
+}
+
+// ---------------------------------------------------------------------------
+
 bool DatabaseContext::isKnownName(const std::string &name,
                                   const std::string &tableName) const {
     std::string sql("SELECT 1 FROM \"");
@@ -1265,6 +1265,7 @@ struct WKTParser::Private {
 
     bool strict_ = true;
     bool unsetIdentifiersIfIncompatibleDef_ = true;
+    bool checkGrammar_ = true;
     std::list<std::string> warningList_{};
     std::list<std::string> grammarErrorList_{};
     std::vector<double> toWGS84Parameters_{};
@@ -1504,6 +1505,23 @@ WKTParser &WKTParser::setUnsetIdentifiersIfIncompatibleDef(bool unset) {
 
 // ---------------------------------------------------------------------------
 
+/** \brief Set whether the WKT string should be validated against the strict
+ * WKT1 or WKT2 grammar.
+ *
+ * This validation is a second pass over the string, done after the object has
+ * been built, whose only outcome is grammarErrorList() in non-strict mode, or
+ * an exception in strict mode. Callers that ignore grammar errors may disable
+ * it to save its cost. Default is true.
+ *
+ * @since PROJ 9.8
+ */
+WKTParser &WKTParser::setCheckGrammar(bool check) {
+    d->checkGrammar_ = check;
+    return *this;
+}
+
+// ---------------------------------------------------------------------------
+
 /** \brief Return the list of warnings found during parsing.
  *
  * \note The list might be non-empty only is setStrict(false) has been called.
@@ -7736,6 +7754,7 @@ static BaseObjectNNPtr createFromUserInput(const std::string &text,
                         return WKTParser()
                             .attachDatabaseContext(dbContext)
                             .setStrict(false)
+                            .setCheckGrammar(false)
                             .createFromWKT(text);
                     }
                     break;
@@ -8452,8 +8471,10 @@ BaseObjectNNPtr WKTParser::createFromWKT(const std::string &wkt) {
 
     auto obj = build();
 
-    if (dialect == WKTGuessedDialect::WKT1_GDAL ||
-        dialect == WKTGuessedDialect::WKT1_ESRI) {
+    if (!d->checkGrammar_) {
+        // Grammar validation not requested
+    } else if (dialect == WKTGuessedDialect::WKT1_GDAL ||
+               dialect == WKTGuessedDialect::WKT1_ESRI) {
         auto errorMsg = pj_wkt1_parse(wkt);
         if (!errorMsg.empty()) {
             d->emitGrammarError(errorMsg);
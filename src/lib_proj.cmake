@@ -196,6 +196,7 @@ set(SRC_LIBPROJ_CORE
   coordinates.cpp
   create.cpp
   crs_to_crs.cpp
+  crs_to_crs_cache.cpp
   ctx.cpp
   datum_set.cpp
   datums.cpp
@@ -203,5 +203,6 @@ void proj_cleanup() {
     pj_clear_hgridshift_knowngrids_cache();
     pj_clear_vgridshift_knowngrids_cache();
     pj_clear_gridshift_knowngrids_cache();
+    pj_clear_grid_block_cache();
     pj_clear_sqlite_cache();
 }
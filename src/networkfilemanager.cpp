@@ -51,6 +51,8 @@
 #include <limits>
 #include <mutex>
 #include <string>
+#include <system_error>
+#include <thread>
 
 #include "filemanager.hpp"
 #include "proj.h"
@@ -123,16 +125,20 @@ struct FileProperties {
     std::string etag{};
 };
 
+// URL shared by a NetworkFile and the keys of its chunks in the cache, so
+// that looking up a chunk does not need to copy it.
+typedef std::shared_ptr<const std::string> SharedUrl;
+
 class NetworkChunkCache {
   public:
-    void insert(PJ_CONTEXT *ctx, const std::string &url,
+    void insert(PJ_CONTEXT *ctx, const SharedUrl &url,
                 unsigned long long chunkIdx, std::vector<unsigned char> &&data);
 
     std::shared_ptr<std::vector<unsigned char>>
-    get(PJ_CONTEXT *ctx, const std::string &url, unsigned long long chunkIdx);
+    get(PJ_CONTEXT *ctx, const SharedUrl &url, unsigned long long chunkIdx);
 
     std::shared_ptr<std::vector<unsigned char>> get(PJ_CONTEXT *ctx,
-                                                    const std::string &url,
+                                                    const SharedUrl &url,
                                                     unsigned long long chunkIdx,
                                                     FileProperties &props);
 
@@ -142,19 +148,20 @@ class NetworkChunkCache {
 
   private:
     struct Key {
-        std::string url;
+        SharedUrl url;
         unsigned long long chunkIdx;
 
-        Key(const std::string &urlIn, unsigned long long chunkIdxIn)
+        Key(const SharedUrl &urlIn, unsigned long long chunkIdxIn)
             : url(urlIn), chunkIdx(chunkIdxIn) {}
         bool operator==(const Key &other) const {
-            return url == other.url && chunkIdx == other.chunkIdx;
+            return chunkIdx == other.chunkIdx &&
+                   (url == other.url || *url == *other.url);
         }
     };
 
     struct KeyHasher {
         std::size_t operator()(const Key &k) const {
-            return std::hash<std::string>{}(k.url) ^
+            return std::hash<std::string>{}(*k.url) ^
                    (std::hash<unsigned long long>{}(k.chunkIdx) << 1);
         }
     };
@@ -794,7 +801,7 @@ bool DiskChunkCache::move_to_tail(sqlite3_int64 chunk_id) {
 
 // ---------------------------------------------------------------------------
 
-void NetworkChunkCache::insert(PJ_CONTEXT *ctx, const std::string &url,
+void NetworkChunkCache::insert(PJ_CONTEXT *ctx, const SharedUrl &url,
                                unsigned long long chunkIdx,
                                std::vector<unsigned char> &&data) {
     auto dataPtr(std::make_shared<std::vector<unsigned char>>(std::move(data)));
@@ -815,7 +822,7 @@ void NetworkChunkCache::insert(PJ_CONTEXT *ctx, const std::string &url,
         "SELECT id, data_id FROM chunks WHERE url = ? AND offset = ?");
     if (!stmt)
         return;
-    stmt->bindText(url.c_str());
+    stmt->bindText(url->c_str());
     stmt->bindInt64(chunkIdx * DOWNLOAD_CHUNK_SIZE);
 
     const auto mainRet = stmt->execute();
@@ -876,7 +883,7 @@ void NetworkChunkCache::insert(PJ_CONTEXT *ctx, const std::string &url,
                                    "WHERE id = ?");
             if (!l_stmt)
                 return;
-            l_stmt->bindText(url.c_str());
+            l_stmt->bindText(url->c_str());
             l_stmt->bindInt64(chunkIdx * DOWNLOAD_CHUNK_SIZE);
             l_stmt->bindInt64(dataPtr->size());
             l_stmt->bindInt64(data_id);
@@ -960,7 +967,7 @@ void NetworkChunkCache::insert(PJ_CONTEXT *ctx, const std::string &url,
                               "data_size) VALUES (?,?,?,?)");
     if (!stmt)
         return;
-    stmt->bindText(url.c_str());
+    stmt->bindText(url->c_str());
     stmt->bindInt64(chunkIdx * DOWNLOAD_CHUNK_SIZE);
     stmt->bindInt64(chunk_data_id);
     stmt->bindInt64(dataPtr->size());
@@ -1010,7 +1017,7 @@ void NetworkChunkCache::insert(PJ_CONTEXT *ctx, const std::string &url,
 // ---------------------------------------------------------------------------
 
 std::shared_ptr<std::vector<unsigned char>>
-NetworkChunkCache::get(PJ_CONTEXT *ctx, const std::string &url,
+NetworkChunkCache::get(PJ_CONTEXT *ctx, const SharedUrl &url,
                        unsigned long long chunkIdx) {
     std::shared_ptr<std::vector<unsigned char>> ret;
     if (cache_.tryGet(Key(url, chunkIdx), ret)) {
@@ -1029,7 +1036,7 @@ NetworkChunkCache::get(PJ_CONTEXT *ctx, const std::string &url,
     if (!stmt)
         return ret;
 
-    stmt->bindText(url.c_str());
+    stmt->bindText(url->c_str());
     stmt->bindInt64(chunkIdx * DOWNLOAD_CHUNK_SIZE);
 
     const auto mainRet = stmt->execute();
@@ -1066,9 +1073,9 @@ NetworkChunkCache::get(PJ_CONTEXT *ctx, const std::string &url,
 // ---------------------------------------------------------------------------
 
 std::shared_ptr<std::vector<unsigned char>>
-NetworkChunkCache::get(PJ_CONTEXT *ctx, const std::string &url,
+NetworkChunkCache::get(PJ_CONTEXT *ctx, const SharedUrl &url,
                        unsigned long long chunkIdx, FileProperties &props) {
-    if (!gNetworkFileProperties.tryGet(ctx, url, props)) {
+    if (!gNetworkFileProperties.tryGet(ctx, *url, props)) {
         return nullptr;
     }
 
@@ -1235,7 +1242,7 @@ void NetworkFilePropertiesCache::clearMemoryCache() { cache_.clear(); }
 
 class NetworkFile : public File {
     PJ_CONTEXT *m_ctx;
-    std::string m_url;
+    SharedUrl m_url;
     PROJ_NETWORK_HANDLE *m_handle;
     unsigned long long m_pos = 0;
     size_t m_nBlocksToDownload = 1;
@@ -1248,11 +1255,11 @@ class NetworkFile : public File {
     NetworkFile &operator=(const NetworkFile &) = delete;
 
   protected:
-    NetworkFile(PJ_CONTEXT *ctx, const std::string &url,
+    NetworkFile(PJ_CONTEXT *ctx, const SharedUrl &url,
                 PROJ_NETWORK_HANDLE *handle,
                 unsigned long long lastDownloadOffset,
                 const FileProperties &props)
-        : File(url), m_ctx(ctx), m_url(url), m_handle(handle),
+        : File(*url), m_ctx(ctx), m_url(url), m_handle(handle),
           m_lastDownloadedOffset(lastDownloadOffset), m_props(props),
           m_closeCbk(ctx->networking.close) {}
 
@@ -1305,9 +1312,10 @@ bool NetworkFile::get_props_from_headers(PJ_CONTEXT *ctx,
 
 std::unique_ptr<File> NetworkFile::open(PJ_CONTEXT *ctx, const char *filename) {
     FileProperties props;
-    if (gNetworkChunkCache.get(ctx, filename, 0, props)) {
+    const auto url = std::make_shared<const std::string>(filename);
+    if (gNetworkChunkCache.get(ctx, url, 0, props)) {
         return std::unique_ptr<File>(new NetworkFile(
-            ctx, filename, nullptr,
+            ctx, url, nullptr,
             std::numeric_limits<unsigned long long>::max(), props));
     } else {
         std::vector<unsigned char> buffer(DOWNLOAD_CHUNK_SIZE);
@@ -1326,9 +1334,9 @@ std::unique_ptr<File> NetworkFile::open(PJ_CONTEXT *ctx, const char *filename) {
         } else if (get_props_from_headers(ctx, handle, props)) {
             gNetworkFileProperties.insert(ctx, filename, props);
             buffer.resize(size_read);
-            gNetworkChunkCache.insert(ctx, filename, 0, std::move(buffer));
+            gNetworkChunkCache.insert(ctx, url, 0, std::move(buffer));
             return std::unique_ptr<File>(
-                new NetworkFile(ctx, filename, handle, size_read, props));
+                new NetworkFile(ctx, url, handle, size_read, props));
         } else {
             ctx->networking.close(ctx, handle, ctx->networking.user_data);
         }
@@ -1346,6 +1354,198 @@ std::unique_ptr<File> pj_network_file_open(PJ_CONTEXT *ctx,
 
 // ---------------------------------------------------------------------------
 
+bool pj_network_file_prefetch(
+    PJ_CONTEXT *ctx, const std::string &urlIn,
+    const std::vector<std::pair<unsigned long long, unsigned long long>>
+        &ranges,
+    int maxParallelRequests) {
+    const auto url = std::make_shared<const std::string>(urlIn);
+
+    FileProperties props;
+    const bool hasProps = gNetworkFileProperties.tryGet(ctx, *url, props);
+
+    // Collect the chunks that are not already cached
+    std::vector<unsigned long long> chunks;
+    for (const auto &range : ranges) {
+        if (range.second == 0)
+            continue;
+        auto lastOffset = range.first + range.second - 1;
+        if (hasProps) {
+            if (range.first >= props.size)
+                continue;
+            lastOffset = std::min(lastOffset, props.size - 1);
+        }
+        for (auto chunkIdx = range.first / DOWNLOAD_CHUNK_SIZE;
+             chunkIdx <= lastOffset / DOWNLOAD_CHUNK_SIZE; ++chunkIdx) {
+            chunks.push_back(chunkIdx);
+        }
+    }
+    std::sort(chunks.begin(), chunks.end());
+    chunks.erase(std::unique(chunks.begin(), chunks.end()), chunks.end());
+    chunks.erase(std::remove_if(chunks.begin(), chunks.end(),
+                                [ctx, &url](unsigned long long chunkIdx) {
+                                    return gNetworkChunkCache.get(
+                                               ctx, url, chunkIdx) != nullptr;
+                                }),
+                 chunks.end());
+    if (chunks.empty())
+        return true;
+
+    if (maxParallelRequests <= 0)
+        maxParallelRequests = 4;
+#ifdef DO_EMSCRIPTEN_FETCH
+    maxParallelRequests = 1;
+#endif
+
+    // Group consecutive chunks in runs, each downloaded by a single range
+    // request. Runs are kept small enough for all requests to be busy.
+    const size_t maxChunksPerRun = std::max<size_t>(
+        1, std::min<size_t>(MAX_CHUNKS, (chunks.size() + maxParallelRequests -
+                                         1) / maxParallelRequests));
+    struct Run {
+        unsigned long long firstChunk;
+        size_t chunkCount;
+    };
+    std::vector<Run> runs;
+    for (const auto chunkIdx : chunks) {
+        if (!runs.empty() &&
+            runs.back().firstChunk + runs.back().chunkCount == chunkIdx &&
+            runs.back().chunkCount < maxChunksPerRun) {
+            runs.back().chunkCount++;
+        } else {
+            runs.push_back(Run{chunkIdx, 1});
+        }
+    }
+
+    struct Result {
+        std::vector<unsigned char> data{};
+        bool hasProps = false;
+        FileProperties props{};
+        std::string error{};
+    };
+    std::vector<Result> results(runs.size());
+    std::mutex mutex;
+    size_t nextRun = 0;
+
+    // Each worker downloads runs on its own handle, with its own context,
+    // so that the network callbacks are never called concurrently for the
+    // same handle or context. The downloaded data is put in the cache by
+    // the calling thread once all workers are done.
+    const auto worker = [&](PJ_CONTEXT *workerCtx) {
+        PROJ_NETWORK_HANDLE *handle = nullptr;
+        while (true) {
+            size_t runIdx;
+            {
+                std::lock_guard<std::mutex> lock(mutex);
+                if (nextRun == runs.size())
+                    break;
+                runIdx = nextRun++;
+            }
+            const auto &run = runs[runIdx];
+            auto &result = results[runIdx];
+            result.data.resize(run.chunkCount * DOWNLOAD_CHUNK_SIZE);
+            const auto offset = run.firstChunk * DOWNLOAD_CHUNK_SIZE;
+            size_t nRead = 0;
+            char errorBuffer[1024];
+            errorBuffer[0] = '\0';
+            if (!handle) {
+                handle = workerCtx->networking.open(
+                    workerCtx, url->c_str(), offset, result.data.size(),
+                    result.data.data(), &nRead, sizeof(errorBuffer),
+                    errorBuffer, workerCtx->networking.user_data);
+            } else {
+                nRead = workerCtx->networking.read_range(
+                    workerCtx, handle, offset, result.data.size(),
+                    result.data.data(), sizeof(errorBuffer), errorBuffer,
+                    workerCtx->networking.user_data);
+            }
+            if (handle) {
+                result.hasProps = NetworkFile::get_props_from_headers(
+                    workerCtx, handle, result.props);
+            }
+            result.data.resize(nRead);
+            if (nRead == 0) {
+                errorBuffer[sizeof(errorBuffer) - 1] = '\0';
+                result.error = errorBuffer[0] ? errorBuffer : "no data";
+            }
+        }
+        if (handle) {
+            workerCtx->networking.close(workerCtx, handle,
+                                        workerCtx->networking.user_data);
+        }
+    };
+
+    const size_t nWorkers =
+        std::min(runs.size(), static_cast<size_t>(maxParallelRequests));
+    std::vector<PJ_CONTEXT *> workerCtxs;
+    std::vector<std::thread> threads;
+    bool threadCreationFailed = false;
+    if (nWorkers > 1) {
+        threads.reserve(nWorkers);
+        for (size_t i = 0; i < nWorkers; ++i) {
+            auto workerCtx = proj_context_clone(ctx);
+            if (!workerCtx)
+                break;
+            workerCtxs.push_back(workerCtx);
+            try {
+                threads.emplace_back(worker, workerCtx);
+            } catch (const std::system_error &) {
+                threadCreationFailed = true;
+                break;
+            }
+        }
+    }
+    // If a thread cannot be started, the calling thread takes its share of
+    // the runs.
+    if (threads.empty() || threadCreationFailed)
+        worker(ctx);
+    for (auto &thread : threads) {
+        thread.join();
+    }
+    for (auto workerCtx : workerCtxs) {
+        proj_context_destroy(workerCtx);
+    }
+
+    bool ret = true;
+    for (size_t runIdx = 0; runIdx < runs.size(); ++runIdx) {
+        auto &result = results[runIdx];
+        if (!result.error.empty()) {
+            pj_log(ctx, PJ_LOG_ERROR, "Cannot read in %s: %s", url->c_str(),
+                   result.error.c_str());
+            proj_context_errno_set(ctx, PROJ_ERR_OTHER_NETWORK_ERROR);
+            ret = false;
+            continue;
+        }
+        if (result.hasProps && hasProps &&
+            (result.props.size != props.size ||
+             result.props.lastModified != props.lastModified ||
+             result.props.etag != props.etag)) {
+            // The remote file has changed: cached data of the previous
+            // version must not be mixed with the new one.
+            pj_log(ctx, PJ_LOG_DEBUG, "%s has changed", url->c_str());
+            gNetworkFileProperties.insert(ctx, *url, result.props);
+            gNetworkChunkCache.clearMemoryCache();
+            return false;
+        }
+
+        const auto &run = runs[runIdx];
+        const auto &data = result.data;
+        const size_t nChunks =
+            (data.size() + DOWNLOAD_CHUNK_SIZE - 1) / DOWNLOAD_CHUNK_SIZE;
+        for (size_t i = 0; i < nChunks; i++) {
+            std::vector<unsigned char> chunk(
+                data.data() + i * DOWNLOAD_CHUNK_SIZE,
+                data.data() +
+                    std::min((i + 1) * DOWNLOAD_CHUNK_SIZE, data.size()));
+            gNetworkChunkCache.insert(ctx, url, run.firstChunk + i,
+                                      std::move(chunk));
+        }
+    }
+    return ret;
+}
+
+// ---------------------------------------------------------------------------
+
 size_t NetworkFile::read(void *buffer, size_t sizeBytes) {
 
     if (sizeBytes == 0)
@@ -1355,10 +1555,14 @@ size_t NetworkFile::read(void *buffer, size_t sizeBytes) {
     while (sizeBytes) {
         const auto chunkIdxToDownload = iterOffset / DOWNLOAD_CHUNK_SIZE;
         const auto offsetToDownload = chunkIdxToDownload * DOWNLOAD_CHUNK_SIZE;
+        // Cached chunks are read in place. region is only filled on a miss.
+        const unsigned char *regionData;
+        size_t regionSize;
         std::vector<unsigned char> region;
         auto pChunk = gNetworkChunkCache.get(m_ctx, m_url, chunkIdxToDownload);
         if (pChunk != nullptr) {
-            region = *pChunk;
+            regionData = pChunk->data();
+            regionSize = pChunk->size();
         } else {
             if (offsetToDownload == m_lastDownloadedOffset) {
                 // In case of consecutive reads (of small size), we use a
@@ -1399,13 +1603,13 @@ size_t NetworkFile::read(void *buffer, size_t sizeBytes) {
 
             region.resize(m_nBlocksToDownload * DOWNLOAD_CHUNK_SIZE);
             size_t nRead = 0;
-            std::string errorBuffer;
-            errorBuffer.resize(1024);
+            char errorBuffer[1024];
+            errorBuffer[0] = '\0';
             if (!m_handle) {
                 m_handle = m_ctx->networking.open(
-                    m_ctx, m_url.c_str(), offsetToDownload,
+                    m_ctx, m_url->c_str(), offsetToDownload,
                     m_nBlocksToDownload * DOWNLOAD_CHUNK_SIZE, &region[0],
-                    &nRead, errorBuffer.size(), &errorBuffer[0],
+                    &nRead, sizeof(errorBuffer), errorBuffer,
                     m_ctx->networking.user_data);
                 if (!m_handle) {
                     proj_context_errno_set(m_ctx, PROJ_ERR_OTHER_NETWORK_ERROR);
@@ -1415,14 +1619,14 @@ size_t NetworkFile::read(void *buffer, size_t sizeBytes) {
                 nRead = m_ctx->networking.read_range(
                     m_ctx, m_handle, offsetToDownload,
                     m_nBlocksToDownload * DOWNLOAD_CHUNK_SIZE, &region[0],
-                    errorBuffer.size(), &errorBuffer[0],
+                    sizeof(errorBuffer), errorBuffer,
                     m_ctx->networking.user_data);
             }
             if (nRead == 0) {
-                errorBuffer.resize(strlen(errorBuffer.data()));
-                if (!errorBuffer.empty()) {
+                errorBuffer[sizeof(errorBuffer) - 1] = '\0';
+                if (errorBuffer[0] != '\0') {
                     pj_log(m_ctx, PJ_LOG_ERROR, "Cannot read in %s: %s",
-                           m_url.c_str(), errorBuffer.c_str());
+                           m_url->c_str(), errorBuffer);
                 }
                 proj_context_errno_set(m_ctx, PROJ_ERR_OTHER_NETWORK_ERROR);
                 return 0;
@@ -1434,7 +1638,7 @@ size_t NetworkFile::read(void *buffer, size_t sizeBytes) {
                     if (props.size != m_props.size ||
                         props.lastModified != m_props.lastModified ||
                         props.etag != m_props.etag) {
-                        gNetworkFileProperties.insert(m_ctx, m_url, props);
+                        gNetworkFileProperties.insert(m_ctx, *m_url, props);
                         gNetworkChunkCache.clearMemoryCache();
                         m_hasChanged = true;
                     }
@@ -1443,6 +1647,8 @@ size_t NetworkFile::read(void *buffer, size_t sizeBytes) {
 
             region.resize(nRead);
             m_lastDownloadedOffset = offsetToDownload + nRead;
+            regionData = region.data();
+            regionSize = region.size();
 
             const auto nChunks =
                 (region.size() + DOWNLOAD_CHUNK_SIZE - 1) / DOWNLOAD_CHUNK_SIZE;
@@ -1457,12 +1663,12 @@ size_t NetworkFile::read(void *buffer, size_t sizeBytes) {
         }
         const size_t nToCopy = static_cast<size_t>(
             std::min(static_cast<unsigned long long>(sizeBytes),
-                     region.size() - (iterOffset - offsetToDownload)));
-        memcpy(buffer, region.data() + iterOffset - offsetToDownload, nToCopy);
+                     regionSize - (iterOffset - offsetToDownload)));
+        memcpy(buffer, regionData + iterOffset - offsetToDownload, nToCopy);
         buffer = static_cast<char *>(buffer) + nToCopy;
         iterOffset += nToCopy;
         sizeBytes -= nToCopy;
-        if (region.size() < static_cast<size_t>(DOWNLOAD_CHUNK_SIZE) &&
+        if (regionSize < static_cast<size_t>(DOWNLOAD_CHUNK_SIZE) &&
             sizeBytes != 0) {
             break;
         }
@@ -106,6 +106,58 @@ paralist *pj_param_exists(paralist *list, const char *parameter) {
     return nullptr;
 }
 
+/************************************************************************/
+/*                            PJParamIndex                              */
+/************************************************************************/
+
+/* FNV-1a hash of the first len characters of key */
+static uint32_t param_key_hash(const char *key, size_t len) {
+    uint32_t hash = 2166136261U;
+    for (size_t i = 0; i < len; ++i) {
+        hash ^= static_cast<unsigned char>(key[i]);
+        hash *= 16777619U;
+    }
+    return hash;
+}
+
+PJParamIndex::PJParamIndex(PJ_CONTEXT *ctxIn, paralist *list)
+    : ctx(ctxIn), head(list), previous(ctxIn->paramIndex) {
+    for (paralist *node = list; node; node = node->next) {
+        entries.emplace_back(
+            param_key_hash(node->param, strcspn(node->param, "=")), node);
+        tail = node;
+    }
+    ctx->paramIndex = this;
+}
+
+PJParamIndex::~PJParamIndex() { ctx->paramIndex = previous; }
+
+/* Equivalent of pj_param_exists(head, parameter) */
+paralist *PJParamIndex::find(const char *parameter) {
+    /* pj_param_exists() only matches "step" on the first node */
+    if (strcmp(parameter, "step") == 0)
+        return pj_param_exists(head, parameter);
+
+    /* Catch up with nodes appended since the last lookup */
+    while (tail && tail->next) {
+        tail = tail->next;
+        entries.emplace_back(
+            param_key_hash(tail->param, strcspn(tail->param, "=")), tail);
+    }
+
+    const size_t len = strcspn(parameter, "=");
+    const uint32_t hash = param_key_hash(parameter, len);
+    for (const auto &entry : entries) {
+        paralist *node = entry.second;
+        if (entry.first == hash && 0 == strncmp(parameter, node->param, len) &&
+            (node->param[len] == '=' || node->param[len] == 0)) {
+            node->used = 1;
+            return node;
+        }
+    }
+    return nullptr;
+}
+
 /************************************************************************/
 /*                              pj_param()                              */
 /*                                                                      */
@@ -142,7 +194,11 @@ PROJVALUE pj_param(PJ_CONTEXT *ctx, paralist *pl, const char *opt) {
         exit(1);
     }
 
-    pl = pj_param_exists(pl, opt);
+    PJParamIndex *index = ctx->paramIndex;
+    if (index != nullptr && index->head == pl && pl != nullptr)
+        pl = index->find(opt);
+    else
+        pl = pj_param_exists(pl, opt);
     if (type == 't') {
         value.i = pl != nullptr;
         return value;
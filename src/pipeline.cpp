@@ -149,6 +149,10 @@ struct PushPop {
 
 static void pipeline_forward_4d(PJ_COORD &point, PJ *P);
 static void pipeline_reverse_4d(PJ_COORD &point, PJ *P);
+static void pipeline_forward_4d_array(PJ_COORD *coo, size_t n, int *err,
+                                      PJ *P);
+static void pipeline_reverse_4d_array(PJ_COORD *coo, size_t n, int *err,
+                                      PJ *P);
 static PJ_XYZ pipeline_forward_3d(PJ_LPZ lpz, PJ *P);
 static PJ_LPZ pipeline_reverse_3d(PJ_XYZ xyz, PJ *P);
 static PJ_XY pipeline_forward(PJ_LP lp, PJ *P);
@@ -192,6 +196,41 @@ static void pipeline_reverse_4d(PJ_COORD &point, PJ *P) {
     }
 }
 
+/* Batched versions of the above: the whole array goes through a step before
+ * moving to the next one, so that the state and code of each step are loaded
+ * once per array rather than once per coordinate. The array stays in cache
+ * between steps, as proj_trans_array() and proj_trans_generic() only hand
+ * blocks of PJ_TRANS_BLOCK_SIZE coordinates to the batched operators.
+ * Coordinates that failed in a previous step are HUGE_VAL and are skipped by
+ * the following ones. */
+static void pipeline_forward_4d_array(PJ_COORD *coo, size_t n, int *err,
+                                      PJ *P) {
+    auto pipeline = static_cast<struct Pipeline *>(P->opaque);
+    for (auto &step : pipeline->steps) {
+        if (!step.omit_fwd) {
+            if (!step.pj->inverted)
+                pj_fwd4d_array(coo, n, err, step.pj);
+            else
+                pj_inv4d_array(coo, n, err, step.pj);
+        }
+    }
+}
+
+static void pipeline_reverse_4d_array(PJ_COORD *coo, size_t n, int *err,
+                                      PJ *P) {
+    auto pipeline = static_cast<struct Pipeline *>(P->opaque);
+    for (auto iterStep = pipeline->steps.rbegin();
+         iterStep != pipeline->steps.rend(); ++iterStep) {
+        const auto &step = *iterStep;
+        if (!step.omit_inv) {
+            if (step.pj->inverted)
+                pj_fwd4d_array(coo, n, err, step.pj);
+            else
+                pj_inv4d_array(coo, n, err, step.pj);
+        }
+    }
+}
+
 static PJ_XYZ pipeline_forward_3d(PJ_LPZ lpz, PJ *P) {
     PJ_COORD point = {{0, 0, 0, 0}};
     point.lpz = lpz;
@@ -319,6 +358,9 @@ static void set_ellipsoid(PJ *P) {
     paralist *cur, *attachment;
     int err = proj_errno_reset(P);
 
+    /* The hashed index of P->params would not see the truncation below */
+    PJParamIndex suspendParamIndex(P->ctx, nullptr);
+
     /* Break the linked list after the global args */
     attachment = nullptr;
     for (cur = P->params; cur != nullptr; cur = cur->next)
@@ -381,6 +423,8 @@ PJ *OPERATION(pipeline, 0) {
 
     P->fwd4d = pipeline_forward_4d;
     P->inv4d = pipeline_reverse_4d;
+    P->fwd4d_array = pipeline_forward_4d_array;
+    P->inv4d_array = pipeline_reverse_4d_array;
     P->fwd3d = pipeline_forward_3d;
     P->inv3d = pipeline_reverse_3d;
     P->fwd = pipeline_forward;
@@ -564,6 +608,7 @@ PJ *OPERATION(pipeline, 0) {
             P->inv = nullptr;
             P->inv3d = nullptr;
             P->inv4d = nullptr;
+            P->inv4d_array = nullptr;
             break;
         }
     }
@@ -685,6 +730,26 @@ static void pop(PJ_COORD &point, PJ *P) {
     }
 }
 
+/* In batched mode, push and pop are applied to all the coordinates of the
+ * array, including the ones that have failed in-between, so that the stacks
+ * remain balanced. Pop is done in reverse order since the stacks are LIFO. */
+static void push_array(PJ_COORD *coo, size_t n, int *, PJ *P) {
+    for (size_t i = 0; i < n; ++i)
+        push(coo[i], P);
+}
+
+static void pop_array(PJ_COORD *coo, size_t n, int *, PJ *P) {
+    for (size_t i = n; i > 0; --i) {
+        PJ_COORD &point = coo[i - 1];
+        if (point.xyzt.x == HUGE_VAL) {
+            PJ_COORD dummy = point;
+            pop(dummy, P);
+        } else {
+            pop(point, P);
+        }
+    }
+}
+
 static PJ *setup_pushpop(PJ *P) {
     auto pushpop =
         static_cast<struct PushPop *>(calloc(1, sizeof(struct PushPop)));
@@ -713,6 +778,8 @@ static PJ *setup_pushpop(PJ *P) {
 PJ *OPERATION(push, 0) {
     P->fwd4d = push;
     P->inv4d = pop;
+    P->fwd4d_array = push_array;
+    P->inv4d_array = pop_array;
 
     return setup_pushpop(P);
 }
@@ -720,6 +787,8 @@ PJ *OPERATION(push, 0) {
 PJ *OPERATION(pop, 0) {
     P->inv4d = push;
     P->fwd4d = pop;
+    P->inv4d_array = push_array;
+    P->fwd4d_array = pop_array;
 
     return setup_pushpop(P);
 }
@@ -578,6 +578,24 @@ void PROJ_DLL proj_grid_cache_set_ttl(PJ_CONTEXT *ctx, int ttl_seconds);
 
 void PROJ_DLL proj_grid_cache_clear(PJ_CONTEXT *ctx);
 
+void PROJ_DLL proj_crs_to_crs_cache_set_enable(PJ_CONTEXT *ctx, int enabled);
+
+void PROJ_DLL proj_crs_to_crs_cache_set_filename(PJ_CONTEXT *ctx,
+                                                 const char *fullname);
+
+void PROJ_DLL proj_grid_block_cache_set_max_size(PJ_CONTEXT *ctx,
+                                                 int max_size_MB);
+
+void PROJ_DLL proj_grid_block_cache_get_stats(PJ_CONTEXT *ctx,
+                                              unsigned long long *out_hits,
+                                              unsigned long long *out_misses,
+                                              unsigned long long *out_evictions);
+
+int PROJ_DLL proj_grid_prefetch_for_area(
+    PJ_CONTEXT *ctx, const char *grid_name, double west_lon_degree,
+    double south_lat_degree, double east_lon_degree, double north_lat_degree,
+    int max_parallel_requests);
+
 int PROJ_DLL proj_is_download_needed(PJ_CONTEXT *ctx,
                                      const char *url_or_filename,
                                      int ignore_ttl_setting);
@@ -650,6 +668,19 @@ int PROJ_DLL proj_trans_bounds_3D(PJ_CONTEXT *context, PJ *P,
                                   double *out_xmax, double *out_ymax,
                                   double *out_zmax, const int densify_pts);
 
+int PROJ_DLL proj_trans_bounds_adaptive(
+    PJ_CONTEXT *context, PJ *P, PJ_DIRECTION direction, double xmin,
+    double ymin, double xmax, double ymax, double *out_xmin, double *out_ymin,
+    double *out_xmax, double *out_ymax, double tolerance,
+    int *out_point_count);
+
+int PROJ_DLL proj_trans_bounds_grid(PJ_CONTEXT *context, PJ *P,
+                                    PJ_DIRECTION direction, double x_origin,
+                                    double y_origin, double cell_width,
+                                    double cell_height, int rows, int cols,
+                                    double *out_bounds, int densify_pts,
+                                    int max_threads);
+
 /*! @cond Doxygen_Suppress */
 
 /* Initializers */
@@ -1225,6 +1256,18 @@ int PROJ_DLL proj_grid_get_info_from_database(
 
 PJ PROJ_DLL *proj_clone(PJ_CONTEXT *ctx, const PJ *obj);
 
+/*! @cond Doxygen_Suppress */
+typedef struct PJ_OPERATION_PLAN PJ_OPERATION_PLAN;
+/*! @endcond */
+
+PJ_OPERATION_PLAN PROJ_DLL *proj_operation_plan_create(PJ_CONTEXT *ctx,
+                                                       const PJ *obj);
+
+PJ PROJ_DLL *proj_operation_plan_create_handle(PJ_CONTEXT *ctx,
+                                               const PJ_OPERATION_PLAN *plan);
+
+void PROJ_DLL proj_operation_plan_destroy(PJ_OPERATION_PLAN *plan);
+
 PJ_OBJ_LIST PROJ_DLL *
 proj_create_from_name(PJ_CONTEXT *ctx, const char *auth_name,
                       const char *searchedName, const PJ_TYPE *types,
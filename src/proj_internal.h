@@ -77,7 +77,9 @@
 #include "proj/coordinateoperation.hpp"
 
 #include <cmath>
+#include <cstdint>
 #include <string>
+#include <unordered_map>
 #include <vector>
 
 #include "proj.h"
@@ -215,6 +217,8 @@ proj_context_delete_cpp_context(struct projCppContext *cppContext);
 
 bool pj_fwd4d(PJ_COORD &coo, PJ *P);
 bool pj_inv4d(PJ_COORD &coo, PJ *P);
+void pj_fwd4d_array(PJ_COORD *coo, size_t n, int *err, PJ *P);
+void pj_inv4d_array(PJ_COORD *coo, size_t n, int *err, PJ *P);
 
 PJ_COORD PROJ_DLL pj_approx_2D_trans(PJ *P, PJ_DIRECTION direction,
                                      PJ_COORD coo);
@@ -303,10 +307,21 @@ PJ_OPERATOR:
     A function taking a reference to a PJ_COORD and a pointer-to-PJ as args,
 applying the PJ to the PJ_COORD, and modifying in-place the passed PJ_COORD.
 
+PJ_ARRAY_OPERATOR:
+
+    The batched counterpart of PJ_OPERATOR: a function taking a pointer to an
+array of n PJ_COORD, an array of n error codes and a pointer-to-PJ as args,
+applying the PJ to all the PJ_COORD in-place. Coordinates whose x component
+is HUGE_VAL on input have already failed and must be left untouched. A
+coordinate that fails is set to HUGE_VAL and, if a reason is known, the
+corresponding error code is set (error codes of other coordinates are not
+modified).
+
 *****************************************************************************/
 typedef PJ *(*PJ_CONSTRUCTOR)(PJ *);
 typedef PJ *(*PJ_DESTRUCTOR)(PJ *, int);
 typedef void (*PJ_OPERATOR)(PJ_COORD &, PJ *);
+typedef void (*PJ_ARRAY_OPERATOR)(PJ_COORD *, size_t, int *, PJ *);
 /****************************************************************************/
 
 /* datum_type values */
@@ -397,6 +412,28 @@ struct PJCoordOperation {
                   ? proj_clone(ctx, other.pjDstGeocentricToLonLat)
                   : nullptr) {}
 
+    // Copy of other, except that its PJ objects are replaced by the passed
+    // ones, of which ownership is taken.
+    PJCoordOperation(const PJCoordOperation &other, PJ *pjIn,
+                     PJ *pjSrcGeocentricToLonLatIn,
+                     PJ *pjDstGeocentricToLonLatIn)
+        : idxInOriginalList(other.idxInOriginalList), minxSrc(other.minxSrc),
+          minySrc(other.minySrc), maxxSrc(other.maxxSrc),
+          maxySrc(other.maxySrc), minxDst(other.minxDst),
+          minyDst(other.minyDst), maxxDst(other.maxxDst),
+          maxyDst(other.maxyDst), pj(pjIn), name(other.name),
+          accuracy(other.accuracy), pseudoArea(other.pseudoArea),
+          areaName(other.areaName), isOffshore(other.isOffshore),
+          isUnknownAreaName(other.isUnknownAreaName),
+          isPriorityOp(other.isPriorityOp),
+          srcIsLonLatDegree(other.srcIsLonLatDegree),
+          srcIsLatLonDegree(other.srcIsLatLonDegree),
+          dstIsLonLatDegree(other.dstIsLonLatDegree),
+          dstIsLatLonDegree(other.dstIsLatLonDegree),
+          pjSrcGeocentricToLonLat(pjSrcGeocentricToLonLatIn),
+          pjDstGeocentricToLonLat(pjDstGeocentricToLonLatIn),
+          isInstantiableCached(other.isInstantiableCached) {}
+
     PJCoordOperation(PJCoordOperation &&other)
         : idxInOriginalList(other.idxInOriginalList), minxSrc(other.minxSrc),
           minySrc(other.minySrc), maxxSrc(other.maxxSrc),
@@ -410,7 +447,8 @@ struct PJCoordOperation {
           srcIsLonLatDegree(other.srcIsLonLatDegree),
           srcIsLatLonDegree(other.srcIsLatLonDegree),
           dstIsLonLatDegree(other.dstIsLonLatDegree),
-          dstIsLatLonDegree(other.dstIsLatLonDegree) {
+          dstIsLatLonDegree(other.dstIsLatLonDegree),
+          isInstantiableCached(other.isInstantiableCached) {
         pj = other.pj;
         other.pj = nullptr;
         pjSrcGeocentricToLonLat = other.pjSrcGeocentricToLonLat;
@@ -446,6 +484,48 @@ struct PJCoordOperation {
     mutable int isInstantiableCached = INSTANTIABLE_STATUS_UNKNOWN;
 };
 
+/* Index over the areas of use of alternativeCoordinateOperations, used by
+ * proj_trans() to avoid scanning the whole list of operations for each point.
+ *
+ * The edges of the bounding boxes of the operations partition the plane into
+ * rectangular cells. Inside a cell, the set of operations whose area of use
+ * contains a point is constant, and so is the result of
+ * pj_get_suggested_operation(), which is thus only computed once per cell.
+ */
+struct PJCoordOperationIndex {
+    struct Direction {
+        // false if the bounding boxes are not expressed in the coordinates
+        // of the points (non-world area of use of a geocentric CRS)
+        bool usable = false;
+
+        // whether pj_get_suggested_operation() may normalize the longitude
+        // in x (resp. y) of points outside of [-180,180]
+        bool normalizeX = false;
+        bool normalizeY = false;
+
+        // Sorted, unique coordinates of the edges of the bounding boxes
+        std::vector<double> xEdges{};
+        std::vector<double> yEdges{};
+
+        // Operation selected for the cells already visited, indexed by
+        // the skipNonInstantiable argument of pj_get_suggested_operation()
+        std::unordered_map<size_t, int> cellOps[2]{};
+
+        // Last visited cell, as open intervals, and its selected operation
+        bool hasLastCell = false;
+        bool lastSkipNonInstantiable = false;
+        double lastMinX = 0.0;
+        double lastMinY = 0.0;
+        double lastMaxX = 0.0;
+        double lastMaxY = 0.0;
+        int lastOp = -1;
+    };
+
+    bool built = false;
+    Direction fwd{};
+    Direction inv{};
+};
+
 enum class TMercAlgo {
     AUTO, // Poder/Engsager if far from central meridian, otherwise
           // Evenden/Snyder
@@ -522,6 +602,12 @@ struct PJconsts {
     PJ_OPERATOR fwd4d = nullptr;
     PJ_OPERATOR inv4d = nullptr;
 
+    /* Optional batched versions of fwd4d/inv4d. When not set, pj_fwd4d_array()
+     * and pj_inv4d_array() fall back to calling pj_fwd4d()/pj_inv4d() on each
+     * coordinate */
+    PJ_ARRAY_OPERATOR fwd4d_array = nullptr;
+    PJ_ARRAY_OPERATOR inv4d_array = nullptr;
+
     PJ_DESTRUCTOR destructor = nullptr;
     void (*reassign_context)(PJ *, PJ_CONTEXT *) = nullptr;
 
@@ -682,6 +768,7 @@ struct PJconsts {
      proj_create_crs_to_crs() alternative coordinate operations
     **************************************************************************************/
     std::vector<PJCoordOperation> alternativeCoordinateOperations{};
+    PJCoordOperationIndex alternativeCoordinateOperationsIndex{};
     int iCurCoordOp = -1;
     bool errorIfBestTransformationNotAvailable = false;
     bool warnIfBestTransformationNotAvailable =
@@ -768,6 +855,18 @@ struct projGridChunkCache {
     int ttl = 86400; // 1 day
 };
 
+NS_PROJ_START
+class CrsToCrsCache;
+NS_PROJ_END
+
+struct projCrsToCrsCache {
+    bool enabled = false;
+    std::string filename{};
+    // Opened on first use, and kept open for the lifetime of the context.
+    // Not shared by cloned contexts.
+    std::shared_ptr<NS_PROJ::CrsToCrsCache> handle{};
+};
+
 struct projFileApiCallbackAndData {
     PROJ_FILE_HANDLE *(*open_cbk)(PJ_CONTEXT *ctx, const char *filename,
                                   PROJ_OPEN_ACCESS access,
@@ -825,6 +924,7 @@ struct PROJ_GCC_DLL pj_ctx {
     std::map<std::string, std::string> lookupedFiles{};
 
     bool defer_grid_opening = false; // set transiently by pj_obj_create()
+                                     // and proj_operation_plan_create_handle()
 
     projFileApiCallbackAndData fileApi{};
     std::string custom_sqlite3_vfs_name{};
@@ -837,6 +937,7 @@ struct PROJ_GCC_DLL pj_ctx {
     std::string ca_bundle_path{};
     bool native_ca = false;
     projGridChunkCache gridChunkCache{};
+    projCrsToCrsCache crsToCrsCache{};
     TMercAlgo defaultTmercAlgo =
         TMercAlgo::PODER_ENGSAGER; // can be overridden by content of proj.ini
     // END ini file settings
@@ -847,6 +948,10 @@ struct PROJ_GCC_DLL pj_ctx {
     int pipelineInitRecursiongCounter =
         0; // to avoid potential infinite recursion in pipeline.cpp
 
+    // Index of the parameters of the PJ being set up, if any. Set
+    // transiently by pj_init_ctx()
+    struct PJParamIndex *paramIndex = nullptr;
+
     pj_ctx() = default;
     pj_ctx(const pj_ctx &);
     ~pj_ctx();
@@ -912,6 +1017,27 @@ paralist PROJ_DLL *pj_param_exists(paralist *list, const char *parameter);
 paralist PROJ_DLL *pj_mkparam(const char *);
 paralist *pj_mkparam_ws(const char *str, const char **next_str);
 
+/* Table of the hashed keys of a paralist, through which pj_param() looks them
+ * up while pj_init_ctx() sets up a PJ, instead of string comparing the key of
+ * each node of the list on each call. The table is installed on ctx for the
+ * lifetime of the object. Nodes appended to the list are indexed on the next
+ * lookup, but code that otherwise rewires the list must suspend the index with
+ * a nested instance built on a null list. */
+struct PJParamIndex {
+    PJParamIndex(PJ_CONTEXT *ctxIn, paralist *list);
+    ~PJParamIndex();
+    PJParamIndex(const PJParamIndex &) = delete;
+    PJParamIndex &operator=(const PJParamIndex &) = delete;
+
+    paralist *find(const char *parameter);
+
+    PJ_CONTEXT *ctx;
+    paralist *head;
+    paralist *tail = nullptr;
+    std::vector<std::pair<uint32_t, paralist *>> entries{};
+    PJParamIndex *previous;
+};
+
 int PROJ_DLL pj_ell_set(PJ_CONTEXT *ctx, paralist *, double *, double *);
 int pj_datum_set(PJ_CONTEXT *, paralist *, PJ *);
 int pj_angular_units_set(paralist *, PJ *);
@@ -995,6 +1121,24 @@ std::vector<PJCoordOperation>
 pj_create_prepared_operations(PJ_CONTEXT *ctx, const PJ *source_crs,
                               const PJ *target_crs, PJ_OBJ_LIST *op_list);
 
+bool pj_operation_list_export(PJ_CONTEXT *ctx, const PJ_OBJ_LIST *op_list,
+                              std::vector<std::string> &out);
+PJ_OBJ_LIST *pj_operation_list_import(PJ_CONTEXT *ctx, const PJ *source_crs,
+                                      const PJ *target_crs,
+                                      const std::vector<std::string> &in);
+
+// Cached version of proj_create_operations(), used by
+// proj_create_crs_to_crs(). optionsKey must describe all the settings of
+// operation_ctx.
+PJ_OBJ_LIST *
+pj_create_operations_cached(PJ_CONTEXT *ctx, const PJ *source_crs,
+                            const PJ *target_crs,
+                            const PJ_OPERATION_FACTORY_CONTEXT *operation_ctx,
+                            const std::string &optionsKey);
+
+// Exported for testing purposes only
+std::string PROJ_DLL pj_context_get_crs_to_crs_cache_filename(PJ_CONTEXT *ctx);
+
 int pj_get_suggested_operation(PJ_CONTEXT *ctx,
                                const std::vector<PJCoordOperation> &opList,
                                const int iExcluded[2], bool skipNonInstantiable,
@@ -200,6 +200,8 @@
 #define proj_crs_info_list_destroy internal_proj_crs_info_list_destroy
 #define proj_crs_is_derived internal_proj_crs_is_derived
 #define proj_crs_promote_to_3D internal_proj_crs_promote_to_3D
+#define proj_crs_to_crs_cache_set_enable internal_proj_crs_to_crs_cache_set_enable
+#define proj_crs_to_crs_cache_set_filename internal_proj_crs_to_crs_cache_set_filename
 #define proj_cs_get_axis_count internal_proj_cs_get_axis_count
 #define proj_cs_get_axis_info internal_proj_cs_get_axis_info
 #define proj_cs_get_type internal_proj_cs_get_type
@@ -247,6 +249,8 @@
 #define proj_get_target_crs internal_proj_get_target_crs
 #define proj_get_type internal_proj_get_type
 #define proj_get_units_from_database internal_proj_get_units_from_database
+#define proj_grid_block_cache_get_stats internal_proj_grid_block_cache_get_stats
+#define proj_grid_block_cache_set_max_size internal_proj_grid_block_cache_set_max_size
 #define proj_grid_cache_clear internal_proj_grid_cache_clear
 #define proj_grid_cache_set_enable internal_proj_grid_cache_set_enable
 #define proj_grid_cache_set_filename internal_proj_grid_cache_set_filename
@@ -254,6 +258,7 @@
 #define proj_grid_cache_set_ttl internal_proj_grid_cache_set_ttl
 #define proj_grid_get_info_from_database internal_proj_grid_get_info_from_database
 #define proj_grid_info internal_proj_grid_info
+#define proj_grid_prefetch_for_area internal_proj_grid_prefetch_for_area
 #define proj_identify internal_proj_identify
 #define proj_info internal_proj_info
 #define projinfo internal_projinfo
@@ -292,6 +297,9 @@
 #define proj_operation_factory_context_set_grid_availability_use internal_proj_operation_factory_context_set_grid_availability_use
 #define proj_operation_factory_context_set_spatial_criterion internal_proj_operation_factory_context_set_spatial_criterion
 #define proj_operation_factory_context_set_use_proj_alternative_grid_names internal_proj_operation_factory_context_set_use_proj_alternative_grid_names
+#define proj_operation_plan_create internal_proj_operation_plan_create
+#define proj_operation_plan_create_handle internal_proj_operation_plan_create_handle
+#define proj_operation_plan_destroy internal_proj_operation_plan_destroy
 #define proj_pj_info internal_proj_pj_info
 #define proj_prime_meridian_get_parameters internal_proj_prime_meridian_get_parameters
 #define proj_query_geodetic_crs_from_datum internal_proj_query_geodetic_crs_from_datum
@@ -307,6 +315,8 @@
 #define proj_trans_array internal_proj_trans_array
 #define proj_trans_bounds internal_proj_trans_bounds
 #define proj_trans_bounds_3D internal_proj_trans_bounds_3D
+#define proj_trans_bounds_adaptive internal_proj_trans_bounds_adaptive
+#define proj_trans_bounds_grid internal_proj_trans_bounds_grid
 #define proj_trans_generic internal_proj_trans_generic
 #define proj_trans_get_last_used_operation internal_proj_trans_get_last_used_operation
 #define proj_unit_list_destroy internal_proj_unit_list_destroy
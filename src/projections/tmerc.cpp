@@ -13,6 +13,8 @@
 #include <errno.h>
 #include <math.h>
 
+#include <algorithm>
+
 #include "proj.h"
 #include "proj_internal.h"
 #include <math.h>
@@ -62,6 +64,22 @@ struct tmerc_data {
 /* Constant for "exact" transverse mercator */
 #define PROJ_ETMERC_ORDER 6
 
+/* Number of coordinates processed at once by the batched "exact" transverse
+ * mercator */
+#define PROJ_ETMERC_TILE_SIZE 64
+
+/* Let the compiler generate AVX2 and baseline (SSE2) versions of the batched
+ * kernels, selected at runtime according to the capabilities of the CPU.
+ * FMA (implied by AVX-512) is deliberately not used, so that the results are
+ * bit-identical to the ones of the per-coordinate code path. */
+#if defined(__GNUC__) && !defined(__clang__) && defined(__x86_64__) &&         \
+    defined(__linux__) && defined(__GLIBC__)
+#define PROJ_ETMERC_TARGET_CLONES                                              \
+    __attribute__((target_clones("avx2", "default")))
+#else
+#define PROJ_ETMERC_TARGET_CLONES
+#endif
+
 /*****************************************************************************/
 //
 //                  Approximate Transverse Mercator functions
@@ -449,6 +467,188 @@ static PJ_LP exact_e_inv(PJ_XY xy, PJ *P) {
     return lp;
 }
 
+/* Complex Clenshaw summation on PROJ_ETMERC_TILE_SIZE arguments at once.
+ * Same computation as clenS(), but with the loop on the coefficients
+ * outermost, so that the loop on the arguments can be vectorized. */
+PROJ_ETMERC_TARGET_CLONES
+static void clenS_tile(const double *a, int size, const double *sin_arg_r,
+                       const double *cos_arg_r, const double *sinh_arg_i,
+                       const double *cosh_arg_i, double *R, double *I) {
+    constexpr int N = PROJ_ETMERC_TILE_SIZE;
+    double r[N], i[N], hr[N], hr1[N], hi[N], hi1[N];
+
+    /* arguments */
+    for (int j = 0; j < N; ++j) {
+        r[j] = 2 * cos_arg_r[j] * cosh_arg_i[j];
+        i[j] = -2 * sin_arg_r[j] * sinh_arg_i[j];
+        hi1[j] = hr1[j] = hi[j] = 0;
+        hr[j] = a[size - 1];
+    }
+
+    /* summation loop */
+    for (int k = size - 2; k >= 0; --k) {
+        const double ak = a[k];
+        for (int j = 0; j < N; ++j) {
+            const double hr2 = hr1[j];
+            const double hi2 = hi1[j];
+            hr1[j] = hr[j];
+            hi1[j] = hi[j];
+            hr[j] = -hr2 + r[j] * hr1[j] - i[j] * hi1[j] + ak;
+            hi[j] = -hi2 + i[j] * hr1[j] + r[j] * hi1[j];
+        }
+    }
+
+    for (int j = 0; j < N; ++j) {
+        const double rj = sin_arg_r[j] * cosh_arg_i[j];
+        const double ij = cos_arg_r[j] * sinh_arg_i[j];
+        R[j] = rj * hr[j] - ij * hi[j];
+        I[j] = rj * hi[j] + ij * hr[j];
+    }
+}
+
+/* Ellipsoidal, forward, on an array of coordinates. Same computation as
+ * exact_e_fwd() */
+static void exact_e_fwd_array(PJ_COORD *coo, size_t n, int *err, PJ *P) {
+    constexpr size_t N = PROJ_ETMERC_TILE_SIZE;
+    const auto *Q = &(static_cast<struct tmerc_data *>(P->opaque)->exact);
+    double Cn[N], Ce[N], sin_arg_r[N], cos_arg_r[N], sinh_arg_i[N],
+        cosh_arg_i[N], dCn[N], dCe[N];
+
+    for (size_t start = 0; start < n; start += N) {
+        PJ_COORD *tile = coo + start;
+        const size_t nTile = std::min(n - start, N);
+
+        for (size_t j = 0; j < N; ++j) {
+            if (j >= nTile || tile[j].v[0] == HUGE_VAL) {
+                /* neutral values for unused lanes */
+                Cn[j] = Ce[j] = 0;
+                sin_arg_r[j] = sinh_arg_i[j] = 0;
+                cos_arg_r[j] = cosh_arg_i[j] = 1;
+                continue;
+            }
+            const PJ_LP lp = tile[j].lp;
+
+            /* ell. LAT, LNG -> Gaussian LAT, LNG */
+            Cn[j] = pj_auxlat_convert(lp.phi, Q->cbg, PROJ_ETMERC_ORDER);
+            /* Gaussian LAT, LNG -> compl. sph. LAT */
+            const double sin_Cn = sin(Cn[j]);
+            const double cos_Cn = cos(Cn[j]);
+            const double sin_Ce = sin(lp.lam);
+            const double cos_Ce = cos(lp.lam);
+
+            const double cos_Cn_cos_Ce = cos_Cn * cos_Ce;
+            Cn[j] = atan2(sin_Cn, cos_Cn_cos_Ce);
+
+            const double inv_denom_tan_Ce = 1. / hypot(sin_Cn, cos_Cn_cos_Ce);
+            const double tan_Ce = sin_Ce * cos_Cn * inv_denom_tan_Ce;
+
+            /* compl. sph. N, E -> ell. norm. N, E */
+            Ce[j] = asinh(tan_Ce);
+
+            /* See exact_e_fwd() for the derivation of the following */
+            const double two_inv_denom_tan_Ce = 2 * inv_denom_tan_Ce;
+            const double two_inv_denom_tan_Ce_square =
+                two_inv_denom_tan_Ce * inv_denom_tan_Ce;
+            const double tmp_r = cos_Cn_cos_Ce * two_inv_denom_tan_Ce_square;
+            sin_arg_r[j] = sin_Cn * tmp_r;
+            cos_arg_r[j] = cos_Cn_cos_Ce * tmp_r - 1;
+            sinh_arg_i[j] = tan_Ce * two_inv_denom_tan_Ce;
+            cosh_arg_i[j] = two_inv_denom_tan_Ce_square - 1;
+        }
+
+        clenS_tile(Q->gtu, PROJ_ETMERC_ORDER, sin_arg_r, cos_arg_r,
+                   sinh_arg_i, cosh_arg_i, dCn, dCe);
+
+        for (size_t j = 0; j < nTile; ++j) {
+            if (tile[j].v[0] == HUGE_VAL)
+                continue;
+            const double CnFinal = Cn[j] + dCn[j];
+            const double CeFinal = Ce[j] + dCe[j];
+            if (fabs(CeFinal) <= 2.623395162778) {
+                tile[j].xy.y = Q->Qn * CnFinal + Q->Zb; /* Northing */
+                tile[j].xy.x = Q->Qn * CeFinal;         /* Easting  */
+            } else {
+                err[start + j] = proj_errno_set(
+                    P, PROJ_ERR_COORD_TRANSFM_OUTSIDE_PROJECTION_DOMAIN);
+                tile[j].xy.x = tile[j].xy.y = HUGE_VAL;
+            }
+        }
+    }
+}
+
+/* Ellipsoidal, inverse, on an array of coordinates. Same computation as
+ * exact_e_inv() */
+static void exact_e_inv_array(PJ_COORD *coo, size_t n, int *err, PJ *P) {
+    constexpr size_t N = PROJ_ETMERC_TILE_SIZE;
+    const auto *Q = &(static_cast<struct tmerc_data *>(P->opaque)->exact);
+    double Cn[N], Ce[N], sin_arg_r[N], cos_arg_r[N], sinh_arg_i[N],
+        cosh_arg_i[N], dCn_ignored[N], dCe[N];
+    bool valid[N];
+
+    for (size_t start = 0; start < n; start += N) {
+        PJ_COORD *tile = coo + start;
+        const size_t nTile = std::min(n - start, N);
+
+        for (size_t j = 0; j < N; ++j) {
+            valid[j] = false;
+            if (j < nTile && tile[j].v[0] != HUGE_VAL) {
+                /* normalize N, E */
+                Cn[j] = (tile[j].xy.y - Q->Zb) / Q->Qn;
+                Ce[j] = tile[j].xy.x / Q->Qn;
+                valid[j] = fabs(Ce[j]) <= 2.623395162778; /* 150 degrees */
+            }
+            if (!valid[j]) {
+                /* neutral values for unused lanes */
+                sin_arg_r[j] = sinh_arg_i[j] = 0;
+                cos_arg_r[j] = cosh_arg_i[j] = 1;
+                continue;
+            }
+
+            /* norm. N, E -> compl. sph. LAT, LNG */
+            sin_arg_r[j] = sin(2 * Cn[j]);
+            cos_arg_r[j] = cos(2 * Cn[j]);
+
+            const double exp_2_Ce = exp(2 * Ce[j]);
+            const double half_inv_exp_2_Ce = 0.5 / exp_2_Ce;
+            sinh_arg_i[j] = 0.5 * exp_2_Ce - half_inv_exp_2_Ce;
+            cosh_arg_i[j] = 0.5 * exp_2_Ce + half_inv_exp_2_Ce;
+        }
+
+        clenS_tile(Q->utg, PROJ_ETMERC_ORDER, sin_arg_r, cos_arg_r,
+                   sinh_arg_i, cosh_arg_i, dCn_ignored, dCe);
+
+        for (size_t j = 0; j < nTile; ++j) {
+            if (tile[j].v[0] == HUGE_VAL)
+                continue;
+            if (!valid[j]) {
+                err[start + j] = proj_errno_set(
+                    P, PROJ_ERR_COORD_TRANSFM_OUTSIDE_PROJECTION_DOMAIN);
+                tile[j].lp.phi = tile[j].lp.lam = HUGE_VAL;
+                continue;
+            }
+            double CnFinal = Cn[j] + dCn_ignored[j];
+            double CeFinal = Ce[j] + dCe[j];
+
+            /* compl. sph. LAT -> Gaussian LAT, LNG */
+            const double sin_Cn = sin(CnFinal);
+            const double cos_Cn = cos(CnFinal);
+
+            /* See exact_e_inv() for the derivation of the following */
+            const double sinhCe = sinh(CeFinal);
+            CeFinal = atan2(sinhCe, cos_Cn);
+            const double modulus_Ce = hypot(sinhCe, cos_Cn),
+                         rr = hypot(sin_Cn, modulus_Ce);
+            CnFinal = atan2(sin_Cn, modulus_Ce);
+
+            /* Gaussian LAT, LNG -> ell. LAT, LNG */
+            tile[j].lp.phi = pj_auxlat_convert(CnFinal, sin_Cn / rr,
+                                               modulus_Ce / rr, Q->cgb,
+                                               PROJ_ETMERC_ORDER);
+            tile[j].lp.lam = CeFinal;
+        }
+    }
+}
+
 static PJ *setup_exact(PJ *P) {
     auto *Q = &(static_cast<struct tmerc_data *>(P->opaque)->exact);
 
@@ -537,6 +737,8 @@ static PJ *setup(PJ *P, TMercAlgo eAlg) {
         setup_exact(P);
         P->inv = exact_e_inv;
         P->fwd = exact_e_fwd;
+        P->fwd4d_array = exact_e_fwd_array;
+        P->inv4d_array = exact_e_inv_array;
         break;
     }
 
@@ -33,6 +33,8 @@
 #include "proj/util.hpp"
 
 #include <functional>
+#include <limits>
+#include <queue>
 #include <vector>
 
 //! @cond Doxygen_Suppress
@@ -74,6 +76,14 @@ struct RectObj {
         return minx <= x && maxx >= x && miny <= y && maxy >= y;
     }
 
+    /* Returns the squared distance between this rectangle and the
+     * specified point (0 if it contains it) */
+    inline double squaredDistanceTo(double x, double y) const {
+        const double dx = x < minx ? minx - x : x > maxx ? x - maxx : 0.0;
+        const double dy = y < miny ? miny - y : y > maxy ? y - maxy : 0.0;
+        return dx * dx + dy * dy;
+    }
+
     /* Return whether this rectangles is different from other */
     inline bool operator!=(const RectObj &other) const {
         return minx != other.minx || miny != other.miny || maxx != other.maxx ||
@@ -123,6 +133,46 @@ template <class Feature> class QuadTree {
         search(root, x, y, features);
     }
 
+    /** Visit features by increasing distance of their node to (x,y), to find
+     * the nearest one.
+     *
+     * visitor is called with each feature whose bounds are at a squared
+     * distance to (x,y) lower or equal to the value returned by its previous
+     * call (infinity initially). It must return the squared distance to
+     * (x,y) of the nearest feature found so far, which must not be lower
+     * than the squared distance to the bounds of that feature.
+     */
+    void
+    searchNearest(double x, double y,
+                  const std::function<double(const Feature &)> &visitor) const {
+        using NodeDist = std::pair<double, const Node *>;
+        const auto cmp = [](const NodeDist &a, const NodeDist &b) {
+            return a.first > b.first;
+        };
+        std::priority_queue<NodeDist, std::vector<NodeDist>, decltype(cmp)>
+            queue(cmp);
+        double maxDist2 = std::numeric_limits<double>::infinity();
+        queue.emplace(root.rect.squaredDistanceTo(x, y), &root);
+        while (!queue.empty()) {
+            const auto nodeDist = queue.top();
+            queue.pop();
+            // All remaining nodes are farther than the nearest feature
+            if (nodeDist.first > maxDist2)
+                break;
+            const Node *node = nodeDist.second;
+            for (const auto &pair : node->features) {
+                if (pair.second.squaredDistanceTo(x, y) <= maxDist2) {
+                    maxDist2 = visitor(pair.first);
+                }
+            }
+            for (const auto &subnode : node->subnodes) {
+                const double dist2 = subnode.rect.squaredDistanceTo(x, y);
+                if (dist2 <= maxDist2)
+                    queue.emplace(dist2, &subnode);
+            }
+        }
+    }
+
   private:
     void splitBounds(const RectObj &in, RectObj &out1, RectObj &out2) {
         // The output bounds will be very similar to the input bounds,
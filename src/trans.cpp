@@ -33,6 +33,7 @@
 #include "proj_internal.h"
 #include <math.h>
 
+#include <algorithm>
 #include <cmath>
 #include <limits>
 
@@ -175,6 +176,135 @@ int pj_get_suggested_operation(PJ_CONTEXT *,
     return iBest;
 }
 
+/**************************************************************************************/
+static void pj_build_coord_operation_index(PJ *P)
+/**************************************************************************************/
+{
+    auto &index = P->alternativeCoordinateOperationsIndex;
+    index.built = true;
+    for (int iDir = 0; iDir < 2; ++iDir) {
+        auto &dir = iDir == 0 ? index.fwd : index.inv;
+        dir.usable = true;
+        for (const auto &alt : P->alternativeCoordinateOperations) {
+            const PJ *geocentricToLonLat =
+                iDir == 0 ? alt.pjSrcGeocentricToLonLat
+                          : alt.pjDstGeocentricToLonLat;
+            const double minx = iDir == 0 ? alt.minxSrc : alt.minxDst;
+            const double miny = iDir == 0 ? alt.minySrc : alt.minyDst;
+            const double maxx = iDir == 0 ? alt.maxxSrc : alt.maxxDst;
+            const double maxy = iDir == 0 ? alt.maxySrc : alt.maxyDst;
+            if (geocentricToLonLat) {
+                // A world area of use matches all points, and thus does
+                // not split cells.
+                if (minx == -180 && miny == -90 && maxx == 180 && maxy == 90)
+                    continue;
+                dir.usable = false;
+                break;
+            }
+            if (std::isnan(minx) || std::isnan(miny) || std::isnan(maxx) ||
+                std::isnan(maxy)) {
+                dir.usable = false;
+                break;
+            }
+            dir.xEdges.push_back(minx);
+            dir.xEdges.push_back(maxx);
+            dir.yEdges.push_back(miny);
+            dir.yEdges.push_back(maxy);
+            if (iDir == 0 ? alt.srcIsLonLatDegree : alt.dstIsLonLatDegree)
+                dir.normalizeX = true;
+            if (iDir == 0 ? alt.srcIsLatLonDegree : alt.dstIsLatLonDegree)
+                dir.normalizeY = true;
+        }
+        if (!dir.usable) {
+            dir.xEdges.clear();
+            dir.yEdges.clear();
+            continue;
+        }
+        for (auto *edges : {&dir.xEdges, &dir.yEdges}) {
+            std::sort(edges->begin(), edges->end());
+            edges->erase(std::unique(edges->begin(), edges->end()),
+                         edges->end());
+        }
+    }
+}
+
+/**************************************************************************************/
+static int pj_get_suggested_operation_indexed(PJ *P, bool skipNonInstantiable,
+                                              PJ_DIRECTION direction,
+                                              PJ_COORD coord)
+/**************************************************************************************/
+{
+    /* Same result as pj_get_suggested_operation() without excluded operations,
+       but computed once per cell of alternativeCoordinateOperationsIndex */
+    constexpr int iExcluded[2] = {-1, -1};
+    auto &index = P->alternativeCoordinateOperationsIndex;
+    if (!index.built)
+        pj_build_coord_operation_index(P);
+    auto &dir = direction == PJ_FWD ? index.fwd : index.inv;
+
+    const double x = coord.xyzt.x;
+    const double y = coord.xyzt.y;
+    // Longitude normalization may move a point to another cell
+    if (!dir.usable || std::isnan(x) || std::isnan(y) ||
+        (dir.normalizeX && !(x >= -180.0 && x <= 180.0)) ||
+        (dir.normalizeY && !(y >= -180.0 && y <= 180.0))) {
+        return pj_get_suggested_operation(P->ctx,
+                                          P->alternativeCoordinateOperations,
+                                          iExcluded, skipNonInstantiable,
+                                          direction, coord);
+    }
+
+    // Fast path for spatially coherent streams of points
+    if (dir.hasLastCell && dir.lastSkipNonInstantiable == skipNonInstantiable &&
+        x > dir.lastMinX && x < dir.lastMaxX && y > dir.lastMinY &&
+        y < dir.lastMaxY) {
+        return dir.lastOp;
+    }
+
+    // Points on an edge belong to no cell
+    const auto xIter =
+        std::lower_bound(dir.xEdges.begin(), dir.xEdges.end(), x);
+    const auto yIter =
+        std::lower_bound(dir.yEdges.begin(), dir.yEdges.end(), y);
+    if ((xIter != dir.xEdges.end() && *xIter == x) ||
+        (yIter != dir.yEdges.end() && *yIter == y)) {
+        return pj_get_suggested_operation(P->ctx,
+                                          P->alternativeCoordinateOperations,
+                                          iExcluded, skipNonInstantiable,
+                                          direction, coord);
+    }
+    const size_t ix = static_cast<size_t>(xIter - dir.xEdges.begin());
+    const size_t iy = static_cast<size_t>(yIter - dir.yEdges.begin());
+    const size_t cell = ix * (dir.yEdges.size() + 1) + iy;
+
+    // Bound the memory used by pathological inputs
+    constexpr size_t MAX_CACHED_CELLS = 65536;
+    auto &cellOps = dir.cellOps[skipNonInstantiable ? 1 : 0];
+    int iBest;
+    const auto cellIter = cellOps.find(cell);
+    if (cellIter != cellOps.end()) {
+        iBest = cellIter->second;
+    } else {
+        iBest = pj_get_suggested_operation(P->ctx,
+                                           P->alternativeCoordinateOperations,
+                                           iExcluded, skipNonInstantiable,
+                                           direction, coord);
+        if (cellOps.size() >= MAX_CACHED_CELLS)
+            cellOps.clear();
+        cellOps[cell] = iBest;
+    }
+
+    constexpr double inf = std::numeric_limits<double>::infinity();
+    dir.hasLastCell = true;
+    dir.lastSkipNonInstantiable = skipNonInstantiable;
+    dir.lastMinX = ix > 0 ? dir.xEdges[ix - 1] : -inf;
+    dir.lastMaxX = ix < dir.xEdges.size() ? dir.xEdges[ix] : inf;
+    dir.lastMinY = iy > 0 ? dir.yEdges[iy - 1] : -inf;
+    dir.lastMaxY = iy < dir.yEdges.size() ? dir.yEdges[iy] : inf;
+    dir.lastOp = iBest;
+    return iBest;
+}
+
 /**************************************************************************************/
 void pj_warn_about_missing_grid(PJ *P)
 /**************************************************************************************/
@@ -210,6 +340,93 @@ void pj_warn_about_missing_grid(PJ *P)
            msg.c_str());
 }
 
+/* Number of coordinates handed at once to the batched operators by
+ * proj_trans_array() and proj_trans_generic() */
+constexpr size_t PJ_TRANS_BLOCK_SIZE = 256;
+
+/**************************************************************************************/
+static bool pj_trans_can_use_array_operators(const PJ *P)
+/**************************************************************************************/
+{
+    return P->alternativeCoordinateOperations.empty() &&
+           (P->iso_obj == nullptr || P->iso_obj_is_coordinate_operation);
+}
+
+/**************************************************************************************/
+static void pj_trans_block(PJ *P, PJ_DIRECTION direction, PJ_COORD *coord,
+                           size_t n, int *err) {
+    /***************************************************************************************
+    Apply the transformation P to an array of at most PJ_TRANS_BLOCK_SIZE
+    coordinates, with the same semantics as calling proj_trans() on each of
+    them. err[i] receives the error code of coordinate i (or 0).
+
+    P must be such that pj_trans_can_use_array_operators(P) is true.
+    ***************************************************************************************/
+    for (size_t i = 0; i < n; i++)
+        err[i] = 0;
+
+    if (direction == PJ_IDENT)
+        return;
+    if (P->inverted)
+        direction = pj_opposite_direction(direction);
+
+    P->iCurCoordOp =
+        0; // dummy value, to be used by proj_trans_get_last_used_operation()
+    if (P->hasCoordinateEpoch) {
+        for (size_t i = 0; i < n; i++)
+            coord[i].xyzt.t = P->coordinateEpoch;
+    }
+
+    // Coordinates with NaN are not transformed, and coordinates that are
+    // already in error must go through the scalar path so that the error code
+    // is the same as with proj_trans(). Gather the remaining ones in a
+    // contiguous buffer if there are any such coordinates.
+    size_t i = 0;
+    for (; i < n; i++) {
+        if (pj_coord_has_nans(coord[i]) || coord[i].v[0] == HUGE_VAL)
+            break;
+    }
+    if (i == n) {
+        if (direction == PJ_FWD)
+            pj_fwd4d_array(coord, n, err, P);
+        else
+            pj_inv4d_array(coord, n, err, P);
+        return;
+    }
+
+    PJ_COORD buffer[PJ_TRANS_BLOCK_SIZE];
+    int bufferErr[PJ_TRANS_BLOCK_SIZE];
+    size_t bufferIdx[PJ_TRANS_BLOCK_SIZE];
+    size_t nBuffer = 0;
+    for (i = 0; i < n; i++) {
+        if (pj_coord_has_nans(coord[i])) {
+            coord[i].v[0] = coord[i].v[1] = coord[i].v[2] = coord[i].v[3] =
+                std::numeric_limits<double>::quiet_NaN();
+        } else if (coord[i].v[0] == HUGE_VAL) {
+            const int last_errno = P->ctx->last_errno;
+            P->ctx->last_errno = 0;
+            const bool ok = direction == PJ_FWD ? pj_fwd4d(coord[i], P)
+                                                : pj_inv4d(coord[i], P);
+            if (!ok)
+                err[i] = P->ctx->last_errno;
+            P->ctx->last_errno = last_errno;
+        } else {
+            buffer[nBuffer] = coord[i];
+            bufferErr[nBuffer] = 0;
+            bufferIdx[nBuffer] = i;
+            nBuffer++;
+        }
+    }
+    if (direction == PJ_FWD)
+        pj_fwd4d_array(buffer, nBuffer, bufferErr, P);
+    else
+        pj_inv4d_array(buffer, nBuffer, bufferErr, P);
+    for (i = 0; i < nBuffer; i++) {
+        coord[bufferIdx[i]] = buffer[i];
+        err[bufferIdx[i]] = bufferErr[i];
+    }
+}
+
 /**************************************************************************************/
 PJ_COORD proj_trans(PJ *P, PJ_DIRECTION direction, PJ_COORD coord) {
     /***************************************************************************************
@@ -248,9 +465,13 @@ PJ_COORD proj_trans(PJ *P, PJ_DIRECTION direction, PJ_COORD coord) {
         for (int iRetry = 0; iRetry <= N_MAX_RETRY; iRetry++) {
             // Do a first pass and select the operations that match the area of
             // use and has the best accuracy.
-            int iBest = pj_get_suggested_operation(
-                P->ctx, P->alternativeCoordinateOperations, iExcluded,
-                skipNonInstantiable, direction, coord);
+            int iBest =
+                iRetry == 0
+                    ? pj_get_suggested_operation_indexed(
+                          P, skipNonInstantiable, direction, coord)
+                    : pj_get_suggested_operation(
+                          P->ctx, P->alternativeCoordinateOperations,
+                          iExcluded, skipNonInstantiable, direction, coord);
             if (iBest < 0) {
                 break;
             }
@@ -397,10 +618,7 @@ int proj_trans_array(PJ *P, PJ_DIRECTION direction, size_t n, PJ_COORD *coord) {
     bool hasSetRetErrno = false;
     bool sameRetErrno = true;
 
-    for (i = 0; i < n; i++) {
-        proj_context_errno_set(P->ctx, 0);
-        coord[i] = proj_trans(P, direction, coord[i]);
-        int thisErrno = proj_errno(P);
+    const auto accumulateErrno = [&](int thisErrno) {
         if (thisErrno != 0) {
             if (!hasSetRetErrno) {
                 retErrno = thisErrno;
@@ -410,6 +628,23 @@ int proj_trans_array(PJ *P, PJ_DIRECTION direction, size_t n, PJ_COORD *coord) {
                 retErrno = PROJ_ERR_COORD_TRANSFM;
             }
         }
+    };
+
+    if (pj_trans_can_use_array_operators(P)) {
+        int err[PJ_TRANS_BLOCK_SIZE];
+        for (i = 0; i < n; i += PJ_TRANS_BLOCK_SIZE) {
+            const size_t nBlock = std::min(n - i, PJ_TRANS_BLOCK_SIZE);
+            proj_context_errno_set(P->ctx, 0);
+            pj_trans_block(P, direction, coord + i, nBlock, err);
+            for (size_t j = 0; j < nBlock; j++)
+                accumulateErrno(err[j]);
+        }
+    } else {
+        for (i = 0; i < n; i++) {
+            proj_context_errno_set(P->ctx, 0);
+            coord[i] = proj_trans(P, direction, coord[i]);
+            accumulateErrno(proj_errno(P));
+        }
     }
 
     proj_context_errno_set(P->ctx, retErrno);
@@ -538,33 +773,102 @@ size_t proj_trans_generic(PJ *P, PJ_DIRECTION direction, double *x, size_t sx,
     /* Arrays of length >1 are iterated over (for the first nmin values) */
     /* The slightly convolved incremental indexing is used due           */
     /* to the stride, which may be any size supported by the platform    */
-    for (i = 0; i < nmin; i++) {
-        coord.xyzt.x = *x;
-        coord.xyzt.y = *y;
-        coord.xyzt.z = *z;
-        coord.xyzt.t = *t;
-
-        coord = proj_trans(P, direction, coord);
-
-        /* in all full length cases, we overwrite the input with the output,  */
-        /* and step on to the next element.                                   */
-        /* The casts are somewhat funky, but they compile down to no-ops and  */
-        /* they tell compilers and static analyzers that we know what we do   */
-        if (nx > 1) {
-            *x = coord.xyzt.x;
-            x = reinterpret_cast<double *>((reinterpret_cast<char *>(x) + sx));
-        }
-        if (ny > 1) {
-            *y = coord.xyzt.y;
-            y = reinterpret_cast<double *>((reinterpret_cast<char *>(y) + sy));
-        }
-        if (nz > 1) {
-            *z = coord.xyzt.z;
-            z = reinterpret_cast<double *>((reinterpret_cast<char *>(z) + sz));
+    if (pj_trans_can_use_array_operators(P)) {
+        /* Gather blocks of coordinates, transform them with the batched */
+        /* operators, and scatter the result back.                       */
+        PJ_COORD block[PJ_TRANS_BLOCK_SIZE];
+        int err[PJ_TRANS_BLOCK_SIZE];
+        int last_errno = proj_errno(P);
+        for (i = 0; i < nmin;) {
+            const size_t nBlock = std::min(nmin - i, PJ_TRANS_BLOCK_SIZE);
+            double *xIn = x;
+            double *yIn = y;
+            double *zIn = z;
+            double *tIn = t;
+            for (size_t j = 0; j < nBlock; j++) {
+                block[j].xyzt.x = *xIn;
+                block[j].xyzt.y = *yIn;
+                block[j].xyzt.z = *zIn;
+                block[j].xyzt.t = *tIn;
+                if (nx > 1)
+                    xIn = reinterpret_cast<double *>(
+                        (reinterpret_cast<char *>(xIn) + sx));
+                if (ny > 1)
+                    yIn = reinterpret_cast<double *>(
+                        (reinterpret_cast<char *>(yIn) + sy));
+                if (nz > 1)
+                    zIn = reinterpret_cast<double *>(
+                        (reinterpret_cast<char *>(zIn) + sz));
+                if (nt > 1)
+                    tIn = reinterpret_cast<double *>(
+                        (reinterpret_cast<char *>(tIn) + st));
+            }
+
+            pj_trans_block(P, direction, block, nBlock, err);
+
+            for (size_t j = 0; j < nBlock; j++) {
+                /* Mimic the error state left by successive proj_trans() */
+                if (block[j].xyzt.x == HUGE_VAL)
+                    last_errno = err[j];
+                if (nx > 1) {
+                    *x = block[j].xyzt.x;
+                    x = reinterpret_cast<double *>(
+                        (reinterpret_cast<char *>(x) + sx));
+                }
+                if (ny > 1) {
+                    *y = block[j].xyzt.y;
+                    y = reinterpret_cast<double *>(
+                        (reinterpret_cast<char *>(y) + sy));
+                }
+                if (nz > 1) {
+                    *z = block[j].xyzt.z;
+                    z = reinterpret_cast<double *>(
+                        (reinterpret_cast<char *>(z) + sz));
+                }
+                if (nt > 1) {
+                    *t = block[j].xyzt.t;
+                    t = reinterpret_cast<double *>(
+                        (reinterpret_cast<char *>(t) + st));
+                }
+            }
+            coord = block[nBlock - 1];
+            i += nBlock;
         }
-        if (nt > 1) {
-            *t = coord.xyzt.t;
-            t = reinterpret_cast<double *>((reinterpret_cast<char *>(t) + st));
+        proj_context_errno_set(P->ctx, last_errno);
+    } else {
+        for (i = 0; i < nmin; i++) {
+            coord.xyzt.x = *x;
+            coord.xyzt.y = *y;
+            coord.xyzt.z = *z;
+            coord.xyzt.t = *t;
+
+            coord = proj_trans(P, direction, coord);
+
+            /* in all full length cases, we overwrite the input with the */
+            /* output, and step on to the next element.                  */
+            /* The casts are somewhat funky, but they compile down to    */
+            /* no-ops and they tell compilers and static analyzers that  */
+            /* we know what we do                                        */
+            if (nx > 1) {
+                *x = coord.xyzt.x;
+                x = reinterpret_cast<double *>(
+                    (reinterpret_cast<char *>(x) + sx));
+            }
+            if (ny > 1) {
+                *y = coord.xyzt.y;
+                y = reinterpret_cast<double *>(
+                    (reinterpret_cast<char *>(y) + sy));
+            }
+            if (nz > 1) {
+                *z = coord.xyzt.z;
+                z = reinterpret_cast<double *>(
+                    (reinterpret_cast<char *>(z) + sz));
+            }
+            if (nt > 1) {
+                *t = coord.xyzt.t;
+                t = reinterpret_cast<double *>(
+                    (reinterpret_cast<char *>(t) + st));
+            }
         }
     }
 
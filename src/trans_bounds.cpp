@@ -36,6 +36,9 @@
 #include <algorithm>
 #include <cmath>
 #include <limits>
+#include <system_error>
+#include <thread>
+#include <vector>
 
 using namespace NS_PROJ::internal;
 
@@ -214,6 +217,22 @@ static double antimeridian_max(const double *data, const int arr_len) {
     return max_value;
 }
 
+// ---------------------------------------------------------------------------
+// Get the position of the north or south pole in the source CRS of the
+// transformation (target CRS if direction is inverse).
+// This assumes that the destination CRS is geographic.
+static void get_input_pole(PJ *projobj, PJ_DIRECTION pj_direction, bool north,
+                           bool lon_lat_order, double &pole_x,
+                           double &pole_y) {
+    pole_y = north ? 90 : -90;
+    pole_x = 0;
+    if (!lon_lat_order)
+        std::swap(pole_x, pole_y);
+    proj_trans_generic(projobj, pj_opposite_direction(pj_direction), &pole_x,
+                       sizeof(double), 1, &pole_y, sizeof(double), 1, nullptr,
+                       sizeof(double), 0, nullptr, sizeof(double), 0);
+}
+
 // ---------------------------------------------------------------------------
 // Check if the original projected bounds contains
 // the north pole.
@@ -222,15 +241,9 @@ static bool contains_north_pole(PJ *projobj, PJ_DIRECTION pj_direction,
                                 const double xmin, const double ymin,
                                 const double xmax, const double ymax,
                                 bool lon_lat_order) {
-    double pole_y = 90;
-    double pole_x = 0;
-    if (!lon_lat_order) {
-        pole_y = 0;
-        pole_x = 90;
-    }
-    proj_trans_generic(projobj, pj_opposite_direction(pj_direction), &pole_x,
-                       sizeof(double), 1, &pole_y, sizeof(double), 1, nullptr,
-                       sizeof(double), 0, nullptr, sizeof(double), 0);
+    double pole_x;
+    double pole_y;
+    get_input_pole(projobj, pj_direction, true, lon_lat_order, pole_x, pole_y);
     if (xmin < pole_x && pole_x < xmax && ymax > pole_y && pole_y > ymin)
         return true;
     return false;
@@ -244,15 +257,10 @@ static bool contains_south_pole(PJ *projobj, PJ_DIRECTION pj_direction,
                                 const double xmin, const double ymin,
                                 const double xmax, const double ymax,
                                 bool lon_lat_order) {
-    double pole_y = -90;
-    double pole_x = 0;
-    if (!lon_lat_order) {
-        pole_y = 0;
-        pole_x = -90;
-    }
-    proj_trans_generic(projobj, pj_opposite_direction(pj_direction), &pole_x,
-                       sizeof(double), 1, &pole_y, sizeof(double), 1, nullptr,
-                       sizeof(double), 0, nullptr, sizeof(double), 0);
+    double pole_x;
+    double pole_y;
+    get_input_pole(projobj, pj_direction, false, lon_lat_order, pole_x,
+                   pole_y);
     if (xmin < pole_x && pole_x < xmax && ymax > pole_y && pole_y > ymin)
         return true;
     return false;
@@ -357,6 +365,57 @@ static int target_crs_lon_lat_order(PJ_CONTEXT *transformer_ctx,
     return strcmp(abbrev, "lon") == 0 || strcmp(abbrev, "Lon") == 0;
 }
 
+// ---------------------------------------------------------------------------
+// Extract the outermost bounds of a transformed linear ring, taking into
+// account the antimeridian and the poles if the output is geographic.
+// The arrays may be swapped to put them in GIS friendly order.
+// Returns whether the bounds crossed the antimeridian.
+static bool boundary_ring_bounds(std::vector<double> &x_boundary_array,
+                                 std::vector<double> &y_boundary_array,
+                                 bool degree_output, bool output_lon_lat_order,
+                                 bool north_pole_in_bounds,
+                                 bool south_pole_in_bounds, double *out_xmin,
+                                 double *out_ymin, double *out_xmax,
+                                 double *out_ymax) {
+    const int boundary_len = static_cast<int>(x_boundary_array.size());
+    if (degree_output && !output_lon_lat_order) {
+        // Use GIS friendly order
+        std::swap(x_boundary_array, y_boundary_array);
+    }
+
+    bool crossed_antimeridian = false;
+    if (!degree_output) {
+        *out_xmin = simple_min(x_boundary_array.data(), boundary_len);
+        *out_xmax = simple_max(x_boundary_array.data(), boundary_len);
+        *out_ymin = simple_min(y_boundary_array.data(), boundary_len);
+        *out_ymax = simple_max(y_boundary_array.data(), boundary_len);
+    } else if (north_pole_in_bounds) {
+        *out_xmin = -180;
+        *out_xmax = 180;
+        *out_ymin = simple_min(y_boundary_array.data(), boundary_len);
+        *out_ymax = 90;
+    } else if (south_pole_in_bounds) {
+        *out_xmin = -180;
+        *out_xmax = 180;
+        *out_ymin = -90;
+        *out_ymax = simple_max(y_boundary_array.data(), boundary_len);
+    } else {
+        *out_xmin = antimeridian_min(x_boundary_array.data(), boundary_len);
+        *out_xmax = antimeridian_max(x_boundary_array.data(), boundary_len);
+        crossed_antimeridian = *out_xmin > *out_xmax;
+        *out_ymin = simple_min(y_boundary_array.data(), boundary_len);
+        *out_ymax = simple_max(y_boundary_array.data(), boundary_len);
+    }
+
+    if (degree_output && !output_lon_lat_order) {
+        // Go back to CRS axis order
+        std::swap(*out_xmin, *out_ymin);
+        std::swap(*out_xmax, *out_ymax);
+    }
+
+    return crossed_antimeridian;
+}
+
 // ---------------------------------------------------------------------------
 
 /** \brief Transform boundary.
@@ -530,40 +589,10 @@ int proj_trans_bounds(PJ_CONTEXT *context, PJ *P, PJ_DIRECTION direction,
                        boundary_len, y_boundary_array.data(), sizeof(double),
                        boundary_len, nullptr, 0, 0, nullptr, 0, 0);
 
-    if (degree_output && !output_lon_lat_order) {
-        // Use GIS friendly order
-        std::swap(x_boundary_array, y_boundary_array);
-    }
-
-    bool crossed_antimeridian = false;
-    if (!degree_output) {
-        *out_xmin = simple_min(x_boundary_array.data(), boundary_len);
-        *out_xmax = simple_max(x_boundary_array.data(), boundary_len);
-        *out_ymin = simple_min(y_boundary_array.data(), boundary_len);
-        *out_ymax = simple_max(y_boundary_array.data(), boundary_len);
-    } else if (north_pole_in_bounds) {
-        *out_xmin = -180;
-        *out_xmax = 180;
-        *out_ymin = simple_min(y_boundary_array.data(), boundary_len);
-        *out_ymax = 90;
-    } else if (south_pole_in_bounds) {
-        *out_xmin = -180;
-        *out_xmax = 180;
-        *out_ymin = -90;
-        *out_ymax = simple_max(y_boundary_array.data(), boundary_len);
-    } else {
-        *out_xmin = antimeridian_min(x_boundary_array.data(), boundary_len);
-        *out_xmax = antimeridian_max(x_boundary_array.data(), boundary_len);
-        crossed_antimeridian = *out_xmin > *out_xmax;
-        *out_ymin = simple_min(y_boundary_array.data(), boundary_len);
-        *out_ymax = simple_max(y_boundary_array.data(), boundary_len);
-    }
-
-    if (degree_output && !output_lon_lat_order) {
-        // Go back to CRS axis order
-        std::swap(*out_xmin, *out_ymin);
-        std::swap(*out_xmax, *out_ymax);
-    }
+    const bool crossed_antimeridian = boundary_ring_bounds(
+        x_boundary_array, y_boundary_array, degree_output,
+        output_lon_lat_order, north_pole_in_bounds, south_pole_in_bounds,
+        out_xmin, out_ymin, out_xmax, out_ymax);
 
     if (!crossed_antimeridian) {
         // Sample points within the source grid
@@ -591,6 +620,755 @@ int proj_trans_bounds(PJ_CONTEXT *context, PJ *P, PJ_DIRECTION direction,
     return true;
 }
 
+// ---------------------------------------------------------------------------
+// Number of segments each edge of the bounding box, and each row sampled
+// inside it, is initially split into by proj_trans_bounds_adaptive().
+// This gives the 2 additional points per edge required by the antimeridian
+// logic.
+constexpr int ADAPTIVE_BOUNDS_INITIAL_SEGMENTS = 3;
+
+// Number of rows sampled inside the bounding box by
+// proj_trans_bounds_adaptive(), as proj_trans_bounds() does with the
+// recommended densify_pts of 21.
+constexpr int ADAPTIVE_BOUNDS_INTERIOR_ROWS = 20;
+
+// Maximum number of times a segment can be bisected by
+// proj_trans_bounds_adaptive().
+constexpr int ADAPTIVE_BOUNDS_MAX_DEPTH = 11;
+
+namespace {
+struct BoundaryPoint {
+    // Coordinates in the input CRS
+    double x;
+    double y;
+    // Coordinates in the output CRS
+    double u;
+    double v;
+};
+} // namespace
+
+// ---------------------------------------------------------------------------
+// Normalize a difference of longitudes to [-180, 180[
+static double longitude_delta(double delta) {
+    delta = std::fmod(delta + 180.0, 360.0);
+    if (delta < 0)
+        delta += 360.0;
+    return delta - 180.0;
+}
+
+// ---------------------------------------------------------------------------
+static void transform_boundary_points(PJ *P, PJ_DIRECTION direction,
+                                      std::vector<BoundaryPoint> &points) {
+    for (auto &pt : points) {
+        pt.u = pt.x;
+        pt.v = pt.y;
+    }
+    proj_trans_generic(P, direction, &points[0].u, sizeof(BoundaryPoint),
+                       points.size(), &points[0].v, sizeof(BoundaryPoint),
+                       points.size(), nullptr, 0, 0, nullptr, 0, 0);
+}
+
+// ---------------------------------------------------------------------------
+// Return by how much the transformed midpoint of a segment deviates from
+// the middle of its transformed end points, along the output axis where it
+// deviates most. Segments where only some points could be transformed get
+// an infinite deviation, so that the limit of the area of validity gets
+// located, and segments where none could be get 0.
+static double segment_deviation(const BoundaryPoint &start,
+                                const BoundaryPoint &mid,
+                                const BoundaryPoint &end, bool u_is_longitude,
+                                bool v_is_longitude) {
+    const auto is_valid = [](const BoundaryPoint &pt) {
+        return std::isfinite(pt.u) && std::isfinite(pt.v);
+    };
+    const bool start_valid = is_valid(start);
+    const bool mid_valid = is_valid(mid);
+    const bool end_valid = is_valid(end);
+    if (!start_valid || !mid_valid || !end_valid)
+        return start_valid || mid_valid || end_valid ? HUGE_VAL : 0;
+
+    const auto deviation = [](double a, double m, double b, bool longitude) {
+        if (!longitude)
+            return std::fabs(m - (a + b) / 2);
+        return std::fabs(
+            longitude_delta(m - (a + longitude_delta(b - a) / 2)));
+    };
+    return std::max(deviation(start.u, mid.u, end.u, u_is_longitude),
+                    deviation(start.v, mid.v, end.v, v_is_longitude));
+}
+
+// ---------------------------------------------------------------------------
+// Bisect the segments of a transformed polyline, which is a linear ring if
+// closed, one level at a time, until their deviation is at most tolerance.
+// Segments that stay inside the current bounds by more than their deviation
+// cannot extend them, and are not bisected further. The current bounds are
+// those of the polyline, extended by bounds (u_min, u_max, v_min, v_max).
+// Longitudes are unwrapped along the polyline for that check, which then
+// requires all its points to be valid. If a ring goes around a pole,
+// longitudes cannot extend the bounds.
+static void densify_adaptively(PJ *P, PJ_DIRECTION direction,
+                               std::vector<BoundaryPoint> &points,
+                               bool closed, double tolerance,
+                               bool u_is_longitude, bool v_is_longitude,
+                               const double bounds[4], int &point_count) {
+    // deviation[i] is the deviation measured on the segment starting at
+    // points[i], and refine[i] is set if that segment must be bisected.
+    std::vector<double> deviation(points.size(), HUGE_VAL);
+    std::vector<char> refine(points.size(), 1);
+    if (!closed)
+        refine.back() = 0;
+    std::vector<BoundaryPoint> midpoints;
+    std::vector<BoundaryPoint> new_points;
+    std::vector<double> new_deviation;
+    // Values of the points along each output axis, with unwrapped longitudes
+    std::vector<double> cmp_u;
+    std::vector<double> cmp_v;
+    for (int depth = 0; depth < ADAPTIVE_BOUNDS_MAX_DEPTH; ++depth) {
+        size_t len = points.size();
+        midpoints.clear();
+        for (size_t i = 0; i < len; ++i) {
+            if (refine[i]) {
+                const auto &start = points[i];
+                const auto &end = points[(i + 1) % len];
+                midpoints.push_back(
+                    {(start.x + end.x) / 2, (start.y + end.y) / 2, 0, 0});
+            }
+        }
+        if (midpoints.empty())
+            break;
+        transform_boundary_points(P, direction, midpoints);
+        point_count += static_cast<int>(midpoints.size());
+
+        new_points.clear();
+        new_deviation.clear();
+        size_t mid_idx = 0;
+        for (size_t i = 0; i < len; ++i) {
+            new_points.push_back(points[i]);
+            if (!refine[i]) {
+                new_deviation.push_back(0);
+                continue;
+            }
+            const auto &mid = midpoints[mid_idx++];
+            const double dev =
+                segment_deviation(points[i], mid, points[(i + 1) % len],
+                                  u_is_longitude, v_is_longitude);
+            new_deviation.push_back(dev);
+            new_points.push_back(mid);
+            new_deviation.push_back(dev);
+        }
+        std::swap(points, new_points);
+        std::swap(deviation, new_deviation);
+        len = points.size();
+        cmp_u.resize(len);
+        cmp_v.resize(len);
+
+        bool can_prune = true;
+        for (size_t i = 0; i < len; ++i) {
+            const auto &pt = points[i];
+            const bool valid = std::isfinite(pt.u) && std::isfinite(pt.v);
+            if (!valid && (u_is_longitude || v_is_longitude)) {
+                can_prune = false;
+                break;
+            }
+            cmp_u[i] = pt.u;
+            cmp_v[i] = pt.v;
+            if (i > 0 && u_is_longitude)
+                cmp_u[i] =
+                    cmp_u[i - 1] + longitude_delta(pt.u - points[i - 1].u);
+            if (i > 0 && v_is_longitude)
+                cmp_v[i] =
+                    cmp_v[i - 1] + longitude_delta(pt.v - points[i - 1].v);
+        }
+        const auto end_value = [len](const std::vector<double> &cmp,
+                                     double start, double end, size_t i,
+                                     bool longitude) {
+            if (longitude)
+                return cmp[i] + longitude_delta(end - start);
+            return cmp[(i + 1) % len];
+        };
+        bool check_u = true;
+        bool check_v = true;
+        if (can_prune && closed && u_is_longitude)
+            check_u = std::fabs(end_value(cmp_u, points.back().u, points[0].u,
+                                          len - 1, true) -
+                                cmp_u[0]) < 180;
+        if (can_prune && closed && v_is_longitude)
+            check_v = std::fabs(end_value(cmp_v, points.back().v, points[0].v,
+                                          len - 1, true) -
+                                cmp_v[0]) < 180;
+        double u_min = bounds[0];
+        double u_max = bounds[1];
+        double v_min = bounds[2];
+        double v_max = bounds[3];
+        for (size_t i = 0; can_prune && i < len; ++i) {
+            if (std::isfinite(cmp_u[i]) && std::isfinite(cmp_v[i])) {
+                u_min = std::min(u_min, cmp_u[i]);
+                u_max = std::max(u_max, cmp_u[i]);
+                v_min = std::min(v_min, cmp_v[i]);
+                v_max = std::max(v_max, cmp_v[i]);
+            }
+        }
+        const auto may_extend = [](double a, double b, double dev, double lo,
+                                   double hi) {
+            return std::min(a, b) - dev <= lo || std::max(a, b) + dev >= hi;
+        };
+        refine.assign(len, 0);
+        for (size_t i = 0; i < len; ++i) {
+            const double dev = deviation[i];
+            if (!(dev > tolerance))
+                continue;
+            if (!can_prune || !std::isfinite(dev)) {
+                refine[i] = 1;
+                continue;
+            }
+            const auto &start = points[i];
+            const auto &end = points[(i + 1) % len];
+            refine[i] =
+                (check_u &&
+                 may_extend(
+                     cmp_u[i],
+                     end_value(cmp_u, start.u, end.u, i, u_is_longitude), dev,
+                     u_min, u_max)) ||
+                (check_v &&
+                 may_extend(
+                     cmp_v[i],
+                     end_value(cmp_v, start.v, end.v, i, v_is_longitude), dev,
+                     v_min, v_max));
+        }
+    }
+}
+
+// ---------------------------------------------------------------------------
+
+/** \brief Transform boundary, densifying it adaptively.
+ *
+ * Transform boundary densifying the edges until the transformed edges are
+ * approximated to within a tolerance, and extracting the outermost bounds.
+ *
+ * Each edge is initially split into 3 segments. Each segment is then
+ * bisected as long as its transformed midpoint deviates from the middle of
+ * its transformed end points by more than tolerance, along either axis of
+ * the target CRS, until a maximum depth is reached. Segments that cannot
+ * extend the bounds found so far are not bisected further. All the
+ * segments of a refinement step are transformed together, and the corners
+ * are shared by adjacent edges, so that nearly linear transformations only
+ * need a few dozens of points while strongly curved edges get as many as
+ * they need. Unless the bounds cross the antimeridian, 20 rows inside the
+ * source bounding box are sampled and densified in the same way, as
+ * proj_trans_bounds() does.
+ *
+ * The handling of the antimeridian and of the poles is the one of
+ * proj_trans_bounds(), whose documentation applies.
+ *
+ * @param context The PJ_CONTEXT object.
+ * @param P The PJ object representing the transformation.
+ * @param direction The direction of the transformation.
+ * @param xmin Minimum bounding coordinate of the first axis in source CRS
+ *             (target CRS if direction is inverse).
+ * @param ymin Minimum bounding coordinate of the second axis in source CRS.
+ *             (target CRS if direction is inverse).
+ * @param xmax Maximum bounding coordinate of the first axis in source CRS.
+ *             (target CRS if direction is inverse).
+ * @param ymax Maximum bounding coordinate of the second axis in source CRS.
+ *             (target CRS if direction is inverse).
+ * @param out_xmin Minimum bounding coordinate of the first axis in target CRS
+ *             (source CRS if direction is inverse).
+ * @param out_ymin Minimum bounding coordinate of the second axis in target CRS.
+ *             (source CRS if direction is inverse).
+ * @param out_xmax Maximum bounding coordinate of the first axis in target CRS.
+ *             (source CRS if direction is inverse).
+ * @param out_ymax Maximum bounding coordinate of the second axis in target CRS.
+ *             (source CRS if direction is inverse).
+ * @param tolerance Maximum deviation allowed between the transformed edges
+ *     and their densified approximation, in units of the target CRS (source
+ *     CRS if direction is inverse). Must be strictly positive.
+ * @param out_point_count If not NULL, receives the number of points that
+ *     were transformed.
+ * @return an integer. 1 if successful. 0 if failures encountered.
+ * @since 9.8
+ * @see proj_trans_bounds()
+ */
+int proj_trans_bounds_adaptive(PJ_CONTEXT *context, PJ *P,
+                               PJ_DIRECTION direction, const double xmin,
+                               const double ymin, const double xmax,
+                               const double ymax, double *out_xmin,
+                               double *out_ymin, double *out_xmax,
+                               double *out_ymax, const double tolerance,
+                               int *out_point_count) {
+    *out_xmin = HUGE_VAL;
+    *out_ymin = HUGE_VAL;
+    *out_xmax = HUGE_VAL;
+    *out_ymax = HUGE_VAL;
+    if (out_point_count)
+        *out_point_count = 0;
+
+    if (P == nullptr) {
+        proj_log_error(P, _("NULL P object not allowed."));
+        proj_errno_set(P, PROJ_ERR_INVALID_OP_ILLEGAL_ARG_VALUE);
+        return false;
+    }
+    if (!(tolerance > 0) || !std::isfinite(tolerance)) {
+        proj_log_error(P, _("tolerance must be strictly positive."));
+        proj_errno_set(P, PROJ_ERR_INVALID_OP_ILLEGAL_ARG_VALUE);
+        return false;
+    }
+
+    PJ_PROJ_INFO pj_info = proj_pj_info(P);
+    if (pj_info.id == nullptr) {
+        proj_log_error(P, _("NULL transformation not allowed,"));
+        proj_errno_set(P, PROJ_ERR_INVALID_OP_ILLEGAL_ARG_VALUE);
+        return false;
+    }
+    if (strcmp(pj_info.id, "noop") == 0 || direction == PJ_IDENT) {
+        *out_xmin = xmin;
+        *out_xmax = xmax;
+        *out_ymin = ymin;
+        *out_ymax = ymax;
+        return true;
+    }
+
+    bool degree_output = proj_degree_output(P, direction) != 0;
+    bool degree_input = proj_degree_input(P, direction) != 0;
+    bool north_pole_in_bounds = false;
+    bool south_pole_in_bounds = false;
+    bool input_lon_lat_order = false;
+    bool output_lon_lat_order = false;
+    int point_count = 0;
+    if (degree_input) {
+        int in_order_lon_lat = target_crs_lon_lat_order(
+            context, P, pj_opposite_direction(direction));
+        if (in_order_lon_lat == -1)
+            return false;
+        input_lon_lat_order = in_order_lon_lat != 0;
+    }
+    if (degree_output) {
+        int out_order_lon_lat = target_crs_lon_lat_order(context, P, direction);
+        if (out_order_lon_lat == -1)
+            return false;
+        output_lon_lat_order = out_order_lon_lat != 0;
+        north_pole_in_bounds = contains_north_pole(
+            P, direction, xmin, ymin, xmax, ymax, output_lon_lat_order);
+        south_pole_in_bounds = contains_south_pole(
+            P, direction, xmin, ymin, xmax, ymax, output_lon_lat_order);
+        point_count += 2;
+    }
+
+    double xend = xmax;
+    double yend = ymax;
+    if (degree_input && xmax < xmin) {
+        if (!input_lon_lat_order) {
+            proj_log_error(P, _("latitude max < latitude min."));
+            proj_errno_set(P, PROJ_ERR_INVALID_OP_ILLEGAL_ARG_VALUE);
+            return false;
+        }
+        // handle antimeridian
+        xend += 360.0;
+    }
+    if (degree_input && ymax < ymin) {
+        if (input_lon_lat_order) {
+            proj_log_error(P, _("latitude max < latitude min."));
+            proj_errno_set(P, PROJ_ERR_INVALID_OP_ILLEGAL_ARG_VALUE);
+            return false;
+        }
+        // handle antimeridian
+        yend += 360.0;
+    }
+
+    const int side_pts = ADAPTIVE_BOUNDS_INITIAL_SEGMENTS;
+    const double delta_x = (xend - xmin) / side_pts;
+    const double delta_y = (yend - ymin) / side_pts;
+    const bool u_is_longitude = degree_output && output_lon_lat_order;
+    const bool v_is_longitude = degree_output && !output_lon_lat_order;
+    try {
+        // build the initial bounding box, where the corners are shared
+        // by adjacent edges.
+        // Note: must be a linear ring for antimeridian logic
+        std::vector<BoundaryPoint> ring(side_pts * 4);
+        for (int iii = 0; iii < side_pts; iii++) {
+            // xmin boundary
+            ring[iii].x = xmin;
+            ring[iii].y = yend - iii * delta_y;
+            // ymin boundary
+            ring[iii + side_pts].x = xmin + iii * delta_x;
+            ring[iii + side_pts].y = ymin;
+            // xmax boundary
+            ring[iii + side_pts * 2].x = xend;
+            ring[iii + side_pts * 2].y = ymin + iii * delta_y;
+            // ymax boundary
+            ring[iii + side_pts * 3].x = xend - iii * delta_x;
+            ring[iii + side_pts * 3].y = yend;
+        }
+        transform_boundary_points(P, direction, ring);
+        point_count += static_cast<int>(ring.size());
+        const double no_bounds[] = {HUGE_VAL, -HUGE_VAL, HUGE_VAL, -HUGE_VAL};
+        densify_adaptively(P, direction, ring, true, tolerance,
+                           u_is_longitude, v_is_longitude, no_bounds,
+                           point_count);
+
+        std::vector<double> x_boundary_array(ring.size());
+        std::vector<double> y_boundary_array(ring.size());
+        for (size_t i = 0; i < ring.size(); ++i) {
+            x_boundary_array[i] = ring[i].u;
+            y_boundary_array[i] = ring[i].v;
+        }
+        const bool crossed_antimeridian = boundary_ring_bounds(
+            x_boundary_array, y_boundary_array, degree_output,
+            output_lon_lat_order, north_pole_in_bounds, south_pole_in_bounds,
+            out_xmin, out_ymin, out_xmax, out_ymax);
+
+        if (!crossed_antimeridian) {
+            // Sample rows within the source grid
+            const double row_delta_y =
+                (yend - ymin) / (ADAPTIVE_BOUNDS_INTERIOR_ROWS + 1);
+            std::vector<BoundaryPoint> row;
+            for (int j = 1; j <= ADAPTIVE_BOUNDS_INTERIOR_ROWS; ++j) {
+                row.clear();
+                for (int i = 0; i <= side_pts; ++i) {
+                    row.push_back(
+                        {xmin + i * delta_x, ymin + j * row_delta_y, 0, 0});
+                }
+                transform_boundary_points(P, direction, row);
+                point_count += static_cast<int>(row.size());
+                const double bounds[] = {*out_xmin, *out_xmax, *out_ymin,
+                                         *out_ymax};
+                densify_adaptively(P, direction, row, false, tolerance,
+                                   u_is_longitude, v_is_longitude, bounds,
+                                   point_count);
+                for (const auto &pt : row) {
+                    if (std::isfinite(pt.u) && std::isfinite(pt.v)) {
+                        *out_xmin = std::min(*out_xmin, pt.u);
+                        *out_xmax = std::max(*out_xmax, pt.u);
+                        *out_ymin = std::min(*out_ymin, pt.v);
+                        *out_ymax = std::max(*out_ymax, pt.v);
+                    }
+                }
+            }
+        }
+    } catch (const std::exception &e) // memory allocation failure
+    {
+        proj_log_error(P, e.what());
+        proj_errno_set(P, PROJ_ERR_INVALID_OP_ILLEGAL_ARG_VALUE);
+        return false;
+    }
+
+    if (out_point_count)
+        *out_point_count = point_count;
+    return true;
+}
+
+// ---------------------------------------------------------------------------
+
+namespace {
+struct TransBoundsGrid {
+    PJ_DIRECTION direction = PJ_FWD;
+    double x_origin = 0;
+    double y_origin = 0;
+    double cell_width = 0;
+    double cell_height = 0;
+    int cols = 0;
+    int side_pts = 0;
+    bool degree_output = false;
+    bool output_lon_lat_order = false;
+    // Position of the poles in the input CRS
+    double north_pole_x = HUGE_VAL;
+    double north_pole_y = HUGE_VAL;
+    double south_pole_x = HUGE_VAL;
+    double south_pole_y = HUGE_VAL;
+    double *out_bounds = nullptr;
+};
+} // namespace
+
+// ---------------------------------------------------------------------------
+// Compute the bounds of the cells of rows [row_begin, row_end[ of a grid.
+// The densified edges and the sampled interior points of the cells of a row
+// are points of a lattice, which is transformed at once. The top line of the
+// lattice of a row is the bottom line of the next row.
+static bool trans_bounds_grid_rows(PJ *P, const TransBoundsGrid &grid,
+                                   int row_begin, int row_end) {
+    const int side_pts = grid.side_pts;
+    const size_t nx = static_cast<size_t>(grid.cols) * side_pts + 1;
+    const size_t lattice_len = (side_pts + 1) * nx;
+    const double delta_x = grid.cell_width / side_pts;
+    const double delta_y = grid.cell_height / side_pts;
+    try {
+        std::vector<double> lattice_x(lattice_len);
+        std::vector<double> lattice_y(lattice_len);
+        std::vector<double> x_boundary_array(side_pts * 4);
+        std::vector<double> y_boundary_array(side_pts * 4);
+        for (int row = row_begin; row < row_end; ++row) {
+            const double ymin = grid.y_origin + row * grid.cell_height;
+            const double ymax = grid.y_origin + (row + 1) * grid.cell_height;
+            int first_line = 0;
+            if (row > row_begin) {
+                // reuse the top line of the previous row
+                std::copy(lattice_x.end() - nx, lattice_x.end(),
+                          lattice_x.begin());
+                std::copy(lattice_y.end() - nx, lattice_y.end(),
+                          lattice_y.begin());
+                first_line = 1;
+            }
+            for (int k = first_line; k <= side_pts; ++k) {
+                const double y = k == side_pts ? ymax : ymin + k * delta_y;
+                for (size_t ix = 0; ix < nx; ++ix) {
+                    const size_t col = ix / side_pts;
+                    const size_t i = ix % side_pts;
+                    lattice_x[k * nx + ix] = grid.x_origin +
+                                             col * grid.cell_width +
+                                             i * delta_x;
+                    lattice_y[k * nx + ix] = y;
+                }
+            }
+            const size_t first = first_line * nx;
+            proj_trans_generic(P, grid.direction, lattice_x.data() + first,
+                               sizeof(double), lattice_len - first,
+                               lattice_y.data() + first, sizeof(double),
+                               lattice_len - first, nullptr, 0, 0, nullptr,
+                               0, 0);
+
+            for (int col = 0; col < grid.cols; ++col) {
+                const double xmin = grid.x_origin + col * grid.cell_width;
+                const double xmax = grid.x_origin + (col + 1) * grid.cell_width;
+                const size_t left = static_cast<size_t>(col) * side_pts;
+                const size_t right = left + side_pts;
+                // Note: must be a linear ring for antimeridian logic, in
+                // the order of proj_trans_bounds()
+                for (int iii = 0; iii < side_pts; iii++) {
+                    // xmin boundary
+                    const size_t xmin_idx = (side_pts - iii) * nx + left;
+                    x_boundary_array[iii] = lattice_x[xmin_idx];
+                    y_boundary_array[iii] = lattice_y[xmin_idx];
+                    // ymin boundary
+                    const size_t ymin_idx = left + iii;
+                    x_boundary_array[iii + side_pts] = lattice_x[ymin_idx];
+                    y_boundary_array[iii + side_pts] = lattice_y[ymin_idx];
+                    // xmax boundary
+                    const size_t xmax_idx = iii * nx + right;
+                    x_boundary_array[iii + side_pts * 2] = lattice_x[xmax_idx];
+                    y_boundary_array[iii + side_pts * 2] = lattice_y[xmax_idx];
+                    // ymax boundary
+                    const size_t ymax_idx = side_pts * nx + right - iii;
+                    x_boundary_array[iii + side_pts * 3] = lattice_x[ymax_idx];
+                    y_boundary_array[iii + side_pts * 3] = lattice_y[ymax_idx];
+                }
+
+                const bool north_pole_in_bounds =
+                    grid.degree_output && xmin < grid.north_pole_x &&
+                    grid.north_pole_x < xmax && ymax > grid.north_pole_y &&
+                    grid.north_pole_y > ymin;
+                const bool south_pole_in_bounds =
+                    grid.degree_output && xmin < grid.south_pole_x &&
+                    grid.south_pole_x < xmax && ymax > grid.south_pole_y &&
+                    grid.south_pole_y > ymin;
+                double *out =
+                    grid.out_bounds +
+                    4 * (static_cast<size_t>(row) * grid.cols + col);
+                const bool crossed_antimeridian = boundary_ring_bounds(
+                    x_boundary_array, y_boundary_array, grid.degree_output,
+                    grid.output_lon_lat_order, north_pole_in_bounds,
+                    south_pole_in_bounds, &out[0], &out[1], &out[2], &out[3]);
+
+                if (!crossed_antimeridian) {
+                    // Sample points within the source grid
+                    for (int j = 1; j < side_pts - 1; ++j) {
+                        for (int i = 0; i < side_pts; ++i) {
+                            const double x = lattice_x[j * nx + left + i];
+                            const double y = lattice_y[j * nx + left + i];
+                            if (std::isfinite(x) && std::isfinite(y)) {
+                                out[0] = std::min(out[0], x);
+                                out[2] = std::max(out[2], x);
+                                out[1] = std::min(out[1], y);
+                                out[3] = std::max(out[3], y);
+                            }
+                        }
+                    }
+                }
+            }
+        }
+    } catch (const std::exception &e) // memory allocation failure
+    {
+        proj_log_error(P, e.what());
+        proj_errno_set(P, PROJ_ERR_INVALID_OP_ILLEGAL_ARG_VALUE);
+        return false;
+    }
+    return true;
+}
+
+// ---------------------------------------------------------------------------
+
+/** \brief Transform the boundaries of the cells of a regular grid.
+ *
+ * Compute the transformed bounds of each cell of a regular grid of
+ * rectangles, such as the tiles of a zoom level of a tile pyramid. The cell
+ * at (row, col) covers [x_origin + col * cell_width,
+ * x_origin + (col + 1) * cell_width] along the first axis and
+ * [y_origin + row * cell_height, y_origin + (row + 1) * cell_height] along
+ * the second axis.
+ *
+ * The bounds of each cell are the ones proj_trans_bounds() would return
+ * for it, with the same densify_pts, and the documentation of
+ * proj_trans_bounds() applies. But the points shared by adjacent cells are
+ * only transformed once, all the points of a row of cells are transformed
+ * in a single batch, and the poles are located once for the whole grid.
+ *
+ * If max_threads is greater than 1, rows of cells are processed in
+ * parallel by up to max_threads threads, each with its own clone of the
+ * context and of the transformation.
+ *
+ * @param context The PJ_CONTEXT object.
+ * @param P The PJ object representing the transformation.
+ * @param direction The direction of the transformation.
+ * @param x_origin Minimum coordinate of the first axis of the grid in source
+ *                 CRS (target CRS if direction is inverse).
+ * @param y_origin Minimum coordinate of the second axis of the grid in
+ *                 source CRS (target CRS if direction is inverse).
+ * @param cell_width Size of a cell along the first axis. Must be positive.
+ * @param cell_height Size of a cell along the second axis. Must be positive.
+ * @param rows Number of rows of cells, along the second axis.
+ * @param cols Number of columns of cells, along the first axis.
+ * @param out_bounds Array of rows * cols * 4 values, which receives the
+ *     xmin, ymin, xmax, ymax bounds of each cell in target CRS (source CRS
+ *     if direction is inverse), cells being ordered by rows.
+ * @param densify_pts Recommended to use 21. This is the number of points
+ *     to use to densify the edges of each cell in the transformation.
+ * @param max_threads Maximum number of threads to use.
+ * @return an integer. 1 if successful. 0 if failures encountered.
+ * @since 9.8
+ * @see proj_trans_bounds()
+ */
+int proj_trans_bounds_grid(PJ_CONTEXT *context, PJ *P, PJ_DIRECTION direction,
+                           const double x_origin, const double y_origin,
+                           const double cell_width, const double cell_height,
+                           const int rows, const int cols, double *out_bounds,
+                           const int densify_pts, const int max_threads) {
+    if (P == nullptr) {
+        proj_log_error(P, _("NULL P object not allowed."));
+        proj_errno_set(P, PROJ_ERR_INVALID_OP_ILLEGAL_ARG_VALUE);
+        return false;
+    }
+    if (rows <= 0 || cols <= 0 || !(cell_width > 0) || !(cell_height > 0) ||
+        out_bounds == nullptr) {
+        proj_log_error(P, _("Invalid grid definition."));
+        proj_errno_set(P, PROJ_ERR_INVALID_OP_ILLEGAL_ARG_VALUE);
+        return false;
+    }
+    const size_t cell_count = static_cast<size_t>(rows) * cols;
+    std::fill(out_bounds, out_bounds + 4 * cell_count, HUGE_VAL);
+    if (densify_pts < 0 || densify_pts > 10000) {
+        proj_log_error(P, _("densify_pts must be between 0-10000."));
+        proj_errno_set(P, PROJ_ERR_INVALID_OP_ILLEGAL_ARG_VALUE);
+        return false;
+    }
+
+    PJ_PROJ_INFO pj_info = proj_pj_info(P);
+    if (pj_info.id == nullptr) {
+        proj_log_error(P, _("NULL transformation not allowed,"));
+        proj_errno_set(P, PROJ_ERR_INVALID_OP_ILLEGAL_ARG_VALUE);
+        return false;
+    }
+    if (strcmp(pj_info.id, "noop") == 0 || direction == PJ_IDENT) {
+        for (int row = 0; row < rows; ++row) {
+            for (int col = 0; col < cols; ++col) {
+                double *out =
+                    out_bounds + 4 * (static_cast<size_t>(row) * cols + col);
+                out[0] = x_origin + col * cell_width;
+                out[1] = y_origin + row * cell_height;
+                out[2] = x_origin + (col + 1) * cell_width;
+                out[3] = y_origin + (row + 1) * cell_height;
+            }
+        }
+        return true;
+    }
+
+    TransBoundsGrid grid;
+    grid.direction = direction;
+    grid.x_origin = x_origin;
+    grid.y_origin = y_origin;
+    grid.cell_width = cell_width;
+    grid.cell_height = cell_height;
+    grid.cols = cols;
+    grid.side_pts = densify_pts + 1; // add one because we are densifying
+    grid.out_bounds = out_bounds;
+    grid.degree_output = proj_degree_output(P, direction) != 0;
+    if (grid.degree_output && densify_pts < 2) {
+        proj_log_error(
+            P,
+            _("densify_pts must be at least 2 if the output is geographic."));
+        proj_errno_set(P, PROJ_ERR_INVALID_OP_ILLEGAL_ARG_VALUE);
+        return false;
+    }
+    if (grid.degree_output) {
+        int out_order_lon_lat = target_crs_lon_lat_order(context, P, direction);
+        if (out_order_lon_lat == -1)
+            return false;
+        grid.output_lon_lat_order = out_order_lon_lat != 0;
+        get_input_pole(P, direction, true, grid.output_lon_lat_order,
+                       grid.north_pole_x, grid.north_pole_y);
+        get_input_pole(P, direction, false, grid.output_lon_lat_order,
+                       grid.south_pole_x, grid.south_pole_y);
+    }
+
+    // Each thread processes a band of contiguous rows, so that the lines
+    // shared by its rows are only transformed once.
+    const int thread_count = std::max(1, std::min(max_threads, rows));
+    std::vector<PJ_CONTEXT *> thread_contexts;
+    std::vector<PJ *> thread_pjs;
+    for (int i = 1; i < thread_count; ++i) {
+        auto thread_ctx = proj_context_clone(context);
+        if (!thread_ctx)
+            break;
+        thread_contexts.push_back(thread_ctx);
+        auto thread_pj = proj_clone(thread_ctx, P);
+        if (!thread_pj)
+            break;
+        thread_pjs.push_back(thread_pj);
+    }
+    if (thread_pjs.size() + 1 != static_cast<size_t>(thread_count)) {
+        // The transformation cannot be cloned: use the calling thread only
+        for (auto thread_pj : thread_pjs)
+            proj_destroy(thread_pj);
+        thread_pjs.clear();
+    }
+
+    const int band_count = static_cast<int>(thread_pjs.size()) + 1;
+    std::vector<char> band_success(band_count, false);
+    const auto process_band = [&grid, &band_success, rows,
+                               band_count](PJ *band_pj, int band) {
+        const int row_begin = static_cast<int>(
+            static_cast<long long>(rows) * band / band_count);
+        const int row_end = static_cast<int>(
+            static_cast<long long>(rows) * (band + 1) / band_count);
+        band_success[band] =
+            trans_bounds_grid_rows(band_pj, grid, row_begin, row_end);
+    };
+    std::vector<std::thread> threads;
+    threads.reserve(band_count - 1);
+    int first_unstarted_band = band_count;
+    for (int band = 1; band < band_count; ++band) {
+        try {
+            threads.emplace_back(process_band, thread_pjs[band - 1], band);
+        } catch (const std::system_error &) {
+            // The thread cannot be started: the calling thread processes
+            // this band and the following ones
+            first_unstarted_band = band;
+            break;
+        }
+    }
+    process_band(P, 0);
+    for (int band = first_unstarted_band; band < band_count; ++band) {
+        process_band(P, band);
+    }
+    for (auto &thread : threads) {
+        thread.join();
+    }
+    for (auto thread_pj : thread_pjs)
+        proj_destroy(thread_pj);
+    for (auto thread_ctx : thread_contexts)
+        proj_context_destroy(thread_ctx);
+
+    return std::all_of(band_success.begin(), band_success.end(),
+                       [](char success) { return success != 0; });
+}
+
 // ---------------------------------------------------------------------------
 /** \brief Transform boundary, taking into account 3D coordinates.
  *
@@ -50,6 +50,8 @@
 #include <string>
 #include <vector>
 
+#include "quadtree.hpp"
+
 #ifndef DEFORMATON_MODEL_NAMESPACE
 #define DEFORMATON_MODEL_NAMESPACE DeformationModel
 #endif
@@ -584,6 +586,18 @@ template <class Grid, class GridSet> struct ComponentEx;
 
 // ---------------------------------------------------------------------------
 
+/** Method used by Evaluator::inverse() */
+enum class InverseMethod {
+    /** Fixed-point iteration on the forward transformation */
+    FIXED_POINT,
+    /** Newton iteration, using the Jacobian of the bilinear interpolation
+     * in the grid cells. Falls back to FIXED_POINT if it does not
+     * converge. */
+    NEWTON,
+};
+
+// ---------------------------------------------------------------------------
+
 /** Class to evaluate the transformation of a coordinate */
 template <class Grid = GridPrototype, class GridSet = GridSetPrototype<>,
           class EvaluatorIface = EvaluatorIfacePrototype<>>
@@ -600,13 +614,17 @@ class Evaluator {
      */
     bool forward(EvaluatorIface &iface, double x, double y, double z, double t,
                  double &x_out, double &y_out, double &z_out) {
-        return forward(iface, x, y, z, t, false, x_out, y_out, z_out);
+        return forward(iface, x, y, z, t, false, x_out, y_out, z_out,
+                       nullptr);
     }
 
     /** Apply inverse transformation. */
     bool inverse(EvaluatorIface &iface, double x, double y, double z, double t,
                  double &x_out, double &y_out, double &z_out);
 
+    /** Set the method used by inverse(). Defaults to NEWTON */
+    void setInverseMethod(InverseMethod method) { mInverseMethod = method; }
+
     /** Clear grid cache */
     void clearGridCache();
 
@@ -621,12 +639,27 @@ class Evaluator {
     const bool mIsHorizontalUnitDegree; /* degree vs metre */
     const bool mIsAddition;             /* addition vs geocentric */
     const bool mIsGeographicCRS;
+    InverseMethod mInverseMethod = InverseMethod::NEWTON;
 
+    // If jacobian is not null, it must point to an array of 6 values, set
+    // with the partial derivatives (dx_out/dx, dx_out/dy, dy_out/dx,
+    // dy_out/dy, dz_out/dx, dz_out/dy).
     bool forward(EvaluatorIface &iface, double x, double y, double z, double t,
                  bool forInverseComputation, double &x_out, double &y_out,
+                 double &z_out, double *jacobian);
+
+    bool inverse(EvaluatorIface &iface, double x, double y, double z, double t,
+                 bool useJacobian, double &x_out, double &y_out,
                  double &z_out);
 
     std::vector<std::unique_ptr<ComponentEx<Grid, GridSet>>> mComponents{};
+
+    // Index of the extents of the components that define a displacement
+    NS_PROJ::QuadTree::QuadTree<unsigned> mComponentsQuadTree{
+        NS_PROJ::QuadTree::RectObj()};
+
+    // Reused between invocations to save memory allocations
+    std::vector<unsigned> mComponentIndices{};
 };
 
 // ---------------------------------------------------------------------------
@@ -180,10 +180,25 @@ template <class Grid, class GridSet> struct ComponentEx {
 
     const DisplacementType displacementType;
 
+    // Time window out of which the time function evaluates to 0
+    double timeWindowMin = -std::numeric_limits<double>::infinity();
+    double timeWindowMax = std::numeric_limits<double>::infinity();
+
     // Cache
     std::unique_ptr<GridSet> gridSet{};
     std::map<const Grid *, GridEx<Grid>> mapGrids{};
 
+    // Values at the corners of the last grid cell used, in the order
+    // (ix0, iy0), (ix0, iy1), (ix1, iy0), (ix1, iy1).
+    // h1 and h2 are longitude and latitude offsets, or easting and northing
+    // offsets, depending on the horizontal offset unit.
+    const Grid *cellGrid = nullptr;
+    int cellIx0 = -1;
+    int cellIy0 = -1;
+    double cellH1[4] = {0, 0, 0, 0};
+    double cellH2[4] = {0, 0, 0, 0};
+    double cellZ[4] = {0, 0, 0, 0};
+
   private:
     mutable double mCachedDt = 0;
     mutable double mCachedValue = 0;
@@ -203,7 +218,35 @@ template <class Grid, class GridSet> struct ComponentEx {
         : component(componentIn),
           isBilinearInterpolation(
               componentIn.spatialModel().interpolationMethod == STR_BILINEAR),
-          displacementType(getDisplacementType(component.displacementType())) {}
+          displacementType(getDisplacementType(component.displacementType())) {
+        const auto *tf = component.timeFunction();
+        if (tf->type == "step") {
+            timeWindowMin =
+                static_cast<const Component::StepTimeFunction *>(tf)
+                    ->stepEpoch.toDecimalYear();
+        } else if (tf->type == "reverse_step") {
+            timeWindowMax =
+                static_cast<const Component::ReverseStepTimeFunction *>(tf)
+                    ->stepEpoch.toDecimalYear();
+        } else if (tf->type == "piecewise") {
+            const auto *piecewise =
+                static_cast<const Component::PiecewiseTimeFunction *>(tf);
+            if (piecewise->model.empty()) {
+                timeWindowMin = std::numeric_limits<double>::infinity();
+                timeWindowMax = -std::numeric_limits<double>::infinity();
+            } else {
+                if (piecewise->beforeFirst == "zero")
+                    timeWindowMin =
+                        piecewise->model.front().epoch.toDecimalYear();
+                if (piecewise->afterLast == "zero")
+                    timeWindowMax =
+                        piecewise->model.back().epoch.toDecimalYear();
+            }
+        }
+    }
+
+    ComponentEx(const ComponentEx &) = delete;
+    ComponentEx &operator=(const ComponentEx &) = delete;
 
     double evaluateAt(double dt) const {
         if (dt == mCachedDt)
@@ -213,9 +256,46 @@ template <class Grid, class GridSet> struct ComponentEx {
         return mCachedValue;
     }
 
+    // Fetch the values at the corners of the grid cell whose lower left
+    // corner is (ix0, iy0), unless it is the last cell fetched, which
+    // typically happens during inverse computations.
+    bool fetchCell(const Grid *grid, int ix0, int iy0,
+                   bool isHorizontalUnitDegree) {
+        if (grid == cellGrid && ix0 == cellIx0 && iy0 == cellIy0)
+            return true;
+        cellGrid = nullptr;
+        for (int i = 0; i < 4; ++i) {
+            const int ix = ix0 + i / 2;
+            const int iy = iy0 + i % 2;
+            bool ok;
+            if (displacementType == DisplacementType::VERTICAL) {
+                ok = grid->getZOffset(ix, iy, cellZ[i]);
+            } else if (isHorizontalUnitDegree) {
+                ok = displacementType == DisplacementType::HORIZONTAL
+                         ? grid->getLongLatOffset(ix, iy, cellH1[i],
+                                                  cellH2[i])
+                         : grid->getLongLatZOffset(ix, iy, cellH1[i],
+                                                   cellH2[i], cellZ[i]);
+            } else {
+                ok = displacementType == DisplacementType::HORIZONTAL
+                         ? grid->getEastingNorthingOffset(ix, iy, cellH1[i],
+                                                          cellH2[i])
+                         : grid->getEastingNorthingZOffset(
+                               ix, iy, cellH1[i], cellH2[i], cellZ[i]);
+            }
+            if (!ok)
+                return false;
+        }
+        cellGrid = grid;
+        cellIx0 = ix0;
+        cellIy0 = iy0;
+        return true;
+    }
+
     void clearGridCache() {
         gridSet.reset();
         mapGrids.clear();
+        cellGrid = nullptr;
     }
 };
 
@@ -752,6 +832,47 @@ Evaluator<Grid, GridSet, EvaluatorIface>::Evaluator(
                 "interpolation_method = geocentric_bilinear are incompatible");
         }
     }
+
+    // Index the extents of the components, so that forward() only visits
+    // the ones that may contain the point. Models with many localized
+    // components (e.g. earthquake patches) would otherwise spend most of
+    // their time rejecting components.
+    const double EPS = mIsGeographicCRS ? 1e-10 : 1e-5;
+    NS_PROJ::QuadTree::RectObj globalBounds;
+    globalBounds.minx = std::numeric_limits<double>::max();
+    globalBounds.miny = std::numeric_limits<double>::max();
+    globalBounds.maxx = -std::numeric_limits<double>::max();
+    globalBounds.maxy = -std::numeric_limits<double>::max();
+    std::vector<std::pair<unsigned, NS_PROJ::QuadTree::RectObj>> bounds;
+    for (size_t i = 0; i < mComponents.size(); ++i) {
+        const auto &compEx = mComponents[i];
+        if (compEx->displacementType == DisplacementType::NONE ||
+            !(compEx->timeWindowMin <= compEx->timeWindowMax)) {
+            continue;
+        }
+        const auto &extent = compEx->component.extent();
+        NS_PROJ::QuadTree::RectObj rect;
+        rect.minx = extent.minxNormalized(mIsGeographicCRS) - EPS;
+        rect.miny = extent.minyNormalized(mIsGeographicCRS) - EPS;
+        rect.maxx = extent.maxxNormalized(mIsGeographicCRS) + EPS;
+        rect.maxy = extent.maxyNormalized(mIsGeographicCRS) + EPS;
+        // Also catches NaN
+        if (!(rect.minx <= rect.maxx && rect.miny <= rect.maxy)) {
+            continue;
+        }
+        globalBounds.minx = std::min(globalBounds.minx, rect.minx);
+        globalBounds.miny = std::min(globalBounds.miny, rect.miny);
+        globalBounds.maxx = std::max(globalBounds.maxx, rect.maxx);
+        globalBounds.maxy = std::max(globalBounds.maxy, rect.maxy);
+        bounds.emplace_back(static_cast<unsigned>(i), rect);
+    }
+    if (!bounds.empty()) {
+        mComponentsQuadTree =
+            NS_PROJ::QuadTree::QuadTree<unsigned>(globalBounds);
+        for (const auto &pair : bounds) {
+            mComponentsQuadTree.insert(pair.first, pair.second);
+        }
+    }
 }
 
 // ---------------------------------------------------------------------------
@@ -825,7 +946,8 @@ static bool bboxCheck(double &x, double &y, bool forInverseComputation,
 template <class Grid, class GridSet, class EvaluatorIface>
 bool Evaluator<Grid, GridSet, EvaluatorIface>::forward(
     EvaluatorIface &iface, double x, double y, double z, double t,
-    bool forInverseComputation, double &x_out, double &y_out, double &z_out)
+    bool forInverseComputation, double &x_out, double &y_out, double &z_out,
+    double *jacobian)
 
 {
     x_out = x;
@@ -889,9 +1011,29 @@ bool Evaluator<Grid, GridSet, EvaluatorIface>::forward(
     double sinphi = 0;
     double cosphi = 0;
 
-    for (auto &compEx : mComponents) {
+    // Partial derivatives along x and y of dlam and dphi, or de and dn,
+    // and of dz, if jacobian is requested.
+    double dh1dx = 0;
+    double dh1dy = 0;
+    double dh2dx = 0;
+    double dh2dy = 0;
+    double dzdx = 0;
+    double dzdy = 0;
+
+    mComponentIndices.clear();
+    mComponentsQuadTree.search(x, y, mComponentIndices);
+    // Visit components in the order of the model, so that the result does
+    // not depend on the index
+    std::sort(mComponentIndices.begin(), mComponentIndices.end());
+
+    for (const unsigned iComponent : mComponentIndices) {
+        auto &compEx = mComponents[iComponent];
         const auto &comp = compEx->component;
-        if (compEx->displacementType == DisplacementType::NONE) {
+        if (t < compEx->timeWindowMin || t > compEx->timeWindowMax) {
+#ifdef DEBUG_DEFMODEL
+            iface.log("Skipping component " + shortName(comp) +
+                      " due to time function evaluating to 0.");
+#endif
             continue;
         }
         const auto &extent = comp.extent();
@@ -961,8 +1103,6 @@ bool Evaluator<Grid, GridSet, EvaluatorIface>::forward(
         }
         const int ix0 = std::min(static_cast<int>(ix_d), grid->width - 2);
         const int iy0 = std::min(static_cast<int>(iy_d), grid->height - 2);
-        const int ix1 = ix0 + 1;
-        const int iy1 = iy0 + 1;
         const double frct_x = ix_d - ix0;
         const double frct_y = iy_d - iy0;
         const double one_minus_frct_x = 1. - frct_x;
@@ -972,65 +1112,49 @@ bool Evaluator<Grid, GridSet, EvaluatorIface>::forward(
         const double m01 = one_minus_frct_x * frct_y;
         const double m11 = frct_x * frct_y;
 
-        if (compEx->displacementType == DisplacementType::VERTICAL) {
-            double dz00 = 0;
-            double dz01 = 0;
-            double dz10 = 0;
-            double dz11 = 0;
-            if (!grid->getZOffset(ix0, iy0, dz00) ||
-                !grid->getZOffset(ix1, iy0, dz10) ||
-                !grid->getZOffset(ix0, iy1, dz01) ||
-                !grid->getZOffset(ix1, iy1, dz11)) {
-                return false;
-            }
-            const double dzInterp =
-                dz00 * m00 + dz01 * m01 + dz10 * m10 + dz11 * m11;
+        if (!compEx->fetchCell(grid, ix0, iy0, mIsHorizontalUnitDegree)) {
+            return false;
+        }
+        const auto interpolate = [m00, m01, m10, m11](const double *v) {
+            return v[0] * m00 + v[1] * m01 + v[2] * m10 + v[3] * m11;
+        };
+
+        // Factors to compute the partial derivatives of the bilinear
+        // interpolation, if jacobian is requested. They are zero along an
+        // axis where the point has been clamped to the extent of the
+        // component.
+        const double derivFactorX =
+            jacobian && xForGrid == x ? tfactor / grid->resx : 0;
+        const double derivFactorY =
+            jacobian && yForGrid == y ? tfactor / grid->resy : 0;
+        const auto derivativeX = [=](const double *v) {
+            return derivFactorX * ((v[2] - v[0]) * one_minus_frct_y +
+                                   (v[3] - v[1]) * frct_y);
+        };
+        const auto derivativeY = [=](const double *v) {
+            return derivFactorY * ((v[1] - v[0]) * one_minus_frct_x +
+                                   (v[3] - v[2]) * frct_x);
+        };
+
+        if (compEx->displacementType != DisplacementType::HORIZONTAL) {
+            const double dzInterp = interpolate(compEx->cellZ);
 #ifdef DEBUG_DEFMODEL
             iface.log("tfactor * dzInterp = " + toString(tfactor) + " * " +
                       toString(dzInterp) + ".");
 #endif
             dz += tfactor * dzInterp;
-        } else if (mIsHorizontalUnitDegree) {
-            double dx00 = 0;
-            double dy00 = 0;
-            double dx01 = 0;
-            double dy01 = 0;
-            double dx10 = 0;
-            double dy10 = 0;
-            double dx11 = 0;
-            double dy11 = 0;
-            if (compEx->displacementType == DisplacementType::HORIZONTAL) {
-                if (!grid->getLongLatOffset(ix0, iy0, dx00, dy00) ||
-                    !grid->getLongLatOffset(ix1, iy0, dx10, dy10) ||
-                    !grid->getLongLatOffset(ix0, iy1, dx01, dy01) ||
-                    !grid->getLongLatOffset(ix1, iy1, dx11, dy11)) {
-                    return false;
-                }
-            } else /* if (compEx->displacementType == DisplacementType::THREE_D)
-                    */
-            {
-                double dz00 = 0;
-                double dz01 = 0;
-                double dz10 = 0;
-                double dz11 = 0;
-                if (!grid->getLongLatZOffset(ix0, iy0, dx00, dy00, dz00) ||
-                    !grid->getLongLatZOffset(ix1, iy0, dx10, dy10, dz10) ||
-                    !grid->getLongLatZOffset(ix0, iy1, dx01, dy01, dz01) ||
-                    !grid->getLongLatZOffset(ix1, iy1, dx11, dy11, dz11)) {
-                    return false;
-                }
-                const double dzInterp =
-                    dz00 * m00 + dz01 * m01 + dz10 * m10 + dz11 * m11;
-#ifdef DEBUG_DEFMODEL
-                iface.log("tfactor * dzInterp = " + toString(tfactor) + " * " +
-                          toString(dzInterp) + ".");
-#endif
-                dz += tfactor * dzInterp;
+            if (jacobian) {
+                dzdx += derivativeX(compEx->cellZ);
+                dzdy += derivativeY(compEx->cellZ);
             }
-            const double dlamInterp =
-                dx00 * m00 + dx01 * m01 + dx10 * m10 + dx11 * m11;
-            const double dphiInterp =
-                dy00 * m00 + dy01 * m01 + dy10 * m10 + dy11 * m11;
+        }
+        if (compEx->displacementType == DisplacementType::VERTICAL) {
+            continue;
+        }
+
+        if (mIsHorizontalUnitDegree) {
+            const double dlamInterp = interpolate(compEx->cellH1);
+            const double dphiInterp = interpolate(compEx->cellH2);
 #ifdef DEBUG_DEFMODEL
             iface.log("tfactor * dlamInterp = " + toString(tfactor) + " * " +
                       toString(dlamInterp) + ".");
@@ -1040,51 +1164,9 @@ bool Evaluator<Grid, GridSet, EvaluatorIface>::forward(
             dlam += tfactor * dlamInterp;
             dphi += tfactor * dphiInterp;
         } else /* horizontal unit is metre */ {
-            double de00 = 0;
-            double dn00 = 0;
-            double de01 = 0;
-            double dn01 = 0;
-            double de10 = 0;
-            double dn10 = 0;
-            double de11 = 0;
-            double dn11 = 0;
-            if (compEx->displacementType == DisplacementType::HORIZONTAL) {
-                if (!grid->getEastingNorthingOffset(ix0, iy0, de00, dn00) ||
-                    !grid->getEastingNorthingOffset(ix1, iy0, de10, dn10) ||
-                    !grid->getEastingNorthingOffset(ix0, iy1, de01, dn01) ||
-                    !grid->getEastingNorthingOffset(ix1, iy1, de11, dn11)) {
-                    return false;
-                }
-            } else /* if (compEx->displacementType == DisplacementType::THREE_D)
-                    */
-            {
-                double dz00 = 0;
-                double dz01 = 0;
-                double dz10 = 0;
-                double dz11 = 0;
-                if (!grid->getEastingNorthingZOffset(ix0, iy0, de00, dn00,
-                                                     dz00) ||
-                    !grid->getEastingNorthingZOffset(ix1, iy0, de10, dn10,
-                                                     dz10) ||
-                    !grid->getEastingNorthingZOffset(ix0, iy1, de01, dn01,
-                                                     dz01) ||
-                    !grid->getEastingNorthingZOffset(ix1, iy1, de11, dn11,
-                                                     dz11)) {
-                    return false;
-                }
-                const double dzInterp =
-                    dz00 * m00 + dz01 * m01 + dz10 * m10 + dz11 * m11;
-#ifdef DEBUG_DEFMODEL
-                iface.log("tfactor * dzInterp = " + toString(tfactor) + " * " +
-                          toString(dzInterp) + ".");
-#endif
-                dz += tfactor * dzInterp;
-            }
             if (compEx->isBilinearInterpolation) {
-                const double deInterp =
-                    de00 * m00 + de01 * m01 + de10 * m10 + de11 * m11;
-                const double dnInterp =
-                    dn00 * m00 + dn01 * m01 + dn10 * m10 + dn11 * m11;
+                const double deInterp = interpolate(compEx->cellH1);
+                const double dnInterp = interpolate(compEx->cellH2);
 #ifdef DEBUG_DEFMODEL
                 iface.log("tfactor * deInterp = " + toString(tfactor) + " * " +
                           toString(deInterp) + ".");
@@ -1108,9 +1190,11 @@ bool Evaluator<Grid, GridSet, EvaluatorIface>::forward(
                 }
                 GridEx<Grid> &gridwithCacheRef = iter->second;
 
+                const double *de_ = compEx->cellH1;
+                const double *dn_ = compEx->cellH2;
                 gridwithCacheRef.getBilinearGeocentric(
-                    ix0, iy0, de00, dn00, de01, dn01, de10, dn10, de11, dn11,
-                    m00, m01, m10, m11, dX, dY, dZ);
+                    ix0, iy0, de_[0], dn_[0], de_[1], dn_[1], de_[2], dn_[2],
+                    de_[3], dn_[3], m00, m01, m10, m11, dX, dY, dZ);
                 if (!sincosphiInitialized) {
                     sincosphiInitialized = true;
                     sinphi = sin(y);
@@ -1148,6 +1232,32 @@ bool Evaluator<Grid, GridSet, EvaluatorIface>::forward(
                 dn += tfactor * dnInterp;
             }
         }
+
+        if (jacobian) {
+            // For geocentric_bilinear, the rotation between the corners of
+            // the cell is neglected.
+            dh1dx += derivativeX(compEx->cellH1);
+            dh1dy += derivativeY(compEx->cellH1);
+            dh2dx += derivativeX(compEx->cellH2);
+            dh2dy += derivativeY(compEx->cellH2);
+        }
+    }
+
+    if (jacobian) {
+        // Offsets in metre are converted to long/lat offsets with factors
+        // that only depend on latitude, whose variation is neglected.
+        double scaleX = 1;
+        double scaleY = 1;
+        if (!mIsHorizontalUnitDegree && mIsGeographicCRS) {
+            DeltaEastingNorthingToLongLat(cos(y), 1, 1, mA, mB, mEs, scaleX,
+                                          scaleY);
+        }
+        jacobian[0] = 1 + scaleX * dh1dx;
+        jacobian[1] = scaleX * dh1dy;
+        jacobian[2] = scaleY * dh2dx;
+        jacobian[3] = 1 + scaleY * dh2dy;
+        jacobian[4] = dzdx;
+        jacobian[5] = dzdy;
     }
 
     // Apply shifts depending on horizontal_offset_unit and
@@ -1227,6 +1337,21 @@ bool Evaluator<Grid, GridSet, EvaluatorIface>::inverse(
     EvaluatorIface &iface, double x, double y, double z, double t,
     double &x_out, double &y_out, double &z_out)
 
+{
+    if (mInverseMethod == InverseMethod::NEWTON &&
+        inverse(iface, x, y, z, t, true, x_out, y_out, z_out)) {
+        return true;
+    }
+    return inverse(iface, x, y, z, t, false, x_out, y_out, z_out);
+}
+
+// ---------------------------------------------------------------------------
+
+template <class Grid, class GridSet, class EvaluatorIface>
+bool Evaluator<Grid, GridSet, EvaluatorIface>::inverse(
+    EvaluatorIface &iface, double x, double y, double z, double t,
+    bool useJacobian, double &x_out, double &y_out, double &z_out)
+
 {
     x_out = x;
     y_out = y;
@@ -1234,6 +1359,8 @@ bool Evaluator<Grid, GridSet, EvaluatorIface>::inverse(
     constexpr double EPS_HORIZ = 1e-12;
     constexpr double EPS_VERT = 1e-3;
     constexpr bool forInverseComputation = true;
+    double jacobian[6] = {1, 0, 0, 1, 0, 0};
+    double prevStep = 0;
     for (int i = 0; i < 10; i++) {
 #ifdef DEBUG_DEFMODEL
         iface.log("Iteration " + std::to_string(i) + ": before forward: x=" +
@@ -1243,7 +1370,7 @@ bool Evaluator<Grid, GridSet, EvaluatorIface>::inverse(
         double y_new;
         double z_new;
         if (!forward(iface, x_out, y_out, z_out, t, forInverseComputation,
-                     x_new, y_new, z_new)) {
+                     x_new, y_new, z_new, useJacobian ? jacobian : nullptr)) {
             return false;
         }
 #ifdef DEBUG_DEFMODEL
@@ -1253,13 +1380,38 @@ bool Evaluator<Grid, GridSet, EvaluatorIface>::inverse(
         const double dx = x_new - x;
         const double dy = y_new - y;
         const double dz = z_new - z;
-        x_out -= dx;
-        y_out -= dy;
-        z_out -= dz;
+        // Newton step, or fixed-point iteration step if the Jacobian is the
+        // identity. The Jacobian of a deformation is close to the identity,
+        // so a determinant far from 1 denotes an invalid model.
+        const double det =
+            jacobian[0] * jacobian[3] - jacobian[1] * jacobian[2];
+        if (!(det > 0.5 && det < 2)) {
+            return false;
+        }
+        const double stepX = (jacobian[3] * dx - jacobian[1] * dy) / det;
+        const double stepY = (jacobian[0] * dy - jacobian[2] * dx) / det;
+        x_out -= stepX;
+        y_out -= stepY;
+        // Account for the variation of the vertical offset along the
+        // horizontal step (only with Newton iteration)
+        z_out -= dz - jacobian[4] * stepX - jacobian[5] * stepY;
         if (std::max(std::fabs(dx), std::fabs(dy)) < EPS_HORIZ &&
             std::fabs(dz) < EPS_VERT) {
             return true;
         }
+        const double step = std::max(std::fabs(stepX), std::fabs(stepY));
+        if (useJacobian) {
+            // Newton iteration converges quadratically. Estimate the
+            // remaining error from the rate of decrease of the steps, to
+            // avoid an extra evaluation of forward() only to check the
+            // residual. The vertical error is then proportional to the
+            // horizontal one.
+            const double rate = step / prevStep;
+            if (rate < 0.5 && step * rate / (1 - rate) < EPS_HORIZ) {
+                return true;
+            }
+        }
+        prevStep = step;
     }
     return false;
 }
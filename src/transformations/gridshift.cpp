@@ -41,6 +41,7 @@
 
 #include <algorithm>
 #include <cmath>
+#include <functional>
 #include <limits>
 #include <map>
 #include <utility>
@@ -120,6 +121,9 @@ struct gridshiftData {
                                GenericShiftGridSet *gridset, bool &shouldRetry);
 
     PJ_XYZ apply(PJ *P, PJ_DIRECTION dir, PJ_XYZ xyz);
+
+    void sortByCell(const PJ_COORD *coo, size_t n, PJ_DIRECTION direction,
+                    std::vector<size_t> &order) const;
 };
 
 // ---------------------------------------------------------------------------
@@ -831,6 +835,58 @@ PJ_XYZ gridshiftData::apply(PJ *P, PJ_DIRECTION direction, PJ_XYZ xyz) {
     return out;
 }
 
+// ---------------------------------------------------------------------------
+
+// Compute in order the indices of the coordinates of coo (skipping failed
+// ones) sorted by the cell of the main grid they fall in, so that
+// grid_interpolate() reads the nodes of each cell only once.
+void gridshiftData::sortByCell(const PJ_COORD *coo, size_t n,
+                               PJ_DIRECTION direction,
+                               std::vector<size_t> &order) const {
+    struct Key {
+        const GenericShiftGrid *grid;
+        int32_t y;
+        int32_t x;
+        size_t idx;
+    };
+    std::vector<Key> keys;
+    keys.reserve(n);
+    for (size_t i = 0; i < n; ++i) {
+        if (coo[i].v[0] == HUGE_VAL)
+            continue;
+        Key key{nullptr, 0, 0, i};
+        PJ_XYZ xyz = coo[i].xyz;
+        if (direction == PJ_INV) {
+            xyz.x -= m_offsetX;
+            xyz.y -= m_offsetY;
+        }
+        GenericShiftGridSet *gridset = nullptr;
+        key.grid = findGrid(m_mainGridType, xyz, gridset);
+        if (key.grid && !key.grid->isNullGrid()) {
+            const NS_PROJ::ExtentAndRes *extent;
+            const PJ_XY normalized = normalizeX(key.grid, xyz, extent);
+            const double x = (normalized.x - extent->west) / extent->resX;
+            const double y = (normalized.y - extent->south) / extent->resY;
+            key.x = std::isnan(x) ? 0 : (int32_t)lround(floor(x));
+            key.y = std::isnan(y) ? 0 : (int32_t)lround(floor(y));
+        }
+        keys.push_back(key);
+    }
+    std::sort(keys.begin(), keys.end(), [](const Key &a, const Key &b) {
+        if (a.grid != b.grid)
+            return std::less<const GenericShiftGrid *>()(a.grid, b.grid);
+        if (a.y != b.y)
+            return a.y < b.y;
+        if (a.x != b.x)
+            return a.x < b.x;
+        return a.idx < b.idx;
+    });
+    order.clear();
+    order.reserve(keys.size());
+    for (const auto &key : keys)
+        order.push_back(key.idx);
+}
+
 } // anonymous namespace
 
 // ---------------------------------------------------------------------------
@@ -878,6 +934,52 @@ static PJ_LPZ pj_gridshift_reverse_3d(PJ_XYZ xyz, PJ *P) {
 
 // ---------------------------------------------------------------------------
 
+// Batched version of pj_gridshift_forward_3d() and pj_gridshift_reverse_3d()
+static void pj_gridshift_apply_array(PJ_COORD *coo, size_t n, int *err,
+                                     PJ *P, PJ_DIRECTION direction) {
+    auto Q = static_cast<gridshiftData *>(P->opaque);
+
+    if (!Q->loadGridsIfNeeded(P)) {
+        const int errorCode = proj_errno(P);
+        for (size_t i = 0; i < n; ++i) {
+            if (coo[i].v[0] == HUGE_VAL)
+                continue;
+            err[i] = errorCode;
+            coo[i] = proj_coord_error();
+        }
+        return;
+    }
+
+    std::vector<size_t> order;
+    Q->sortByCell(coo, n, direction, order);
+    for (const size_t i : order) {
+        proj_errno_reset(P);
+        if (direction == PJ_FWD) {
+            const auto xyz = pj_gridshift_forward_3d(coo[i].lpz, P);
+            coo[i].xyz = xyz;
+        } else {
+            const auto lpz = pj_gridshift_reverse_3d(coo[i].xyz, P);
+            coo[i].lpz = lpz;
+        }
+        if (coo[i].v[0] == HUGE_VAL || proj_errno(P)) {
+            err[i] = proj_errno(P);
+            coo[i] = proj_coord_error();
+        }
+    }
+}
+
+static void pj_gridshift_forward_4d_array(PJ_COORD *coo, size_t n, int *err,
+                                          PJ *P) {
+    pj_gridshift_apply_array(coo, n, err, P, PJ_FWD);
+}
+
+static void pj_gridshift_reverse_4d_array(PJ_COORD *coo, size_t n, int *err,
+                                          PJ *P) {
+    pj_gridshift_apply_array(coo, n, err, P, PJ_INV);
+}
+
+// ---------------------------------------------------------------------------
+
 static PJ *pj_gridshift_destructor(PJ *P, int errlev) {
     if (nullptr == P)
         return nullptr;
@@ -907,6 +1009,8 @@ PJ *PJ_TRANSFORMATION(gridshift, 0) {
 
     P->fwd3d = pj_gridshift_forward_3d;
     P->inv3d = pj_gridshift_reverse_3d;
+    P->fwd4d_array = pj_gridshift_forward_4d_array;
+    P->inv4d_array = pj_gridshift_reverse_4d_array;
     P->fwd = nullptr;
     P->inv = nullptr;
 
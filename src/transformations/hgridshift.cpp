@@ -124,6 +124,61 @@ static void pj_hgridshift_reverse_4d(PJ_COORD &coo, PJ *P) {
     }
 }
 
+// Batched version of pj_hgridshift_forward_4d() and
+// pj_hgridshift_reverse_4d()
+static void pj_hgridshift_apply_array(PJ_COORD *coo, size_t n, int *err,
+                                      PJ *P, PJ_DIRECTION direction) {
+    auto Q = static_cast<hgridshiftData *>(P->opaque);
+    const auto apply4d = direction == PJ_FWD ? pj_hgridshift_forward_4d
+                                             : pj_hgridshift_reverse_4d;
+
+    if (Q->t_final != 0 && Q->t_epoch != 0) {
+        /* Time restricted: not worth batching */
+        for (size_t i = 0; i < n; ++i) {
+            if (coo[i].v[0] == HUGE_VAL)
+                continue;
+            proj_errno_reset(P);
+            apply4d(coo[i], P);
+            if (coo[i].v[0] == HUGE_VAL || proj_errno(P)) {
+                err[i] = proj_errno(P);
+                coo[i] = proj_coord_error();
+            }
+        }
+        return;
+    }
+
+    if (Q->defer_grid_opening) {
+        Q->defer_grid_opening = false;
+        Q->grids = pj_hgrid_init(P, "grids");
+        Q->error_code_in_defer_grid_opening = proj_errno(P);
+    }
+    if (Q->error_code_in_defer_grid_opening) {
+        for (size_t i = 0; i < n; ++i) {
+            if (coo[i].v[0] == HUGE_VAL)
+                continue;
+            err[i] = proj_errno_set(P, Q->error_code_in_defer_grid_opening);
+            coo[i] = proj_coord_error();
+        }
+        return;
+    }
+
+    if (!Q->grids.empty()) {
+        /* Only try the gridshift if at least one grid is loaded,
+         * otherwise just pass the coordinates through unchanged. */
+        pj_hgrid_apply_array(P->ctx, Q->grids, coo, n, err, direction);
+    }
+}
+
+static void pj_hgridshift_forward_4d_array(PJ_COORD *coo, size_t n, int *err,
+                                           PJ *P) {
+    pj_hgridshift_apply_array(coo, n, err, P, PJ_FWD);
+}
+
+static void pj_hgridshift_reverse_4d_array(PJ_COORD *coo, size_t n, int *err,
+                                           PJ *P) {
+    pj_hgridshift_apply_array(coo, n, err, P, PJ_INV);
+}
+
 static PJ *pj_hgridshift_destructor(PJ *P, int errlev) {
     if (nullptr == P)
         return nullptr;
@@ -149,6 +204,8 @@ PJ *PJ_TRANSFORMATION(hgridshift, 0) {
 
     P->fwd4d = pj_hgridshift_forward_4d;
     P->inv4d = pj_hgridshift_reverse_4d;
+    P->fwd4d_array = pj_hgridshift_forward_4d_array;
+    P->inv4d_array = pj_hgridshift_reverse_4d_array;
     P->fwd3d = pj_hgridshift_forward_3d;
     P->inv3d = pj_hgridshift_reverse_3d;
     P->fwd = nullptr;
@@ -93,38 +93,87 @@ PJ *PJ_TRANSFORMATION(tinshift, 1) {
     }
     file->seek(0, SEEK_END);
     unsigned long long size = file->tell();
-    // Arbitrary threshold to avoid ingesting an arbitrarily large JSON file,
-    // that could be a denial of service risk. 100 MB should be sufficiently
-    // large for any valid use !
-    if (size > 100 * 1024 * 1024) {
-        proj_log_error(P, _("File %s too large"), filename);
-        return pj_tinshift_destructor(
-            P, PROJ_ERR_INVALID_OP_FILE_NOT_FOUND_OR_INVALID);
-    }
     file->seek(0);
-    std::string jsonStr;
-    try {
-        jsonStr.resize(static_cast<size_t>(size));
-    } catch (const std::bad_alloc &) {
-        proj_log_error(P, _("Cannot read %s. Not enough memory"), filename);
-        return pj_tinshift_destructor(P, PROJ_ERR_OTHER);
-    }
-    if (file->read(&jsonStr[0], jsonStr.size()) != jsonStr.size()) {
-        proj_log_error(P, _("Cannot read %s"), filename);
-        return pj_tinshift_destructor(
-            P, PROJ_ERR_INVALID_OP_FILE_NOT_FOUND_OR_INVALID);
-    }
+
+    unsigned char signature[8] = {0};
+    const bool isBinary =
+        file->read(signature, sizeof(signature)) == sizeof(signature) &&
+        TINShiftFile::isBinary(signature, sizeof(signature));
+    file->seek(0);
 
     auto Q = new tinshiftData();
     P->opaque = (void *)Q;
     P->destructor = pj_tinshift_destructor;
 
-    try {
-        Q->evaluator.reset(new Evaluator(TINShiftFile::parse(jsonStr)));
-    } catch (const std::exception &e) {
-        proj_log_error(P, _("invalid model: %s"), e.what());
-        return pj_tinshift_destructor(
-            P, PROJ_ERR_INVALID_OP_FILE_NOT_FOUND_OR_INVALID);
+    if (isBinary) {
+        // Use the file content in place when it can be memory mapped, which
+        // avoids any parsing and copy of the triangulation and its index.
+        std::shared_ptr<const void> owner;
+        const unsigned char *data = nullptr;
+        size_t dataSize = 0;
+        auto mapping = file->map();
+        if (mapping) {
+            data = mapping->data();
+            dataSize = mapping->size();
+            owner = std::shared_ptr<NS_PROJ::FileMapping>(std::move(mapping));
+        } else {
+            auto buffer = std::make_shared<std::vector<unsigned char>>();
+            try {
+                buffer->resize(static_cast<size_t>(size));
+            } catch (const std::bad_alloc &) {
+                proj_log_error(P, _("Cannot read %s. Not enough memory"),
+                               filename);
+                return pj_tinshift_destructor(P, PROJ_ERR_OTHER);
+            }
+            if (file->read(buffer->data(), buffer->size()) != buffer->size()) {
+                proj_log_error(P, _("Cannot read %s"), filename);
+                return pj_tinshift_destructor(
+                    P, PROJ_ERR_INVALID_OP_FILE_NOT_FOUND_OR_INVALID);
+            }
+            data = buffer->data();
+            dataSize = buffer->size();
+            owner = std::move(buffer);
+        }
+
+        try {
+            Q->evaluator.reset(new Evaluator(
+                TINShiftFile::parseBinary(data, dataSize, owner)));
+        } catch (const std::exception &e) {
+            proj_log_error(P, _("invalid model: %s"), e.what());
+            return pj_tinshift_destructor(
+                P, PROJ_ERR_INVALID_OP_FILE_NOT_FOUND_OR_INVALID);
+        }
+    } else {
+        // Arbitrary threshold to avoid ingesting an arbitrarily large JSON
+        // file, that could be a denial of service risk. 100 MB should be
+        // sufficiently large for any valid use ! Larger triangulations
+        // should use the binary format.
+        if (size > 100 * 1024 * 1024) {
+            proj_log_error(P, _("File %s too large"), filename);
+            return pj_tinshift_destructor(
+                P, PROJ_ERR_INVALID_OP_FILE_NOT_FOUND_OR_INVALID);
+        }
+        std::string jsonStr;
+        try {
+            jsonStr.resize(static_cast<size_t>(size));
+        } catch (const std::bad_alloc &) {
+            proj_log_error(P, _("Cannot read %s. Not enough memory"),
+                           filename);
+            return pj_tinshift_destructor(P, PROJ_ERR_OTHER);
+        }
+        if (file->read(&jsonStr[0], jsonStr.size()) != jsonStr.size()) {
+            proj_log_error(P, _("Cannot read %s"), filename);
+            return pj_tinshift_destructor(
+                P, PROJ_ERR_INVALID_OP_FILE_NOT_FOUND_OR_INVALID);
+        }
+
+        try {
+            Q->evaluator.reset(new Evaluator(TINShiftFile::parse(jsonStr)));
+        } catch (const std::exception &e) {
+            proj_log_error(P, _("invalid model: %s"), e.what());
+            return pj_tinshift_destructor(
+                P, PROJ_ERR_INVALID_OP_FILE_NOT_FOUND_OR_INVALID);
+        }
     }
 
     P->fwd4d = tinshift_forward_4d;
@@ -36,6 +36,7 @@
 
 #include <algorithm>
 #include <cmath>
+#include <cstdint>
 #include <exception>
 #include <functional>
 #include <limits>
@@ -72,6 +73,24 @@ class TINShiftFile {
      */
     static std::unique_ptr<TINShiftFile> parse(const std::string &text);
 
+    /** Return whether the provided buffer starts with the signature of the
+     * binary format. */
+    static bool isBinary(const unsigned char *data, size_t size);
+
+    /** Return an object from the content of a file in the binary format.
+     *
+     * On little-endian hosts, vertices, triangles and spatial indices are
+     * used in place from data, without any copy. data must thus remain
+     * valid during the lifetime of the returned object, which is achieved
+     * by keeping a reference to owner (typically a memory mapping of the
+     * file).
+     *
+     * @throws ParsingException in case of error.
+     */
+    static std::unique_ptr<TINShiftFile>
+    parseBinary(const unsigned char *data, size_t size,
+                const std::shared_ptr<const void> &owner);
+
     /** Get file type. Should always be "triangulation_file" */
     const std::string &fileType() const { return mFileType; }
 
@@ -186,6 +205,9 @@ class TINShiftFile {
     /** Return number of elements per vertex of vertices() */
     unsigned verticesColumnCount() const { return mVerticesColumnCount; }
 
+    /** Return number of vertices */
+    size_t vertexCount() const { return mVertexCount; }
+
     /** Return description of triangulation vertices.
      * Each vertex is described by verticesColumnCount() consecutive values.
      * They are respectively:
@@ -199,13 +221,52 @@ class TINShiftFile {
      * X is assumed to be a longitude (in degrees) or easting value.
      * Y is assumed to be a latitude (in degrees) or northing value.
      */
-    const std::vector<double> &vertices() const { return mVertices; }
+    const double *vertices() const { return mVertices; }
+
+    /** Return number of triangles */
+    size_t triangleCount() const { return mTriangleCount; }
 
     /** Return triangles*/
-    const std::vector<VertexIndices> &triangles() const { return mTriangles; }
+    const VertexIndices *triangles() const { return mTriangles; }
+
+    /** Spatial index of the triangles, as stored in binary files.
+     *
+     * The extent of the vertices is split in ncols * nrows cells of equal
+     * size. The indices of the triangles whose bounding box intersects
+     * the cell at (col, row) are
+     * cellTriangles[cellStart[row * ncols + col]] to
+     * cellTriangles[cellStart[row * ncols + col + 1] - 1].
+     */
+    struct GridIndex {
+        double minx = 0;
+        double miny = 0;
+        double maxx = 0;
+        double maxy = 0;
+        /** Number of columns. 0 if there is no index */
+        unsigned ncols = 0;
+        /** Number of rows. 0 if there is no index */
+        unsigned nrows = 0;
+        /** ncols * nrows + 1 values */
+        const unsigned *cellStart = nullptr;
+        const unsigned *cellTriangles = nullptr;
+    };
+
+    /** Return the spatial index of the triangles in source coordinates
+     * (forward = true) or target coordinates (forward = false).
+     * Its ncols member is 0 if the file has no prebuilt index.
+     */
+    const GridIndex &gridIndex(bool forward) const {
+        return forward ? mForwardIndex : mInverseIndex;
+    }
 
   private:
     TINShiftFile() = default;
+    TINShiftFile(const TINShiftFile &) = delete;
+    TINShiftFile &operator=(const TINShiftFile &) = delete;
+
+    struct ColumnIndices;
+    static ColumnIndices parseMetadata(const json &j,
+                                       TINShiftFile *tinshiftFile);
 
     std::string mFileType{};
     std::string mFormatVersion{};
@@ -222,8 +283,36 @@ class TINShiftFile {
     bool mTransformHorizontalComponent = false;
     bool mTransformVerticalComponent = false;
     unsigned mVerticesColumnCount = 0;
-    std::vector<double> mVertices{};
-    std::vector<VertexIndices> mTriangles{};
+    size_t mVertexCount = 0;
+    const double *mVertices = nullptr;
+    size_t mTriangleCount = 0;
+    const VertexIndices *mTriangles = nullptr;
+    GridIndex mForwardIndex{};
+    GridIndex mInverseIndex{};
+
+    // Storage of the above arrays when they are not used in place from
+    // the content of a binary file.
+    std::vector<double> mVerticesStorage{};
+    std::vector<VertexIndices> mTrianglesStorage{};
+    std::vector<unsigned> mForwardIndexStorage{};
+    std::vector<unsigned> mInverseIndexStorage{};
+
+    // Keeps the content of a binary file alive
+    std::shared_ptr<const void> mOwner{};
+};
+
+// ---------------------------------------------------------------------------
+
+/** State of the search of triangles from the last triangle found, for
+ * streams of nearby points. */
+struct TriangleWalkState {
+    /** Last triangle found, or max() if none. */
+    unsigned lastTriangle = std::numeric_limits<unsigned>::max();
+    /** Number of consecutive searches that did not find the triangle by
+     * walking from the last one. */
+    unsigned failures = 0;
+    /** Number of next searches that will directly use the spatial index. */
+    unsigned skip = 0;
 };
 
 // ---------------------------------------------------------------------------
@@ -253,6 +342,16 @@ class Evaluator {
     // Reused between invocations to save memory allocations
     std::vector<unsigned> mTriangleIndices{};
 
+    // For each triangle, index of the neighboring triangles across the edges
+    // opposite to its first, second and third vertex (max() if none).
+    // Built with the quadtrees.
+    std::vector<unsigned> mNeighbors{};
+
+    // Searches of triangles by forward() and inverse() start from the last
+    // triangle they found.
+    TriangleWalkState mWalkForward{};
+    TriangleWalkState mWalkInverse{};
+
     std::unique_ptr<NS_PROJ::QuadTree::QuadTree<unsigned>> mQuadTreeForward{};
     std::unique_ptr<NS_PROJ::QuadTree::QuadTree<unsigned>> mQuadTreeInverse{};
 };
@@ -31,6 +31,7 @@
 
 #include <algorithm>
 #include <cmath>
+#include <cstring>
 #include <limits>
 
 namespace TINSHIFT_NAMESPACE {
@@ -76,14 +77,26 @@ static json getArrayMember(const json &j, const char *key) {
 
 // ---------------------------------------------------------------------------
 
-std::unique_ptr<TINShiftFile> TINShiftFile::parse(const std::string &text) {
-    std::unique_ptr<TINShiftFile> tinshiftFile(new TINShiftFile());
-    json j;
-    try {
-        j = json::parse(text);
-    } catch (const std::exception &e) {
-        throw ParsingException(e.what());
-    }
+struct TINShiftFile::ColumnIndices {
+    size_t verticesColumnCount = 0;
+    int sourceXCol = -1;
+    int sourceYCol = -1;
+    int sourceZCol = -1;
+    int targetXCol = -1;
+    int targetYCol = -1;
+    int targetZCol = -1;
+    int offsetZCol = -1;
+    size_t trianglesColumnCount = 0;
+    int idxVertex1Col = -1;
+    int idxVertex2Col = -1;
+    int idxVertex3Col = -1;
+};
+
+// ---------------------------------------------------------------------------
+
+// Parse everything but the vertices and triangles arrays
+TINShiftFile::ColumnIndices
+TINShiftFile::parseMetadata(const json &j, TINShiftFile *tinshiftFile) {
     if (!j.is_object()) {
         throw ParsingException("Not an object");
     }
@@ -162,14 +175,16 @@ std::unique_ptr<TINShiftFile> TINShiftFile::parse(const std::string &text) {
         }
     }
 
+    ColumnIndices cols;
     const auto jVerticesColumns = getArrayMember(j, "vertices_columns");
-    int sourceXCol = -1;
-    int sourceYCol = -1;
-    int sourceZCol = -1;
-    int targetXCol = -1;
-    int targetYCol = -1;
-    int targetZCol = -1;
-    int offsetZCol = -1;
+    cols.verticesColumnCount = jVerticesColumns.size();
+    int &sourceXCol = cols.sourceXCol;
+    int &sourceYCol = cols.sourceYCol;
+    int &sourceZCol = cols.sourceZCol;
+    int &targetXCol = cols.targetXCol;
+    int &targetYCol = cols.targetYCol;
+    int &targetZCol = cols.targetZCol;
+    int &offsetZCol = cols.offsetZCol;
     for (size_t i = 0; i < jVerticesColumns.size(); ++i) {
         const json &jColumn = jVerticesColumns[i];
         if (!jColumn.is_string()) {
@@ -226,9 +241,10 @@ std::unique_ptr<TINShiftFile> TINShiftFile::parse(const std::string &text) {
     }
 
     const auto jTrianglesColumns = getArrayMember(j, "triangles_columns");
-    int idxVertex1Col = -1;
-    int idxVertex2Col = -1;
-    int idxVertex3Col = -1;
+    cols.trianglesColumnCount = jTrianglesColumns.size();
+    int &idxVertex1Col = cols.idxVertex1Col;
+    int &idxVertex2Col = cols.idxVertex2Col;
+    int &idxVertex3Col = cols.idxVertex3Col;
     for (size_t i = 0; i < jTrianglesColumns.size(); ++i) {
         const json &jColumn = jTrianglesColumns[i];
         if (!jColumn.is_string()) {
@@ -256,50 +272,76 @@ std::unique_ptr<TINShiftFile> TINShiftFile::parse(const std::string &text) {
             "idx_vertex3 must be specified in triangles_columns[]");
     }
 
-    const auto jVertices = getArrayMember(j, "vertices");
     tinshiftFile->mVerticesColumnCount = 2;
     if (tinshiftFile->mTransformHorizontalComponent)
         tinshiftFile->mVerticesColumnCount += 2;
     if (tinshiftFile->mTransformVerticalComponent)
         tinshiftFile->mVerticesColumnCount += 1;
 
-    tinshiftFile->mVertices.reserve(tinshiftFile->mVerticesColumnCount *
-                                    jVertices.size());
+    return cols;
+}
+
+// ---------------------------------------------------------------------------
+
+std::unique_ptr<TINShiftFile> TINShiftFile::parse(const std::string &text) {
+    std::unique_ptr<TINShiftFile> tinshiftFile(new TINShiftFile());
+    json j;
+    try {
+        j = json::parse(text);
+    } catch (const std::exception &e) {
+        throw ParsingException(e.what());
+    }
+    const auto cols = parseMetadata(j, tinshiftFile.get());
+    const int sourceXCol = cols.sourceXCol;
+    const int sourceYCol = cols.sourceYCol;
+    const int sourceZCol = cols.sourceZCol;
+    const int targetXCol = cols.targetXCol;
+    const int targetYCol = cols.targetYCol;
+    const int targetZCol = cols.targetZCol;
+    const int offsetZCol = cols.offsetZCol;
+    const int idxVertex1Col = cols.idxVertex1Col;
+    const int idxVertex2Col = cols.idxVertex2Col;
+    const int idxVertex3Col = cols.idxVertex3Col;
+
+    const auto jVertices = getArrayMember(j, "vertices");
+    if (jVertices.size() > std::numeric_limits<unsigned>::max() /
+                               tinshiftFile->mVerticesColumnCount) {
+        throw ParsingException("Too many vertices");
+    }
+    auto &vertices = tinshiftFile->mVerticesStorage;
+    vertices.reserve(tinshiftFile->mVerticesColumnCount * jVertices.size());
     for (const auto &jVertex : jVertices) {
         if (!jVertex.is_array()) {
             throw ParsingException("vertices[] item is not an array");
         }
-        if (jVertex.size() != jVerticesColumns.size()) {
+        if (jVertex.size() != cols.verticesColumnCount) {
             throw ParsingException(
                 "vertices[] item has not expected number of elements");
         }
         if (!jVertex[sourceXCol].is_number()) {
             throw ParsingException("vertices[][] item is not a number");
         }
-        tinshiftFile->mVertices.push_back(jVertex[sourceXCol].get<double>());
+        vertices.push_back(jVertex[sourceXCol].get<double>());
         if (!jVertex[sourceYCol].is_number()) {
             throw ParsingException("vertices[][] item is not a number");
         }
-        tinshiftFile->mVertices.push_back(jVertex[sourceYCol].get<double>());
+        vertices.push_back(jVertex[sourceYCol].get<double>());
         if (tinshiftFile->mTransformHorizontalComponent) {
             if (!jVertex[targetXCol].is_number()) {
                 throw ParsingException("vertices[][] item is not a number");
             }
-            tinshiftFile->mVertices.push_back(
-                jVertex[targetXCol].get<double>());
+            vertices.push_back(jVertex[targetXCol].get<double>());
             if (!jVertex[targetYCol].is_number()) {
                 throw ParsingException("vertices[][] item is not a number");
             }
-            tinshiftFile->mVertices.push_back(
-                jVertex[targetYCol].get<double>());
+            vertices.push_back(jVertex[targetYCol].get<double>());
         }
         if (tinshiftFile->mTransformVerticalComponent) {
             if (offsetZCol >= 0) {
                 if (!jVertex[offsetZCol].is_number()) {
                     throw ParsingException("vertices[][] item is not a number");
                 }
-                tinshiftFile->mVertices.push_back(
-                    jVertex[offsetZCol].get<double>());
+                vertices.push_back(jVertex[offsetZCol].get<double>());
             } else {
                 if (!jVertex[sourceZCol].is_number()) {
                     throw ParsingException("vertices[][] item is not a number");
@@ -309,18 +351,19 @@ std::unique_ptr<TINShiftFile> TINShiftFile::parse(const std::string &text) {
                     throw ParsingException("vertices[][] item is not a number");
                 }
                 const double targetZ = jVertex[targetZCol].get<double>();
-                tinshiftFile->mVertices.push_back(targetZ - sourceZ);
+                vertices.push_back(targetZ - sourceZ);
             }
         }
     }
 
     const auto jTriangles = getArrayMember(j, "triangles");
-    tinshiftFile->mTriangles.reserve(jTriangles.size());
+    auto &triangles = tinshiftFile->mTrianglesStorage;
+    triangles.reserve(jTriangles.size());
     for (const auto &jTriangle : jTriangles) {
         if (!jTriangle.is_array()) {
             throw ParsingException("triangles[] item is not an array");
         }
-        if (jTriangle.size() != jTrianglesColumns.size()) {
+        if (jTriangle.size() != cols.trianglesColumnCount) {
             throw ParsingException(
                 "triangles[] item has not expected number of elements");
         }
@@ -353,7 +396,264 @@ std::unique_ptr<TINShiftFile> TINShiftFile::parse(const std::string &text) {
         vi.idx1 = vertex1;
         vi.idx2 = vertex2;
         vi.idx3 = vertex3;
-        tinshiftFile->mTriangles.push_back(vi);
+        triangles.push_back(vi);
+    }
+
+    tinshiftFile->mVertexCount = jVertices.size();
+    tinshiftFile->mVertices = vertices.data();
+    tinshiftFile->mTriangleCount = triangles.size();
+    tinshiftFile->mTriangles = triangles.data();
+
+    return tinshiftFile;
+}
+
+// ---------------------------------------------------------------------------
+
+// Binary format. All values are little-endian. Arrays start at offsets that
+// are a multiple of the size of their elements.
+//
+// Offset  Size  Content
+// 0       8     Signature "TINSHIFT"
+// 8       4     uint32: format version (1)
+// 12      4     uint32: number of values per vertex
+// 16      8     uint64: offset of metadata
+// 24      8     uint64: size of metadata
+// 32      8     uint64: number of vertices
+// 40      8     uint64: offset of vertices (doubles)
+// 48      8     uint64: number of triangles
+// 56      8     uint64: offset of triangles (3 uint32 per triangle)
+// 64      64    spatial index in source coordinates
+// 128     64    spatial index in target coordinates
+//
+// Metadata is a JSON object with the same content as a JSON file, except
+// the "vertices" and "triangles" members. Its "vertices_columns" and
+// "triangles_columns" members must describe the layout of the binary
+// arrays, that is source_x, source_y, [target_x, target_y], [offset_z] and
+// idx_vertex1, idx_vertex2, idx_vertex3.
+//
+// Spatial index (see TINShiftFile::GridIndex):
+// Offset  Size  Content
+// 0       32    doubles: minx, miny, maxx, maxy
+// 32      4     uint32: ncols (0 if there is no index)
+// 36      4     uint32: nrows
+// 40      8     uint64: offset of cellStart (ncols * nrows + 1 uint32)
+// 48      8     uint64: offset of cellTriangles (uint32)
+// 56      8     uint64: number of values in cellTriangles
+
+static constexpr char BINARY_SIGNATURE[] = "TINSHIFT";
+static constexpr size_t BINARY_SIGNATURE_SIZE = sizeof(BINARY_SIGNATURE) - 1;
+static constexpr size_t BINARY_HEADER_SIZE = 192;
+static constexpr size_t BINARY_INDEX_HEADER_SIZE = 64;
+
+static bool IsLittleEndianHost() {
+    const unsigned one = 1;
+    unsigned char firstByte = 0;
+    std::memcpy(&firstByte, &one, 1);
+    return firstByte == 1;
+}
+
+static void CopyFromLittleEndian(void *dest, const unsigned char *src,
+                                 size_t eltSize, size_t count) {
+    std::memcpy(dest, src, eltSize * count);
+    if (!IsLittleEndianHost()) {
+        auto *data = static_cast<unsigned char *>(dest);
+        for (size_t i = 0; i < count; ++i, data += eltSize) {
+            std::reverse(data, data + eltSize);
+        }
+    }
+}
+
+template <class T> static T ReadLittleEndian(const unsigned char *src) {
+    T val;
+    CopyFromLittleEndian(&val, src, sizeof(T), 1);
+    return val;
+}
+
+// Check that count elements of size eltSize at offset fit in the data
+static const unsigned char *GetArray(const unsigned char *data, size_t size,
+                                     std::uint64_t offset, std::uint64_t count,
+                                     size_t eltSize, const char *what) {
+    if ((offset % eltSize) != 0) {
+        throw ParsingException(std::string("Misaligned ") + what);
+    }
+    if (offset > size || count > (size - offset) / eltSize) {
+        throw ParsingException(std::string("Truncated ") + what);
+    }
+    return data + offset;
+}
+
+// ---------------------------------------------------------------------------
+
+bool TINShiftFile::isBinary(const unsigned char *data, size_t size) {
+    return size >= BINARY_SIGNATURE_SIZE &&
+           std::memcmp(data, BINARY_SIGNATURE, BINARY_SIGNATURE_SIZE) == 0;
+}
+
+// ---------------------------------------------------------------------------
+
+std::unique_ptr<TINShiftFile>
+TINShiftFile::parseBinary(const unsigned char *data, size_t size,
+                          const std::shared_ptr<const void> &owner) {
+    static_assert(sizeof(unsigned) == sizeof(std::uint32_t),
+                  "unsigned should be 32 bit");
+    static_assert(sizeof(VertexIndices) == 3 * sizeof(std::uint32_t),
+                  "VertexIndices should be 3 packed uint32");
+
+    if (!isBinary(data, size) || size < BINARY_HEADER_SIZE) {
+        throw ParsingException("Not a binary triangulation file");
+    }
+    const auto formatVersion = ReadLittleEndian<std::uint32_t>(data + 8);
+    if (formatVersion != 1) {
+        throw ParsingException("Unsupported binary format version " +
+                               std::to_string(formatVersion));
+    }
+
+    std::unique_ptr<TINShiftFile> tinshiftFile(new TINShiftFile());
+    tinshiftFile->mOwner = owner;
+
+    const auto metadataOffset = ReadLittleEndian<std::uint64_t>(data + 16);
+    const auto metadataSize = ReadLittleEndian<std::uint64_t>(data + 24);
+    const auto metadata = reinterpret_cast<const char *>(
+        GetArray(data, size, metadataOffset, metadataSize, 1, "metadata"));
+    json j;
+    try {
+        j = json::parse(metadata, metadata + metadataSize);
+    } catch (const std::exception &e) {
+        throw ParsingException(e.what());
+    }
+    const auto cols = parseMetadata(j, tinshiftFile.get());
+    const unsigned colCount = tinshiftFile->mVerticesColumnCount;
+    if (ReadLittleEndian<std::uint32_t>(data + 12) != colCount ||
+        cols.verticesColumnCount != colCount || cols.sourceXCol != 0 ||
+        cols.sourceYCol != 1 ||
+        (tinshiftFile->mTransformHorizontalComponent &&
+         (cols.targetXCol != 2 || cols.targetYCol != 3)) ||
+        (tinshiftFile->mTransformVerticalComponent &&
+         cols.offsetZCol != static_cast<int>(colCount) - 1)) {
+        throw ParsingException(
+            "vertices_columns[] inconsistent with binary layout");
+    }
+    if (cols.trianglesColumnCount != 3 || cols.idxVertex1Col != 0 ||
+        cols.idxVertex2Col != 1 || cols.idxVertex3Col != 2) {
+        throw ParsingException(
+            "triangles_columns[] inconsistent with binary layout");
+    }
+
+    // Arrays are used in place if the host byte order and the alignment of
+    // data allow it, and copied otherwise.
+    const bool inPlace =
+        IsLittleEndianHost() &&
+        (reinterpret_cast<std::uintptr_t>(data) % sizeof(double)) == 0;
+
+    const auto vertexCount = ReadLittleEndian<std::uint64_t>(data + 32);
+    if (vertexCount > std::numeric_limits<unsigned>::max() / colCount) {
+        throw ParsingException("Too many vertices");
+    }
+    const auto vertices =
+        GetArray(data, size, ReadLittleEndian<std::uint64_t>(data + 40),
+                 vertexCount * colCount, sizeof(double), "vertices");
+    tinshiftFile->mVertexCount = static_cast<size_t>(vertexCount);
+    if (inPlace) {
+        tinshiftFile->mVertices = reinterpret_cast<const double *>(vertices);
+    } else {
+        auto &storage = tinshiftFile->mVerticesStorage;
+        storage.resize(static_cast<size_t>(vertexCount * colCount));
+        CopyFromLittleEndian(storage.data(), vertices, sizeof(double),
+                             storage.size());
+        tinshiftFile->mVertices = storage.data();
+    }
+
+    const auto triangleCount = ReadLittleEndian<std::uint64_t>(data + 48);
+    if (triangleCount > std::numeric_limits<unsigned>::max()) {
+        throw ParsingException("Too many triangles");
+    }
+    const auto triangles =
+        GetArray(data, size, ReadLittleEndian<std::uint64_t>(data + 56),
+                 triangleCount * 3, sizeof(unsigned), "triangles");
+    tinshiftFile->mTriangleCount = static_cast<size_t>(triangleCount);
+    if (inPlace) {
+        tinshiftFile->mTriangles =
+            reinterpret_cast<const VertexIndices *>(triangles);
+    } else {
+        auto &storage = tinshiftFile->mTrianglesStorage;
+        storage.resize(static_cast<size_t>(triangleCount));
+        CopyFromLittleEndian(storage.data(), triangles, sizeof(unsigned),
+                             3 * storage.size());
+        tinshiftFile->mTriangles = storage.data();
+    }
+    for (size_t i = 0; i < tinshiftFile->mTriangleCount; ++i) {
+        const auto &triangle = tinshiftFile->mTriangles[i];
+        if (triangle.idx1 >= vertexCount || triangle.idx2 >= vertexCount ||
+            triangle.idx3 >= vertexCount) {
+            throw ParsingException("Invalid value for a vertex index");
+        }
+    }
+
+    for (int iIndex = 0; iIndex < 2; ++iIndex) {
+        const unsigned char *header =
+            data + BINARY_HEADER_SIZE - (2 - iIndex) * BINARY_INDEX_HEADER_SIZE;
+        auto &gridIndex = iIndex == 0 ? tinshiftFile->mForwardIndex
+                                      : tinshiftFile->mInverseIndex;
+        const auto ncols = ReadLittleEndian<std::uint32_t>(header + 32);
+        if (ncols == 0) {
+            continue;
+        }
+        gridIndex.minx = ReadLittleEndian<double>(header);
+        gridIndex.miny = ReadLittleEndian<double>(header + 8);
+        gridIndex.maxx = ReadLittleEndian<double>(header + 16);
+        gridIndex.maxy = ReadLittleEndian<double>(header + 24);
+        const auto nrows = ReadLittleEndian<std::uint32_t>(header + 36);
+        if (!(gridIndex.minx <= gridIndex.maxx) ||
+            !(gridIndex.miny <= gridIndex.maxy) ||
+            !std::isfinite(gridIndex.minx) || !std::isfinite(gridIndex.maxx) ||
+            !std::isfinite(gridIndex.miny) || !std::isfinite(gridIndex.maxy) ||
+            nrows == 0) {
+            throw ParsingException("Invalid spatial index");
+        }
+        const std::uint64_t cellCount =
+            static_cast<std::uint64_t>(ncols) * nrows;
+        const auto cellStart =
+            GetArray(data, size, ReadLittleEndian<std::uint64_t>(header + 40),
+                     cellCount + 1, sizeof(unsigned), "spatial index");
+        const auto cellTrianglesCount =
+            ReadLittleEndian<std::uint64_t>(header + 56);
+        const auto cellTriangles = GetArray(
+            data, size, ReadLittleEndian<std::uint64_t>(header + 48),
+            cellTrianglesCount, sizeof(unsigned), "spatial index");
+        gridIndex.ncols = ncols;
+        gridIndex.nrows = nrows;
+        if (inPlace) {
+            gridIndex.cellStart = reinterpret_cast<const unsigned *>(cellStart);
+            gridIndex.cellTriangles =
+                reinterpret_cast<const unsigned *>(cellTriangles);
+        } else {
+            auto &storage = iIndex == 0 ? tinshiftFile->mForwardIndexStorage
+                                        : tinshiftFile->mInverseIndexStorage;
+            storage.resize(static_cast<size_t>(cellCount + 1) +
+                           static_cast<size_t>(cellTrianglesCount));
+            CopyFromLittleEndian(storage.data(), cellStart, sizeof(unsigned),
+                                 static_cast<size_t>(cellCount + 1));
+            CopyFromLittleEndian(storage.data() + cellCount + 1,
+                                 cellTriangles, sizeof(unsigned),
+                                 static_cast<size_t>(cellTrianglesCount));
+            gridIndex.cellStart = storage.data();
+            gridIndex.cellTriangles = storage.data() + cellCount + 1;
+        }
+
+        if (gridIndex.cellStart[0] != 0 ||
+            gridIndex.cellStart[cellCount] != cellTrianglesCount) {
+            throw ParsingException("Invalid spatial index");
+        }
+        for (size_t i = 0; i < cellCount; ++i) {
+            if (gridIndex.cellStart[i] > gridIndex.cellStart[i + 1]) {
+                throw ParsingException("Invalid spatial index");
+            }
+        }
+        for (size_t i = 0; i < cellTrianglesCount; ++i) {
+            if (gridIndex.cellTriangles[i] >= triangleCount) {
+                throw ParsingException("Invalid spatial index");
+            }
+        }
     }
 
     return tinshiftFile;
@@ -368,11 +668,12 @@ static NS_PROJ::QuadTree::RectObj GetBounds(const TINShiftFile &file,
     rect.miny = std::numeric_limits<double>::max();
     rect.maxx = -std::numeric_limits<double>::max();
     rect.maxy = -std::numeric_limits<double>::max();
-    const auto &vertices = file.vertices();
+    const double *vertices = file.vertices();
     const unsigned colCount = file.verticesColumnCount();
     const int idxX = file.transformHorizontalComponent() && !forward ? 2 : 0;
     const int idxY = file.transformHorizontalComponent() && !forward ? 3 : 1;
-    for (size_t i = 0; i + colCount - 1 < vertices.size(); i += colCount) {
+    const size_t valueCount = file.vertexCount() * colCount;
+    for (size_t i = 0; i < valueCount; i += colCount) {
         const double x = vertices[i + idxX];
         const double y = vertices[i + idxY];
         rect.minx = std::min(rect.minx, x);
@@ -389,12 +690,12 @@ static std::unique_ptr<NS_PROJ::QuadTree::QuadTree<unsigned>>
 BuildQuadTree(const TINShiftFile &file, bool forward) {
     auto quadtree = std::unique_ptr<NS_PROJ::QuadTree::QuadTree<unsigned>>(
         new NS_PROJ::QuadTree::QuadTree<unsigned>(GetBounds(file, forward)));
-    const auto &triangles = file.triangles();
-    const auto &vertices = file.vertices();
+    const auto *triangles = file.triangles();
+    const double *vertices = file.vertices();
     const int idxX = file.transformHorizontalComponent() && !forward ? 2 : 0;
     const int idxY = file.transformHorizontalComponent() && !forward ? 3 : 1;
     const unsigned colCount = file.verticesColumnCount();
-    for (size_t i = 0; i < triangles.size(); ++i) {
+    for (size_t i = 0; i < file.triangleCount(); ++i) {
         const unsigned i1 = triangles[i].idx1;
         const unsigned i2 = triangles[i].idx2;
         const unsigned i3 = triangles[i].idx3;
@@ -425,6 +726,59 @@ BuildQuadTree(const TINShiftFile &file, bool forward) {
 
 // ---------------------------------------------------------------------------
 
+constexpr unsigned NO_TRIANGLE = std::numeric_limits<unsigned>::max();
+
+// Return, for each triangle, the index of the triangles that share the edges
+// opposite to its first, second and third vertex.
+static std::vector<unsigned> BuildNeighbors(const TINShiftFile &file) {
+    const auto *triangles = file.triangles();
+    const size_t triangleCount = file.triangleCount();
+
+    // Sort edges by their vertices, so that the two triangles sharing an
+    // edge are next to each other.
+    struct Edge {
+        std::uint64_t vertices;
+        // 3 * triangle index + index of the opposite vertex
+        size_t triangleEdge;
+    };
+    std::vector<Edge> edges;
+    edges.reserve(3 * triangleCount);
+    const auto addEdge = [&edges](unsigned v1, unsigned v2,
+                                  size_t triangleEdge) {
+        Edge edge;
+        edge.vertices = (static_cast<std::uint64_t>(std::min(v1, v2)) << 32) |
+                        std::max(v1, v2);
+        edge.triangleEdge = triangleEdge;
+        edges.push_back(edge);
+    };
+    for (size_t i = 0; i < triangleCount; ++i) {
+        addEdge(triangles[i].idx2, triangles[i].idx3, 3 * i);
+        addEdge(triangles[i].idx1, triangles[i].idx3, 3 * i + 1);
+        addEdge(triangles[i].idx1, triangles[i].idx2, 3 * i + 2);
+    }
+    std::sort(edges.begin(), edges.end(), [](const Edge &a, const Edge &b) {
+        return a.vertices < b.vertices;
+    });
+
+    std::vector<unsigned> neighbors(3 * triangleCount, NO_TRIANGLE);
+    for (size_t i = 0; i < edges.size();) {
+        size_t j = i + 1;
+        while (j < edges.size() && edges[j].vertices == edges[i].vertices)
+            ++j;
+        // Edges shared by more than 2 triangles are ignored
+        if (j == i + 2) {
+            neighbors[edges[i].triangleEdge] =
+                static_cast<unsigned>(edges[i + 1].triangleEdge / 3);
+            neighbors[edges[i + 1].triangleEdge] =
+                static_cast<unsigned>(edges[i].triangleEdge / 3);
+        }
+        i = j;
+    }
+    return neighbors;
+}
+
+// ---------------------------------------------------------------------------
+
 Evaluator::Evaluator(std::unique_ptr<TINShiftFile> &&fileIn)
     : mFile(std::move(fileIn)) {}
 
@@ -452,59 +806,242 @@ static double distance_point_segment(double x, double y, double x1, double y1,
     return squared_distance(x, y, x1 + t * (x2 - x1), y1 + t * (y2 - y1));
 }
 
-static const TINShiftFile::VertexIndices *
-FindTriangle(const TINShiftFile &file,
-             const NS_PROJ::QuadTree::QuadTree<unsigned> &quadtree,
-             std::vector<unsigned> &triangleIndices, double x, double y,
-             bool forward, double &lambda1, double &lambda2, double &lambda3) {
-#define USE_QUADTREE
-#ifdef USE_QUADTREE
-    triangleIndices.clear();
-    quadtree.search(x, y, triangleIndices);
-#endif
-    const auto &triangles = file.triangles();
-    const auto &vertices = file.vertices();
+// Return the index of the cell of the grid index that contains v
+static bool GetCellIndex(double v, double vmin, double vmax, unsigned n,
+                         unsigned &idx) {
+    if (!(v >= vmin && v <= vmax)) {
+        return false;
+    }
+    idx = vmax > vmin ? static_cast<unsigned>((v - vmin) / (vmax - vmin) * n)
+                      : 0;
+    if (idx >= n) {
+        idx = n - 1;
+    }
+    return true;
+}
+
+// Call visitor with the triangles of the cells of gridIndex, by rings of
+// cells of increasing distance to (x, y), until all cells of a ring are
+// farther than the squared distance returned by visitor.
+template <class Visitor>
+static void SearchNearestInGridIndex(const TINShiftFile::GridIndex &gridIndex,
+                                     double x, double y, Visitor &&visitor) {
+    const unsigned ncols = gridIndex.ncols;
+    const unsigned nrows = gridIndex.nrows;
+    const double cellWidth = (gridIndex.maxx - gridIndex.minx) / ncols;
+    const double cellHeight = (gridIndex.maxy - gridIndex.miny) / nrows;
+    // Margin to account for rounding errors in the computation of the
+    // bounds of cells, that must not be overestimated.
+    const double marginX = 1e-10 * (cellWidth + std::fabs(gridIndex.minx));
+    const double marginY = 1e-10 * (cellHeight + std::fabs(gridIndex.miny));
+
+    // Cell closest to (x, y)
+    unsigned col0 = 0;
+    unsigned row0 = 0;
+    GetCellIndex(std::max(gridIndex.minx, std::min(gridIndex.maxx, x)),
+                 gridIndex.minx, gridIndex.maxx, ncols, col0);
+    GetCellIndex(std::max(gridIndex.miny, std::min(gridIndex.maxy, y)),
+                 gridIndex.miny, gridIndex.maxy, nrows, row0);
+
+    double maxDist2 = std::numeric_limits<double>::infinity();
+    const auto visitCell = [&](long long col, long long row) {
+        if (col < 0 || row < 0 || col >= ncols || row >= nrows)
+            return false;
+        NS_PROJ::QuadTree::RectObj rect;
+        rect.minx = gridIndex.minx + col * cellWidth - marginX;
+        rect.maxx = gridIndex.minx + (col + 1) * cellWidth + marginX;
+        rect.miny = gridIndex.miny + row * cellHeight - marginY;
+        rect.maxy = gridIndex.miny + (row + 1) * cellHeight + marginY;
+        if (rect.squaredDistanceTo(x, y) > maxDist2)
+            return false;
+        const size_t cell = static_cast<size_t>(row) * ncols + col;
+        for (unsigned k = gridIndex.cellStart[cell];
+             k < gridIndex.cellStart[cell + 1]; ++k) {
+            maxDist2 = visitor(gridIndex.cellTriangles[k]);
+        }
+        return true;
+    };
+
+    // The minimum distance of the cells of a ring to (x, y) increases with
+    // the ring number, so we can stop at the first ring where no cell is
+    // visited.
+    const long long maxCol = static_cast<long long>(ncols) - 1;
+    const long long maxRow = static_cast<long long>(nrows) - 1;
+    const long long maxRing = std::max(ncols, nrows);
+    for (long long ring = 0; ring < maxRing; ++ring) {
+        bool cellVisited = false;
+        const long long rowMin = static_cast<long long>(row0) - ring;
+        const long long rowMax = static_cast<long long>(row0) + ring;
+        const long long colMin = static_cast<long long>(col0) - ring;
+        const long long colMax = static_cast<long long>(col0) + ring;
+        const long long colStart = std::max(colMin, 0LL);
+        const long long colEnd = std::min(colMax, maxCol);
+        for (long long col = colStart; col <= colEnd; ++col) {
+            if (visitCell(col, rowMin))
+                cellVisited = true;
+            if (ring > 0 && visitCell(col, rowMax))
+                cellVisited = true;
+        }
+        const long long rowStart = std::max(rowMin + 1, 0LL);
+        const long long rowEnd = std::min(rowMax - 1, maxRow);
+        for (long long row = rowStart; row <= rowEnd; ++row) {
+            if (visitCell(colMin, row))
+                cellVisited = true;
+            if (visitCell(colMax, row))
+                cellVisited = true;
+        }
+        if (!cellVisited)
+            break;
+    }
+}
+
+// Compute the barycentric coordinates of (x, y) in triangle, and return
+// whether (x, y) is inside it.
+static bool IsInTriangle(const TINShiftFile &file,
+                         const TINShiftFile::VertexIndices &triangle, double x,
+                         double y, bool forward, double &lambda1,
+                         double &lambda2, double &lambda3) {
+    const double *vertices = file.vertices();
     constexpr double EPS = 1e-10;
     const int idxX = file.transformHorizontalComponent() && !forward ? 2 : 0;
     const int idxY = file.transformHorizontalComponent() && !forward ? 3 : 1;
     const unsigned colCount = file.verticesColumnCount();
-#ifdef USE_QUADTREE
-    for (unsigned i : triangleIndices)
-#else
-    for (size_t i = 0; i < triangles.size(); ++i)
-#endif
-    {
-        const auto &triangle = triangles[i];
-        const unsigned i1 = triangle.idx1;
-        const unsigned i2 = triangle.idx2;
-        const unsigned i3 = triangle.idx3;
-        const double x1 = vertices[i1 * colCount + idxX];
-        const double y1 = vertices[i1 * colCount + idxY];
-        const double x2 = vertices[i2 * colCount + idxX];
-        const double y2 = vertices[i2 * colCount + idxY];
-        const double x3 = vertices[i3 * colCount + idxX];
-        const double y3 = vertices[i3 * colCount + idxY];
-        const double det_T = (y2 - y3) * (x1 - x3) + (x3 - x2) * (y1 - y3);
-        lambda1 = ((y2 - y3) * (x - x3) + (x3 - x2) * (y - y3)) / det_T;
-        lambda2 = ((y3 - y1) * (x - x3) + (x1 - x3) * (y - y3)) / det_T;
-        if (lambda1 >= -EPS && lambda1 <= 1 + EPS && lambda2 >= -EPS &&
-            lambda2 <= 1 + EPS) {
-            lambda3 = 1 - lambda1 - lambda2;
-            if (lambda3 >= 0) {
-                return &triangle;
-            }
+    const unsigned i1 = triangle.idx1;
+    const unsigned i2 = triangle.idx2;
+    const unsigned i3 = triangle.idx3;
+    const double x1 = vertices[i1 * colCount + idxX];
+    const double y1 = vertices[i1 * colCount + idxY];
+    const double x2 = vertices[i2 * colCount + idxX];
+    const double y2 = vertices[i2 * colCount + idxY];
+    const double x3 = vertices[i3 * colCount + idxX];
+    const double y3 = vertices[i3 * colCount + idxY];
+    const double det_T = (y2 - y3) * (x1 - x3) + (x3 - x2) * (y1 - y3);
+    lambda1 = ((y2 - y3) * (x - x3) + (x3 - x2) * (y - y3)) / det_T;
+    lambda2 = ((y3 - y1) * (x - x3) + (x1 - x3) * (y - y3)) / det_T;
+    lambda3 = 1 - lambda1 - lambda2;
+    return lambda1 >= -EPS && lambda1 <= 1 + EPS && lambda2 >= -EPS &&
+           lambda2 <= 1 + EPS && lambda3 >= 0;
+}
+
+// Maximum number of moves to a neighboring triangle done by WalkToTriangle()
+constexpr int MAX_WALK_STEPS = 8;
+
+// Starting from triangle idx, walk through neighboring triangles towards
+// (x, y), and return whether a triangle containing it is found in a few
+// steps. Points that are consecutive in the input are often in the same or
+// in a close triangle, which makes this faster than a spatial index lookup.
+static bool WalkToTriangle(const TINShiftFile &file,
+                           const std::vector<unsigned> &neighbors,
+                           unsigned &idx, double x, double y, bool forward,
+                           double &lambda1, double &lambda2, double &lambda3) {
+    const auto *triangles = file.triangles();
+    for (int step = 0;; ++step) {
+        if (IsInTriangle(file, triangles[idx], x, y, forward, lambda1,
+                         lambda2, lambda3)) {
+            return true;
+        }
+        if (step == MAX_WALK_STEPS || neighbors.empty()) {
+            return false;
+        }
+        // Cross the edge opposite to the vertex with the lowest barycentric
+        // coordinate, that is the edge (x, y) is beyond.
+        int edge = 0;
+        double minLambda = lambda1;
+        if (lambda2 < minLambda) {
+            edge = 1;
+            minLambda = lambda2;
+        }
+        if (lambda3 < minLambda) {
+            edge = 2;
+            minLambda = lambda3;
+        }
+        // minLambda may be NaN for degenerate triangles
+        if (!(minLambda < 0)) {
+            return false;
+        }
+        const unsigned next = neighbors[3 * static_cast<size_t>(idx) + edge];
+        if (next == NO_TRIANGLE) {
+            return false;
+        }
+        idx = next;
+    }
+}
+
+// Maximum number of searches that skip WalkToTriangle() after it failed
+// several times in a row, which happens when points are not spatially
+// ordered.
+constexpr unsigned MAX_WALK_SKIP = 64;
+
+// Find the triangle that contains (x, y), by walking from the last triangle
+// found if possible, and otherwise using gridIndex if it is available, or
+// quadtree.
+static const TINShiftFile::VertexIndices *
+FindTriangle(const TINShiftFile &file, const TINShiftFile::GridIndex &gridIndex,
+             const NS_PROJ::QuadTree::QuadTree<unsigned> *quadtree,
+             const std::vector<unsigned> &neighbors, TriangleWalkState &walk,
+             std::vector<unsigned> &triangleIndices, double x, double y,
+             bool forward, double &lambda1, double &lambda2, double &lambda3) {
+    const auto *triangles = file.triangles();
+    if (walk.skip > 0) {
+        --walk.skip;
+    } else if (walk.lastTriangle != NO_TRIANGLE) {
+        unsigned idx = walk.lastTriangle;
+        if (WalkToTriangle(file, neighbors, idx, x, y, forward, lambda1,
+                           lambda2, lambda3)) {
+            walk.lastTriangle = idx;
+            walk.failures = 0;
+            return &triangles[idx];
+        }
+        // Back off exponentially if walking keeps failing
+        walk.skip =
+            std::min(MAX_WALK_SKIP, (1U << std::min(walk.failures, 6U)) - 1);
+        ++walk.failures;
+    }
+
+    const unsigned *candidates = nullptr;
+    size_t candidateCount = 0;
+    if (quadtree) {
+        triangleIndices.clear();
+        quadtree->search(x, y, triangleIndices);
+        candidates = triangleIndices.data();
+        candidateCount = triangleIndices.size();
+    } else {
+        unsigned col = 0;
+        unsigned row = 0;
+        if (GetCellIndex(x, gridIndex.minx, gridIndex.maxx, gridIndex.ncols,
+                         col) &&
+            GetCellIndex(y, gridIndex.miny, gridIndex.maxy, gridIndex.nrows,
+                         row)) {
+            const size_t cell = static_cast<size_t>(row) * gridIndex.ncols + col;
+            candidates = gridIndex.cellTriangles + gridIndex.cellStart[cell];
+            candidateCount =
+                gridIndex.cellStart[cell + 1] - gridIndex.cellStart[cell];
+        }
+    }
+    for (size_t iCandidate = 0; iCandidate < candidateCount; ++iCandidate) {
+        const unsigned idx = candidates[iCandidate];
+        if (IsInTriangle(file, triangles[idx], x, y, forward, lambda1, lambda2,
+                         lambda3)) {
+            walk.lastTriangle = idx;
+            return &triangles[idx];
         }
     }
     if (file.fallbackStrategy() == FALLBACK_NONE) {
         return nullptr;
     }
     // find triangle with the shortest squared distance
-    //
-    // TODO: extend quadtree to support nearest neighbor search
-    double closest_dist = std::numeric_limits<double>::infinity();
+    const double *vertices = file.vertices();
+    constexpr double EPS = 1e-10;
+    const int idxX = file.transformHorizontalComponent() && !forward ? 2 : 0;
+    const int idxY = file.transformHorizontalComponent() && !forward ? 3 : 1;
+    const unsigned colCount = file.verticesColumnCount();
     double closest_dist2 = std::numeric_limits<double>::infinity();
     size_t closest_i = 0;
-    for (size_t i = 0; i < triangles.size(); ++i) {
+    // Update the closest triangle with triangle i, and return the squared
+    // distance to the closest triangle. On ties, the triangle of lowest index
+    // is selected, so that the result does not depend on the order in which
+    // triangles are visited.
+    const auto visitTriangle = [&](unsigned i) {
         const auto &triangle = triangles[i];
         const unsigned i1 = triangle.idx1;
         const unsigned i2 = triangle.idx2;
@@ -516,57 +1053,42 @@ FindTriangle(const TINShiftFile &file,
         const double x3 = vertices[i3 * colCount + idxX];
         const double y3 = vertices[i3 * colCount + idxY];
 
-        // don't check this triangle if the query point plusminus the
-        // currently closest found distance is outside the triangle's AABB
-        if (x + closest_dist < std::min(x1, std::min(x2, x3)) ||
-            x - closest_dist > std::max(x1, std::max(x2, x3)) ||
-            y + closest_dist < std::min(y1, std::min(y2, y3)) ||
-            y - closest_dist > std::max(y1, std::max(y2, y3))) {
-            continue;
-        }
-
         double dist12 = squared_distance(x1, y1, x2, y2);
         double dist23 = squared_distance(x2, y2, x3, y3);
         double dist13 = squared_distance(x1, y1, x3, y3);
         if (dist12 < EPS || dist23 < EPS || dist13 < EPS) {
             // do not use degenerate triangles
-            continue;
+            return closest_dist2;
         }
         double dist2;
         if (file.fallbackStrategy() == FALLBACK_NEAREST_SIDE) {
             // we don't know whether the points of the triangle are given
             // clockwise or counter-clockwise, so we have to check the distance
             // of the point to all three sides of the triangle
-            dist2 = distance_point_segment(x, y, x1, y1, x2, y2, dist12);
-            if (dist2 < closest_dist2) {
-                closest_dist2 = dist2;
-                closest_dist = sqrt(dist2);
-                closest_i = i;
-            }
-            dist2 = distance_point_segment(x, y, x2, y2, x3, y3, dist23);
-            if (dist2 < closest_dist2) {
-                closest_dist2 = dist2;
-                closest_dist = sqrt(dist2);
-                closest_i = i;
-            }
-            dist2 = distance_point_segment(x, y, x1, y1, x3, y3, dist13);
-            if (dist2 < closest_dist2) {
-                closest_dist2 = dist2;
-                closest_dist = sqrt(dist2);
-                closest_i = i;
-            }
-        } else if (file.fallbackStrategy() == FALLBACK_NEAREST_CENTROID) {
+            dist2 = std::min(
+                distance_point_segment(x, y, x1, y1, x2, y2, dist12),
+                std::min(distance_point_segment(x, y, x2, y2, x3, y3, dist23),
+                         distance_point_segment(x, y, x1, y1, x3, y3, dist13)));
+        } else {
             double c_x = (x1 + x2 + x3) / 3.0;
             double c_y = (y1 + y2 + y3) / 3.0;
             dist2 = squared_distance(x, y, c_x, c_y);
-            if (dist2 < closest_dist2) {
-                closest_dist2 = dist2;
-                closest_dist = sqrt(dist2);
-                closest_i = i;
-            }
         }
+        if (dist2 < closest_dist2 || (dist2 == closest_dist2 && i < closest_i)) {
+            closest_dist2 = dist2;
+            closest_i = i;
+        }
+        return closest_dist2;
+    };
+    // The distance to a side or to the centroid of a triangle is not lower
+    // than the distance to its bounding box, so the spatial indices can be
+    // used to only visit the triangles that are near (x, y).
+    if (quadtree) {
+        quadtree->searchNearest(x, y, visitTriangle);
+    } else {
+        SearchNearestInGridIndex(gridIndex, x, y, visitTriangle);
     }
-    if (std::isinf(closest_dist)) {
+    if (std::isinf(closest_dist2)) {
         // nothing was found due to empty triangle list or only degenerate
         // triangles
         return nullptr;
@@ -596,18 +1118,23 @@ FindTriangle(const TINShiftFile &file,
 
 bool Evaluator::forward(double x, double y, double z, double &x_out,
                         double &y_out, double &z_out) {
-    if (!mQuadTreeForward)
+    const auto &gridIndex = mFile->gridIndex(true);
+    if (gridIndex.ncols == 0 && !mQuadTreeForward) {
         mQuadTreeForward = BuildQuadTree(*(mFile.get()), true);
+        if (mNeighbors.empty())
+            mNeighbors = BuildNeighbors(*(mFile.get()));
+    }
 
     double lambda1 = 0.0;
     double lambda2 = 0.0;
     double lambda3 = 0.0;
-    const auto *triangle =
-        FindTriangle(*mFile, *mQuadTreeForward, mTriangleIndices, x, y, true,
-                     lambda1, lambda2, lambda3);
+    const auto *triangle = FindTriangle(
+        *mFile, gridIndex, mQuadTreeForward.get(), mNeighbors,
+        mWalkForward, mTriangleIndices, x, y, true, lambda1, lambda2,
+        lambda3);
     if (!triangle)
         return false;
-    const auto &vertices = mFile->vertices();
+    const double *vertices = mFile->vertices();
     const unsigned i1 = triangle->idx1;
     const unsigned i2 = triangle->idx2;
     const unsigned i3 = triangle->idx3;
@@ -641,25 +1168,31 @@ bool Evaluator::forward(double x, double y, double z, double &x_out,
 bool Evaluator::inverse(double x, double y, double z, double &x_out,
                         double &y_out, double &z_out) {
     NS_PROJ::QuadTree::QuadTree<unsigned> *quadtree;
+    const TINShiftFile::GridIndex *gridIndex;
     if (!mFile->transformHorizontalComponent() &&
         mFile->transformVerticalComponent()) {
-        if (!mQuadTreeForward)
+        gridIndex = &(mFile->gridIndex(true));
+        if (gridIndex->ncols == 0 && !mQuadTreeForward)
             mQuadTreeForward = BuildQuadTree(*(mFile.get()), true);
         quadtree = mQuadTreeForward.get();
     } else {
-        if (!mQuadTreeInverse)
+        gridIndex = &(mFile->gridIndex(false));
+        if (gridIndex->ncols == 0 && !mQuadTreeInverse)
             mQuadTreeInverse = BuildQuadTree(*(mFile.get()), false);
         quadtree = mQuadTreeInverse.get();
     }
+    if (quadtree && mNeighbors.empty())
+        mNeighbors = BuildNeighbors(*(mFile.get()));
 
     double lambda1 = 0.0;
     double lambda2 = 0.0;
     double lambda3 = 0.0;
-    const auto *triangle = FindTriangle(*mFile, *quadtree, mTriangleIndices, x,
-                                        y, false, lambda1, lambda2, lambda3);
+    const auto *triangle = FindTriangle(
+        *mFile, *gridIndex, quadtree, mNeighbors, mWalkInverse,
+        mTriangleIndices, x, y, false, lambda1, lambda2, lambda3);
     if (!triangle)
         return false;
-    const auto &vertices = mFile->vertices();
+    const double *vertices = mFile->vertices();
     const unsigned i1 = triangle->idx1;
     const unsigned i2 = triangle->idx2;
     const unsigned i3 = triangle->idx3;
@@ -154,6 +154,80 @@ static void pj_vgridshift_reverse_4d(PJ_COORD &coo, PJ *P) {
     }
 }
 
+// Batched version of pj_vgridshift_forward_4d() and
+// pj_vgridshift_reverse_4d(): the grid values of all coordinates are read
+// at once, which allows each cell of the grids to be read only once.
+static void pj_vgridshift_apply_array(PJ_COORD *coo, size_t n, int *err,
+                                      PJ *P, PJ_DIRECTION direction) {
+    struct vgridshiftData *Q = (struct vgridshiftData *)P->opaque;
+    const auto apply4d = direction == PJ_FWD ? pj_vgridshift_forward_4d
+                                             : pj_vgridshift_reverse_4d;
+
+    if (Q->t_final != 0 && Q->t_epoch != 0) {
+        /* Time restricted: not worth batching */
+        for (size_t i = 0; i < n; ++i) {
+            if (coo[i].v[0] == HUGE_VAL)
+                continue;
+            proj_errno_reset(P);
+            apply4d(coo[i], P);
+            if (coo[i].v[0] == HUGE_VAL || proj_errno(P)) {
+                err[i] = proj_errno(P);
+                coo[i] = proj_coord_error();
+            }
+        }
+        return;
+    }
+
+    if (Q->defer_grid_opening) {
+        Q->defer_grid_opening = false;
+        Q->grids = pj_vgrid_init(P, "grids");
+        deal_with_vertcon_gtx_hack(P);
+        Q->error_code_in_defer_grid_opening = proj_errno(P);
+    }
+    if (Q->error_code_in_defer_grid_opening) {
+        for (size_t i = 0; i < n; ++i) {
+            if (coo[i].v[0] == HUGE_VAL)
+                continue;
+            err[i] = proj_errno_set(P, Q->error_code_in_defer_grid_opening);
+            coo[i] = proj_coord_error();
+        }
+        return;
+    }
+
+    if (Q->grids.empty()) {
+        /* Only try the gridshift if at least one grid is loaded,
+         * otherwise just pass the coordinates through unchanged. */
+        return;
+    }
+
+    std::vector<double> values(n);
+    std::vector<int> valueErr(n);
+    pj_vgrid_value_array(P, Q->grids, coo, n, Q->forward_multiplier,
+                         values.data(), valueErr.data());
+    for (size_t i = 0; i < n; ++i) {
+        if (coo[i].v[0] == HUGE_VAL)
+            continue;
+        if (valueErr[i]) {
+            err[i] = valueErr[i];
+            coo[i] = proj_coord_error();
+        } else if (direction == PJ_FWD) {
+            coo[i].xyz.z += values[i];
+        } else {
+            coo[i].xyz.z -= values[i];
+        }
+    }
+}
+
+static void pj_vgridshift_forward_4d_array(PJ_COORD *coo, size_t n, int *err,
+                                           PJ *P) {
+    pj_vgridshift_apply_array(coo, n, err, P, PJ_FWD);
+}
+
+static void pj_vgridshift_reverse_4d_array(PJ_COORD *coo, size_t n, int *err,
+                                           PJ *P) {
+    pj_vgridshift_apply_array(coo, n, err, P, PJ_INV);
+}
+
 static PJ *pj_vgridshift_destructor(PJ *P, int errlev) {
     if (nullptr == P)
         return nullptr;
@@ -239,6 +313,8 @@ PJ *PJ_TRANSFORMATION(vgridshift, 0) {
 
     P->fwd4d = pj_vgridshift_forward_4d;
     P->inv4d = pj_vgridshift_reverse_4d;
+    P->fwd4d_array = pj_vgridshift_forward_4d_array;
+    P->inv4d_array = pj_vgridshift_reverse_4d_array;
     P->fwd3d = pj_vgridshift_forward_3d;
     P->inv3d = pj_vgridshift_reverse_3d;
     P->fwd = nullptr;
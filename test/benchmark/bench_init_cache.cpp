@@ -0,0 +1,131 @@
+/******************************************************************************
+ * Project:  PROJ
+ * Purpose:  Benchmark of the creation of objects from +init= strings by
+ *           several threads
+ *
+ ******************************************************************************
+ * Copyright (c) 2026, PROJ contributors
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included
+ * in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+ * OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+ * THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE.
+ *****************************************************************************/
+
+#include "proj.h"
+
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <thread>
+#include <vector>
+
+static void usage() {
+    printf("Usage: bench_init_cache [(--threads|-j) number]\n");
+    printf("                        [(--loops|-l) number]\n");
+    printf("                        [init_key]*\n");
+    printf("\n");
+    printf("Measures the time to create objects from +init= strings, with "
+           "the legacy\n");
+    printf("PROJ.4 init rules, by several threads. Each thread uses its own "
+           "context.\n");
+    printf("\n");
+    printf("Default: bench_init_cache -j 4 -l 1000 epsg:4326 epsg:32631 "
+           "epsg:3857\n");
+    exit(1);
+}
+
+int main(int argc, char *argv[]) {
+    int threadCount = 4;
+    int loops = 1000;
+    std::vector<std::string> keys;
+    for (int i = 1; i < argc; ++i) {
+        if (strcmp(argv[i], "--threads") == 0 || strcmp(argv[i], "-j") == 0) {
+            if (i + 1 >= argc)
+                usage();
+            threadCount = atoi(argv[i + 1]);
+            ++i;
+        } else if (strcmp(argv[i], "--loops") == 0 ||
+                   strcmp(argv[i], "-l") == 0) {
+            if (i + 1 >= argc)
+                usage();
+            loops = atoi(argv[i + 1]);
+            ++i;
+        } else if (argv[i][0] == '-') {
+            usage();
+        } else {
+            keys.push_back(argv[i]);
+        }
+    }
+    if (threadCount <= 0 || loops <= 0)
+        usage();
+    if (keys.empty())
+        keys = {"epsg:4326", "epsg:32631", "epsg:3857"};
+
+    std::vector<std::string> definitions;
+    for (const auto &key : keys)
+        definitions.push_back("+init=" + key);
+
+    // Fill the cache, and check that the definitions are valid
+    PJ_CONTEXT *ctxt = proj_context_create();
+    proj_context_use_proj4_init_rules(ctxt, true);
+    for (const auto &definition : definitions) {
+        PJ *P = proj_create(ctxt, definition.c_str());
+        if (P == nullptr) {
+            fprintf(stderr, "Cannot create %s\n", definition.c_str());
+            proj_context_destroy(ctxt);
+            exit(1);
+        }
+        proj_destroy(P);
+    }
+    proj_context_destroy(ctxt);
+
+    std::atomic<int> failures{0};
+    const auto worker = [&definitions, &failures, loops]() {
+        PJ_CONTEXT *workerCtxt = proj_context_create();
+        proj_context_use_proj4_init_rules(workerCtxt, true);
+        for (int i = 0; i < loops; ++i) {
+            const auto &definition = definitions[i % definitions.size()];
+            PJ *P = proj_create(workerCtxt, definition.c_str());
+            if (P == nullptr)
+                ++failures;
+            proj_destroy(P);
+        }
+        proj_context_destroy(workerCtxt);
+    };
+
+    auto start = std::chrono::system_clock::now();
+    std::vector<std::thread> threads;
+    for (int i = 0; i < threadCount; ++i)
+        threads.emplace_back(worker);
+    for (auto &thread : threads)
+        thread.join();
+    auto end = std::chrono::system_clock::now();
+
+    const double totalMs =
+        std::chrono::duration<double, std::milli>(end - start).count();
+    const double count = static_cast<double>(threadCount) * loops;
+    printf("%d threads, %.0f objects: %.1f ms, %.0f objects/s\n", threadCount,
+           count, totalMs, count / totalMs * 1000);
+    if (failures) {
+        fprintf(stderr, "%d failures\n", failures.load());
+        return 1;
+    }
+    return 0;
+}
@@ -0,0 +1,204 @@
+/******************************************************************************
+ * Project:  PROJ
+ * Purpose:  Benchmark of small random reads in a remote file whose chunks
+ *           are in the in-memory cache
+ *
+ ******************************************************************************
+ * Copyright (c) 2026, PROJ contributors
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included
+ * in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+ * OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+ * THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE.
+ *****************************************************************************/
+
+#include "filemanager.hpp"
+#include "proj.h"
+
+#include <stdlib.h> // rand()
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <vector>
+
+// Size of the remote file. Small enough for all its chunks to stay in the
+// in-memory chunk cache once read.
+constexpr size_t FILE_SIZE = 512 * 1024;
+
+namespace {
+
+// In-memory "server" for the network callbacks
+struct RemoteFile {
+    std::vector<unsigned char> content{};
+    std::string contentRange{};
+    size_t requestCount = 0;
+};
+
+struct Handle {
+    RemoteFile *file;
+};
+
+} // namespace
+
+static size_t readRange(RemoteFile *file, unsigned long long offset,
+                        size_t size_to_read, void *buffer) {
+    if (offset >= file->content.size())
+        return 0;
+    ++file->requestCount;
+    const size_t size = std::min(
+        size_to_read, static_cast<size_t>(file->content.size() - offset));
+    memcpy(buffer, file->content.data() + offset, size);
+    return size;
+}
+
+static PROJ_NETWORK_HANDLE *
+open_cbk(PJ_CONTEXT *, const char *, unsigned long long offset,
+         size_t size_to_read, void *buffer, size_t *out_size_read, size_t,
+         char *, void *user_data) {
+    auto file = static_cast<RemoteFile *>(user_data);
+    *out_size_read = readRange(file, offset, size_to_read, buffer);
+    return reinterpret_cast<PROJ_NETWORK_HANDLE *>(new Handle{file});
+}
+
+static void close_cbk(PJ_CONTEXT *, PROJ_NETWORK_HANDLE *handle, void *) {
+    delete reinterpret_cast<Handle *>(handle);
+}
+
+static const char *get_header_value_cbk(PJ_CONTEXT *,
+                                        PROJ_NETWORK_HANDLE *handle,
+                                        const char *header_name, void *) {
+    if (strcmp(header_name, "Content-Range") == 0)
+        return reinterpret_cast<Handle *>(handle)->file->contentRange.c_str();
+    return nullptr;
+}
+
+static size_t read_range_cbk(PJ_CONTEXT *, PROJ_NETWORK_HANDLE *handle,
+                             unsigned long long offset, size_t size_to_read,
+                             void *buffer, size_t, char *, void *) {
+    return readRange(reinterpret_cast<Handle *>(handle)->file, offset,
+                     size_to_read, buffer);
+}
+
+static void usage() {
+    printf("Usage: bench_network_read [(--reads|-n) number]\n");
+    printf("                          [(--loops|-l) number]\n");
+    printf("\n");
+    printf("Measures the time of random reads of 2 to 16 bytes in a remote "
+           "file of %u KB,\n",
+           static_cast<unsigned>(FILE_SIZE / 1024));
+    printf("served by in-memory network callbacks, once all its chunks are "
+           "cached.\n");
+    exit(1);
+}
+
+int main(int argc, char *argv[]) {
+    int nReads = 1000 * 1000;
+    int loops = 5;
+    for (int i = 1; i < argc; ++i) {
+        if (strcmp(argv[i], "--reads") == 0 || strcmp(argv[i], "-n") == 0) {
+            if (i + 1 >= argc)
+                usage();
+            nReads = atoi(argv[i + 1]);
+            ++i;
+        } else if (strcmp(argv[i], "--loops") == 0 ||
+                   strcmp(argv[i], "-l") == 0) {
+            if (i + 1 >= argc)
+                usage();
+            loops = atoi(argv[i + 1]);
+            ++i;
+        } else {
+            usage();
+        }
+    }
+    if (nReads <= 0 || loops <= 0)
+        usage();
+
+    RemoteFile remoteFile;
+    remoteFile.content.resize(FILE_SIZE);
+    for (auto &c : remoteFile.content)
+        c = static_cast<unsigned char>(rand());
+    remoteFile.contentRange =
+        "bytes 0-" + std::to_string(FILE_SIZE - 1) + "/" +
+        std::to_string(FILE_SIZE);
+
+    PJ_CONTEXT *ctxt = proj_context_create();
+    // Only exercise the in-memory chunk cache
+    proj_grid_cache_set_enable(ctxt, false);
+    proj_context_set_network_callbacks(ctxt, open_cbk, close_cbk,
+                                       get_header_value_cbk, read_range_cbk,
+                                       &remoteFile);
+    if (!proj_context_set_enable_network(ctxt, true)) {
+        printf("Cannot enable network access\n");
+        proj_context_destroy(ctxt);
+        return 1;
+    }
+
+    auto file = NS_PROJ::FileManager::open(
+        ctxt, "https://example.com/bench_network_read.tif",
+        NS_PROJ::FileAccess::READ_ONLY);
+    if (!file) {
+        printf("Cannot open remote file\n");
+        proj_context_destroy(ctxt);
+        return 1;
+    }
+
+    // Read the whole file once, so that the benchmark only measures hits
+    std::vector<unsigned char> whole(FILE_SIZE);
+    file->seek(0);
+    file->read(whole.data(), whole.size());
+    const size_t requestsBefore = remoteFile.requestCount;
+
+    std::vector<unsigned long long> offsets(nReads);
+    std::vector<size_t> sizes(nReads);
+    for (int i = 0; i < nReads; ++i) {
+        sizes[i] = 2 + static_cast<size_t>(rand()) % 15;
+        offsets[i] = static_cast<unsigned long long>(rand()) %
+                     (FILE_SIZE - sizes[i] + 1);
+    }
+
+    bool ok = whole == remoteFile.content;
+    unsigned char buffer[16];
+    auto start = std::chrono::system_clock::now();
+    for (int iter = 0; iter < loops; ++iter) {
+        for (int i = 0; i < nReads; ++i) {
+            file->seek(offsets[i]);
+            if (file->read(buffer, sizes[i]) != sizes[i] ||
+                memcmp(buffer, remoteFile.content.data() + offsets[i],
+                       sizes[i]) != 0) {
+                ok = false;
+            }
+        }
+    }
+    auto end = std::chrono::system_clock::now();
+    const double totalReads = static_cast<double>(nReads) * loops;
+    const double ns =
+        std::chrono::duration<double, std::nano>(end - start).count();
+
+    printf("Random reads of 2 to 16 bytes: %.01f ns/read, %u network "
+           "requests%s\n",
+           ns / totalReads,
+           static_cast<unsigned>(remoteFile.requestCount - requestsBefore),
+           ok ? "" : " MISMATCHING RESULTS");
+
+    file.reset();
+    proj_context_destroy(ctxt);
+
+    return ok ? 0 : 1;
+}
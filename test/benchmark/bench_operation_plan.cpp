@@ -0,0 +1,120 @@
+/******************************************************************************
+ * Project:  PROJ
+ * Purpose:  Benchmark comparing proj_clone() and the creation of handles from
+ *           an operation plan
+ *
+ ******************************************************************************
+ * Copyright (c) 2026, PROJ contributors
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included
+ * in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+ * OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+ * THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE.
+ *****************************************************************************/
+
+#include "proj.h"
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+
+static void usage() {
+    printf("Usage: bench_operation_plan [(--source-crs|-s) string]\n");
+    printf("                            [(--target-crs|-t) string]\n");
+    printf("                            [(--loops|-l) number]\n");
+    printf("\n");
+    printf("Measures the time to get a new object equivalent to the result of "
+           "proj_create_crs_to_crs(),\n");
+    printf("with proj_clone() and with proj_operation_plan_create_handle().\n");
+    printf("\n");
+    printf("Default: bench_operation_plan -s EPSG:4267 -t EPSG:4326\n");
+    exit(1);
+}
+
+int main(int argc, char *argv[]) {
+    std::string sourceCRS("EPSG:4267");
+    std::string targetCRS("EPSG:4326");
+    int loops = 100;
+    for (int i = 1; i < argc; ++i) {
+        if (strcmp(argv[i], "--source-crs") == 0 ||
+            strcmp(argv[i], "-s") == 0) {
+            if (i + 1 >= argc)
+                usage();
+            sourceCRS = argv[i + 1];
+            ++i;
+        } else if (strcmp(argv[i], "--target-crs") == 0 ||
+                   strcmp(argv[i], "-t") == 0) {
+            if (i + 1 >= argc)
+                usage();
+            targetCRS = argv[i + 1];
+            ++i;
+        } else if (strcmp(argv[i], "--loops") == 0 ||
+                   strcmp(argv[i], "-l") == 0) {
+            if (i + 1 >= argc)
+                usage();
+            loops = atoi(argv[i + 1]);
+            ++i;
+        } else {
+            usage();
+        }
+    }
+    if (loops <= 0)
+        usage();
+
+    PJ_CONTEXT *ctxt = proj_context_create();
+    PJ *P = proj_create_crs_to_crs(ctxt, sourceCRS.c_str(), targetCRS.c_str(),
+                                   nullptr);
+    if (P == nullptr) {
+        proj_context_destroy(ctxt);
+        exit(1);
+    }
+    PJ_OPERATION_PLAN *plan = proj_operation_plan_create(ctxt, P);
+    if (plan == nullptr) {
+        proj_destroy(P);
+        proj_context_destroy(ctxt);
+        exit(1);
+    }
+
+    // Another context, as a worker thread would use
+    PJ_CONTEXT *workerCtxt = proj_context_create();
+
+    auto start = std::chrono::system_clock::now();
+    for (int i = 0; i < loops; ++i) {
+        proj_destroy(proj_clone(workerCtxt, P));
+    }
+    auto end = std::chrono::system_clock::now();
+    const double usClone =
+        std::chrono::duration<double, std::micro>(end - start).count() / loops;
+
+    start = std::chrono::system_clock::now();
+    for (int i = 0; i < loops; ++i) {
+        proj_destroy(proj_operation_plan_create_handle(workerCtxt, plan));
+    }
+    end = std::chrono::system_clock::now();
+    const double usHandle =
+        std::chrono::duration<double, std::micro>(end - start).count() / loops;
+
+    printf("proj_clone():                        %.01f us\n", usClone);
+    printf("proj_operation_plan_create_handle(): %.01f us\n", usHandle);
+
+    proj_operation_plan_destroy(plan);
+    proj_destroy(P);
+    proj_context_destroy(workerCtxt);
+    proj_context_destroy(ctxt);
+    return 0;
+}
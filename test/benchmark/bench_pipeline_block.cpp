@@ -0,0 +1,168 @@
+/******************************************************************************
+ * Project:  PROJ
+ * Purpose:  Benchmark comparing per-point and block-oriented execution of
+ *           pipelines
+ *
+ ******************************************************************************
+ * Copyright (c) 2026, PROJ contributors
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included
+ * in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+ * OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+ * THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE.
+ *****************************************************************************/
+
+#include "proj.h"
+
+#include <stdlib.h> // rand()
+
+#include <chrono>
+#include <cmath> // HUGE_VAL
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <vector>
+
+namespace {
+
+struct TestCase {
+    const char *sourceCRS;
+    const char *targetCRS;
+    // Area in which input coordinates are generated, in the axis order
+    // of the source CRS
+    double minX;
+    double minY;
+    double maxX;
+    double maxY;
+};
+
+} // namespace
+
+// Common operations that resolve to a single pipeline
+static const TestCase testCases[] = {
+    {"EPSG:4326", "EPSG:32631", 40, 0, 60, 6},
+    {"EPSG:4326", "EPSG:3857", -80, -180, 80, 180},
+    {"EPSG:4258", "EPSG:25832", 47, 6, 55, 15},
+    {"EPSG:4326", "EPSG:4978", -90, -180, 90, 180},
+    {"EPSG:4171", "EPSG:2154", 42, -4, 51, 8},
+    {"EPSG:4326", "EPSG:3035", 35, -10, 70, 30},
+};
+
+static void usage() {
+    printf("Usage: bench_pipeline_block [(--points|-n) number]\n");
+    printf("                            [(--loops|-l) number]\n");
+    printf("\n");
+    printf("Compares the throughput of proj_trans() called for each point "
+           "with proj_trans_array(),\n");
+    printf("which runs blocks of points through each step of the pipeline "
+           "before moving to the next one.\n");
+    exit(1);
+}
+
+static double elapsedMs(std::chrono::system_clock::time_point start,
+                        std::chrono::system_clock::time_point end) {
+    return std::chrono::duration<double, std::milli>(end - start).count();
+}
+
+static bool runTestCase(PJ_CONTEXT *ctxt, const TestCase &testCase,
+                        int nPoints, int loops) {
+    PJ *P = proj_create_crs_to_crs(ctxt, testCase.sourceCRS,
+                                   testCase.targetCRS, nullptr);
+    if (P == nullptr) {
+        printf("%s -> %s: cannot create transformation\n", testCase.sourceCRS,
+               testCase.targetCRS);
+        return false;
+    }
+
+    std::vector<PJ_COORD> input(nPoints);
+    for (auto &c : input) {
+        c.v[0] = testCase.minX +
+                 (testCase.maxX - testCase.minX) * double(rand()) / RAND_MAX;
+        c.v[1] = testCase.minY +
+                 (testCase.maxY - testCase.minY) * double(rand()) / RAND_MAX;
+        c.v[2] = 0;
+        c.v[3] = HUGE_VAL;
+    }
+    std::vector<PJ_COORD> outputPerPoint(input);
+    std::vector<PJ_COORD> outputBlock(input);
+
+    auto start = std::chrono::system_clock::now();
+    for (int iter = 0; iter < loops; ++iter) {
+        for (int i = 0; i < nPoints; ++i)
+            outputPerPoint[i] = proj_trans(P, PJ_FWD, input[i]);
+    }
+    auto end = std::chrono::system_clock::now();
+    const double perPointMs = elapsedMs(start, end);
+
+    double blockMs = 0;
+    for (int iter = 0; iter < loops; ++iter) {
+        outputBlock = input;
+        start = std::chrono::system_clock::now();
+        proj_trans_array(P, PJ_FWD, outputBlock.size(), outputBlock.data());
+        end = std::chrono::system_clock::now();
+        blockMs += elapsedMs(start, end);
+    }
+
+    int nMismatches = 0;
+    for (int i = 0; i < nPoints; ++i) {
+        if (memcmp(&outputPerPoint[i], &outputBlock[i], sizeof(PJ_COORD)) !=
+            0)
+            ++nMismatches;
+    }
+
+    const double totalPoints = static_cast<double>(nPoints) * loops;
+    printf("%s -> %s: per-point %.02f, block %.02f million coordinates/s "
+           "(x%.02f)%s\n",
+           testCase.sourceCRS, testCase.targetCRS,
+           1e-3 * totalPoints / perPointMs, 1e-3 * totalPoints / blockMs,
+           perPointMs / blockMs,
+           nMismatches ? " MISMATCHING RESULTS" : "");
+    proj_destroy(P);
+    return nMismatches == 0;
+}
+
+int main(int argc, char *argv[]) {
+    int nPoints = 100 * 1000;
+    int loops = 10;
+    for (int i = 1; i < argc; ++i) {
+        if (strcmp(argv[i], "--points") == 0 || strcmp(argv[i], "-n") == 0) {
+            if (i + 1 >= argc)
+                usage();
+            nPoints = atoi(argv[i + 1]);
+            ++i;
+        } else if (strcmp(argv[i], "--loops") == 0 ||
+                   strcmp(argv[i], "-l") == 0) {
+            if (i + 1 >= argc)
+                usage();
+            loops = atoi(argv[i + 1]);
+            ++i;
+        } else {
+            usage();
+        }
+    }
+    if (nPoints <= 0 || loops <= 0)
+        usage();
+
+    PJ_CONTEXT *ctxt = proj_context_create();
+    bool ok = true;
+    for (const auto &testCase : testCases) {
+        if (!runTestCase(ctxt, testCase, nPoints, loops))
+            ok = false;
+    }
+    proj_context_destroy(ctxt);
+
+    return ok ? 0 : 1;
+}
@@ -0,0 +1,112 @@
+/******************************************************************************
+ * Project:  PROJ
+ * Purpose:  Micro-benchmarks of the creation of PJ objects from PROJ strings
+ *
+ ******************************************************************************
+ * Copyright (c) 2026, PROJ contributors
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included
+ * in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+ * OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+ * THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE.
+ *****************************************************************************/
+
+#include "proj.h"
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <vector>
+
+static void usage() {
+    printf("Usage: bench_pj_create [(--loops|-l) number] [proj_string]*\n");
+    printf("\n");
+    printf("Measures the time to create and destroy PJ objects from PROJ "
+           "strings.\n");
+    printf("Without proj_string, runs a suite of typical definitions.\n");
+    exit(1);
+}
+
+int main(int argc, char *argv[]) {
+    int loops = 2000;
+    std::vector<std::string> definitions;
+    for (int i = 1; i < argc; ++i) {
+        if (strcmp(argv[i], "--loops") == 0 || strcmp(argv[i], "-l") == 0) {
+            if (i + 1 >= argc)
+                usage();
+            loops = atoi(argv[i + 1]);
+            ++i;
+        } else if (argv[i][0] == '-' && argv[i][1] == '-') {
+            usage();
+        } else {
+            definitions.push_back(argv[i]);
+        }
+    }
+    if (loops <= 0)
+        usage();
+    if (definitions.empty()) {
+        definitions = {
+            "+proj=utm +zone=32 +ellps=GRS80",
+            "+proj=tmerc +lat_0=0 +lon_0=9 +k=0.9996 +x_0=500000 +y_0=0 "
+            "+ellps=intl +units=m",
+            "+proj=merc +a=6378137 +b=6378137 +lat_ts=0 +lon_0=0 +x_0=0 "
+            "+y_0=0 +k=1 +units=m +nadgrids=@null +wktext +no_defs",
+            "+proj=lcc +lat_0=46.5 +lon_0=3 +lat_1=49 +lat_2=44 "
+            "+x_0=700000 +y_0=6600000 +ellps=GRS80 +towgs84=0,0,0,0,0,0,0 "
+            "+units=m +no_defs",
+            "+proj=helmert +x=-81.0703 +y=-89.3603 +z=-115.7526 "
+            "+rx=-0.48488 +ry=-0.02436 +rz=-0.41321 +s=-0.540645 "
+            "+convention=coordinate_frame",
+            "+proj=pipeline +step +proj=axisswap +order=2,1 "
+            "+step +proj=unitconvert +xy_in=deg +xy_out=rad "
+            "+step +proj=push +v_3 +step +proj=cart +ellps=intl "
+            "+step +proj=helmert +x=-87 +y=-98 +z=-121 "
+            "+step +inv +proj=cart +ellps=WGS84 +step +proj=pop +v_3 "
+            "+step +proj=unitconvert +xy_in=rad +xy_out=deg "
+            "+step +proj=axisswap +order=2,1",
+        };
+    }
+
+    PJ_CONTEXT *ctxt = proj_context_create();
+    double totalUs = 0;
+    for (const auto &definition : definitions) {
+        PJ *P = proj_create(ctxt, definition.c_str());
+        if (P == nullptr) {
+            fprintf(stderr, "Cannot create %s\n", definition.c_str());
+            proj_context_destroy(ctxt);
+            exit(1);
+        }
+        proj_destroy(P);
+
+        auto start = std::chrono::system_clock::now();
+        for (int i = 0; i < loops; ++i) {
+            proj_destroy(proj_create(ctxt, definition.c_str()));
+        }
+        auto end = std::chrono::system_clock::now();
+        const double us =
+            std::chrono::duration<double, std::micro>(end - start).count() /
+            loops;
+        totalUs += us;
+        printf("%8.1f us  %.60s%s\n", us, definition.c_str(),
+               definition.size() > 60 ? "..." : "");
+    }
+    printf("%8.1f us  total\n", totalUs);
+
+    proj_context_destroy(ctxt);
+    return 0;
+}
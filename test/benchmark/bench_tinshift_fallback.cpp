@@ -0,0 +1,223 @@
+/******************************************************************************
+ * Project:  PROJ
+ * Purpose:  Benchmark of the tinshift fallback strategies, for points
+ *           located around a triangulation
+ *
+ ******************************************************************************
+ * Copyright (c) 2026, PROJ contributors
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included
+ * in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+ * OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+ * THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE.
+ *****************************************************************************/
+
+#define PROJ_COMPILATION
+#define TINSHIFT_NAMESPACE BenchTINShift
+#include "transformations/tinshift.hpp"
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <random>
+#include <sstream>
+#include <string>
+
+using namespace TINSHIFT_NAMESPACE;
+
+static void usage() {
+    printf("Usage: bench_tinshift_fallback [(--size|-s) number]\n");
+    printf("                               [(--points|-p) number]\n");
+    printf("                               [--strategy "
+           "nearest_side|nearest_centroid]\n");
+    printf("                               [--file filename]\n");
+    printf("\n");
+    printf("Measures the time to transform points located around a "
+           "triangulation, that\n");
+    printf("are transformed with the fallback strategy.\n");
+    printf("The triangulation is either a synthetic one of 2*(size-1)^2 "
+           "triangles covering\n");
+    printf("a square, or read from a JSON or binary tinshift file.\n");
+    printf("\n");
+    printf("Default: bench_tinshift_fallback -s 300 -p 10000 --strategy "
+           "nearest_side\n");
+    exit(1);
+}
+
+// Triangulation of a size x size grid of jittered vertices
+static std::string buildSyntheticTriangulation(int size,
+                                               const std::string &strategy) {
+    std::mt19937 gen(0);
+    std::uniform_real_distribution<double> jitter(-0.3, 0.3);
+    json j;
+    j["file_type"] = "triangulation_file";
+    j["format_version"] = "1.1";
+    j["fallback_strategy"] = strategy;
+    j["transformed_components"] = {"horizontal"};
+    j["vertices_columns"] = {"source_x", "source_y", "target_x", "target_y"};
+    j["triangles_columns"] = {"idx_vertex1", "idx_vertex2", "idx_vertex3"};
+    json vertices = json::array();
+    for (int row = 0; row < size; ++row) {
+        for (int col = 0; col < size; ++col) {
+            const bool border =
+                row == 0 || col == 0 || row == size - 1 || col == size - 1;
+            const double x = col + (border ? 0 : jitter(gen));
+            const double y = row + (border ? 0 : jitter(gen));
+            vertices.push_back({x, y, x + 1e-3 * y, y - 1e-3 * x});
+        }
+    }
+    j["vertices"] = std::move(vertices);
+    json triangles = json::array();
+    for (int row = 0; row + 1 < size; ++row) {
+        for (int col = 0; col + 1 < size; ++col) {
+            const int a = row * size + col;
+            triangles.push_back({a, a + 1, a + size + 1});
+            triangles.push_back({a, a + size + 1, a + size});
+        }
+    }
+    j["triangles"] = std::move(triangles);
+    return j.dump();
+}
+
+int main(int argc, char *argv[]) {
+    int size = 300;
+    int points = 10000;
+    std::string strategy("nearest_side");
+    std::string filename;
+    for (int i = 1; i < argc; ++i) {
+        if ((strcmp(argv[i], "--size") == 0 || strcmp(argv[i], "-s") == 0) &&
+            i + 1 < argc) {
+            size = atoi(argv[i + 1]);
+            ++i;
+        } else if ((strcmp(argv[i], "--points") == 0 ||
+                    strcmp(argv[i], "-p") == 0) &&
+                   i + 1 < argc) {
+            points = atoi(argv[i + 1]);
+            ++i;
+        } else if (strcmp(argv[i], "--strategy") == 0 && i + 1 < argc) {
+            strategy = argv[i + 1];
+            ++i;
+        } else if (strcmp(argv[i], "--file") == 0 && i + 1 < argc) {
+            filename = argv[i + 1];
+            ++i;
+        } else {
+            usage();
+        }
+    }
+    if (size < 2 || points <= 0 ||
+        (strategy != "nearest_side" && strategy != "nearest_centroid"))
+        usage();
+
+    std::string content;
+    if (filename.empty()) {
+        content = buildSyntheticTriangulation(size, strategy);
+    } else {
+        std::ifstream f(filename, std::ios::binary);
+        if (!f) {
+            fprintf(stderr, "Cannot open %s\n", filename.c_str());
+            exit(1);
+        }
+        std::ostringstream oss;
+        oss << f.rdbuf();
+        content = oss.str();
+    }
+
+    std::unique_ptr<TINShiftFile> file;
+    const auto start = std::chrono::steady_clock::now();
+    try {
+        const auto data =
+            reinterpret_cast<const unsigned char *>(content.data());
+        if (TINShiftFile::isBinary(data, content.size()))
+            file = TINShiftFile::parseBinary(data, content.size(), nullptr);
+        else
+            file = TINShiftFile::parse(content);
+    } catch (const std::exception &e) {
+        fprintf(stderr, "Cannot parse triangulation: %s\n", e.what());
+        exit(1);
+    }
+    if (file->fallbackStrategy() == FALLBACK_NONE) {
+        fprintf(stderr, "The triangulation has no fallback strategy\n");
+        exit(1);
+    }
+    printf("Triangles: %u\n", static_cast<unsigned>(file->triangleCount()));
+
+    // Points located at up to 5% of the extent of the triangulation outside
+    // of its bounding box, uniformly along its perimeter.
+    double minx = std::numeric_limits<double>::max();
+    double miny = std::numeric_limits<double>::max();
+    double maxx = -std::numeric_limits<double>::max();
+    double maxy = -std::numeric_limits<double>::max();
+    for (size_t i = 0; i < file->vertexCount(); ++i) {
+        const double *vertex = file->vertices() + i * file->verticesColumnCount();
+        minx = std::min(minx, vertex[0]);
+        miny = std::min(miny, vertex[1]);
+        maxx = std::max(maxx, vertex[0]);
+        maxy = std::max(maxy, vertex[1]);
+    }
+    const double width = maxx - minx;
+    const double height = maxy - miny;
+    std::mt19937 gen(0);
+    std::uniform_real_distribution<double> along(0, 2 * (width + height));
+    std::uniform_real_distribution<double> away(1e-6, 0.05);
+    std::vector<std::pair<double, double>> coords;
+    coords.reserve(points);
+    for (int i = 0; i < points; ++i) {
+        const double pos = along(gen);
+        const double offset = away(gen) * std::max(width, height);
+        if (pos < width)
+            coords.emplace_back(minx + pos, miny - offset);
+        else if (pos < width + height)
+            coords.emplace_back(maxx + offset, miny + pos - width);
+        else if (pos < 2 * width + height)
+            coords.emplace_back(maxx - (pos - width - height), maxy + offset);
+        else
+            coords.emplace_back(minx - offset,
+                                maxy - (pos - 2 * width - height));
+    }
+
+    Evaluator evaluator(std::move(file));
+    double x_out = 0;
+    double y_out = 0;
+    double z_out = 0;
+    // Make sure that the spatial index is built before timing
+    evaluator.forward(coords[0].first, coords[0].second, 0, x_out, y_out,
+                      z_out);
+    const auto startTransform = std::chrono::steady_clock::now();
+    int failures = 0;
+    for (const auto &coord : coords) {
+        if (!evaluator.forward(coord.first, coord.second, 0, x_out, y_out,
+                               z_out))
+            ++failures;
+    }
+    const auto end = std::chrono::steady_clock::now();
+
+    printf("Opening and first point: %.1f ms\n",
+           std::chrono::duration<double, std::milli>(startTransform - start)
+               .count());
+    printf("Transformation of %d points: %.1f ms (%.2f us per point)\n",
+           points,
+           std::chrono::duration<double, std::milli>(end - startTransform)
+               .count(),
+           std::chrono::duration<double, std::micro>(end - startTransform)
+                   .count() /
+               points);
+    if (failures)
+        printf("Failed transformations: %d\n", failures);
+
+    return 0;
+}
@@ -0,0 +1,179 @@
+/******************************************************************************
+ * Project:  PROJ
+ * Purpose:  Micro-benchmarks of WKT parsing
+ *
+ ******************************************************************************
+ * Copyright (c) 2026, PROJ contributors
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included
+ * in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+ * OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+ * THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE.
+ *****************************************************************************/
+
+#include "proj/io.hpp"
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <vector>
+
+using namespace osgeo::proj;
+
+static void usage() {
+    printf("Usage: bench_wkt_parse [(--loops|-l) number] [wkt]*\n");
+    printf("\n");
+    printf("Measures the time to parse WKT strings, with and without "
+           "validation against the WKT grammar.\n");
+    printf("Without wkt, runs a suite of WKT1_GDAL, WKT1_ESRI and WKT2_2019 "
+           "strings.\n");
+    exit(1);
+}
+
+static const char *dialectName(io::WKTParser::WKTGuessedDialect dialect) {
+    switch (dialect) {
+    case io::WKTParser::WKTGuessedDialect::WKT2_2019:
+        return "WKT2_2019";
+    case io::WKTParser::WKTGuessedDialect::WKT2_2015:
+        return "WKT2_2015";
+    case io::WKTParser::WKTGuessedDialect::WKT1_GDAL:
+        return "WKT1_GDAL";
+    case io::WKTParser::WKTGuessedDialect::WKT1_ESRI:
+        return "WKT1_ESRI";
+    case io::WKTParser::WKTGuessedDialect::NOT_WKT:
+        break;
+    }
+    return "NOT_WKT";
+}
+
+static double bench(const std::string &wkt, int loops, bool checkGrammar) {
+    auto start = std::chrono::system_clock::now();
+    for (int i = 0; i < loops; ++i) {
+        io::WKTParser()
+            .setStrict(false)
+            .setCheckGrammar(checkGrammar)
+            .createFromWKT(wkt);
+    }
+    auto end = std::chrono::system_clock::now();
+    return std::chrono::duration<double, std::micro>(end - start).count() /
+           loops;
+}
+
+int main(int argc, char *argv[]) {
+    int loops = 2000;
+    std::vector<std::string> wkts;
+    for (int i = 1; i < argc; ++i) {
+        if (strcmp(argv[i], "--loops") == 0 || strcmp(argv[i], "-l") == 0) {
+            if (i + 1 >= argc)
+                usage();
+            loops = atoi(argv[i + 1]);
+            ++i;
+        } else if (argv[i][0] == '-' && argv[i][1] == '-') {
+            usage();
+        } else {
+            wkts.push_back(argv[i]);
+        }
+    }
+    if (loops <= 0)
+        usage();
+    if (wkts.empty()) {
+        wkts = {
+            // WKT1_GDAL
+            "PROJCS[\"WGS 84 / UTM zone 31N\","
+            "GEOGCS[\"WGS 84\","
+            "DATUM[\"WGS_1984\","
+            "SPHEROID[\"WGS 84\",6378137,298.257223563,"
+            "AUTHORITY[\"EPSG\",\"7030\"]],"
+            "AUTHORITY[\"EPSG\",\"6326\"]],"
+            "PRIMEM[\"Greenwich\",0,AUTHORITY[\"EPSG\",\"8901\"]],"
+            "UNIT[\"degree\",0.0174532925199433,AUTHORITY[\"EPSG\",\"9122\"]],"
+            "AUTHORITY[\"EPSG\",\"4326\"]],"
+            "PROJECTION[\"Transverse_Mercator\"],"
+            "PARAMETER[\"latitude_of_origin\",0],"
+            "PARAMETER[\"central_meridian\",3],"
+            "PARAMETER[\"scale_factor\",0.9996],"
+            "PARAMETER[\"false_easting\",500000],"
+            "PARAMETER[\"false_northing\",0],"
+            "UNIT[\"metre\",1,AUTHORITY[\"EPSG\",\"9001\"]],"
+            "AXIS[\"Easting\",EAST],AXIS[\"Northing\",NORTH],"
+            "AUTHORITY[\"EPSG\",\"32631\"]]",
+
+            // WKT1_ESRI
+            "PROJCS[\"WGS_1984_UTM_Zone_31N\","
+            "GEOGCS[\"GCS_WGS_1984\","
+            "DATUM[\"D_WGS_1984\","
+            "SPHEROID[\"WGS_1984\",6378137.0,298.257223563]],"
+            "PRIMEM[\"Greenwich\",0.0],"
+            "UNIT[\"Degree\",0.0174532925199433]],"
+            "PROJECTION[\"Transverse_Mercator\"],"
+            "PARAMETER[\"False_Easting\",500000.0],"
+            "PARAMETER[\"False_Northing\",0.0],"
+            "PARAMETER[\"Central_Meridian\",3.0],"
+            "PARAMETER[\"Scale_Factor\",0.9996],"
+            "PARAMETER[\"Latitude_Of_Origin\",0.0],"
+            "UNIT[\"Meter\",1.0]]",
+
+            // WKT2_2019
+            "PROJCRS[\"WGS 84 / UTM zone 31N\","
+            "BASEGEOGCRS[\"WGS 84\","
+            "DATUM[\"World Geodetic System 1984\","
+            "ELLIPSOID[\"WGS 84\",6378137,298.257223563,"
+            "LENGTHUNIT[\"metre\",1]]],"
+            "PRIMEM[\"Greenwich\",0,ANGLEUNIT[\"degree\",0.0174532925199433]],"
+            "ID[\"EPSG\",4326]],"
+            "CONVERSION[\"UTM zone 31N\","
+            "METHOD[\"Transverse Mercator\",ID[\"EPSG\",9807]],"
+            "PARAMETER[\"Latitude of natural origin\",0,"
+            "ANGLEUNIT[\"degree\",0.0174532925199433],ID[\"EPSG\",8801]],"
+            "PARAMETER[\"Longitude of natural origin\",3,"
+            "ANGLEUNIT[\"degree\",0.0174532925199433],ID[\"EPSG\",8802]],"
+            "PARAMETER[\"Scale factor at natural origin\",0.9996,"
+            "SCALEUNIT[\"unity\",1],ID[\"EPSG\",8805]],"
+            "PARAMETER[\"False easting\",500000,"
+            "LENGTHUNIT[\"metre\",1],ID[\"EPSG\",8806]],"
+            "PARAMETER[\"False northing\",0,"
+            "LENGTHUNIT[\"metre\",1],ID[\"EPSG\",8807]]],"
+            "CS[Cartesian,2],"
+            "AXIS[\"(E)\",east,ORDER[1],LENGTHUNIT[\"metre\",1]],"
+            "AXIS[\"(N)\",north,ORDER[2],LENGTHUNIT[\"metre\",1]],"
+            "USAGE[SCOPE[\"Navigation and medium accuracy spatial "
+            "referencing.\"],"
+            "AREA[\"Between 0°E and 6°E, northern hemisphere between "
+            "equator and 84°N, onshore and offshore.\"],"
+            "BBOX[0,0,84,6]],"
+            "ID[\"EPSG\",32631]]",
+        };
+    }
+
+    printf("%13s %13s  %s\n", "grammar (us)", "no check (us)", "dialect");
+    for (const auto &wkt : wkts) {
+        const auto dialect = io::WKTParser().guessDialect(wkt);
+        try {
+            io::WKTParser().setStrict(false).createFromWKT(wkt);
+        } catch (const std::exception &e) {
+            fprintf(stderr, "Cannot parse %s: %s\n", wkt.c_str(), e.what());
+            exit(1);
+        }
+        const double withCheck = bench(wkt, loops, true);
+        const double withoutCheck = bench(wkt, loops, false);
+        printf("%13.1f %13.1f  %s\n", withCheck, withoutCheck,
+               dialectName(dialect));
+    }
+
+    return 0;
+}
@@ -37,6 +37,7 @@
 
 #include <cmath>
 #include <string>
+#include <vector>
 
 namespace {
 
@@ -1476,6 +1477,69 @@ TEST(gie, proj_create_crs_to_crs_with_longitude_outside_minus_180_180) {
 
 // ---------------------------------------------------------------------------
 
+TEST(gie, proj_create_crs_to_crs_cached_operation_selection) {
+
+    // The selection of the alternative operation is memoized per cell of
+    // the partition of the plane by the areas of use. Check that it matches
+    // the selection done on a fresh object, for points visited in a coherent
+    // order and then in a scattered one.
+    auto P = proj_create_crs_to_crs(PJ_DEFAULT_CTX, "EPSG:4267", "EPSG:4326",
+                                    nullptr);
+    ASSERT_TRUE(P != nullptr);
+    ASSERT_GT(P->alternativeCoordinateOperations.size(), 1U);
+
+    std::vector<PJ_COORD> points;
+    for (int i = 0; i <= 20; ++i) {
+        for (int j = 0; j <= 20; ++j) {
+            PJ_COORD c;
+            c.xyzt.x = 10 + 3 * i;     // Lat in deg
+            c.xyzt.y = -180 + 7.5 * j; // Long in deg
+            c.xyzt.z = 0;
+            c.xyzt.t = HUGE_VAL;
+            points.push_back(c);
+        }
+    }
+    // Points on the edge of an area of use
+    const auto &firstOp = P->alternativeCoordinateOperations[0];
+    PJ_COORD c;
+    c.xyzt.x = firstOp.minxSrc;
+    c.xyzt.y = firstOp.minySrc;
+    c.xyzt.z = 0;
+    c.xyzt.t = HUGE_VAL;
+    points.push_back(c);
+    c.xyzt.x = firstOp.maxxSrc;
+    c.xyzt.y = 0.5 * (firstOp.minySrc + firstOp.maxySrc);
+    points.push_back(c);
+
+    std::vector<int> expectedOp;
+    std::vector<PJ_COORD> expectedRes;
+    for (const auto &point : points) {
+        auto Pclone = proj_clone(PJ_DEFAULT_CTX, P);
+        ASSERT_TRUE(Pclone != nullptr);
+        expectedRes.push_back(proj_trans(Pclone, PJ_FWD, point));
+        expectedOp.push_back(Pclone->iCurCoordOp);
+        proj_destroy(Pclone);
+    }
+
+    for (size_t i = 0; i < points.size(); ++i) {
+        const auto res = proj_trans(P, PJ_FWD, points[i]);
+        EXPECT_EQ(P->iCurCoordOp, expectedOp[i]) << i;
+        EXPECT_EQ(res.xyzt.x, expectedRes[i].xyzt.x) << i;
+        EXPECT_EQ(res.xyzt.y, expectedRes[i].xyzt.y) << i;
+    }
+    for (size_t k = 0; k < points.size(); ++k) {
+        const size_t i = (k * 97) % points.size();
+        const auto res = proj_trans(P, PJ_FWD, points[i]);
+        EXPECT_EQ(P->iCurCoordOp, expectedOp[i]) << i;
+        EXPECT_EQ(res.xyzt.x, expectedRes[i].xyzt.x) << i;
+        EXPECT_EQ(res.xyzt.y, expectedRes[i].xyzt.y) << i;
+    }
+
+    proj_destroy(P);
+}
+
+// ---------------------------------------------------------------------------
+
 TEST(gie, proj_trans_generic) {
     // GDA2020 to WGS84 (G1762)
     auto P = proj_create(
@@ -1502,6 +1566,169 @@ TEST(gie, proj_trans_generic) {
 
 // ---------------------------------------------------------------------------
 
+TEST(gie, proj_trans_array_batched_pipeline) {
+    // Pipeline with push/pop, so as to check that the stacks are correctly
+    // handled when processing several coordinates at once
+    auto P = proj_create(PJ_DEFAULT_CTX,
+                         "+proj=pipeline +step +proj=push +v_3 "
+                         "+step +proj=cart +ellps=GRS80 "
+                         "+step +proj=helmert +x=100 +y=200 +z=300 "
+                         "+step +inv +proj=cart +ellps=WGS84 "
+                         "+step +proj=pop +v_3 "
+                         "+step +proj=utm +zone=32 +ellps=WGS84");
+    ASSERT_TRUE(P != nullptr);
+
+    // More than one block of coordinates
+    constexpr int N = 1000;
+    std::vector<PJ_COORD> coords(N);
+    for (int i = 0; i < N; i++) {
+        coords[i] = proj_coord(proj_torad(9 + 0.001 * i),
+                               proj_torad(50 + 0.002 * i), i, 2020);
+    }
+    // Invalid latitude
+    coords[10].lpz.phi = proj_torad(95);
+    coords[500].lpz.phi = proj_torad(95);
+    auto expected(coords);
+
+    for (auto dir : {PJ_FWD, PJ_INV}) {
+        int expectedErrno = 0;
+        for (int i = 0; i < N; i++) {
+            proj_errno_reset(P);
+            expected[i] = proj_trans(P, dir, expected[i]);
+            if (proj_errno(P) != 0)
+                expectedErrno = proj_errno(P);
+        }
+        if (dir == PJ_FWD) {
+            EXPECT_EQ(expectedErrno, PROJ_ERR_COORD_TRANSFM_INVALID_COORD);
+        }
+        EXPECT_EQ(proj_trans_array(P, dir, N, coords.data()), expectedErrno);
+        for (int i = 0; i < N; i++) {
+            EXPECT_EQ(coords[i].xyzt.x, expected[i].xyzt.x) << i;
+            EXPECT_EQ(coords[i].xyzt.y, expected[i].xyzt.y) << i;
+            EXPECT_EQ(coords[i].xyzt.z, expected[i].xyzt.z) << i;
+            EXPECT_EQ(coords[i].xyzt.t, expected[i].xyzt.t) << i;
+        }
+        if (dir == PJ_FWD) {
+            EXPECT_NEAR(coords[0].xyzt.z, 0, 1e-8);
+            EXPECT_NEAR(coords[999].xyzt.z, 999, 1e-8);
+        }
+    }
+
+    proj_destroy(P);
+}
+
+// ---------------------------------------------------------------------------
+
+TEST(gie, proj_trans_array_etmerc) {
+    // Check that the batched Poder/Engsager implementation gives the same
+    // results as the per-coordinate one
+    auto P = proj_create(PJ_DEFAULT_CTX,
+                         "+proj=etmerc +lat_0=38 +lon_0=125 +k=0.9996 "
+                         "+x_0=200000 +y_0=500000 +ellps=bessel");
+    ASSERT_TRUE(P != nullptr);
+
+    std::vector<PJ_COORD> coords;
+    for (int lon = -179; lon <= 179; lon += 7) {
+        for (int lat = -89; lat <= 89; lat += 3) {
+            coords.push_back(
+                proj_coord(proj_torad(lon), proj_torad(lat), 0, 0));
+        }
+    }
+    const auto N = coords.size();
+    auto expected(coords);
+
+    for (auto dir : {PJ_FWD, PJ_INV}) {
+        for (size_t i = 0; i < N; i++) {
+            expected[i] = proj_trans(P, dir, expected[i]);
+        }
+        proj_trans_array(P, dir, N, coords.data());
+        for (size_t i = 0; i < N; i++) {
+            EXPECT_EQ(coords[i].xyzt.x, expected[i].xyzt.x) << i;
+            EXPECT_EQ(coords[i].xyzt.y, expected[i].xyzt.y) << i;
+        }
+    }
+
+    proj_destroy(P);
+}
+
+// ---------------------------------------------------------------------------
+
+// Check that proj_trans_array() on a grid based operation gives the same
+// results as proj_trans(), on points scattered over the extent of the grid
+// and slightly beyond it
+static void checkGridShiftArray(const char *pipeline, const char *gridname) {
+    auto P = proj_create(PJ_DEFAULT_CTX, pipeline);
+    ASSERT_TRUE(P != nullptr) << pipeline;
+
+    const auto info = proj_grid_info(gridname);
+    const double minLon = info.lowerleft.lam;
+    const double minLat = info.lowerleft.phi;
+    const double maxLon = info.upperright.lam;
+    const double maxLat = info.upperright.phi;
+    ASSERT_LT(minLon, maxLon) << gridname;
+
+    constexpr int N = 41;
+    std::vector<PJ_COORD> coords;
+    for (int k = 0; k < N * N; k++) {
+        // Visit the points in a scattered order
+        const int idx = (k * 97) % (N * N);
+        const double fx = -0.1 + 1.2 * (idx % N) / (N - 1);
+        const double fy = -0.1 + 1.2 * (idx / N) / (N - 1);
+        coords.push_back(proj_coord(minLon + fx * (maxLon - minLon),
+                                    minLat + fy * (maxLat - minLat), 10, 0));
+    }
+    const auto N2 = coords.size();
+    auto expected(coords);
+
+    for (auto dir : {PJ_FWD, PJ_INV}) {
+        int expectedErrno = 0;
+        for (size_t i = 0; i < N2; i++) {
+            proj_errno_reset(P);
+            expected[i] = proj_trans(P, dir, expected[i]);
+            if (proj_errno(P) != 0)
+                expectedErrno = proj_errno(P);
+        }
+        size_t nValid = 0;
+        for (const auto &c : expected) {
+            if (c.xyzt.x != HUGE_VAL)
+                ++nValid;
+        }
+        EXPECT_GT(nValid, N2 / 2) << pipeline;
+        EXPECT_LT(nValid, N2) << pipeline;
+        EXPECT_EQ(proj_trans_array(P, dir, N2, coords.data()), expectedErrno)
+            << pipeline;
+        for (size_t i = 0; i < N2; i++) {
+            EXPECT_EQ(coords[i].xyzt.x, expected[i].xyzt.x) << pipeline << i;
+            EXPECT_EQ(coords[i].xyzt.y, expected[i].xyzt.y) << pipeline << i;
+            EXPECT_EQ(coords[i].xyzt.z, expected[i].xyzt.z) << pipeline << i;
+        }
+    }
+
+    proj_destroy(P);
+}
+
+// ---------------------------------------------------------------------------
+
+TEST(gie, proj_trans_array_grid_shifts) {
+    checkGridShiftArray("+proj=hgridshift +grids=tests/ntv2_0_downsampled.gsb",
+                        "tests/ntv2_0_downsampled.gsb");
+    checkGridShiftArray("+proj=vgridshift +grids=tests/test_nodata.gtx "
+                        "+multiplier=1",
+                        "tests/test_nodata.gtx");
+#ifdef TIFF_ENABLED
+    checkGridShiftArray("+proj=hgridshift +grids=tests/test_hgrid_tiled.tif",
+                        "tests/test_hgrid_tiled.tif");
+    checkGridShiftArray(
+        "+proj=gridshift "
+        "+grids=tests/"
+        "us_noaa_nadcon5_nad83_1986_nad83_harn_conus_extract_sanfrancisco.tif",
+        "tests/"
+        "us_noaa_nadcon5_nad83_1986_nad83_harn_conus_extract_sanfrancisco.tif");
+#endif
+}
+
+// ---------------------------------------------------------------------------
+
 TEST(gie, proj_trans_with_a_crs) {
     auto P = proj_create(PJ_DEFAULT_CTX, "EPSG:4326");
     PJ_COORD input;
@@ -49,6 +49,7 @@
 
 #if !defined(_WIN32)
 #include <sys/resource.h>
+#include <utime.h>
 #endif
 
 #ifndef __MINGW32__
@@ -335,6 +336,20 @@ TEST_F(CApi, proj_create_from_wkt) {
         EXPECT_NE(errorList, nullptr);
         proj_string_list_destroy(errorList);
     }
+    {
+        // Grammar is still checked in strict mode without out_grammar_errors
+        const char *const options[] = {"STRICT=YES", nullptr};
+        auto obj = proj_create_from_wkt(
+            m_ctxt,
+            "GEOGCS[\"WGS 84\",\n"
+            "    DATUM[\"WGS_1984\",\n"
+            "        SPHEROID[\"WGS 84\",6378137,298.257223563,\"unused\"]],\n"
+            "    PRIMEM[\"Greenwich\",0],\n"
+            "    UNIT[\"degree\",0.0174532925199433]]",
+            options, nullptr, nullptr);
+        ObjectKeeper keeper(obj);
+        EXPECT_EQ(obj, nullptr);
+    }
     {
         PROJ_STRING_LIST warningList = nullptr;
         PROJ_STRING_LIST errorList = nullptr;
@@ -3323,6 +3338,76 @@ TEST_F(CApi, proj_clone_of_obj_with_alternative_operations) {
 
 // ---------------------------------------------------------------------------
 
+TEST_F(CApi, proj_operation_plan) {
+    EXPECT_EQ(proj_operation_plan_create(m_ctxt, nullptr), nullptr);
+    EXPECT_EQ(proj_operation_plan_create_handle(m_ctxt, nullptr), nullptr);
+    proj_operation_plan_destroy(nullptr);
+
+    {
+        auto obj = proj_create(m_ctxt, "+proj=utm +zone=31 +ellps=GRS80");
+        ObjectKeeper keeper(obj);
+        ASSERT_NE(obj, nullptr);
+
+        auto plan = proj_operation_plan_create(m_ctxt, obj);
+        ASSERT_NE(plan, nullptr);
+        auto handle = proj_operation_plan_create_handle(m_ctxt, plan);
+        ObjectKeeper keeperHandle(handle);
+        proj_operation_plan_destroy(plan);
+        ASSERT_NE(handle, nullptr);
+
+        EXPECT_TRUE(proj_is_equivalent_to(obj, handle, PJ_COMP_STRICT));
+        PJ_COORD c;
+        c.lpzt.lam = 0.05;
+        c.lpzt.phi = 0.85;
+        c.lpzt.z = 0;
+        c.lpzt.t = HUGE_VAL;
+        PJ_COORD c_trans_ref = proj_trans(obj, PJ_FWD, c);
+        PJ_COORD c_trans = proj_trans(handle, PJ_FWD, c);
+        EXPECT_EQ(c_trans.xyzt.x, c_trans_ref.xyzt.x);
+        EXPECT_EQ(c_trans.xyzt.y, c_trans_ref.xyzt.y);
+    }
+
+    {
+        // NAD27 to NAD83
+        auto obj =
+            proj_create_crs_to_crs(m_ctxt, "EPSG:4267", "EPSG:4269", nullptr);
+        ObjectKeeper keeper(obj);
+        ASSERT_NE(obj, nullptr);
+
+        PJ_COORD c;
+        c.xyzt.x = 40.5;
+        c.xyzt.y = -60;
+        c.xyzt.z = 0;
+        c.xyzt.t = 2021;
+        PJ_COORD c_trans_ref = proj_trans(obj, PJ_FWD, c);
+        EXPECT_NE(c_trans_ref.xyzt.x, c.xyzt.x);
+
+        auto plan = proj_operation_plan_create(m_ctxt, obj);
+        ASSERT_NE(plan, nullptr);
+        keeper.clear();
+        obj = nullptr;
+        (void)obj;
+
+        for (int i = 0; i < 2; ++i) {
+            auto handle = proj_operation_plan_create_handle(m_ctxt, plan);
+            ObjectKeeper keeperHandle(handle);
+            ASSERT_NE(handle, nullptr);
+            EXPECT_EQ(proj_trans_get_last_used_operation(handle), nullptr);
+
+            PJ_COORD c_trans = proj_trans(handle, PJ_FWD, c);
+            EXPECT_EQ(c_trans.xyzt.x, c_trans_ref.xyzt.x);
+            EXPECT_EQ(c_trans.xyzt.y, c_trans_ref.xyzt.y);
+
+            PJ *pj_used = proj_trans_get_last_used_operation(handle);
+            EXPECT_NE(pj_used, nullptr);
+            proj_destroy(pj_used);
+        }
+        proj_operation_plan_destroy(plan);
+    }
+}
+
+// ---------------------------------------------------------------------------
+
 TEST_F(CApi, proj_crs_alter_geodetic_crs) {
     auto projCRS = proj_create_from_wkt(
         m_ctxt,
@@ -4847,6 +4932,193 @@ TEST_F(CApi, proj_create_crs_to_crs_from_pj_ballpark_filter) {
 
 // ---------------------------------------------------------------------------
 
+static std::string getCrsToCrsCacheColumn(const std::string &filename,
+                                          const char *sql) {
+    sqlite3 *hDB = nullptr;
+    sqlite3_open_v2(filename.c_str(), &hDB, SQLITE_OPEN_READONLY, nullptr);
+    if (!hDB)
+        return "<error>";
+    std::string ret("<no row>");
+    sqlite3_stmt *hStmt = nullptr;
+    sqlite3_prepare_v2(hDB, sql, -1, &hStmt, nullptr);
+    if (hStmt && sqlite3_step(hStmt) == SQLITE_ROW) {
+        auto val = sqlite3_column_text(hStmt, 0);
+        ret = val ? reinterpret_cast<const char *>(val) : "<null>";
+    }
+    sqlite3_finalize(hStmt);
+    sqlite3_close(hDB);
+    return ret;
+}
+
+static void execCrsToCrsCacheSQL(const std::string &filename,
+                                 const char *sql) {
+    sqlite3 *hDB = nullptr;
+    sqlite3_open_v2(filename.c_str(), &hDB, SQLITE_OPEN_READWRITE, nullptr);
+    ASSERT_TRUE(hDB != nullptr);
+    EXPECT_EQ(sqlite3_exec(hDB, sql, nullptr, nullptr, nullptr), SQLITE_OK);
+    sqlite3_close(hDB);
+}
+
+TEST_F(CApi, proj_crs_to_crs_cache) {
+    const char *tempdir = getenv("TEMP");
+    if (!tempdir) {
+        tempdir = getenv("TMP");
+    }
+    if (!tempdir) {
+        tempdir = "/tmp";
+    }
+    const std::string cacheFilename(std::string(tempdir) +
+                                    "/test_proj_crs_to_crs_cache.db");
+    std::remove(cacheFilename.c_str());
+
+    auto ctx = proj_context_create();
+    ASSERT_NE(ctx, nullptr);
+    PjContextKeeper keeper_ctxt(ctx);
+    proj_crs_to_crs_cache_set_filename(ctx, cacheFilename.c_str());
+    proj_crs_to_crs_cache_set_enable(ctx, true);
+
+    PJ_COORD c;
+    c.xyzt.x = 40.5;  // lat
+    c.xyzt.y = -98.5; // lon
+    c.xyzt.z = 0;
+    c.xyzt.t = HUGE_VAL;
+
+    auto transform = [ctx, c]() {
+        auto P = proj_create_crs_to_crs(ctx, "EPSG:4267", "EPSG:4269", nullptr);
+        if (!P)
+            return PJ_COORD();
+        auto res = proj_trans(P, PJ_FWD, c);
+        proj_destroy(P);
+        return res;
+    };
+
+    // Reference result, without the cache
+    proj_crs_to_crs_cache_set_enable(ctx, false);
+    const auto ref = transform();
+    ASSERT_NE(ref.xyzt.x, HUGE_VAL);
+    proj_crs_to_crs_cache_set_enable(ctx, true);
+
+    // Miss: the candidate operations are stored
+    auto res = transform();
+    EXPECT_EQ(res.xyzt.x, ref.xyzt.x);
+    EXPECT_EQ(res.xyzt.y, ref.xyzt.y);
+    EXPECT_EQ(getCrsToCrsCacheColumn(
+                  cacheFilename, "SELECT COUNT(*) FROM crs_to_crs_cache"),
+              "1");
+    const auto operations = getCrsToCrsCacheColumn(
+        cacheFilename, "SELECT operations FROM crs_to_crs_cache");
+    EXPECT_TRUE(operations.find("\"type\":") != std::string::npos)
+        << operations;
+
+    // Hit: the candidate operations are read from the cache. A recomputation
+    // would have overwritten compute_time.
+    execCrsToCrsCacheSQL(
+        cacheFilename, "UPDATE crs_to_crs_cache SET compute_time = 999999999");
+    res = transform();
+    EXPECT_EQ(res.xyzt.x, ref.xyzt.x);
+    EXPECT_EQ(res.xyzt.y, ref.xyzt.y);
+    EXPECT_EQ(getCrsToCrsCacheColumn(
+                  cacheFilename, "SELECT compute_time FROM crs_to_crs_cache"),
+              "999999999");
+
+    // Hit whose parsing takes longer than the original computation: the
+    // entry is turned into a "not worth caching" marker
+    execCrsToCrsCacheSQL(cacheFilename,
+                         "UPDATE crs_to_crs_cache SET compute_time = 0");
+    res = transform();
+    EXPECT_EQ(res.xyzt.x, ref.xyzt.x);
+    EXPECT_EQ(getCrsToCrsCacheColumn(cacheFilename,
+                                     "SELECT operations FROM crs_to_crs_cache"),
+              "<null>");
+    res = transform();
+    EXPECT_EQ(res.xyzt.x, ref.xyzt.x);
+
+    // Entry computed with another database or set of grids: recomputed
+    execCrsToCrsCacheSQL(cacheFilename,
+                         "UPDATE crs_to_crs_cache SET fingerprint = 'stale'");
+    res = transform();
+    EXPECT_EQ(res.xyzt.x, ref.xyzt.x);
+    EXPECT_NE(getCrsToCrsCacheColumn(
+                  cacheFilename, "SELECT fingerprint FROM crs_to_crs_cache"),
+              "stale");
+    EXPECT_EQ(getCrsToCrsCacheColumn(cacheFilename,
+                                     "SELECT operations FROM crs_to_crs_cache"),
+              operations);
+
+    // Different options are different entries
+    {
+        const char *const options[] = {"ALLOW_BALLPARK=NO", nullptr};
+        auto src = proj_create(ctx, "EPSG:4267");
+        ObjectKeeper keeper_src(src);
+        auto dst = proj_create(ctx, "EPSG:4269");
+        ObjectKeeper keeper_dst(dst);
+        auto P = proj_create_crs_to_crs_from_pj(ctx, src, dst, nullptr, options);
+        ObjectKeeper keeper_P(P);
+    }
+    EXPECT_GE(std::stoi(getCrsToCrsCacheColumn(
+                  cacheFilename, "SELECT COUNT(*) FROM crs_to_crs_cache")),
+              2);
+
+    // Closes the cache
+    proj_crs_to_crs_cache_set_enable(ctx, false);
+    std::remove(cacheFilename.c_str());
+}
+
+// ---------------------------------------------------------------------------
+
+#if !defined(_WIN32)
+TEST_F(CApi, proj_crs_to_crs_cache_in_user_writable_directory) {
+    // By default, the cache is in the user writable directory, which is also
+    // searched for grids. Writes to the cache change the modification time
+    // of that directory, which must not invalidate the entries for the
+    // next context or process.
+    const std::string dirname("./proj_test_crs_to_crs_cache_tmp");
+    const std::string cacheFilename(dirname + "/crs_to_crs_cache.db");
+    std::remove(cacheFilename.c_str());
+    putenv(const_cast<char *>("PROJ_SKIP_READ_USER_WRITABLE_DIRECTORY="));
+
+    const auto createCrsToCrs = [&dirname]() {
+        auto ctx = proj_context_create();
+        proj_context_set_user_writable_directory(ctx, dirname.c_str(), true);
+        proj_crs_to_crs_cache_set_enable(ctx, true);
+        auto P = proj_create_crs_to_crs(ctx, "EPSG:4267", "EPSG:4269", nullptr);
+        const bool ok = P != nullptr;
+        proj_destroy(P);
+        proj_context_destroy(ctx);
+        return ok;
+    };
+
+    EXPECT_TRUE(createCrsToCrs());
+    const auto fingerprint = getCrsToCrsCacheColumn(
+        cacheFilename, "SELECT fingerprint FROM crs_to_crs_cache");
+    EXPECT_TRUE(fingerprint.find(dirname) != std::string::npos)
+        << fingerprint;
+
+    // Mark the entry, and change the modification time of the directory
+    execCrsToCrsCacheSQL(
+        cacheFilename, "UPDATE crs_to_crs_cache SET compute_time = 999999999");
+    struct utimbuf times;
+    times.actime = 1000000000;
+    times.modtime = 1000000000;
+    EXPECT_EQ(utime(dirname.c_str(), &times), 0);
+
+    // Hit: the entry is neither stale nor recomputed
+    EXPECT_TRUE(createCrsToCrs());
+    EXPECT_EQ(getCrsToCrsCacheColumn(
+                  cacheFilename, "SELECT fingerprint FROM crs_to_crs_cache"),
+              fingerprint);
+    EXPECT_EQ(getCrsToCrsCacheColumn(
+                  cacheFilename, "SELECT compute_time FROM crs_to_crs_cache"),
+              "999999999");
+
+    putenv(const_cast<char *>("PROJ_SKIP_READ_USER_WRITABLE_DIRECTORY=YES"));
+    std::remove(cacheFilename.c_str());
+    std::remove(dirname.c_str());
+}
+#endif
+
+// ---------------------------------------------------------------------------
+
 TEST_F(CApi, proj_create_crs_to_crs_coordinate_metadata_in_src) {
 
     auto P =
@@ -6751,6 +7023,210 @@ TEST_F(CApi, proj_trans_bounds_world_geodetic_to_spilhaus) {
 
 // ---------------------------------------------------------------------------
 
+TEST_F(CApi, proj_trans_bounds_adaptive) {
+    auto P =
+        proj_create_crs_to_crs(m_ctxt, "EPSG:4326",
+                               "+proj=laea +lat_0=45 +lon_0=-100 +x_0=0 +y_0=0 "
+                               "+a=6370997 +b=6370997 +units=m +no_defs",
+                               nullptr);
+    ObjectKeeper keeper_P(P);
+    ASSERT_NE(P, nullptr);
+    double out_left;
+    double out_bottom;
+    double out_right;
+    double out_top;
+    int point_count = 0;
+    int success = proj_trans_bounds_adaptive(
+        m_ctxt, P, PJ_FWD, 40, -120, 64, -80, &out_left, &out_bottom,
+        &out_right, &out_top, 1.0, &point_count);
+    EXPECT_TRUE(success == 1);
+    EXPECT_NEAR(out_left, -1684649.41338, 1);
+    // proj_trans_bounds(..., 10000) gives -555797.97004
+    EXPECT_NEAR(out_bottom, -555797.97209, 1);
+    EXPECT_NEAR(out_right, 1684649.41338, 1);
+    EXPECT_NEAR(out_top, 2234551.18559, 1);
+    // Much less than with proj_trans_bounds(..., 100)
+    EXPECT_GT(point_count, 12);
+    EXPECT_LT(point_count, 404);
+
+    // A looser tolerance needs less points
+    int point_count_coarse = 0;
+    success = proj_trans_bounds_adaptive(
+        m_ctxt, P, PJ_FWD, 40, -120, 64, -80, &out_left, &out_bottom,
+        &out_right, &out_top, 1000.0, &point_count_coarse);
+    EXPECT_TRUE(success == 1);
+    EXPECT_LT(point_count_coarse, point_count);
+    EXPECT_NEAR(out_bottom, -555797.97209, 1000);
+
+    // Invalid tolerance
+    EXPECT_EQ(proj_trans_bounds_adaptive(m_ctxt, P, PJ_FWD, 40, -120, 64, -80,
+                                         &out_left, &out_bottom, &out_right,
+                                         &out_top, 0.0, nullptr),
+              0);
+}
+
+// ---------------------------------------------------------------------------
+
+TEST_F(CApi, proj_trans_bounds_adaptive_antimeridian) {
+    auto P = proj_create_crs_to_crs(m_ctxt, "EPSG:4167", "EPSG:3851", nullptr);
+    ObjectKeeper keeper_P(P);
+    ASSERT_NE(P, nullptr);
+    double out_left;
+    double out_bottom;
+    double out_right;
+    double out_top;
+    int success = proj_trans_bounds_adaptive(
+        m_ctxt, P, PJ_FWD, -55.95, 160.6, -25.88, -171.2, &out_left,
+        &out_bottom, &out_right, &out_top, 1.0, nullptr);
+    EXPECT_TRUE(success == 1);
+    EXPECT_NEAR(out_left, 5228058.6143420935, 1);
+    EXPECT_NEAR(out_bottom, 1722483.900174921, 1);
+    // proj_trans_bounds(..., 10000) gives 8692678.1064
+    EXPECT_NEAR(out_right, 8692678.0363, 1);
+    EXPECT_NEAR(out_top, 4624385.4948085546, 1);
+    double out_left_inv;
+    double out_bottom_inv;
+    double out_right_inv;
+    double out_top_inv;
+    int success_inv = proj_trans_bounds_adaptive(
+        m_ctxt, P, PJ_INV, 5228058.6143420935, 1722483.900174921,
+        8692574.544944234, 4624385.494808555, &out_left_inv, &out_bottom_inv,
+        &out_right_inv, &out_top_inv, 1e-6, nullptr);
+    EXPECT_TRUE(success_inv == 1);
+    EXPECT_NEAR(out_left_inv, -56.7471249, 1);
+    EXPECT_NEAR(out_bottom_inv, 153.2799922, 1);
+    EXPECT_NEAR(out_right_inv, -24.6148194, 1);
+    EXPECT_NEAR(out_top_inv, -162.1813873, 1);
+}
+
+// ---------------------------------------------------------------------------
+
+TEST_F(CApi, proj_trans_bounds_adaptive_north_pole) {
+    auto P = proj_create_crs_to_crs(m_ctxt, "EPSG:32661", "EPSG:4326", nullptr);
+    ObjectKeeper keeper_P(P);
+    ASSERT_NE(P, nullptr);
+    double out_left;
+    double out_bottom;
+    double out_right;
+    double out_top;
+    int success = proj_trans_bounds_adaptive(
+        m_ctxt, P, PJ_FWD, -1405880.71737131, -1371213.7625429356,
+        5405880.71737131, 5371213.762542935, &out_left, &out_bottom,
+        &out_right, &out_top, 1e-6, nullptr);
+    EXPECT_TRUE(success == 1);
+    EXPECT_NEAR(out_left, 48.656, 1);
+    EXPECT_NEAR(out_bottom, -180.0, 1);
+    EXPECT_NEAR(out_right, 90.0, 1);
+    EXPECT_NEAR(out_top, 180.0, 1);
+}
+
+// ---------------------------------------------------------------------------
+
+TEST_F(CApi, proj_trans_bounds_adaptive_world_geodetic_to_spilhaus) {
+    auto P = proj_create_crs_to_crs(m_ctxt, "OGC:CRS84", "ESRI:54099", nullptr);
+    ObjectKeeper keeper_P(P);
+    ASSERT_NE(P, nullptr);
+    double out_left;
+    double out_bottom;
+    double out_right;
+    double out_top;
+    int success = proj_trans_bounds_adaptive(
+        m_ctxt, P, PJ_FWD, -180.0, -90.0, 180.0, 90.0, &out_left, &out_bottom,
+        &out_right, &out_top, 1.0, nullptr);
+    EXPECT_TRUE(success == 1);
+    // The extremes are inside the image of the boundary.
+    // proj_trans_bounds(..., 400) gives -16691317.1, -16691452.6,
+    // 16691440.1, 16690584.8
+    EXPECT_NEAR(out_left, -16690510.5, 10);
+    EXPECT_NEAR(out_bottom, -16690562.8, 10);
+    EXPECT_NEAR(out_right, 16691494.4, 10);
+    EXPECT_NEAR(out_top, 16690747.1, 10);
+}
+
+// ---------------------------------------------------------------------------
+
+static void
+check_trans_bounds_grid(PJ_CONTEXT *ctx, PJ *P, PJ_DIRECTION direction,
+                        double x_origin, double y_origin, double cell_width,
+                        double cell_height, int rows, int cols,
+                        int densify_pts, int max_threads, double tolerance) {
+    std::vector<double> bounds(rows * cols * 4);
+    EXPECT_EQ(proj_trans_bounds_grid(ctx, P, direction, x_origin, y_origin,
+                                     cell_width, cell_height, rows, cols,
+                                     bounds.data(), densify_pts, max_threads),
+              1);
+    for (int row = 0; row < rows; ++row) {
+        for (int col = 0; col < cols; ++col) {
+            double out_left;
+            double out_bottom;
+            double out_right;
+            double out_top;
+            EXPECT_EQ(proj_trans_bounds(ctx, P, direction,
+                                        x_origin + col * cell_width,
+                                        y_origin + row * cell_height,
+                                        x_origin + (col + 1) * cell_width,
+                                        y_origin + (row + 1) * cell_height,
+                                        &out_left, &out_bottom, &out_right,
+                                        &out_top, densify_pts),
+                      1);
+            const double *cell = &bounds[(row * cols + col) * 4];
+            EXPECT_NEAR(cell[0], out_left, tolerance) << row << " " << col;
+            EXPECT_NEAR(cell[1], out_bottom, tolerance) << row << " " << col;
+            EXPECT_NEAR(cell[2], out_right, tolerance) << row << " " << col;
+            EXPECT_NEAR(cell[3], out_top, tolerance) << row << " " << col;
+        }
+    }
+}
+
+// ---------------------------------------------------------------------------
+
+TEST_F(CApi, proj_trans_bounds_grid) {
+    auto P =
+        proj_create_crs_to_crs(m_ctxt, "EPSG:4326",
+                               "+proj=laea +lat_0=45 +lon_0=-100 +x_0=0 +y_0=0 "
+                               "+a=6370997 +b=6370997 +units=m +no_defs",
+                               nullptr);
+    ObjectKeeper keeper_P(P);
+    ASSERT_NE(P, nullptr);
+    check_trans_bounds_grid(m_ctxt, P, PJ_FWD, 30, -130, 10, 15, 3, 4, 21, 1,
+                            1e-3);
+    check_trans_bounds_grid(m_ctxt, P, PJ_FWD, 30, -130, 10, 15, 3, 4, 21, 3,
+                            1e-3);
+    check_trans_bounds_grid(m_ctxt, P, PJ_INV, -2e6, -1e6, 5e5, 5e5, 5, 7, 2,
+                            4, 1e-9);
+
+    // Invalid grid
+    double bounds[4];
+    EXPECT_EQ(proj_trans_bounds_grid(m_ctxt, P, PJ_FWD, 30, -130, 10, 15, 0,
+                                     1, bounds, 21, 1),
+              0);
+    EXPECT_EQ(proj_trans_bounds_grid(m_ctxt, P, PJ_FWD, 30, -130, -10, 15, 1,
+                                     1, bounds, 21, 1),
+              0);
+}
+
+// ---------------------------------------------------------------------------
+
+TEST_F(CApi, proj_trans_bounds_grid_geographic_output) {
+    // Tiles of the whole web mercator extent
+    auto P = proj_create_crs_to_crs(m_ctxt, "EPSG:3857", "EPSG:4326", nullptr);
+    ObjectKeeper keeper_P(P);
+    ASSERT_NE(P, nullptr);
+    const double extent = 20037508.342789244;
+    check_trans_bounds_grid(m_ctxt, P, PJ_FWD, -extent, -extent, extent / 2,
+                            extent / 2, 4, 4, 21, 2, 1e-9);
+
+    // Cells around the north pole
+    auto P_polar =
+        proj_create_crs_to_crs(m_ctxt, "EPSG:32661", "EPSG:4326", nullptr);
+    ObjectKeeper keeper_P_polar(P_polar);
+    ASSERT_NE(P_polar, nullptr);
+    check_trans_bounds_grid(m_ctxt, P_polar, PJ_FWD, 1e6, 1e6, 6e5, 6e5, 3, 3,
+                            21, 1, 1e-9);
+}
+
+// ---------------------------------------------------------------------------
+
 TEST_F(CApi, proj_trans_bounds_3d_densify_0_geog3D_to_proj2D) {
     auto P =
         proj_create_crs_to_crs(m_ctxt, "EPSG:4979",
@@ -7092,6 +7568,45 @@ TEST_F(CApi, concurrent_context) {
     proj_cleanup();
 }
 
+// ---------------------------------------------------------------------------
+
+TEST_F(CApi, proj_operation_plan_concurrent_handles) {
+    // NAD27 to NAD83
+    auto obj =
+        proj_create_crs_to_crs(m_ctxt, "EPSG:4267", "EPSG:4269", nullptr);
+    ObjectKeeper keeper(obj);
+    ASSERT_NE(obj, nullptr);
+    PJ_COORD c;
+    c.xyzt.x = 40.5;
+    c.xyzt.y = -60;
+    c.xyzt.z = 0;
+    c.xyzt.t = 2021;
+    const PJ_COORD c_trans_ref = proj_trans(obj, PJ_FWD, c);
+
+    auto plan = proj_operation_plan_create(m_ctxt, obj);
+    ASSERT_NE(plan, nullptr);
+
+    std::vector<std::thread> threads;
+    for (int i = 0; i < 4; i++) {
+        threads.emplace_back(std::thread([plan, c, c_trans_ref] {
+            PJ_CONTEXT *ctxt = proj_context_create();
+            for (int j = 0; j < 20; j++) {
+                auto handle = proj_operation_plan_create_handle(ctxt, plan);
+                ObjectKeeper keeperHandle(handle);
+                ASSERT_NE(handle, nullptr);
+                PJ_COORD c_trans = proj_trans(handle, PJ_FWD, c);
+                EXPECT_EQ(c_trans.xyzt.x, c_trans_ref.xyzt.x);
+                EXPECT_EQ(c_trans.xyzt.y, c_trans_ref.xyzt.y);
+            }
+            proj_context_destroy(ctxt);
+        }));
+    }
+    for (auto &t : threads) {
+        t.join();
+    }
+    proj_operation_plan_destroy(plan);
+}
+
 #endif // __MINGW32__
 
 // ---------------------------------------------------------------------------
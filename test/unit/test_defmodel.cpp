@@ -35,6 +35,10 @@
 #include "proj.h"
 #include "proj_internal.h"
 
+#include <array>
+#include <cmath>
+#include <vector>
+
 // Silence C4702 (unreachable code) due to some dummy implementation of the
 // interfaces of defmodel.hpp
 #ifdef _MSC_VER
@@ -1513,6 +1517,320 @@ TEST(defmodel, evaluator_projected_crs) {
     }
 }
 
+// ---------------------------------------------------------------------------
+
+TEST(defmodel, evaluator_inverse_newton) {
+
+    json j(getMinValidContent());
+    j["horizontal_offset_method"] = "addition";
+    j["vertical_offset_unit"] = "metre";
+    constexpr double gridMinX = 170;
+    constexpr double gridMinY = -45;
+    constexpr double gridResX = 0.1;
+    constexpr double gridResY = 0.1;
+    constexpr int gridWidth = 21;
+    constexpr int gridHeight = 21;
+    j["components"] = {
+        {{"displacement_type", "3d"},
+         {"uncertainty_type", "none"},
+         {"extent",
+          {{"type", "bbox"},
+           {"parameters",
+            {{"bbox",
+              {gridMinX, gridMinY, gridMinX + (gridWidth - 1) * gridResX,
+               gridMinY + (gridHeight - 1) * gridResY}}}}}},
+         {"spatial_model",
+          {
+              {"type", "GeoTIFF"},
+              {"interpolation_method", "bilinear"},
+              {"filename", "bla.tif"},
+          }},
+         {"time_function", {{"type", "constant"}}}}};
+
+    // Smooth, non-linear, offsets
+    struct Grid : public GridPrototype {
+        static double offsetX(int ix, int iy) {
+            return std::sin(ix * 0.3) + 0.02 * ix * iy;
+        }
+        static double offsetY(int ix, int iy) {
+            return std::cos(iy * 0.2) - 0.03 * ix;
+        }
+        static double offsetZ(int ix, int iy) { return 0.1 * (ix - iy); }
+
+        bool getLongLatZOffset(int ix, int iy, double &longOffsetRadian,
+                               double &latOffsetRadian, double &zOffset) const {
+            longOffsetRadian = DegToRad(1e-3 * offsetX(ix, iy));
+            latOffsetRadian = DegToRad(1e-3 * offsetY(ix, iy));
+            zOffset = offsetZ(ix, iy);
+            return true;
+        }
+
+        bool getEastingNorthingZOffset(int ix, int iy, double &eastingOffset,
+                                       double &northingOffset,
+                                       double &zOffset) const {
+            eastingOffset = 100 * offsetX(ix, iy);
+            northingOffset = 100 * offsetY(ix, iy);
+            zOffset = offsetZ(ix, iy);
+            return true;
+        }
+
+#ifdef DEBUG_DEFMODEL
+        std::string name() const { return std::string(); }
+#endif
+    };
+
+    struct GridSet : public GridSetPrototype<Grid> {
+
+        Grid grid{};
+        int *gridAtCount = nullptr;
+
+        GridSet() {
+            grid.minx = DegToRad(gridMinX);
+            grid.miny = DegToRad(gridMinY);
+            grid.resx = DegToRad(gridResX);
+            grid.resy = DegToRad(gridResY);
+            grid.width = gridWidth;
+            grid.height = gridHeight;
+        }
+
+        const Grid *gridAt(double /*x */, double /* y */) {
+            ++(*gridAtCount);
+            return &grid;
+        }
+    };
+
+    struct EvaluatorIface : public EvaluatorIfacePrototype<Grid, GridSet> {
+        // Number of evaluations of the spatial model
+        int gridAtCount = 0;
+
+        std::unique_ptr<GridSet> open(const std::string &filename) {
+            if (filename != "bla.tif")
+                return nullptr;
+            auto gridSet = std::unique_ptr<GridSet>(new GridSet());
+            gridSet->gridAtCount = &gridAtCount;
+            return gridSet;
+        }
+
+        bool isGeographicCRS(const std::string & /* crsDef */) { return true; }
+
+#ifdef DEBUG_DEFMODEL
+        void log(const std::string & /* msg */) {}
+#endif
+    };
+
+    constexpr double a = 6378137;
+    constexpr double b = 6356752.314140;
+    constexpr double tValid = 2018;
+    constexpr double zVal = 100;
+    constexpr int pointCount = 100;
+
+    for (const char *unit : {"degree", "metre"}) {
+        j["horizontal_offset_unit"] = unit;
+
+        EvaluatorIface iface;
+        Evaluator<Grid, GridSet, EvaluatorIface> eval(
+            MasterFile::parse(j.dump()), iface, a, b);
+
+        // Source points, distributed over the grid, and their forward
+        // transformation
+        std::vector<std::array<double, 3>> srcPoints;
+        std::vector<std::array<double, 3>> dstPoints;
+        for (int i = 0; i < pointCount; ++i) {
+            const double longitude = gridMinX + 0.05 + 0.0191 * i;
+            const double lat = gridMinY + 0.05 + 0.0187 * ((i * 37) % 100);
+            srcPoints.push_back({DegToRad(longitude), DegToRad(lat), zVal});
+            std::array<double, 3> dst;
+            EXPECT_TRUE(eval.forward(iface, DegToRad(longitude), DegToRad(lat),
+                                     zVal, tValid, dst[0], dst[1], dst[2]));
+            dstPoints.push_back(dst);
+        }
+
+        int gridAtCount[2] = {0, 0};
+        double maxError[2] = {0, 0};
+        const InverseMethod methods[] = {InverseMethod::FIXED_POINT,
+                                         InverseMethod::NEWTON};
+        for (int iMethod = 0; iMethod < 2; ++iMethod) {
+            eval.setInverseMethod(methods[iMethod]);
+            iface.gridAtCount = 0;
+            for (int i = 0; i < pointCount; ++i) {
+                double invLongitude;
+                double invLat;
+                double invZ;
+                EXPECT_TRUE(eval.inverse(iface, dstPoints[i][0],
+                                         dstPoints[i][1], dstPoints[i][2],
+                                         tValid, invLongitude, invLat, invZ));
+                EXPECT_NEAR(invZ, zVal, 1e-3);
+                maxError[iMethod] = std::max(
+                    maxError[iMethod],
+                    std::max(std::fabs(invLongitude - srcPoints[i][0]),
+                             std::fabs(invLat - srcPoints[i][1])));
+            }
+            gridAtCount[iMethod] = iface.gridAtCount;
+        }
+
+        // Both methods converge to the same accuracy
+        EXPECT_LT(RadToDeg(maxError[0]), 1e-10) << unit;
+        EXPECT_LT(RadToDeg(maxError[1]), 1e-10) << unit;
+
+        // Newton needs 2 evaluations of the model for most points (points
+        // whose inverse is in another grid cell may need one more), and
+        // less than fixed-point iteration.
+        EXPECT_LE(gridAtCount[1], 2 * pointCount + pointCount / 10) << unit;
+        EXPECT_LT(gridAtCount[1], gridAtCount[0]) << unit;
+    }
+}
+
+// ---------------------------------------------------------------------------
+
+TEST(defmodel, evaluator_many_components) {
+
+    // A model-wide component, and 10x10 patches of 1 degree, whose time
+    // function is a step for even patches.
+    json j(getMinValidContent());
+    j["horizontal_offset_method"] = "addition";
+    j["horizontal_offset_unit"] = "degree";
+    constexpr double patchMinX = 170;
+    constexpr double patchMinY = -45;
+    constexpr int patchCount = 10;
+    constexpr double stepEpoch = 2015;
+    json jComponents = json::array();
+    const auto getComponent = [](const std::string &filename, double minx,
+                                 double miny, double maxx, double maxy,
+                                 const json &jTimeFunction) {
+        return json{{"displacement_type", "horizontal"},
+                    {"uncertainty_type", "none"},
+                    {"extent",
+                     {{"type", "bbox"},
+                      {"parameters", {{"bbox", {minx, miny, maxx, maxy}}}}}},
+                    {"spatial_model",
+                     {
+                         {"type", "GeoTIFF"},
+                         {"interpolation_method", "bilinear"},
+                         {"filename", filename},
+                     }},
+                    {"time_function", jTimeFunction}};
+    };
+    jComponents.push_back(getComponent("all.tif", modelMinX, modelMinY,
+                                       modelMaxX, modelMaxY,
+                                       {{"type", "constant"}}));
+    for (int iy = 0; iy < patchCount; ++iy) {
+        for (int ix = 0; ix < patchCount; ++ix) {
+            const int i = iy * patchCount + ix;
+            jComponents.push_back(getComponent(
+                std::to_string(i) + ".tif", patchMinX + ix, patchMinY + iy,
+                patchMinX + ix + 1, patchMinY + iy + 1,
+                (i % 2) == 0 ? json{{"type", "step"},
+                                    {"parameters",
+                                     {{"step_epoch", "2015-01-01T00:00:00Z"}}}}
+                             : json{{"type", "constant"}}));
+        }
+    }
+    j["components"] = std::move(jComponents);
+
+    // Grids with a constant longitude offset of 1e-3 degree for the
+    // model-wide component, and (index + 1) * 1e-6 degree for patches.
+    struct Grid : public GridPrototype {
+        double longOffset = 0;
+
+        bool getLongLatOffset(int, int, double &longOffsetRadian,
+                              double &latOffsetRadian) const {
+            longOffsetRadian = DegToRad(longOffset);
+            latOffsetRadian = 0;
+            return true;
+        }
+
+#ifdef DEBUG_DEFMODEL
+        std::string name() const { return std::string(); }
+#endif
+    };
+
+    struct GridSet : public GridSetPrototype<Grid> {
+
+        Grid grid{};
+        int *gridAtCount = nullptr;
+
+        const Grid *gridAt(double /*x */, double /* y */) {
+            ++(*gridAtCount);
+            return &grid;
+        }
+    };
+
+    struct EvaluatorIface : public EvaluatorIfacePrototype<Grid, GridSet> {
+        int gridAtCount = 0;
+
+        std::unique_ptr<GridSet> open(const std::string &filename) {
+            auto gridSet = std::unique_ptr<GridSet>(new GridSet());
+            if (filename == "all.tif") {
+                gridSet->grid.minx = DegToRad(modelMinX);
+                gridSet->grid.miny = DegToRad(modelMinY);
+                gridSet->grid.resx = DegToRad(modelMaxX - modelMinX);
+                gridSet->grid.resy = DegToRad(modelMaxY - modelMinY);
+                gridSet->grid.longOffset = 1e-3;
+            } else {
+                const int i = std::stoi(filename);
+                gridSet->grid.minx = DegToRad(patchMinX + i % patchCount);
+                gridSet->grid.miny = DegToRad(patchMinY + i / patchCount);
+                gridSet->grid.resx = DegToRad(1);
+                gridSet->grid.resy = DegToRad(1);
+                gridSet->grid.longOffset = (i + 1) * 1e-6;
+            }
+            gridSet->grid.width = 2;
+            gridSet->grid.height = 2;
+            gridSet->gridAtCount = &gridAtCount;
+            return gridSet;
+        }
+
+        bool isGeographicCRS(const std::string & /* crsDef */) { return true; }
+
+#ifdef DEBUG_DEFMODEL
+        void log(const std::string & /* msg */) {}
+#endif
+    };
+
+    EvaluatorIface iface;
+    Evaluator<Grid, GridSet, EvaluatorIface> eval(MasterFile::parse(j.dump()),
+                                                  iface, 1, 1);
+
+    for (const double t : {stepEpoch - 1, stepEpoch + 1}) {
+        for (int iy = 0; iy < patchCount; ++iy) {
+            for (int ix = 0; ix < patchCount; ++ix) {
+                const int i = iy * patchCount + ix;
+                const double longitude = patchMinX + ix + 0.5;
+                const double lat = patchMinY + iy + 0.5;
+                iface.gridAtCount = 0;
+                double newLong;
+                double newLat;
+                double newZ;
+                EXPECT_TRUE(eval.forward(iface, DegToRad(longitude),
+                                         DegToRad(lat), 0, t, newLong, newLat,
+                                         newZ));
+                const bool patchActive = (i % 2) != 0 || t > stepEpoch;
+                const double expectedOffset =
+                    1e-3 + (patchActive ? (i + 1) * 1e-6 : 0);
+                EXPECT_NEAR(RadToDeg(newLong), longitude + expectedOffset,
+                            1e-10);
+                EXPECT_NEAR(RadToDeg(newLat), lat, 1e-10);
+                // Only the relevant components are evaluated
+                EXPECT_EQ(iface.gridAtCount, patchActive ? 2 : 1);
+            }
+        }
+    }
+
+    // Outside of the patches
+    {
+        const double longitude = patchMinX - 0.5;
+        const double lat = patchMinY - 0.5;
+        iface.gridAtCount = 0;
+        double newLong;
+        double newLat;
+        double newZ;
+        EXPECT_TRUE(eval.forward(iface, DegToRad(longitude), DegToRad(lat), 0,
+                                 stepEpoch + 1, newLong, newLat, newZ));
+        EXPECT_NEAR(RadToDeg(newLong), longitude + 1e-3, 1e-10);
+        EXPECT_EQ(iface.gridAtCount, 1);
+    }
+}
+
 } // namespace
 
 #ifdef _MSC_VER
@@ -3942,6 +3942,45 @@ TEST(factory, getMetadata) {
 
 // ---------------------------------------------------------------------------
 
+TEST(factory, getQueryStatistics) {
+    auto ctxt = DatabaseContext::create();
+    auto factory = AuthorityFactory::create(ctxt, "EPSG");
+
+    // Not collected by default
+    factory->createCoordinateReferenceSystem("4326");
+    EXPECT_TRUE(ctxt->getQueryStatistics().empty());
+
+    ctxt->setQueryStatisticsEnabled(true);
+    const auto queryCounterBefore = ctxt->getQueryCounter();
+    for (const char *code : {"4258", "4269", "32631", "2154"}) {
+        factory->createCoordinateReferenceSystem(code);
+    }
+
+    const auto stats = ctxt->getQueryStatistics();
+    ASSERT_FALSE(stats.empty());
+    unsigned int executionCount = 0;
+    bool foundReusedStatement = false;
+    for (const auto &stat : stats) {
+        EXPECT_FALSE(stat.sql.empty());
+        EXPECT_GE(stat.executionCount, 1U);
+        // Each statement is prepared at most once, and then reused
+        EXPECT_LE(stat.preparedStatementHitCount, stat.executionCount)
+            << stat.sql;
+        EXPECT_GE(stat.preparedStatementHitCount + 1, stat.executionCount)
+            << stat.sql;
+        if (stat.preparedStatementHitCount > 0)
+            foundReusedStatement = true;
+        executionCount += stat.executionCount;
+    }
+    EXPECT_TRUE(foundReusedStatement);
+    EXPECT_EQ(executionCount, ctxt->getQueryCounter() - queryCounterBefore);
+    for (size_t i = 1; i < stats.size(); ++i) {
+        EXPECT_GE(stats[i - 1].totalTimeUs, stats[i].totalTimeUs);
+    }
+}
+
+// ---------------------------------------------------------------------------
+
 TEST(factory, listAreaOfUseFromName) {
     auto ctxt = DatabaseContext::create();
     auto factory = AuthorityFactory::create(ctxt, std::string());
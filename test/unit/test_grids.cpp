@@ -32,6 +32,13 @@
 
 #include "proj_internal.h" // M_PI
 
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <limits>
+#include <string>
+#include <vector>
+
 namespace {
 
 // ---------------------------------------------------------------------------
@@ -117,6 +124,141 @@ TEST_F(GridTest, HorizontalShiftGridSet_null) {
 
 // ---------------------------------------------------------------------------
 
+static void writeNTv2Record(FILE *f, const char *key, const void *value,
+                            size_t valueSize) {
+    char record[16] = {};
+    memcpy(record, key, strlen(key));
+    memset(record + strlen(key), ' ', 8 - strlen(key));
+    memcpy(record + 8, value, valueSize);
+    fwrite(record, 1, sizeof(record), f);
+}
+
+static void writeNTv2Name(FILE *f, const char *key, const char *name) {
+    char value[8];
+    memset(value, ' ', sizeof(value));
+    memcpy(value, name, strlen(name));
+    writeNTv2Record(f, key, value, sizeof(value));
+}
+
+static void writeNTv2Double(FILE *f, const char *key, double value) {
+    writeNTv2Record(f, key, &value, sizeof(value));
+}
+
+static void writeNTv2Int(FILE *f, const char *key, int value) {
+    writeNTv2Record(f, key, &value, sizeof(value));
+}
+
+// Write a subgrid of a NTv2 file, with extent in degrees, positive east.
+static void writeNTv2Subgrid(FILE *f, const char *name, const char *parent,
+                             double west, double south, double east,
+                             double north, double res) {
+    writeNTv2Name(f, "SUB_NAME", name);
+    writeNTv2Name(f, "PARENT", parent);
+    writeNTv2Name(f, "CREATED", "");
+    writeNTv2Name(f, "UPDATED", "");
+    writeNTv2Double(f, "S_LAT", south * 3600);
+    writeNTv2Double(f, "N_LAT", north * 3600);
+    writeNTv2Double(f, "E_LONG", -east * 3600);
+    writeNTv2Double(f, "W_LONG", -west * 3600);
+    writeNTv2Double(f, "LAT_INC", res * 3600);
+    writeNTv2Double(f, "LONG_INC", res * 3600);
+    const int columns = static_cast<int>((east - west) / res + 0.5) + 1;
+    const int rows = static_cast<int>((north - south) / res + 0.5) + 1;
+    writeNTv2Int(f, "GS_COUNT", columns * rows);
+    const std::vector<float> data(static_cast<size_t>(4) * columns * rows);
+    fwrite(data.data(), sizeof(float), data.size(), f);
+}
+
+// ---------------------------------------------------------------------------
+
+TEST_F(GridTest, HorizontalShiftGridSet_ntv2_many_subgrids) {
+    const char *tempdir = getenv("TEMP");
+    if (!tempdir) {
+        tempdir = getenv("TMP");
+    }
+    if (!tempdir) {
+        tempdir = "/tmp";
+    }
+    const std::string filename(std::string(tempdir) +
+                               "/test_grids_ntv2_many_subgrids.gsb");
+    FILE *f = fopen(filename.c_str(), "wb");
+    ASSERT_NE(f, nullptr) << filename;
+
+    // 10x10 subgrids of 1 degree covering [0,10]x[40,50], in decreasing
+    // order, and a child of the one at (3,4)
+    constexpr int N = 10;
+    writeNTv2Int(f, "NUM_OREC", 11);
+    writeNTv2Int(f, "NUM_SREC", 11);
+    writeNTv2Int(f, "NUM_FILE", N * N + 1);
+    writeNTv2Name(f, "GS_TYPE", "SECONDS");
+    writeNTv2Name(f, "VERSION", "");
+    writeNTv2Name(f, "SYSTEM_F", "");
+    writeNTv2Name(f, "SYSTEM_T", "");
+    writeNTv2Double(f, "MAJOR_F", 0);
+    writeNTv2Double(f, "MINOR_F", 0);
+    writeNTv2Double(f, "MAJOR_T", 0);
+    writeNTv2Double(f, "MINOR_T", 0);
+    const auto subgridName = [](int i, int j) {
+        return "S" + std::to_string(10 + i) + std::to_string(10 + j);
+    };
+    for (int j = N - 1; j >= 0; --j) {
+        for (int i = N - 1; i >= 0; --i) {
+            writeNTv2Subgrid(f, subgridName(i, j).c_str(), "NONE", i,
+                             40 + j, i + 1, 41 + j, 0.25);
+            if (i == 3 && j == 4) {
+                writeNTv2Subgrid(f, "CHILD", subgridName(i, j).c_str(),
+                                 3.25, 44.25, 3.75, 44.75, 0.125);
+            }
+        }
+    }
+    fclose(f);
+
+    auto gridSet = NS_PROJ::HorizontalShiftGridSet::open(m_ctxt, filename);
+    ASSERT_NE(gridSet, nullptr);
+    EXPECT_EQ(gridSet->grids().size(), static_cast<size_t>(N * N));
+
+    const auto nameAt = [&gridSet](double lonDeg, double latDeg) {
+        auto grid =
+            gridSet->gridAt(lonDeg / 180 * M_PI, latDeg / 180 * M_PI);
+        if (!grid)
+            return std::string();
+        // Name is "filename, SUB_NAME" with SUB_NAME padded to 8 characters
+        const auto &name = grid->name();
+        const auto subName = name.substr(name.rfind(", ") + 2);
+        return subName.substr(0, subName.find(' '));
+    };
+
+    for (int j = 0; j < N; ++j) {
+        for (int i = 0; i < N; ++i) {
+            EXPECT_EQ(nameAt(i + 0.1, 40 + j + 0.1), subgridName(i, j));
+            EXPECT_EQ(nameAt(i + 0.9, 40 + j + 0.9), subgridName(i, j));
+        }
+    }
+
+    // Child takes precedence over its parent
+    EXPECT_EQ(nameAt(3.5, 44.5), "CHILD");
+    EXPECT_EQ(nameAt(3.1, 44.5), subgridName(3, 4));
+
+    // On a shared edge, the first subgrid of the file wins
+    EXPECT_EQ(nameAt(5.0, 45.5), subgridName(5, 5));
+    EXPECT_EQ(nameAt(5.5, 45.0), subgridName(5, 5));
+
+    // Longitude wrapping
+    EXPECT_EQ(nameAt(360 + 0.5, 40.5), subgridName(0, 0));
+    EXPECT_EQ(nameAt(-360 + 9.5, 49.5), subgridName(9, 9));
+
+    // Outside of all subgrids
+    EXPECT_EQ(nameAt(20, 45), std::string());
+    EXPECT_EQ(nameAt(5, 60), std::string());
+    EXPECT_EQ(nameAt(5, std::numeric_limits<double>::quiet_NaN()),
+              std::string());
+
+    gridSet.reset();
+    remove(filename.c_str());
+}
+
+// ---------------------------------------------------------------------------
+
 TEST_F(GridTest, GenericShiftGridSet_null) {
     auto gridSet = NS_PROJ::GenericShiftGridSet::open(m_ctxt, "null");
     ASSERT_NE(gridSet, nullptr);
@@ -339,6 +481,165 @@ TEST_F(GridTest, GenericShiftGridSet_gtiff_projected) {
     EXPECT_EQ(grid->extentAndRes().resY, 1000);
 }
 
+// ---------------------------------------------------------------------------
+
+TEST_F(GridTest, HorizontalShiftGridSet_gtiff_block_layouts) {
+    // Uncompressed blocks are read directly from a memory mapping of the
+    // file, whatever their organization, and compressed ones are decoded by
+    // libtiff. Files opened through a user-provided file API are not mapped,
+    // so their blocks are decoded by libtiff, which gives the reference
+    // values.
+    struct PROJ_FILE_API api;
+    api.version = 1;
+    api.open_cbk = [](PJ_CONTEXT *, const char *filename,
+                      PROJ_OPEN_ACCESS access,
+                      void *) -> PROJ_FILE_HANDLE * {
+        if (access != PROJ_OPEN_ACCESS_READ_ONLY)
+            return nullptr;
+        return reinterpret_cast<PROJ_FILE_HANDLE *>(fopen(filename, "rb"));
+    };
+    api.read_cbk = [](PJ_CONTEXT *, PROJ_FILE_HANDLE *handle, void *buffer,
+                      size_t sizeBytes, void *) -> size_t {
+        return fread(buffer, 1, sizeBytes, reinterpret_cast<FILE *>(handle));
+    };
+    api.write_cbk = [](PJ_CONTEXT *, PROJ_FILE_HANDLE *, const void *, size_t,
+                       void *) -> size_t { return 0; };
+    api.seek_cbk = [](PJ_CONTEXT *, PROJ_FILE_HANDLE *handle, long long offset,
+                      int whence, void *) -> int {
+        return fseek(reinterpret_cast<FILE *>(handle),
+                     static_cast<long>(offset), whence) == 0;
+    };
+    api.tell_cbk = [](PJ_CONTEXT *, PROJ_FILE_HANDLE *handle,
+                      void *) -> unsigned long long {
+        return ftell(reinterpret_cast<FILE *>(handle));
+    };
+    api.close_cbk = [](PJ_CONTEXT *, PROJ_FILE_HANDLE *handle, void *) {
+        fclose(reinterpret_cast<FILE *>(handle));
+    };
+    api.exists_cbk = [](PJ_CONTEXT *, const char *filename, void *) -> int {
+        FILE *f = fopen(filename, "rb");
+        if (f == nullptr)
+            return false;
+        fclose(f);
+        return true;
+    };
+    api.mkdir_cbk = [](PJ_CONTEXT *, const char *, void *) -> int {
+        return false;
+    };
+    api.unlink_cbk = [](PJ_CONTEXT *, const char *, void *) -> int {
+        return false;
+    };
+    api.rename_cbk = [](PJ_CONTEXT *, const char *, const char *,
+                        void *) -> int { return false; };
+    ASSERT_TRUE(proj_context_set_fileapi(m_ctxt2, &api, nullptr));
+
+    const auto checkSameValues = [this](const char *filename,
+                                        bool expectMapped) {
+        auto refGridSet =
+            NS_PROJ::HorizontalShiftGridSet::open(m_ctxt2, filename);
+        ASSERT_NE(refGridSet, nullptr) << filename;
+        auto gridSet = NS_PROJ::HorizontalShiftGridSet::open(m_ctxt, filename);
+        ASSERT_NE(gridSet, nullptr) << filename;
+        auto refGrid = refGridSet->gridAt(5.5 / 180 * M_PI, 53.5 / 180 * M_PI);
+        auto grid = gridSet->gridAt(5.5 / 180 * M_PI, 53.5 / 180 * M_PI);
+        ASSERT_NE(refGrid, nullptr) << filename;
+        ASSERT_NE(grid, nullptr) << filename;
+        ASSERT_EQ(grid->width(), refGrid->width()) << filename;
+        ASSERT_EQ(grid->height(), refGrid->height()) << filename;
+        std::vector<std::pair<float, float>> refValues;
+        for (int y = 0; y < refGrid->height(); ++y) {
+            for (int x = 0; x < refGrid->width(); ++x) {
+                float refLon = 0, refLat = 0;
+                ASSERT_TRUE(refGrid->valueAt(x, y, false, refLon, refLat))
+                    << filename;
+                refValues.emplace_back(refLon, refLat);
+            }
+        }
+
+        // Blocks read from the memory mapping do not go through the cache
+        // of decoded blocks
+        const auto getCacheLookups = [this]() {
+            unsigned long long hits = 0;
+            unsigned long long misses = 0;
+            proj_grid_block_cache_get_stats(m_ctxt, &hits, &misses, nullptr);
+            return hits + misses;
+        };
+        const auto lookupsBefore = getCacheLookups();
+        size_t i = 0;
+        for (int y = 0; y < grid->height(); ++y) {
+            for (int x = 0; x < grid->width(); ++x, ++i) {
+                float lon = -1, lat = -1;
+                ASSERT_TRUE(grid->valueAt(x, y, false, lon, lat)) << filename;
+                ASSERT_EQ(lon, refValues[i].first)
+                    << filename << " " << x << " " << y;
+                ASSERT_EQ(lat, refValues[i].second)
+                    << filename << " " << x << " " << y;
+            }
+        }
+        if (expectMapped)
+            EXPECT_EQ(getCacheLookups(), lookupsBefore) << filename;
+        else
+            EXPECT_GT(getCacheLookups(), lookupsBefore) << filename;
+    };
+    // Contiguous and separate strips
+    checkSameValues("tests/test_hgrid.tif", true);
+    checkSameValues("tests/test_hgrid_strip.tif", true);
+    checkSameValues("tests/test_hgrid_separate.tif", true);
+    // Contiguous and separate tiles, with partial tiles at the right and
+    // bottom edges of the 45x30 grid
+    checkSameValues("tests/test_hgrid_tiled_uncompressed.tif", true);
+    checkSameValues("tests/test_hgrid_tiled_separate_uncompressed.tif", true);
+    // DEFLATE-compressed tiles
+    checkSameValues("tests/test_hgrid_tiled.tif", false);
+    checkSameValues("tests/test_hgrid_tiled_separate.tif", false);
+}
+
+// ---------------------------------------------------------------------------
+
+TEST_F(GridTest, HorizontalShiftGridSet_gtiff_shared_block_cache) {
+    // Start from an empty cache
+    proj_grid_block_cache_set_max_size(m_ctxt, 0);
+    proj_grid_block_cache_set_max_size(m_ctxt, 64);
+
+    const auto readValue = [](PJ_CONTEXT *ctx, unsigned long long &hits,
+                              unsigned long long &misses) {
+        auto gridSet = NS_PROJ::HorizontalShiftGridSet::open(
+            ctx, "tests/test_hgrid_tiled.tif");
+        ASSERT_NE(gridSet, nullptr);
+        auto grid = gridSet->gridAt(5.5 / 180 * M_PI, 53.5 / 180 * M_PI);
+        ASSERT_NE(grid, nullptr);
+        float lon = 0, lat = 0;
+        ASSERT_TRUE(grid->valueAt(1, 1, false, lon, lat));
+        proj_grid_block_cache_get_stats(ctx, &hits, &misses, nullptr);
+    };
+
+    unsigned long long hits0 = 0, misses0 = 0;
+    proj_grid_block_cache_get_stats(m_ctxt, &hits0, &misses0, nullptr);
+
+    // The first read decodes the block
+    unsigned long long hits1 = 0, misses1 = 0;
+    readValue(m_ctxt, hits1, misses1);
+    EXPECT_EQ(hits1, hits0);
+    EXPECT_EQ(misses1, misses0 + 1);
+
+    // Another dataset on the same file, from another context, reuses it
+    auto ctxt2 = proj_context_create();
+    unsigned long long hits2 = 0, misses2 = 0;
+    readValue(ctxt2, hits2, misses2);
+    EXPECT_EQ(hits2, hits1 + 1);
+    EXPECT_EQ(misses2, misses1);
+
+    // Blocks are no longer retained once the cache is disabled
+    proj_grid_block_cache_set_max_size(m_ctxt, 0);
+    unsigned long long hits3 = 0, misses3 = 0;
+    readValue(ctxt2, hits3, misses3);
+    EXPECT_EQ(hits3, hits2);
+    EXPECT_EQ(misses3, misses2 + 1);
+    proj_context_destroy(ctxt2);
+
+    proj_grid_block_cache_set_max_size(m_ctxt, 64);
+}
+
 #endif // TIFF_ENABLED
 
 } // namespace
@@ -885,6 +885,32 @@ TEST(wkt_parse, wkt1_geographic_missing_unit_and_axis) {
 
 // ---------------------------------------------------------------------------
 
+TEST(wkt_parse, wkt1_no_grammar_check) {
+    // Extra "unused" in SPHEROID is only rejected by the WKT1 grammar
+    auto wkt = "GEOGCS[\"WGS 84\","
+               "DATUM[\"WGS_1984\","
+               "SPHEROID[\"WGS 84\",6378137,298.257223563,\"unused\"]],"
+               "PRIMEM[\"Greenwich\",0],"
+               "UNIT[\"degree\",0.0174532925199433]]";
+
+    EXPECT_THROW(WKTParser().createFromWKT(wkt), ParsingException);
+
+    {
+        WKTParser parser;
+        parser.setStrict(false).createFromWKT(wkt);
+        EXPECT_EQ(parser.grammarErrorList().size(), 1U);
+    }
+
+    {
+        WKTParser parser;
+        auto obj = parser.setCheckGrammar(false).createFromWKT(wkt);
+        EXPECT_TRUE(nn_dynamic_pointer_cast<GeographicCRS>(obj) != nullptr);
+        EXPECT_TRUE(parser.grammarErrorList().empty());
+    }
+}
+
+// ---------------------------------------------------------------------------
+
 TEST(wkt_parse, wkt1_geocentric_with_PROJ4_extension) {
     auto wkt = "GEOCCS[\"WGS 84\",\n"
                "    DATUM[\"unknown\",\n"
@@ -28,9 +28,14 @@
 
 #include "gtest_include.h"
 
+#include <algorithm>
 #include <memory>
+#include <mutex>
 #include <stdio.h>
 #include <stdlib.h>
+#include <string.h>
+#include <string>
+#include <vector>
 
 #include "proj_internal.h"
 #include <proj.h>
@@ -1104,6 +1109,155 @@ TEST(networking, simul_file_change_while_opened) {
 
 // ---------------------------------------------------------------------------
 
+// Minimal stand-in of a HTTP server, serving the content of a local file,
+// and recording the requested ranges.
+struct LocalFileServer {
+    std::string url{};
+    std::vector<unsigned char> content{};
+    std::string contentRange{};
+    std::mutex mutex{};
+    std::vector<unsigned long long> requestedOffsets{};
+};
+
+struct LocalFileServerHandle {
+    LocalFileServer *server;
+};
+
+static size_t local_server_read(LocalFileServer *server,
+                                unsigned long long offset, size_t size_to_read,
+                                void *buffer) {
+    std::lock_guard<std::mutex> lock(server->mutex);
+    server->requestedOffsets.push_back(offset);
+    if (offset >= server->content.size())
+        return 0;
+    const size_t size = std::min(
+        size_to_read, static_cast<size_t>(server->content.size() - offset));
+    memcpy(buffer, server->content.data() + offset, size);
+    return size;
+}
+
+static PROJ_NETWORK_HANDLE *
+local_server_open_cbk(PJ_CONTEXT *, const char *url, unsigned long long offset,
+                      size_t size_to_read, void *buffer, size_t *out_size_read,
+                      size_t error_string_max_size, char *out_error_string,
+                      void *user_data) {
+    auto server = static_cast<LocalFileServer *>(user_data);
+    if (server->url != url) {
+        snprintf(out_error_string, error_string_max_size, "Not found");
+        return nullptr;
+    }
+    *out_size_read = local_server_read(server, offset, size_to_read, buffer);
+    return reinterpret_cast<PROJ_NETWORK_HANDLE *>(
+        new LocalFileServerHandle{server});
+}
+
+static void local_server_close_cbk(PJ_CONTEXT *, PROJ_NETWORK_HANDLE *handle,
+                                   void *) {
+    delete reinterpret_cast<LocalFileServerHandle *>(handle);
+}
+
+static const char *
+local_server_get_header_value_cbk(PJ_CONTEXT *, PROJ_NETWORK_HANDLE *handle,
+                                  const char *header_name, void *) {
+    if (strcmp(header_name, "Content-Range") == 0)
+        return reinterpret_cast<LocalFileServerHandle *>(handle)
+            ->server->contentRange.c_str();
+    if (strcmp(header_name, "Last-Modified") == 0)
+        return "some_date";
+    if (strcmp(header_name, "ETag") == 0)
+        return "some_etag";
+    return nullptr;
+}
+
+static size_t local_server_read_range_cbk(PJ_CONTEXT *,
+                                          PROJ_NETWORK_HANDLE *handle,
+                                          unsigned long long offset,
+                                          size_t size_to_read, void *buffer,
+                                          size_t, char *, void *) {
+    return local_server_read(
+        reinterpret_cast<LocalFileServerHandle *>(handle)->server, offset,
+        size_to_read, buffer);
+}
+
+TEST(networking, proj_grid_prefetch_for_area) {
+    LocalFileServer server;
+    server.url = "https://example.com/prefetch/fr_ign_RAGTBT2016.tif";
+    {
+        const char *proj_source_data = getenv("PROJ_SOURCE_DATA");
+        ASSERT_TRUE(proj_source_data != nullptr);
+        std::string filename(proj_source_data);
+        // Single deflate-compressed strip of 32 KB, after 1 KB of headers
+        filename += "/tests/fr_ign_RAGTBT2016.tif";
+        FILE *f = fopen(filename.c_str(), "rb");
+        ASSERT_TRUE(f != nullptr);
+        fseek(f, 0, SEEK_END);
+        server.content.resize(static_cast<size_t>(ftell(f)));
+        fseek(f, 0, SEEK_SET);
+        ASSERT_EQ(fread(server.content.data(), 1, server.content.size(), f),
+                  server.content.size());
+        fclose(f);
+        server.contentRange =
+            "bytes 0-16383/" + std::to_string(server.content.size());
+    }
+
+    auto ctx = proj_context_create();
+    proj_grid_cache_set_enable(ctx, false);
+    proj_context_set_enable_network(ctx, true);
+    ASSERT_TRUE(proj_context_set_network_callbacks(
+        ctx, local_server_open_cbk, local_server_close_cbk,
+        local_server_get_header_value_cbk, local_server_read_range_cbk,
+        &server));
+
+    ASSERT_FALSE(proj_grid_prefetch_for_area(
+        ctx, "https://example.com/prefetch/not_existing.tif", -61.6, 16.1,
+        -61.4, 16.3, 0));
+    server.requestedOffsets.clear();
+
+    // Area outside of the grid: only the headers are read
+    EXPECT_TRUE(proj_grid_prefetch_for_area(ctx, server.url.c_str(), 2, 49, 3,
+                                            50, 0));
+    EXPECT_EQ(server.requestedOffsets,
+              std::vector<unsigned long long>{0});
+    server.requestedOffsets.clear();
+
+    // The 2 chunks of the strip not in the first one are downloaded
+    // concurrently
+    EXPECT_TRUE(proj_grid_prefetch_for_area(ctx, server.url.c_str(), -61.6,
+                                            16.1, -61.4, 16.3, 2));
+    std::sort(server.requestedOffsets.begin(), server.requestedOffsets.end());
+    EXPECT_EQ(server.requestedOffsets,
+              (std::vector<unsigned long long>{16384, 32768}));
+    server.requestedOffsets.clear();
+
+    // Everything is already cached
+    EXPECT_TRUE(proj_grid_prefetch_for_area(ctx, server.url.c_str(), -61.6,
+                                            16.1, -61.4, 16.3, 2));
+    EXPECT_TRUE(server.requestedOffsets.empty());
+
+    // Using the grid does not need the network any longer
+    auto P = proj_create(
+        ctx, ("+proj=vgridshift +grids=" + server.url + " +multiplier=1")
+                 .c_str());
+    ASSERT_NE(P, nullptr);
+    {
+        double longitude = -61.5 / 180. * M_PI;
+        double lat = 16.2 / 180. * M_PI;
+        double z = 0;
+        ASSERT_EQ(proj_trans_generic(P, PJ_FWD, &longitude, sizeof(double), 1,
+                                     &lat, sizeof(double), 1, &z,
+                                     sizeof(double), 1, nullptr, 0, 0),
+                  1U);
+        EXPECT_NE(z, HUGE_VAL);
+        EXPECT_NE(z, 0);
+    }
+    EXPECT_TRUE(server.requestedOffsets.empty());
+    proj_destroy(P);
+
+    proj_context_destroy(ctx);
+}
+
+// ---------------------------------------------------------------------------
+
 #ifdef CURL_ENABLED
 
 TEST(networking, curl_hgridshift) {
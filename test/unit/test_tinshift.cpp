@@ -275,4 +275,234 @@ TEST(tinshift, basic) {
     }
 }
 
+// ---------------------------------------------------------------------------
+
+static void appendLittleEndian(std::string &s, std::uint64_t val,
+                               size_t size) {
+    for (size_t i = 0; i < size; ++i) {
+        s += static_cast<char>((val >> (8 * i)) & 0xFF);
+    }
+}
+
+static void appendDouble(std::string &s, double val) {
+    std::uint64_t bits;
+    memcpy(&bits, &val, sizeof(bits));
+    appendLittleEndian(s, bits, sizeof(bits));
+}
+
+static void padTo8(std::string &s) {
+    while ((s.size() % 8) != 0)
+        s += '\0';
+}
+
+// Build the content of a file in the binary format. If withIndex is set,
+// a spatial index with a single cell referencing all triangles is added for
+// source coordinates.
+static std::string buildBinary(const json &jMetadata,
+                               const std::vector<double> &vertices,
+                               unsigned colCount,
+                               const std::vector<unsigned> &triangles,
+                               bool withIndex) {
+    const std::string metadata = jMetadata.dump();
+    std::string body;
+    const size_t metadataOffset = 192;
+    body += metadata;
+    padTo8(body);
+    const size_t verticesOffset = metadataOffset + body.size();
+    for (double v : vertices)
+        appendDouble(body, v);
+    const size_t trianglesOffset = metadataOffset + body.size();
+    for (unsigned idx : triangles)
+        appendLittleEndian(body, idx, 4);
+    padTo8(body);
+    const unsigned triangleCount = static_cast<unsigned>(triangles.size() / 3);
+    const size_t cellStartOffset = metadataOffset + body.size();
+    appendLittleEndian(body, 0, 4);
+    appendLittleEndian(body, triangleCount, 4);
+    const size_t cellTrianglesOffset = metadataOffset + body.size();
+    for (unsigned i = 0; i < triangleCount; ++i)
+        appendLittleEndian(body, i, 4);
+
+    std::string header("TINSHIFT");
+    appendLittleEndian(header, 1, 4);
+    appendLittleEndian(header, colCount, 4);
+    appendLittleEndian(header, metadataOffset, 8);
+    appendLittleEndian(header, metadata.size(), 8);
+    appendLittleEndian(header, vertices.size() / colCount, 8);
+    appendLittleEndian(header, verticesOffset, 8);
+    appendLittleEndian(header, triangleCount, 8);
+    appendLittleEndian(header, trianglesOffset, 8);
+    if (withIndex) {
+        double minx = std::numeric_limits<double>::max();
+        double miny = std::numeric_limits<double>::max();
+        double maxx = -std::numeric_limits<double>::max();
+        double maxy = -std::numeric_limits<double>::max();
+        for (size_t i = 0; i < vertices.size(); i += colCount) {
+            minx = std::min(minx, vertices[i]);
+            miny = std::min(miny, vertices[i + 1]);
+            maxx = std::max(maxx, vertices[i]);
+            maxy = std::max(maxy, vertices[i + 1]);
+        }
+        appendDouble(header, minx);
+        appendDouble(header, miny);
+        appendDouble(header, maxx);
+        appendDouble(header, maxy);
+        appendLittleEndian(header, 1, 4);
+        appendLittleEndian(header, 1, 4);
+        appendLittleEndian(header, cellStartOffset, 8);
+        appendLittleEndian(header, cellTrianglesOffset, 8);
+        appendLittleEndian(header, triangleCount, 8);
+    }
+    header.resize(metadataOffset, '\0');
+    return header + body;
+}
+
+// ---------------------------------------------------------------------------
+
+static std::unique_ptr<TINShiftFile> parseBinary(const std::string &content) {
+    return TINShiftFile::parseBinary(
+        reinterpret_cast<const unsigned char *>(content.data()),
+        content.size(), nullptr);
+}
+
+// ---------------------------------------------------------------------------
+
+TEST(tinshift, binary) {
+    auto jMetadata(getMinValidContent());
+    jMetadata.erase("vertices");
+    jMetadata.erase("triangles");
+    const std::vector<double> vertices{0, 0, 101, 101, 0, 1,
+                                       100, 101, 1, 1, 100, 100};
+    const std::vector<unsigned> triangles{0, 1, 2};
+
+    EXPECT_FALSE(TINShiftFile::isBinary(
+        reinterpret_cast<const unsigned char *>("foo"), 3));
+    EXPECT_THROW(parseBinary("foo"), ParsingException);
+    EXPECT_THROW(parseBinary("TINSHIFT"), ParsingException);
+
+    for (bool withIndex : {false, true}) {
+        const auto content =
+            buildBinary(jMetadata, vertices, 4, triangles, withIndex);
+        EXPECT_TRUE(TINShiftFile::isBinary(
+            reinterpret_cast<const unsigned char *>(content.data()),
+            content.size()));
+        auto f = parseBinary(content);
+        EXPECT_EQ(f->fileType(), "triangulation_file");
+        EXPECT_EQ(f->inputCRS(), "EPSG:2393");
+        EXPECT_EQ(f->vertexCount(), 3U);
+        EXPECT_EQ(f->triangleCount(), 1U);
+        EXPECT_EQ(f->gridIndex(true).ncols, withIndex ? 1U : 0U);
+        EXPECT_EQ(f->gridIndex(false).ncols, 0U);
+
+        auto eval = Evaluator(std::move(f));
+        double x_out = 0;
+        double y_out = 0;
+        double z_out = 0;
+
+        EXPECT_FALSE(eval.forward(-0.1, 0.0, 1000.0, x_out, y_out, z_out));
+
+        EXPECT_TRUE(eval.forward(0.5, 0.75, 1000.0, x_out, y_out, z_out));
+        EXPECT_EQ(x_out, 100.25);
+        EXPECT_EQ(y_out, 100.5);
+        EXPECT_EQ(z_out, 1000.0);
+
+        EXPECT_TRUE(eval.inverse(100.25, 100.5, 1000.0, x_out, y_out, z_out));
+        EXPECT_EQ(x_out, 0.5);
+        EXPECT_EQ(y_out, 0.75);
+        EXPECT_EQ(z_out, 1000.0);
+    }
+
+    // Misaligned buffer: arrays are copied instead of used in place
+    {
+        const auto content =
+            ' ' + buildBinary(jMetadata, vertices, 4, triangles, true);
+        auto f = TINShiftFile::parseBinary(
+            reinterpret_cast<const unsigned char *>(content.data()) + 1,
+            content.size() - 1, nullptr);
+        auto eval = Evaluator(std::move(f));
+        double x_out = 0;
+        double y_out = 0;
+        double z_out = 0;
+        EXPECT_TRUE(eval.forward(0.5, 0.75, 1000.0, x_out, y_out, z_out));
+        EXPECT_EQ(x_out, 100.25);
+        EXPECT_EQ(y_out, 100.5);
+    }
+
+    // Truncated file
+    {
+        const auto content =
+            buildBinary(jMetadata, vertices, 4, triangles, true);
+        EXPECT_THROW(parseBinary(content.substr(0, content.size() - 4)),
+                     ParsingException);
+    }
+
+    // Invalid vertex index
+    {
+        EXPECT_THROW(
+            parseBinary(buildBinary(jMetadata, vertices, 4, {0, 1, 3}, true)),
+            ParsingException);
+    }
+
+    // vertices_columns[] not in the order of the binary layout
+    {
+        auto j(jMetadata);
+        j["vertices_columns"] = {"target_x", "target_y", "source_x",
+                                 "source_y"};
+        EXPECT_THROW(
+            parseBinary(buildBinary(j, vertices, 4, triangles, true)),
+            ParsingException);
+    }
+}
+
+// ---------------------------------------------------------------------------
+
+TEST(tinshift, walk_from_last_triangle) {
+    // Regular grid of 10x10 vertices with a linear shift, so that the
+    // expected result does not depend on the triangle used.
+    constexpr int size = 10;
+    auto j(getMinValidContent());
+    json vertices = json::array();
+    for (int row = 0; row < size; ++row) {
+        for (int col = 0; col < size; ++col) {
+            vertices.push_back({col, row, col + 0.5 * row, row - 0.25 * col});
+        }
+    }
+    j["vertices"] = std::move(vertices);
+    json triangles = json::array();
+    for (int row = 0; row + 1 < size; ++row) {
+        for (int col = 0; col + 1 < size; ++col) {
+            const int a = row * size + col;
+            triangles.push_back({a, a + 1, a + size + 1});
+            triangles.push_back({a, a + size + 1, a + size});
+        }
+    }
+    j["triangles"] = std::move(triangles);
+
+    auto eval = Evaluator(TINShiftFile::parse(j.dump()));
+    double x_out = 0;
+    double y_out = 0;
+    double z_out = 0;
+    // Nearby points, points far from the previous one, and points outside
+    // of the triangulation.
+    const std::vector<std::pair<double, double>> points{
+        {0.1, 0.2}, {0.3, 0.2}, {1.6, 0.4}, {2.5, 2.5},  {3.2, 2.9},
+        {8.9, 8.8}, {0.2, 8.7}, {4.5, 4},   {-1, 4},     {4.5, 4.1},
+        {9.5, 4},   {9, 9},     {0, 0},     {8.99, 0.01}};
+    for (const auto &point : points) {
+        const double x = point.first;
+        const double y = point.second;
+        const bool inside = x >= 0 && x <= size - 1 && y >= 0 && y <= size - 1;
+        EXPECT_EQ(eval.forward(x, y, 0, x_out, y_out, z_out), inside)
+            << x << " " << y;
+        if (inside) {
+            EXPECT_NEAR(x_out, x + 0.5 * y, 1e-10) << x << " " << y;
+            EXPECT_NEAR(y_out, y - 0.25 * x, 1e-10) << x << " " << y;
+
+            EXPECT_TRUE(eval.inverse(x_out, y_out, 0, x_out, y_out, z_out));
+            EXPECT_NEAR(x_out, x, 1e-10);
+            EXPECT_NEAR(y_out, y, 1e-10);
+        }
+    }
+}
+
 } // namespace